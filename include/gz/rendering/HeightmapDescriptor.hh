@@ -17,6 +17,7 @@
 #ifndef GZ_RENDERING_HEIGHTMAPDESCRIPTOR_HH_
 #define GZ_RENDERING_HEIGHTMAPDESCRIPTOR_HH_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <gz/common/geospatial/HeightmapData.hh>
@@ -250,6 +251,57 @@ inline namespace GZ_RENDERING_VERSION_NAMESPACE {
     /// \param[in] _blend Blend to add.
     public: void AddBlend(const HeightmapBlend &_blend);
 
+    /// \brief Function that loads the heightfield data of one tile of a
+    /// tiled heightmap. It may be called from any thread. The first
+    /// parameter is the column of the tile, along +X, and the second one
+    /// its row, along +Y. It returns null if the tile can't be loaded.
+    public: using TileLoader = std::function<
+        std::shared_ptr<common::HeightmapData>(unsigned int, unsigned int)>;
+
+    /// \brief Split the heightmap into a grid of tiles whose data is loaded
+    /// on demand, for terrains too large to be loaded at once. Size() and
+    /// Position() then describe the whole grid, each tile covering
+    /// Size().X() / _columns by Size().Y() / _rows, and Data() is not used.
+    /// Each tile is rendered like a heightmap of its own data with the size
+    /// of a tile, so the data of every tile must satisfy the sampling
+    /// constraints of Data(). Seams between tiles are not stitched.
+    /// Render engines that support tiling only keep the tiles close to the
+    /// camera loaded, see TileLoadDistance(). Pass 0 columns or rows to
+    /// disable tiling.
+    /// \param[in] _columns Number of tiles along X
+    /// \param[in] _rows Number of tiles along Y
+    /// \param[in] _loader Function loading the data of a tile
+    public: void SetTiles(unsigned int _columns, unsigned int _rows,
+        const TileLoader &_loader);
+
+    /// \brief Get the number of tiles along X.
+    /// \return Number of tile columns, 0 if the heightmap is not tiled.
+    public: unsigned int TileColumns() const;
+
+    /// \brief Get the number of tiles along Y.
+    /// \return Number of tile rows, 0 if the heightmap is not tiled.
+    public: unsigned int TileRows() const;
+
+    /// \brief Load the heightfield data of a tile.
+    /// \param[in] _column Column of the tile, along +X
+    /// \param[in] _row Row of the tile, along +Y
+    /// \return Data of the tile. Null if the tile is out of the grid or
+    /// can't be loaded.
+    public: std::shared_ptr<common::HeightmapData> LoadTile(
+        unsigned int _column, unsigned int _row) const;
+
+    /// \brief Get the distance from the camera within which tiles are
+    /// loaded.
+    /// \return Distance in meters. 0 means the larger side of a tile.
+    public: double TileLoadDistance() const;
+
+    /// \brief Set the distance from the camera within which tiles are
+    /// loaded. Tiles are unloaded once they are 1.5 times that distance
+    /// away. Defaults to 0, which uses the larger side of a tile.
+    /// \param[in] _distance Distance in meters, measured in the XY plane
+    /// between the camera and the closest point of a tile.
+    public: void SetTileLoadDistance(double _distance);
+
     /// \internal
     /// \brief Private data
     GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
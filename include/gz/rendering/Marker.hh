@@ -17,6 +17,9 @@
 #ifndef GZ_RENDERING_MARKER_HH_
 #define GZ_RENDERING_MARKER_HH_
 
+#include <cstddef>
+#include <vector>
+
 #include <gz/math/Color.hh>
 #include <gz/math/Vector3.hh>
 #include "gz/rendering/config.hh"
@@ -30,6 +33,8 @@ namespace gz
   {
     inline namespace GZ_RENDERING_VERSION_NAMESPACE {
     //
+    class MarkerExt;
+
     /// \brief Enum for marker types
     enum GZ_RENDERING_VISIBLE MarkerType
     {
@@ -140,6 +145,60 @@ namespace gz
       /// \param[in] _value The new positional vector of the point
       public: virtual void SetPoint(unsigned int _index,
                   const gz::math::Vector3d &_value) = 0;
+
+      /// \brief Replace all points of the marker with packed single
+      /// precision data. Render engines that support it upload the points
+      /// in bulk, which is much faster than calling AddPoint for every
+      /// point when streaming large point sets. Otherwise this calls
+      /// ClearPoints and AddPoint.
+      /// \param[in] _xyz Array of 3 * _count floats holding the x, y and z
+      /// coordinates of each point
+      /// \param[in] _rgba Array of 4 * _count floats holding the r, g, b
+      /// and a color components of each point, or nullptr to make all
+      /// points white
+      /// \param[in] _count Number of points
+      /// \sa MarkerExt
+      /// \todo(anyone) make this virtual in gz-rendering8
+      public: void SetPoints(const float *_xyz, const float *_rgba,
+                  std::size_t _count);
+
+      /// \brief Replace all points of the marker with packed single
+      /// precision data, taking ownership of the buffers to avoid a copy.
+      /// \param[in] _xyz x, y and z coordinates of each point
+      /// \param[in] _rgba r, g, b and a color components of each point.
+      /// May be empty to make all points white.
+      /// \sa SetPoints(const float *, const float *, std::size_t)
+      /// \todo(anyone) make this virtual in gz-rendering8
+      public: void SetPoints(std::vector<float> &&_xyz,
+                  std::vector<float> &&_rgba);
+
+      /// \brief Bound the number of points of the marker. Once the limit
+      /// is reached, adding a point drops the oldest one. Render engines
+      /// can then stream long trails and paths while only uploading the
+      /// newly added points. Only affects MT_POINTS and MT_LINE_STRIP.
+      /// Not every render engine supports it, see MaxPointCount.
+      /// \param[in] _count Max number of points, 0 for no limit
+      /// \sa MarkerExt
+      /// \todo(anyone) make this virtual in gz-rendering8
+      public: void SetMaxPointCount(unsigned int _count);
+
+      /// \brief Get the max number of points of the marker
+      /// \return Max number of points, 0 if there is no limit or if the
+      /// render engine does not support it
+      /// \sa SetMaxPointCount
+      /// \todo(anyone) make this virtual in gz-rendering8
+      public: unsigned int MaxPointCount() const;
+
+      /// \brief Get the extension of this marker, which render engines use
+      /// to implement the newer marker API
+      /// \return Pointer to the marker extension, null if the render
+      /// engine does not provide one
+      public: MarkerExt *Extension() const;
+
+      /// \brief Set the extension of this marker
+      /// \param[in] _ext Marker extension, it must outlive the marker or
+      /// be unset with nullptr
+      protected: void SetExtension(MarkerExt *_ext);
     };
     }
   }
@@ -18,6 +18,7 @@
 #define GZ_RENDERING_MESHDESCRIPTOR_HH_
 
 #include <string>
+#include <vector>
 
 #include <gz/utils/SuppressWarning.hh>
 
@@ -77,6 +78,51 @@ namespace gz
 
       /// \brief Denotes if the loaded sub-mesh vertices should be centered
       public: bool centerSubMesh = false;
+
+      /// \brief A level of detail generated automatically when the mesh is
+      /// loaded
+      public: struct LodLevel
+      {
+        /// \brief Fraction of the triangles of the full detail mesh to
+        /// keep, in (0, 1]
+        double triangleRatio = 0.5;
+
+        /// \brief The level is drawn by a camera when the bounding sphere
+        /// of the mesh covers less than this fraction of its image, in
+        /// (0, 1]
+        double screenRatio = 0.1;
+      };
+
+      /// \brief Set the levels of detail to generate when a mesh is
+      /// loaded, from the most to the least detailed, so both ratios must
+      /// decrease from one level to the next. Triangles are removed by
+      /// quadric error edge collapse. Each camera picks the level to draw
+      /// from the size of the mesh in its image. The levels apply to
+      /// meshes loaded afterwards through any descriptor of the mesh. Not
+      /// supported by every render engine and ignored for meshes with a
+      /// skeleton.
+      ///
+      /// The levels are kept in a single registry for the whole process,
+      /// shared by all render engines and scenes, until they are reset or
+      /// the registry is cleared with ClearLodLevels. The ogre2 render
+      /// engine clears it when it is destroyed. In ogre2, creating the
+      /// first mesh with generated levels of detail also makes every
+      /// camera select the level of detail of all items, including
+      /// meshes loaded with their own levels of detail, from the fraction
+      /// of its image they cover instead of their distance to the camera.
+      /// \param[in] _meshName Name of the registered mesh
+      /// \param[in] _levels Levels of detail, empty to only draw the full
+      /// detail mesh
+      public: static void SetLodLevels(const std::string &_meshName,
+                  const std::vector<LodLevel> &_levels);
+
+      /// \brief Clear the levels of detail set with SetLodLevels for all
+      /// meshes
+      public: static void ClearLodLevels();
+
+      /// \brief Get the levels of detail to generate for the mesh
+      /// \return Levels of detail set with SetLodLevels for the mesh
+      public: std::vector<LodLevel> LodLevels() const;
     };
     }
   }
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_POINTCLOUDVISUAL_HH_
+#define GZ_RENDERING_POINTCLOUDVISUAL_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/Export.hh"
+#include "gz/rendering/Visual.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class PointCloudVisual PointCloudVisual.hh
+    /// gz/rendering/PointCloudVisual.hh
+    /// \brief A visual for large, static point clouds such as maps.
+    /// Points are stored in a compact format (single precision position
+    /// and 8 bit per channel color), drawn unlit with a constant screen
+    /// space size and split into spatially coherent chunks that are frustum
+    /// culled individually.
+    /// Point cloud visuals are created through the scene extension API,
+    /// with Scene::Extension()->CreateExt("point_cloud", _name), by the
+    /// render engines that support them.
+    /// \todo(anyone) add Scene::CreatePointCloud in gz-rendering8
+    class GZ_RENDERING_VISIBLE PointCloudVisual :
+      public virtual Visual
+    {
+      /// \brief Constructor
+      protected: PointCloudVisual();
+
+      /// \brief Destructor
+      public: virtual ~PointCloudVisual();
+
+      /// \brief Replace the points of the point cloud
+      /// \param[in] _xyz Array of 3 * _count floats holding the x, y and z
+      /// coordinates of each point
+      /// \param[in] _rgba Array of 4 * _count bytes holding the r, g, b
+      /// and a color components of each point, or nullptr to make all
+      /// points white
+      /// \param[in] _count Number of points
+      public: virtual void SetPoints(const float *_xyz,
+                  const uint8_t *_rgba, std::size_t _count) = 0;
+
+      /// \brief Remove all points
+      public: virtual void ClearPoints() = 0;
+
+      /// \brief Get the number of points
+      /// \return Number of points
+      public: virtual std::size_t PointCount() const = 0;
+
+      /// \brief Set the size of the points in pixels
+      /// \param[in] _size Point size in pixels
+      public: virtual void SetPointSize(double _size) = 0;
+
+      /// \brief Get the size of the points in pixels
+      /// \return Point size in pixels
+      public: virtual double PointSize() const = 0;
+
+      /// \brief Set the distance from the camera beyond which points are
+      /// decimated. Past that distance, the fraction of points drawn
+      /// decreases with the square of the distance so the density of points
+      /// on screen stays roughly constant.
+      /// \param[in] _distance Decimation distance in meters, 0 to draw all
+      /// points at any distance
+      public: virtual void SetDecimationDistance(double _distance) = 0;
+
+      /// \brief Get the distance beyond which points are decimated
+      /// \return Decimation distance in meters, 0 if disabled
+      public: virtual double DecimationDistance() const = 0;
+
+      /// \brief Set the max number of points in each chunk. Chunks are the
+      /// unit of frustum culling. Only affects subsequent calls to
+      /// SetPoints.
+      /// \param[in] _count Max number of points per chunk
+      public: virtual void SetChunkSize(std::size_t _count) = 0;
+
+      /// \brief Get the max number of points in each chunk
+      /// \return Max number of points per chunk
+      public: virtual std::size_t ChunkSize() const = 0;
+
+      /// \brief Draw the live output of a sensor instead of the points
+      /// given to SetPoints. Points are reconstructed on the GPU from the
+      /// sensor output texture every frame so they are never read back to
+      /// the CPU. Supported sensors are GpuRays, whose points are computed
+      /// from their ranges, and DepthCamera, whose points and colors are
+      /// read directly. Points are expressed in the sensor frame so the
+      /// visual is typically given the world pose of the sensor. Setting a
+      /// source removes the points given to SetPoints.
+      /// \param[in] _sensor GpuRays or DepthCamera to draw, nullptr to stop
+      /// drawing the sensor output
+      public: virtual void SetSource(SensorPtr _sensor) = 0;
+
+      /// \brief Get the sensor whose output is drawn
+      /// \return The sensor, nullptr if the visual draws the points given
+      /// to SetPoints
+      public: virtual SensorPtr Source() const = 0;
+    };
+    }
+  }
+}
+#endif
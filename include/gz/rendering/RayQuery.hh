@@ -58,6 +58,21 @@ namespace gz
               }
     };
 
+    /// \brief A ray used for batched ray queries.
+    /// \sa closestPoints
+    class GZ_RENDERING_VISIBLE RayQueryRay
+    {
+      /// \brief Ray origin
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      public: math::Vector3d origin;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+
+      /// \brief Ray direction
+      GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
+      public: math::Vector3d direction;
+      GZ_UTILS_WARN_RESUME__DLL_INTERFACE_MISSING
+    };
+
     /// \class RayQuery RayQuery.hh gz/rendering/RayQuery.hh
     /// \brief A Ray Query class used for computing ray object intersections
     class GZ_RENDERING_VISIBLE RayQuery
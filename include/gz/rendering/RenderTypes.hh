@@ -75,6 +75,7 @@ namespace gz
     class Object;
     class ObjectFactory;
     class ParticleEmitter;
+    class PointCloudVisual;
     class PointLight;
     class Projector;
     class RayQuery;
@@ -220,6 +221,10 @@ namespace gz
     /// \brief Shared pointer to ParticleEmitter
     typedef shared_ptr<ParticleEmitter> ParticleEmitterPtr;
 
+    /// \typedef PointCloudVisualPtr
+    /// \brief Shared pointer to PointCloudVisual
+    typedef shared_ptr<PointCloudVisual> PointCloudVisualPtr;
+
     /// \typedef ProjectorPtr
     /// \brief Shared pointer to Projector
     typedef shared_ptr<Projector> ProjectorPtr;
@@ -378,6 +383,10 @@ namespace gz
     /// \brief Shared pointer to const ParticleEmitter
     typedef shared_ptr<const ParticleEmitter> ConstParticleEmitterPtr;
 
+    /// \typedef const PointCloudVisualPtr
+    /// \brief Shared pointer to const PointCloudVisual
+    typedef shared_ptr<const PointCloudVisual> ConstPointCloudVisualPtr;
+
     /// \typedef const ProjectorPtr
     /// \brief Shared pointer to const Projector
     typedef shared_ptr<const Projector> ConstProjectorPtr;
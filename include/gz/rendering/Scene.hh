@@ -1228,6 +1228,22 @@ namespace gz
       /// \see Scene::SetCameraPassCountPerGpuFlush
       public: virtual void PostRender() = 0;
 
+      /// \brief Render every camera of the scene once so that the shaders
+      /// and pipeline states needed by the current visuals, materials and
+      /// camera types are built now rather than on the frame where they
+      /// are first drawn. This includes the special rendering modes used by
+      /// thermal, segmentation and bounding box cameras. Call it after the
+      /// scene is populated and before starting the render loop, and again
+      /// after adding visuals with new materials, to keep frame times
+      /// steady. It calls PreRender and PostRender itself, so it must not
+      /// be called between them. Cameras do not produce new frames, but
+      /// particle effects move forward by one frame. In the legacy mode of
+      /// SetCameraPassCountPerGpuFlush, the pass count is raised to 1 for
+      /// the duration of the call so the warm-up frame is ended and its
+      /// GPU commands flushed before returning.
+      /// \todo(anyone) make this virtual in gz-rendering8
+      public: void WarmUp();
+
       /// \brief
       /// The ideal render loop is as follows:
       ///
@@ -17,6 +17,8 @@
 #ifndef GZ_RENDERING_UTILS_HH_
 #define GZ_RENDERING_UTILS_HH_
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -85,6 +87,33 @@ namespace gz
       const RayQueryPtr &_rayQuery,
       const float _offset = 0.0);
 
+    /// \brief Compute the closest intersection of many rays at once. This
+    /// runs RayQuery::ClosestPoint for each ray, and works with every render
+    /// engine. Ogre2RayQuery::ClosestPoints traverses the scene once for the
+    /// whole batch and intersects the rays in parallel.
+    /// The origin and direction of the ray query are restored afterwards.
+    /// Directions are normalized so result distances are in world units.
+    /// \param[in] _rayQuery Ray query
+    /// \param[in] _rays Array of _count rays to test
+    /// \param[out] _results Array of _count results. Rays that hit
+    /// nothing get an invalid result (negative distance).
+    /// \param[in] _count Number of rays
+    /// \param[in] _maxDistance Ignore intersections farther than this
+    /// distance. A value <= 0 means no limit.
+    /// \param[in] _visibilityMask Only objects whose visibility flags
+    /// share at least one bit with this mask are hit
+    /// \param[in] _forceSceneUpdate Performance optimization hint.
+    /// See RayQuery::ClosestPoint.
+    GZ_RENDERING_VISIBLE
+    void closestPoints(
+        const RayQueryPtr &_rayQuery,
+        const RayQueryRay *_rays,
+        RayQueryResult *_results,
+        std::size_t _count,
+        double _maxDistance = -1.0,
+        uint32_t _visibilityMask = GZ_VISIBILITY_ALL,
+        bool _forceSceneUpdate = true);
+
     /// \brief Get the screen scaling factor.
     /// \return The screen scaling factor.
     GZ_RENDERING_VISIBLE
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_BASE_BASEPOINTCLOUDVISUAL_HH_
+#define GZ_RENDERING_BASE_BASEPOINTCLOUDVISUAL_HH_
+
+#include <cstddef>
+
+#include <gz/common/Console.hh>
+
+#include "gz/rendering/DepthCamera.hh"
+#include "gz/rendering/GpuRays.hh"
+#include "gz/rendering/PointCloudVisual.hh"
+#include "gz/rendering/base/BaseObject.hh"
+#include "gz/rendering/base/BaseRenderTypes.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of a point cloud visual
+    template <class T>
+    class BasePointCloudVisual :
+      public virtual PointCloudVisual,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BasePointCloudVisual();
+
+      /// \brief Destructor
+      public: virtual ~BasePointCloudVisual();
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      // Documentation inherited.
+      public: virtual void SetPointSize(double _size) override;
+
+      // Documentation inherited.
+      public: virtual double PointSize() const override;
+
+      // Documentation inherited.
+      public: virtual void SetDecimationDistance(double _distance) override;
+
+      // Documentation inherited.
+      public: virtual double DecimationDistance() const override;
+
+      // Documentation inherited.
+      public: virtual void SetChunkSize(std::size_t _count) override;
+
+      // Documentation inherited.
+      public: virtual std::size_t ChunkSize() const override;
+
+      // Documentation inherited.
+      public: virtual void SetSource(SensorPtr _sensor) override;
+
+      // Documentation inherited.
+      public: virtual SensorPtr Source() const override;
+
+      /// \brief Point size in pixels
+      protected: double pointSize = 1.0;
+
+      /// \brief Distance beyond which points are decimated, 0 if disabled
+      protected: double decimationDistance = 0.0;
+
+      /// \brief Max number of points per chunk
+      protected: std::size_t chunkSize = 65536u;
+
+      /// \brief Sensor whose output is drawn, null if none
+      protected: SensorPtr source;
+    };
+
+    /////////////////////////////////////////////////
+    // BasePointCloudVisual
+    /////////////////////////////////////////////////
+    template <class T>
+    BasePointCloudVisual<T>::BasePointCloudVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    BasePointCloudVisual<T>::~BasePointCloudVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::PreRender()
+    {
+      T::PreRender();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::Destroy()
+    {
+      T::Destroy();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetPointSize(double _size)
+    {
+      this->pointSize = _size;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    double BasePointCloudVisual<T>::PointSize() const
+    {
+      return this->pointSize;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetDecimationDistance(double _distance)
+    {
+      if (_distance < 0.0)
+      {
+        gzerr << "Decimation distance must be positive, got ["
+               << _distance << "]" << std::endl;
+        return;
+      }
+      this->decimationDistance = _distance;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    double BasePointCloudVisual<T>::DecimationDistance() const
+    {
+      return this->decimationDistance;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetChunkSize(std::size_t _count)
+    {
+      if (_count == 0u)
+      {
+        gzerr << "Point cloud chunk size must be greater than 0"
+               << std::endl;
+        return;
+      }
+      this->chunkSize = _count;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    std::size_t BasePointCloudVisual<T>::ChunkSize() const
+    {
+      return this->chunkSize;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BasePointCloudVisual<T>::SetSource(SensorPtr _sensor)
+    {
+      if (_sensor && !std::dynamic_pointer_cast<GpuRays>(_sensor) &&
+          !std::dynamic_pointer_cast<DepthCamera>(_sensor))
+      {
+        gzerr << "Point cloud source [" << _sensor->Name()
+               << "] is neither a GpuRays nor a DepthCamera" << std::endl;
+        return;
+      }
+
+      if (_sensor)
+        this->ClearPoints();
+      this->source = _sensor;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    SensorPtr BasePointCloudVisual<T>::Source() const
+    {
+      return this->source;
+    }
+    }
+  }
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_MARKEREXT_HH_
+#define GZ_RENDERING_MARKEREXT_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/Marker.hh"
+#include "gz/rendering/Export.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Marker Extension class. Provides API extension to the Marker
+    /// class without breaking ABI. The default implementations only use the
+    /// existing Marker API.
+    class GZ_RENDERING_VISIBLE MarkerExt
+    {
+      /// \brief Constructor
+      /// \param[in] _marker Pointer to marker
+      public: explicit MarkerExt(Marker *_marker);
+
+      /// \brief Destructor
+      public: virtual ~MarkerExt();
+
+      /// \brief Replace all points of the marker with packed single
+      /// precision data. Calls Marker::ClearPoints and Marker::AddPoint.
+      /// \param[in] _xyz Array of 3 * _count floats holding the x, y and z
+      /// coordinates of each point
+      /// \param[in] _rgba Array of 4 * _count floats holding the r, g, b
+      /// and a color components of each point, or nullptr
+      /// \param[in] _count Number of points
+      /// \sa Marker::SetPoints
+      public: virtual void SetPoints(const float *_xyz, const float *_rgba,
+          std::size_t _count);
+
+      /// \brief Replace all points of the marker with packed single
+      /// precision data, taking ownership of the buffers
+      /// \param[in] _xyz x, y and z coordinates of each point
+      /// \param[in] _rgba r, g, b and a color components of each point, or
+      /// empty
+      /// \sa Marker::SetPoints
+      public: virtual void SetPoints(std::vector<float> &&_xyz,
+          std::vector<float> &&_rgba);
+
+      /// \brief Bound the number of points of the marker. Not supported by
+      /// default, only prints a warning.
+      /// \param[in] _count Max number of points, 0 for no limit
+      /// \sa Marker::SetMaxPointCount
+      public: virtual void SetMaxPointCount(unsigned int _count);
+
+      /// \brief Get the max number of points of the marker
+      /// \return Max number of points, 0 by default
+      /// \sa Marker::MaxPointCount
+      public: virtual unsigned int MaxPointCount() const;
+
+      /// \brief Pointer to marker
+      protected: Marker *marker{nullptr};
+    };
+    }
+  }
+}
+#endif
@@ -436,6 +436,13 @@ void OgreHeightmap::Init()
 {
   OgreObject::Init();
 
+  if (this->descriptor.TileColumns() > 0u)
+  {
+    gzerr << "Failed to initialize: tiled heightmaps are not supported by "
+          << "ogre, use ogre2." << std::endl;
+    return;
+  }
+
   if (this->descriptor.Data() == nullptr)
   {
     gzerr << "Failed to initialize: null heightmap data." << std::endl;
@@ -18,6 +18,7 @@
 #define GZ_RENDERING_OGRE2_OGRE2CAMERA_HH_
 
 #include <memory>
+#include <vector>
 
 #include "gz/rendering/base/BaseCamera.hh"
 #include "gz/rendering/ogre2/Ogre2RenderTypes.hh"
@@ -115,6 +116,59 @@ namespace gz
       public: virtual VisualPtr VisualAt(const gz::math::Vector2i
                   &_mousePos) override;
 
+      /// \brief Get the visuals for many mouse positions at once. All
+      /// positions are resolved from a single render of the selection
+      /// buffer. Blocks until the result is read back from the GPU.
+      /// \param[in] _mousePos Mouse positions
+      /// \return Visual for each position, null where no visual was found
+      /// \todo(anyone) make this a virtual of Camera in gz-rendering8
+      public: std::vector<VisualPtr> VisualsAt(
+                  const std::vector<math::Vector2i> &_mousePos);
+
+      /// \brief Get all visuals visible inside a rectangle of the image,
+      /// e.g. for box selection. Blocks until the result is read back from
+      /// the GPU, use RequestRegionVisuals to avoid waiting.
+      /// \param[in] _min Top left corner of the rectangle in pixels
+      /// \param[in] _max Bottom right corner of the rectangle in pixels,
+      /// inclusive
+      /// \return Unique visuals visible in the rectangle
+      /// \todo(anyone) make this a virtual of Camera in gz-rendering8
+      public: std::vector<VisualPtr> VisualsAt(
+                  const math::Vector2i &_min, const math::Vector2i &_max);
+
+      /// \brief Render the visuals inside a rectangle of the image and start
+      /// reading them back without waiting for the GPU. Poll
+      /// RegionVisualsReady, then get them with RegionVisuals. A new request,
+      /// or a call to VisualsAt, replaces the results.
+      /// \param[in] _min Top left corner of the rectangle in pixels
+      /// \param[in] _max Bottom right corner of the rectangle in pixels,
+      /// inclusive
+      /// \return False if the request could not be issued, e.g. if the
+      /// rectangle is outside of the image
+      public: bool RequestRegionVisuals(const math::Vector2i &_min,
+                  const math::Vector2i &_max);
+
+      /// \brief Check whether the visuals requested with
+      /// RequestRegionVisuals have been read back. This does not block.
+      /// \return True if RegionVisuals can be called without waiting
+      public: bool RegionVisualsReady();
+
+      /// \brief Get the visuals requested with RequestRegionVisuals. Blocks
+      /// until they are read back if RegionVisualsReady is false.
+      /// \return Unique visuals visible in the requested rectangle, empty
+      /// if nothing was requested
+      public: std::vector<VisualPtr> RegionVisuals();
+
+      /// \brief Create the selection buffer if needed and match its size to
+      /// the camera image
+      /// \return False if the selection buffer could not be created
+      private: bool PrepareSelectionBuffer();
+
+      /// \brief Get the visual an ogre item belongs to
+      /// \param[in] _item Ogre item
+      /// \return Visual, or null if the item does not belong to a visual
+      private: VisualPtr VisualFromItem(Ogre::Item *_item) const;
+
       // Documentation Inherited.
       // \sa Camera::SetMaterial(const MaterialPtr &)
       public: virtual void SetMaterial(
@@ -39,6 +39,7 @@ namespace Ogre
   class Material;
   class RenderTarget;
   class Texture;
+  class TextureGpu;
   class Viewport;
 }
 
@@ -133,6 +134,16 @@ namespace gz
       // Documentation inherited.
       public: virtual Ogre::Camera *OgreCamera() const override;
 
+      /// \brief Get the texture holding the final output of the camera.
+      /// Each texel holds the xyz position of a point in the camera frame as
+      /// float bits followed by its rgba8 color packed in a single uint,
+      /// see depth_camera_final_fs.glsl. The texture can be sampled on the
+      /// GPU to visualize the point cloud without reading it back to the
+      /// CPU.
+      /// \return The point texture, null if the depth texture has not been
+      /// created yet
+      public: Ogre::TextureGpu *OutputTexture() const;
+
       /// \brief Get a pointer to the render target.
       /// \return Pointer to the render target
       protected: virtual RenderTargetPtr RenderTarget() const override;
@@ -89,6 +89,23 @@ namespace gz
       public: void AddPoint(const double _x, const double _y, const double _z,
             const gz::math::Color &_color = gz::math::Color::White);
 
+      /// \brief Replace the point list with packed single precision data.
+      /// \param[in] _xyz Array of 3 * _count floats holding the position of
+      /// each point
+      /// \param[in] _rgba Array of 4 * _count floats holding the color of
+      /// each point, or nullptr to make all points white
+      /// \param[in] _count Number of points
+      public: void SetPoints(const float *_xyz, const float *_rgba,
+                             std::size_t _count);
+
+      /// \brief Replace the point list with packed single precision data,
+      /// taking ownership of the buffers.
+      /// \param[in] _xyz Position of each point, 3 floats per point
+      /// \param[in] _rgba Color of each point, 4 floats per point. May be
+      /// empty to make all points white.
+      public: void SetPoints(std::vector<float> &&_xyz,
+                             std::vector<float> &&_rgba);
+
       /// \brief Change the location of an existing point in the point list
       /// \param[in] _index Index of the point to set
       /// \param[in] _value Position of the point
@@ -113,6 +130,19 @@ namespace gz
       /// \return Number of points
       public: unsigned int PointCount() const;
 
+      /// \brief Bound the number of points. Once the limit is reached,
+      /// adding a point replaces the oldest one, which makes the point list
+      /// behave as a ring buffer: only the new point is uploaded so
+      /// streaming trails and paths cost O(1) per added point regardless of
+      /// their length. Only supported for MT_POINTS and MT_LINE_STRIP.
+      /// \param[in] _count Max number of points, 0 for no limit
+      public: void SetMaxPointCount(unsigned int _count);
+
+      /// \brief Get the max number of points
+      /// \return Max number of points, 0 if there is no limit
+      /// \sa SetMaxPointCount
+      public: unsigned int MaxPointCount() const;
+
       /// \brief Remove all points from the point list
       public: void Clear();
 
@@ -132,18 +162,25 @@ namespace gz
 
       /// \brief Helper function to generate normals
       /// \param[in] _opType Ogre render operation type
-      /// \param[in] _vertices a list of vertices
+      /// \param[in] _vertices packed xyz positions of the vertices
+      /// \param[in] _vertexCount number of vertices
+      /// \param[in,out] _start First vertex that changed. Set to the first
+      /// vertex whose normal was regenerated.
+      /// \param[in,out] _end One past the last vertex that changed. Set to
+      /// one past the last vertex whose normal was regenerated.
       /// \param[in,out] _vbuffer vertex buffer to be filled
       private: void GenerateNormals(Ogre::OperationType _opType,
-          const std::vector<math::Vector3d> &_vertices, float *_vbuffer);
+          const float *_vertices, unsigned int _vertexCount,
+          unsigned int &_start, unsigned int &_end, float *_vbuffer);
 
       /// \brief Helper function to generate colors per-vertex. Only applies
       /// to points. The colors fill the normal slots on the vertex buffer.
       /// \param[in] _opType Ogre render operation type
-      /// \param[in] _vertices a list of vertices
+      /// \param[in] _start First vertex to fill
+      /// \param[in] _end One past the last vertex to fill
       /// \param[in,out] _vbuffer vertex buffer to be filled
       private: void GenerateColors(Ogre::OperationType _opType,
-          const std::vector<math::Vector3d> &_vertices, float *_vbuffer);
+          unsigned int _start, unsigned int _end, float *_vbuffer);
 
       /// \brief Destroy the vertex buffer
       private: void DestroyBuffer();
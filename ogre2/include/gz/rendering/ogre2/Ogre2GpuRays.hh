@@ -37,6 +37,7 @@ namespace Ogre
   class Material;
   class RenderTarget;
   class Texture;
+  class TextureGpu;
   class Viewport;
 }
 
@@ -101,6 +102,15 @@ namespace gz
       // Documentation inherited.
       public: virtual RenderTargetPtr RenderTarget() const override;
 
+      /// \brief Get the texture holding the output of the 2nd pass. Each
+      /// texel holds the range (r) and retro (g) of one ray. Rows go from
+      /// the min to the max vertical angle and columns from the min to the
+      /// max horizontal angle. The texture can be sampled on the GPU to
+      /// visualize the rays without reading them back to the CPU.
+      /// \return The range texture, null if the sensor textures have not
+      /// been created yet
+      public: Ogre::TextureGpu *OutputTexture() const;
+
       /// \brief Set the number of samples in the width and height for the
       /// first pass texture.
       /// \param[in] _w Number of samples in the horizontal sweep
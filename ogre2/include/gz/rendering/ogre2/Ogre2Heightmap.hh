@@ -18,6 +18,7 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2HEIGHTMAP_HH_
 #define GZ_RENDERING_OGRE2_OGRE2HEIGHTMAP_HH_
 
+#include <cstddef>
 #include <memory>
 
 #include "gz/rendering/base/BaseHeightmap.hh"
@@ -35,6 +36,7 @@ namespace Ogre
 {
   class Camera;
   class Terra;
+  class Vector4;
 }
 
 namespace gz
@@ -83,15 +85,29 @@ namespace gz
           override;
 
       /// \internal
-      /// \brief Retrieves the internal Terra pointer
+      /// \brief Retrieves the internal Terra pointer. For tiled heightmaps,
+      /// the loaded tile closest to the last camera passed to
+      /// UpdateForRender.
       /// \return internal Terra pointer
       public: Ogre::Terra* Terra();
 
+      /// \internal
+      /// \brief Set a solid color on all Terra instances, see
+      /// Ogre::Terra::SetSolidColor
+      /// \param[in] _idx Index of the solid color
+      /// \param[in] _color Color
+      public: void SetSolidColor(size_t _idx, const Ogre::Vector4 &_color);
+
+      /// \internal
+      /// \brief Unset the solid colors of all Terra instances
+      public: void UnsetSolidColors();
+
       /// \internal
       /// \brief Must be called before rendering with the camera
       /// that will perform rendering.
       ///
-      /// May update shadows if light direction changed
+      /// May update shadows if light direction changed. Loads and unloads
+      /// the tiles of tiled heightmaps based on the camera position.
       /// \param[in] _activeCamera Camera about to be used for rendering
       public: void UpdateForRender(Ogre::Camera *_activeCamera);
 
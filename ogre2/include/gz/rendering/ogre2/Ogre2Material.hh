@@ -321,6 +321,18 @@ namespace gz
       /// \return Ogre texture
       protected: virtual Ogre::TextureGpu *Texture(const std::string &_name);
 
+      /// \brief Apply the settings that depend on the format of a texture
+      /// map, such as disabling alpha from texture when the diffuse map has
+      /// no alpha channel. The texture metadata must be ready.
+      /// \param[in] _tex Texture of the map
+      /// \param[in] _type Type of the texture map
+      protected: void ApplyTextureMetadata(Ogre::TextureGpu *_tex,
+          Ogre::PbsTextureTypes _type);
+
+      /// \brief Apply the metadata of streamed texture maps that finished
+      /// loading their metadata. See Ogre2RenderEngine::StreamTextures.
+      protected: void UpdateStreamedTextures();
+
       /// \brief Updates the material transparency in the engine,
       /// based on transparency and diffuse alpha values
       protected: virtual void UpdateTransparency();
@@ -376,11 +388,25 @@ namespace gz
       /// \brief Unique id assigned to ogre hlms datablock
       protected: std::string ogreDatablockId;
 
+      /// \brief Register a submesh bound to a shared datablock with the
+      /// content of this material. It is bound again in PreRender after
+      /// the datablock of this material changes.
+      /// \param[in] _subMesh Submesh to register
+      private: void AddSharedUser(Ogre2SubMesh *_subMesh);
+
+      /// \brief Unregister a submesh added with AddSharedUser
+      /// \param[in] _subMesh Submesh to unregister
+      private: void RemoveSharedUser(Ogre2SubMesh *_subMesh);
+
       /// \brief Pointer to private data class
       private: std::unique_ptr<Ogre2MaterialPrivate> dataPtr;
 
       /// \brief Only an ogre scene can create an ogre material
       private: friend class Ogre2Scene;
+
+      /// \brief Make submesh our friend so it can register as a user of
+      /// a shared datablock
+      private: friend class Ogre2SubMesh;
     };
     }
   }
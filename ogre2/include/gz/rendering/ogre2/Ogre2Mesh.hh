@@ -129,10 +129,25 @@ namespace gz
       /// \brief Get internal ogre subitem created from this submesh
       public: virtual Ogre::SubItem *Ogre2SubItem() const;
 
+      /// \brief Bind the datablock of the material itself instead of a
+      /// datablock shared with other submeshes, and keep doing so for any
+      /// material set later. Must be called before modifying the datablock
+      /// of the sub item directly. See Ogre2RenderEngine::ShareMaterials.
+      public: void Unshare();
+
       /// \brief Helper function for setting the material to use
       /// \param[in] _material Material to be assigned to the submesh
       protected: virtual void SetMaterialImpl(MaterialPtr _material) override;
 
+      /// \brief Bind the datablock of a material to the sub item, or the
+      /// shared datablock with the same content if materials are shared
+      /// \param[in] _material Pbs material
+      protected: void BindDatablock(Ogre2Material *_material);
+
+      /// \brief Stop using the shared datablock bound to the sub item, if
+      /// any
+      protected: void ReleaseSharedDatablock();
+
       /// \brief Initialize the submesh
       protected: virtual void Init() override;
 
@@ -146,6 +161,10 @@ namespace gz
       /// ogre2 submesh
       private: friend class Ogre2SubMeshStoreFactory;
 
+      /// \brief Make material our friend so it can bind the shared
+      /// datablock matching its new content
+      private: friend class Ogre2Material;
+
       /// \brief Pointer to private data
       private: std::unique_ptr<Ogre2SubMeshPrivate> dataPtr;
     };
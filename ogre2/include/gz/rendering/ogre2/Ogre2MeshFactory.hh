@@ -17,6 +17,7 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2MESHFACTORY_HH_
 #define GZ_RENDERING_OGRE2_OGRE2MESHFACTORY_HH_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -57,6 +58,26 @@ namespace gz
       /// mesh
       public: virtual Ogre2MeshPtr Create(const MeshDescriptor &_desc);
 
+      /// \brief Create a mesh from a descriptor asynchronously. The vertex
+      /// and index data is packed on a worker thread and the mesh is created
+      /// by a later call to ProcessAsyncLoads.
+      /// \param[in] _desc Mesh descriptor containing data needed to create a
+      /// mesh
+      /// \param[in] _callback Function called from ProcessAsyncLoads with
+      /// the created mesh, or nullptr on failure
+      public: void CreateAsync(const MeshDescriptor &_desc,
+                  std::function<void(Ogre2MeshPtr)> _callback);
+
+      /// \brief Create the meshes whose data was packed by worker threads
+      /// and pass them to their callbacks. Must be called from the render
+      /// thread.
+      public: void ProcessAsyncLoads();
+
+      /// \brief Wait for the worker threads and pass nullptr to the
+      /// callbacks of every pending asynchronous mesh. Must be called before
+      /// the objects referenced by the callbacks are destroyed.
+      public: void CancelAsyncLoads();
+
       /// \brief Cleanup and clear all internal ogre v2 meshes created by this
       /// factory
       public: virtual void Clear();
@@ -79,6 +100,12 @@ namespace gz
       /// \param[in] _desc Input mesh descriptor
       protected: virtual bool LoadImpl(const MeshDescriptor &_desc);
 
+      /// \brief Load a mesh through an ogre v1 mesh that is converted to a
+      /// v2 mesh by OgreItem. Only used for meshes with a skeleton.
+      /// \param[in] _desc Input mesh descriptor
+      /// \return True on success
+      private: bool LoadV1Impl(const MeshDescriptor &_desc);
+
       /// \brief Get the mesh name from the mesh descriptor
       /// \param[in] _desc Mesh descriptor containing the mesh name
       protected: virtual std::string MeshName(const MeshDescriptor &_desc);
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2POINTCLOUDVISUAL_HH_
+#define GZ_RENDERING_OGRE2_OGRE2POINTCLOUDVISUAL_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gz/rendering/base/BasePointCloudVisual.hh"
+#include "gz/rendering/ogre2/Ogre2Visual.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreAabb.h>
+#include <OgrePrerequisites.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace Ogre
+{
+  class Item;
+  class TextureGpu;
+  class VertexBufferPacked;
+}
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2PointCloudVisualPrivate;
+
+    /// \brief Ogre 2.x implementation of a point cloud visual. Points are
+    /// split into chunks along the median of their longest axis until each
+    /// chunk holds at most ChunkSize() points. Every chunk is an Ogre item
+    /// with its own bounds and a vertex buffer of 16 byte
+    /// vertices (float3 position + ubyte4 color).
+    class GZ_RENDERING_OGRE2_VISIBLE Ogre2PointCloudVisual
+      : public BasePointCloudVisual<Ogre2Visual>
+    {
+      /// \brief Constructor
+      protected: Ogre2PointCloudVisual();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2PointCloudVisual();
+
+      // Documentation inherited.
+      public: virtual void Init() override;
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      // Documentation inherited.
+      public: virtual void SetPoints(const float *_xyz,
+                  const uint8_t *_rgba, std::size_t _count) override;
+
+      // Documentation inherited.
+      public: virtual void ClearPoints() override;
+
+      // Documentation inherited.
+      public: virtual std::size_t PointCount() const override;
+
+      /// \brief Create the item for one chunk of points
+      /// \param[in] _xyz Positions of all points
+      /// \param[in] _rgba Colors of all points, may be null
+      /// \param[in] _indices Indices of the points in the chunk
+      /// \param[in] _count Number of points in the chunk
+      private: void CreateChunk(const float *_xyz, const uint8_t *_rgba,
+                   const uint32_t *_indices, std::size_t _count);
+
+      /// \brief Create an item drawing a vertex buffer of points
+      /// \param[in] _vertexBuffer Vertex buffer holding the points
+      /// \param[in] _bounds Bounds of the points
+      /// \param[in] _material Material of the item
+      /// \return The item, attached to the visual node
+      private: Ogre::Item *CreateItem(
+                   Ogre::VertexBufferPacked *_vertexBuffer,
+                   const Ogre::Aabb &_bounds,
+                   const Ogre::MaterialPtr &_material);
+
+      /// \brief Rebuild the source item if the output texture of the
+      /// source sensor changed and update the sensor parameters of the
+      /// source material
+      private: void UpdateSource();
+
+      /// \brief Create the item drawing the output texture of the source
+      /// sensor
+      /// \param[in] _texture Output texture of the sensor
+      /// \param[in] _materialName Name of the material reading the texture
+      /// \param[in] _maxRange Max range of the sensor
+      private: void CreateSource(Ogre::TextureGpu *_texture,
+                   const std::string &_materialName, double _maxRange);
+
+      /// \brief Destroy the item and material created by CreateSource
+      private: void DestroySource();
+
+      /// \brief Only the ogre scene can instantiate this class
+      private: friend class Ogre2Scene;
+
+      /// \brief Private data class
+      private: std::unique_ptr<Ogre2PointCloudVisualPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -17,6 +17,8 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2RAYQUERY_HH_
 #define GZ_RENDERING_OGRE2_OGRE2RAYQUERY_HH_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 #include "gz/rendering/base/BaseRayQuery.hh"
@@ -52,6 +54,29 @@ namespace gz
       public: virtual RayQueryResult ClosestPoint(
             bool _forceSceneUpdate = true);
 
+      /// \brief Compute the closest intersection of many rays at once.
+      /// The scene is only traversed once for the whole batch and rays are
+      /// intersected in parallel. This does not use the origin and
+      /// direction set on this ray query. Directions are normalized so
+      /// result distances are in world units.
+      /// \param[in] _rays Array of _count rays to test
+      /// \param[out] _results Array of _count results. Rays that hit
+      /// nothing get an invalid result (negative distance).
+      /// \param[in] _count Number of rays
+      /// \param[in] _maxDistance Ignore intersections farther than this
+      /// distance. A value <= 0 means no limit.
+      /// \param[in] _visibilityMask Only objects whose visibility flags
+      /// share at least one bit with this mask are hit
+      /// \param[in] _forceSceneUpdate Performance optimization hint.
+      /// See ClosestPoint.
+      /// \sa closestPoints for other render engines
+      /// \todo(anyone) make this a virtual of RayQuery in gz-rendering8
+      public: void ClosestPoints(const RayQueryRay *_rays,
+            RayQueryResult *_results, std::size_t _count,
+            double _maxDistance = -1.0,
+            uint32_t _visibilityMask = GZ_VISIBILITY_ALL,
+            bool _forceSceneUpdate = true);
+
       /// \brief Get closest point by selection buffer.
       /// This is executed on the GPU.
       private: RayQueryResult ClosestPointBySelectionBuffer();
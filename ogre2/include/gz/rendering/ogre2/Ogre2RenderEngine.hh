@@ -17,9 +17,11 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2RENDERENGINE_HH_
 #define GZ_RENDERING_OGRE2_OGRE2RENDERENGINE_HH_
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gz/common/SingletonT.hh>
@@ -55,6 +57,28 @@ namespace gz
     // forward declaration
     class Ogre2RenderEnginePrivate;
     class Ogre2GzHlmsSphericalClipMinDistance;
+    class Ogre2ImageDecoder;
+
+    /// \brief Residency statistics of the textures loaded from files, see
+    /// Ogre2RenderEngine::TextureStats
+    struct Ogre2TextureStats
+    {
+      /// \brief Bytes of textures resident or becoming resident
+      uint64_t residentBytes = 0u;
+
+      /// \brief Number of textures resident or becoming resident
+      unsigned int residentTextures = 0u;
+
+      /// \brief Texture budget in bytes, 0 if there is no limit
+      uint64_t budgetBytes = 0u;
+
+      /// \brief Number of textures evicted to stay within the budget
+      uint64_t evictions = 0u;
+
+      /// \brief Number of evicted textures made resident again because
+      /// they were drawn
+      uint64_t streamIns = 0u;
+    };
 
     /// \brief Plugin for loading ogre render engine
     class GZ_RENDERING_OGRE2_VISIBLE Ogre2RenderEnginePlugin :
@@ -123,6 +147,114 @@ namespace gz
       // Documentation Inherited
       public: virtual rendering::GraphicsAPI GraphicsAPI() const override;
 
+      /// \brief Get the directory of the mesh cache, set with the
+      /// "meshCacheDir" parameter of Load. Meshes are stored there under a
+      /// hash of their content the first time they are loaded and read back
+      /// on later runs instead of being converted again.
+      /// \return Mesh cache directory, empty if the cache is disabled
+      public: std::string MeshCacheDir() const;
+
+      /// \brief Get the directory of the heightmap cache, set with the
+      /// "heightmapCacheDir" parameter of Load. The sampled and normalized
+      /// heights of heightmaps loaded from files are stored there under a
+      /// hash of the source file and of the descriptor, and read back on
+      /// later runs instead of sampling the source image again.
+      /// \return Heightmap cache directory, empty if the cache is disabled
+      public: std::string HeightmapCacheDir() const;
+
+      /// \brief Get whether meshes use the compact vertex layout, set with
+      /// the "compactMeshVertices" parameter of Load. The compact layout
+      /// stores normals as QTangents and texture coordinates as half
+      /// floats, and positions as half floats when no coordinate of the
+      /// submesh exceeds 2 m, roughly halving the size of vertex buffers.
+      /// Custom vertex programs must then not read normals as float3.
+      /// Meshes with a skeleton are not affected. 16 bit indices are used
+      /// whenever possible regardless of this setting.
+      /// \return True if the compact vertex layout is used
+      public: bool CompactMeshVertices() const;
+
+      /// \brief Get whether meshes are optimized at load time, set with the
+      /// "optimizeMeshes" parameter of Load. Triangles are reordered for
+      /// the post-transform vertex cache and to reduce overdraw, and
+      /// vertices are sorted by first use, which typically reduces vertex
+      /// shader invocations of scanned meshes by a third. Unused vertices
+      /// are dropped. The result is stored in the mesh cache. Meshes with a
+      /// skeleton are not affected.
+      /// \return True if meshes are optimized
+      public: bool OptimizeMeshes() const;
+
+      /// \brief Get whether material textures are streamed, set with the
+      /// "streamTextures" parameter of Load. When enabled, setting a
+      /// texture map does not wait for the image to be decoded and
+      /// uploaded; this happens on Ogre's texture streaming threads and the
+      /// material is drawn without the map until it is ready. Settings
+      /// that depend on the image format, such as disabling alpha from
+      /// texture for images without alpha, are applied on a later
+      /// PreRender once the image metadata is known.
+      /// \return True if material textures are streamed
+      public: bool StreamTextures() const;
+
+      /// \brief Get the directory of the texture cache, set with the
+      /// "textureCacheDir" parameter of Load. The first time an image file
+      /// is used as a material texture map, a worker thread converts it to
+      /// a GPU-ready copy with a full mipmap chain, stored there under a
+      /// hash of the file path, size and modification time; later loads
+      /// use that copy without decoding the image or generating mipmaps.
+      /// \return Texture cache directory, empty if the cache is disabled
+      public: std::string TextureCacheDir() const;
+
+      /// \brief Get whether identical mesh materials are shared, set with
+      /// the "shareMaterials" parameter of Load. Submeshes whose materials
+      /// have the same properties are then rendered with a single shared
+      /// Hlms datablock, which lets Ogre batch them and upload their
+      /// constants once, even though each submesh keeps its own cloned
+      /// Material. Changing a material through its setters moves its
+      /// submeshes to a datablock matching the new properties on the next
+      /// PreRender. Code modifying Ogre2Material::Datablock or the
+      /// datablock of a sub item directly must call Ogre2SubMesh::Unshare
+      /// first.
+      /// \return True if identical mesh materials are shared
+      public: bool ShareMaterials() const;
+
+      /// \brief Get residency statistics of the textures loaded from
+      /// files. When the "textureBudgetMB" parameter of Load is set, the
+      /// least recently drawn textures of Pbs materials are made
+      /// non-resident whenever they exceed the budget, and they are loaded
+      /// again from their file the next time they are drawn. Textures
+      /// drawn within the last few seconds and textures also used by other
+      /// Hlms types are kept. Textures created from memory and render
+      /// targets are not counted nor evicted.
+      /// \return Texture residency statistics
+      public: Ogre2TextureStats TextureStats() const;
+
+      /// \brief Get the directory of the shader cache, set with the
+      /// "shaderCacheDir" parameter of Load. When set, the shader variants
+      /// and pipeline states generated during a run, along with their
+      /// compiled microcode, are saved by SaveShaderCache and when the
+      /// engine is destroyed, and recreated when the next run initializes
+      /// the engine, so they are not generated and compiled again on first
+      /// draw. Entries are kept per engine version, GPU and driver, and
+      /// entries made with other shader templates are ignored.
+      /// \return Shader cache directory, empty if the cache is disabled
+      public: std::string ShaderCacheDir() const;
+
+      /// \brief Save the shader cache now, if enabled, e.g. after
+      /// Scene::WarmUp so what it built is kept even if the process does
+      /// not shut the engine down cleanly.
+      /// \sa ShaderCacheDir
+      public: void SaveShaderCache();
+
+      /// \brief Get the duration of each stage of the last startup, from
+      /// Load to the end of Init, in order. The stages are
+      /// "CreateContext", "CreateRoot", "LoadPlugins",
+      /// "CreateRenderSystem", "CreateRenderWindow", "CreateResources",
+      /// "InitResourceGroups" and, if ShaderCacheDir() is set,
+      /// "LoadShaderCache". They are also logged when the "profileStartup"
+      /// parameter of Load is set.
+      /// \return Name and duration in seconds of each startup stage
+      public: std::vector<std::pair<std::string, double>>
+          StartupProfile() const;
+
       /// \brief Create a scene
       /// \param[in] _id Unique scene Id
       /// \param[in] _name Name of scene
@@ -134,7 +266,26 @@ namespace gz
       /// \return list of scenes
       protected: virtual SceneStorePtr Scenes() const override;
 
-      // Documentation Inherited.
+      /// \brief Load the render engine. In addition to the generic
+      /// parameters, "meshCacheDir" sets the directory where the GPU-ready
+      /// data of meshes is cached between runs, see MeshCacheDir(),
+      /// "heightmapCacheDir" sets the directory where sampled heightmaps
+      /// are cached between runs, see HeightmapCacheDir(),
+      /// "compactMeshVertices" enables the compact vertex layout, see
+      /// CompactMeshVertices(), "optimizeMeshes" enables load time
+      /// reordering of mesh triangles and vertices, see OptimizeMeshes(),
+      /// "streamTextures" enables non-blocking loading of material
+      /// textures, see StreamTextures(), "textureCacheDir" sets the
+      /// directory where GPU-ready textures are cached between runs, see
+      /// TextureCacheDir(), "shareMaterials" enables sharing of
+      /// identical mesh materials, see ShareMaterials(),
+      /// "textureBudgetMB" sets the max memory of textures loaded from
+      /// files in MiB, see TextureStats(), "shaderCacheDir" sets the
+      /// directory where shaders and pipeline states are cached between
+      /// runs, see ShaderCacheDir(), and "profileStartup" logs the
+      /// duration of each startup stage, see StartupProfile().
+      /// \param[in] _params Parameters of the render engine
+      /// \return True if the render engine was loaded
       protected: virtual bool LoadImpl(
           const std::map<std::string, std::string> &_params) override;
 
@@ -145,6 +296,11 @@ namespace gz
       /// \brief Helper function to initialize the render engine
       private: void LoadAttempt();
 
+      /// \brief Record the duration of a startup stage, which started when
+      /// the previous one ended
+      /// \param[in] _name Name of the stage
+      private: void EndStartupStage(const std::string &_name);
+
       /// \brief Create the ogre logger for logging ogre messages to file
       private: void CreateLogger();
 
@@ -175,6 +331,9 @@ namespace gz
       /// \brief Attempt to initialize engine and catch exeption if they occur
       private: void InitAttempt();
 
+      /// \brief Enforce the texture budget. Called by scenes every frame.
+      private: void UpdateTextureBudget();
+
       /// \brief Get a list of all supported FSAA levels for this render system
       /// \return a list of FSAA levels
       public: std::vector<unsigned int> FSAALevels() const;
@@ -205,6 +364,12 @@ namespace gz
           return SetGzOgreRenderingMode(renderingMode);
         }
 
+      /// \internal
+      /// \brief Get the decoder of the images used by materials, which
+      /// decodes them on worker threads owned by the render engine
+      /// \return Pointer to the image decoder
+      public: Ogre2ImageDecoder *ImageDecoder() const;
+
       /// \internal
       /// \brief Get a pointer to the Pbs listener that adds terra shadows.
       /// Do NOT assume HlmsPbs::getListener() == HlmsPbsTerraShadows()
@@ -264,6 +429,9 @@ namespace gz
 
       /// \brief Singleton setup
       private: friend class common::SingletonT<Ogre2RenderEngine>;
+
+      /// \brief Scenes enforce the texture budget every frame
+      private: friend class Ogre2Scene;
     };
     }
   }
@@ -54,6 +54,7 @@ namespace gz
     class Ogre2Object;
     class Ogre2ObjectInterface;
     class Ogre2ParticleEmitter;
+    class Ogre2PointCloudVisual;
     class Ogre2Projector;
     class Ogre2PointLight;
     class Ogre2RayQuery;
@@ -107,6 +108,7 @@ namespace gz
     typedef shared_ptr<Ogre2Object>               Ogre2ObjectPtr;
     typedef shared_ptr<Ogre2ObjectInterface>      Ogre2ObjectInterfacePtr;
     typedef shared_ptr<Ogre2ParticleEmitter>      Ogre2ParticleEmitterPtr;
+    typedef shared_ptr<Ogre2PointCloudVisual>     Ogre2PointCloudVisualPtr;
     typedef shared_ptr<Ogre2Projector>            Ogre2ProjectorPtr;
     typedef shared_ptr<Ogre2PointLight>           Ogre2PointLightPtr;
     typedef shared_ptr<Ogre2RayQuery>             Ogre2RayQueryPtr;
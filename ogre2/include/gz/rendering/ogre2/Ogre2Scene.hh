@@ -17,6 +17,7 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2SCENE_HH_
 #define GZ_RENDERING_OGRE2_OGRE2SCENE_HH_
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -116,6 +117,21 @@ namespace gz
       // Documentation inherited
       public: virtual void PostRender() override;
 
+      /// \brief Create new mesh geometry asynchronously. The mesh data is
+      /// packed on a background thread and only its GPU buffers are created
+      /// on the render thread, during a later call to PreRender, so loading
+      /// large meshes does not stall rendering. The common::Mesh referenced
+      /// by the descriptor is loaded before this function returns and must
+      /// not be modified until the future is ready. Meshes still pending
+      /// when the scene is destroyed resolve to nullptr.
+      /// \param[in] _desc Descriptor of the mesh to load
+      /// \return Future holding the created mesh, or nullptr on failure.
+      /// The future becomes ready during PreRender so do not block on it
+      /// from the thread that calls PreRender.
+      /// \todo(anyone) Move to Scene in gz-rendering8
+      public: std::future<MeshPtr> CreateMeshAsync(
+                  const MeshDescriptor &_desc);
+
       /// \cond PRIVATE
       /// \brief Certain functions like Ogre2Camera::VisualAt would
       /// need to call PreRender and PostFrame, which is very unintuitive
@@ -345,6 +361,15 @@ namespace gz
       protected: virtual ParticleEmitterPtr CreateParticleEmitterImpl(
                      unsigned int _id, const std::string &_name) override;
 
+      /// \brief Implementation for creating a point cloud visual, see
+      /// Ogre2SceneExt::CreateExt
+      /// \param[in] _id Unique id.
+      /// \param[in] _name Name of the point cloud visual.
+      /// \return Pointer to the created point cloud visual.
+      /// \todo(anyone) make this virtual in gz-rendering8
+      protected: PointCloudVisualPtr CreatePointCloudImpl(
+                     unsigned int _id, const std::string &_name);
+
       // Documentation inherited
       // \todo(iche033) make this virtual in gz-rendering8
       protected: ProjectorPtr CreateProjectorImpl(
@@ -457,7 +482,9 @@ namespace gz
       private: friend class Ogre2SceneExt;
     };
 
-    /// \brief Ogre2 implementation of the scene extension API
+    /// \brief Ogre2 implementation of the scene extension API. Supported
+    /// types are "projector", which creates a Projector, and
+    /// "point_cloud", which creates a PointCloudVisual.
     class Ogre2SceneExt : public SceneExt
     {
       /// \brief Constructor
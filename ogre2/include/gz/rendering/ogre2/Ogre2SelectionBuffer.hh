@@ -19,12 +19,19 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include <gz/math/Pose3.hh>
+#include <gz/math/Vector2.hh>
+#include <gz/math/Vector3.hh>
 
 #include "gz/rendering/config.hh"
 #include "gz/rendering/ogre2/Export.hh"
 
 namespace Ogre
 {
+  class ColourValue;
+  class CompositorWorkspace;
   class Item;
   class RenderTarget;
   class SceneManager;
@@ -44,6 +51,9 @@ namespace gz
     /// color is assigned to each entity. Whenever a selection request is made,
     /// the selection buffer camera renders to a 1x1 sized offscreen buffer.
     /// The color value of that pixel gives the identity of the entity.
+    /// Region queries render a whole rectangle of the view once and read it
+    /// back asynchronously so many pixels can be looked up for the cost of
+    /// a single render.
     class GZ_RENDERING_OGRE2_VISIBLE Ogre2SelectionBuffer
     {
       /// \brief Constructor
@@ -75,6 +85,51 @@ namespace gz
       public: bool ExecuteQuery(const int _x, const int _y, Ogre::Item *&_item,
           math::Vector3d &_point);
 
+      /// \brief Perform selection operation for many pixels at once. The
+      /// bounding rectangle of all pixels is rendered once and read back.
+      /// \param[in] _pixels Pixel coordinates to query.
+      /// \param[out] _items Ogre item at each coordinate, nullptr if none.
+      /// \param[out] _points 3D point of intersection at each coordinate.
+      /// \return Number of pixels for which an item was found.
+      public: unsigned int ExecuteQuery(
+          const std::vector<math::Vector2i> &_pixels,
+          std::vector<Ogre::Item *> &_items,
+          std::vector<math::Vector3d> &_points);
+
+      /// \brief Render a rectangular region of the selection buffer and
+      /// start reading it back without waiting for the GPU. Use
+      /// RegionReady to poll for completion and RegionQuery or RegionItems
+      /// to access the results. Requesting a new region discards the
+      /// results of the previous one.
+      /// \param[in] _min Top left pixel of the region, inclusive.
+      /// \param[in] _max Bottom right pixel of the region, inclusive.
+      /// \return True if the request was issued.
+      public: bool RequestRegion(const math::Vector2i &_min,
+          const math::Vector2i &_max);
+
+      /// \brief Check whether the region requested with RequestRegion has
+      /// been read back from the GPU. This does not block.
+      /// \return True if results of the last request are available.
+      public: bool RegionReady();
+
+      /// \brief Get the ogre item and point of intersection at a pixel of
+      /// the last requested region. Blocks until the region is read back.
+      /// \param[in] _x X coordinate in pixels.
+      /// \param[in] _y Y coordinate in pixels.
+      /// \param[out] _item Ogre item at the coordinate.
+      /// \param[out] _point 3D point of intersection with the ogre item's
+      /// mesh.
+      /// \return True if an ogre item is found, false otherwise or if the
+      /// pixel is outside the last requested region.
+      public: bool RegionQuery(const int _x, const int _y, Ogre::Item *&_item,
+          math::Vector3d &_point);
+
+      /// \brief Get all unique ogre items visible in the last requested
+      /// region, e.g. for box selection. Blocks until the region is read
+      /// back.
+      /// \return Ogre items in the region.
+      public: std::vector<Ogre::Item *> RegionItems();
+
       /// \brief Set dimension of the selection buffer
       /// \param[in] _width X dimension in pixels.
       /// \param[in] _height Y dimension in pixels.
@@ -89,6 +144,44 @@ namespace gz
       /// \brief Create the render texture
       private: void CreateRTTBuffer();
 
+      /// \brief Create or resize the texture, workspace and readback ticket
+      /// used by region queries
+      /// \param[in] _width Required region width in pixels.
+      /// \param[in] _height Required region height in pixels.
+      private: void CreateRegionBuffer(unsigned int _width,
+          unsigned int _height);
+
+      /// \brief Delete the resources used by region queries
+      private: void DeleteRegionBuffer();
+
+      /// \brief Point the selection camera at a rectangle of the reference
+      /// camera's view
+      /// \param[in] _x X coordinate of the top left pixel.
+      /// \param[in] _y Y coordinate of the top left pixel.
+      /// \param[in] _width Width of the rectangle in pixels.
+      /// \param[in] _height Height of the rectangle in pixels.
+      /// \return False if the reference camera has an invalid projection.
+      private: bool SetupSelectionCamera(int _x, int _y, unsigned int _width,
+          unsigned int _height);
+
+      /// \brief Render a compositor workspace of the selection buffer
+      /// \param[in] _workspace Workspace to render.
+      private: void Render(Ogre::CompositorWorkspace *_workspace);
+
+      /// \brief Wait for the pending region readback and copy the results
+      private: void FinishRegionReadback();
+
+      /// \brief Decode a selection buffer pixel
+      /// \param[in] _pixel Pixel value.
+      /// \param[in] _cameraPose World pose of the reference camera at the
+      /// time the pixel was rendered.
+      /// \param[out] _item Ogre item encoded in the pixel.
+      /// \param[out] _point 3D point of intersection in world frame.
+      /// \return True if the pixel maps to an item or heightmap.
+      private: bool DecodePixel(const Ogre::ColourValue &_pixel,
+          const math::Pose3d &_cameraPose, Ogre::Item *&_item,
+          math::Vector3d &_point) const;
+
       /// \brief Create the selection buffer offscreen render texture.
       // private: void CreateRTTOverlays();
 
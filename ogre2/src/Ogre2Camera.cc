@@ -15,6 +15,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "gz/rendering/ogre2/Ogre2Camera.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2RenderTarget.hh"
@@ -281,42 +283,33 @@ Ogre2SelectionBuffer *Ogre2Camera::SelectionBuffer() const
 }
 
 //////////////////////////////////////////////////
-VisualPtr Ogre2Camera::VisualAt(const math::Vector2i &_mousePos)
+bool Ogre2Camera::PrepareSelectionBuffer()
 {
-  VisualPtr result;
-
   if (!this->selectionBuffer)
   {
     this->SetSelectionBuffer();
-
-    if (!this->selectionBuffer)
-    {
-      return result;
-    }
-  }
-  else
-  {
-    this->selectionBuffer->SetDimensions(
-      this->ImageWidth(), this->ImageHeight());
+    return this->selectionBuffer != nullptr;
   }
 
-  float ratio = screenScalingFactor();
-  math::Vector2i mousePos(
-      static_cast<int>(std::rint(ratio * _mousePos.X())),
-      static_cast<int>(std::rint(ratio * _mousePos.Y())));
-  Ogre::Item *ogreItem = this->selectionBuffer->OnSelectionClick(
-      mousePos.X(), mousePos.Y());
+  this->selectionBuffer->SetDimensions(
+    this->ImageWidth(), this->ImageHeight());
+  return true;
+}
 
-  if (ogreItem)
+//////////////////////////////////////////////////
+VisualPtr Ogre2Camera::VisualFromItem(Ogre::Item *_item) const
+{
+  VisualPtr result;
+  if (_item)
   {
-    if (!ogreItem->getUserObjectBindings().getUserAny().isEmpty() &&
-        ogreItem->getUserObjectBindings().getUserAny().getType() ==
+    if (!_item->getUserObjectBindings().getUserAny().isEmpty() &&
+        _item->getUserObjectBindings().getUserAny().getType() ==
         typeid(unsigned int))
     {
       try
       {
         result = this->scene->VisualById(Ogre::any_cast<unsigned int>(
-              ogreItem->getUserObjectBindings().getUserAny()));
+              _item->getUserObjectBindings().getUserAny()));
       }
       catch(Ogre::Exception &e)
       {
@@ -324,7 +317,100 @@ VisualPtr Ogre2Camera::VisualAt(const math::Vector2i &_mousePos)
       }
     }
   }
+  return result;
+}
+
+//////////////////////////////////////////////////
+VisualPtr Ogre2Camera::VisualAt(const math::Vector2i &_mousePos)
+{
+  if (!this->PrepareSelectionBuffer())
+    return VisualPtr();
+
+  float ratio = screenScalingFactor();
+  math::Vector2i mousePos(
+      static_cast<int>(std::rint(ratio * _mousePos.X())),
+      static_cast<int>(std::rint(ratio * _mousePos.Y())));
+  Ogre::Item *ogreItem = this->selectionBuffer->OnSelectionClick(
+      mousePos.X(), mousePos.Y());
+
+  return this->VisualFromItem(ogreItem);
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> Ogre2Camera::VisualsAt(
+    const std::vector<math::Vector2i> &_mousePos)
+{
+  std::vector<VisualPtr> result(_mousePos.size());
+  if (_mousePos.empty() || !this->PrepareSelectionBuffer())
+    return result;
+
+  float ratio = screenScalingFactor();
+  std::vector<math::Vector2i> pixels;
+  pixels.reserve(_mousePos.size());
+  for (const auto &pos : _mousePos)
+  {
+    pixels.emplace_back(
+        static_cast<int>(std::rint(ratio * pos.X())),
+        static_cast<int>(std::rint(ratio * pos.Y())));
+  }
+
+  std::vector<Ogre::Item *> items;
+  std::vector<math::Vector3d> points;
+  this->selectionBuffer->ExecuteQuery(pixels, items, points);
+  for (unsigned int i = 0; i < items.size(); ++i)
+    result[i] = this->VisualFromItem(items[i]);
+
+  return result;
+}
+
+//////////////////////////////////////////////////
+std::vector<VisualPtr> Ogre2Camera::VisualsAt(const math::Vector2i &_min,
+    const math::Vector2i &_max)
+{
+  if (!this->RequestRegionVisuals(_min, _max))
+    return std::vector<VisualPtr>();
+  return this->RegionVisuals();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::RequestRegionVisuals(const math::Vector2i &_min,
+    const math::Vector2i &_max)
+{
+  if (!this->PrepareSelectionBuffer())
+    return false;
+
+  float ratio = screenScalingFactor();
+  math::Vector2i minPos(
+      static_cast<int>(std::rint(ratio * _min.X())),
+      static_cast<int>(std::rint(ratio * _min.Y())));
+  math::Vector2i maxPos(
+      static_cast<int>(std::rint(ratio * _max.X())),
+      static_cast<int>(std::rint(ratio * _max.Y())));
+  return this->selectionBuffer->RequestRegion(minPos, maxPos);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2Camera::RegionVisualsReady()
+{
+  return this->selectionBuffer && this->selectionBuffer->RegionReady();
+}
 
+//////////////////////////////////////////////////
+std::vector<VisualPtr> Ogre2Camera::RegionVisuals()
+{
+  std::vector<VisualPtr> result;
+  if (!this->selectionBuffer)
+    return result;
+
+  for (Ogre::Item *item : this->selectionBuffer->RegionItems())
+  {
+    VisualPtr visual = this->VisualFromItem(item);
+    if (visual &&
+        std::find(result.begin(), result.end(), visual) == result.end())
+    {
+      result.push_back(visual);
+    }
+  }
   return result;
 }
 
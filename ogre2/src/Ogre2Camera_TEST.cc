@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+#include "gz/rendering/ogre2/Ogre2Camera.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of the visual queries of Ogre2Camera
+class Ogre2CameraTest : public Ogre2RenderingTest
+{
+  /// \brief Get the names of visuals
+  /// \param[in] _visuals Visuals
+  /// \return Names of the visuals, empty for null visuals
+  protected: static std::multiset<std::string> Names(
+      const std::vector<VisualPtr> &_visuals)
+  {
+    std::multiset<std::string> names;
+    for (const auto &visual : _visuals)
+      names.insert(visual ? visual->Name() : std::string());
+    return names;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2CameraTest, VisualsAt)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  VisualPtr box = scene->CreateVisual("box");
+  box->AddGeometry(scene->CreateBox());
+  box->SetOrigin(0.0, 0.5, 0.0);
+  box->SetLocalPosition(3, 0, 0);
+  box->SetLocalRotation(GZ_PI / 4, 0, GZ_PI / 3);
+  box->SetLocalScale(1, 2.5, 1);
+  root->AddChild(box);
+
+  VisualPtr sphere = scene->CreateVisual("sphere");
+  sphere->AddGeometry(scene->CreateSphere());
+  sphere->SetOrigin(0.0, -0.5, 0.0);
+  sphere->SetLocalPosition(3, 0, 0);
+  sphere->SetLocalScale(1, 2.5, 1);
+  root->AddChild(sphere);
+
+  auto camera = std::dynamic_pointer_cast<Ogre2Camera>(
+      scene->CreateCamera("camera"));
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(800);
+  camera->SetImageHeight(600);
+  camera->SetAntiAliasing(2);
+  camera->SetAspectRatio(1.333);
+  camera->SetHFOV(GZ_PI / 2);
+  root->AddChild(camera);
+  camera->Update();
+
+  const math::Vector2i spherePos(220, 307);
+  const math::Vector2i boxPos(452, 338);
+  const math::Vector2i emptyPos(300, 150);
+
+  // many positions are resolved at once, in order
+  std::vector<VisualPtr> visuals =
+      camera->VisualsAt({spherePos, boxPos, emptyPos, boxPos});
+  ASSERT_EQ(4u, visuals.size());
+  ASSERT_NE(nullptr, visuals[0]);
+  EXPECT_EQ("sphere", visuals[0]->Name());
+  ASSERT_NE(nullptr, visuals[1]);
+  EXPECT_EQ("box", visuals[1]->Name());
+  EXPECT_EQ(nullptr, visuals[2]);
+  EXPECT_EQ(visuals[1], visuals[3]);
+  EXPECT_TRUE(camera->VisualsAt(std::vector<math::Vector2i>()).empty());
+
+  // visuals in a region are unique
+  EXPECT_EQ(std::multiset<std::string>({"box", "sphere"}),
+      Names(camera->VisualsAt(math::Vector2i(0, 0),
+          math::Vector2i(799, 599))));
+  EXPECT_EQ(std::multiset<std::string>({"sphere"}),
+      Names(camera->VisualsAt(spherePos - math::Vector2i(2, 2),
+          spherePos + math::Vector2i(2, 2))));
+  EXPECT_TRUE(camera->VisualsAt(math::Vector2i(0, 0),
+      math::Vector2i(20, 20)).empty());
+
+  // regions outside of the image are rejected
+  EXPECT_FALSE(camera->RequestRegionVisuals(math::Vector2i(900, 700),
+      math::Vector2i(1000, 800)));
+
+  // region requests do not wait for the GPU, poll until they are read back
+  ASSERT_TRUE(camera->RequestRegionVisuals(math::Vector2i(0, 0),
+      math::Vector2i(799, 599)));
+  for (unsigned int i = 0u; i < 100u && !camera->RegionVisualsReady(); ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_TRUE(camera->RegionVisualsReady());
+  EXPECT_EQ(std::multiset<std::string>({"box", "sphere"}),
+      Names(camera->RegionVisuals()));
+
+  // other queries of many visuals replace the pending request
+  ASSERT_TRUE(camera->RequestRegionVisuals(math::Vector2i(0, 0),
+      math::Vector2i(799, 599)));
+  EXPECT_EQ(std::multiset<std::string>({"sphere"}),
+      Names(camera->VisualsAt({spherePos})));
+  EXPECT_EQ(std::multiset<std::string>({"sphere"}),
+      Names(camera->RegionVisuals()));
+
+  engine->DestroyScene(scene);
+}
@@ -995,7 +995,54 @@ void Ogre2DepthCamera::Render()
 void Ogre2DepthCamera::PreRender()
 {
   if (!this->dataPtr->ogreDepthTexture[0])
+  {
     this->CreateDepthTexture();
+  }
+  else if (this->dataPtr->ogreDepthTexture[0]->getWidth() !=
+      this->ImageWidth() ||
+      this->dataPtr->ogreDepthTexture[0]->getHeight() != this->ImageHeight())
+  {
+    // the image size changed, resize the textures in place so the materials
+    // and compositor definitions can be reused and the workspace instance is
+    // recreated below
+    auto ogreRoot = Ogre2RenderEngine::Instance()->OgreRoot();
+    if (this->dataPtr->ogreCompositorWorkspace)
+    {
+      ogreRoot->getCompositorManager2()->removeWorkspace(
+          this->dataPtr->ogreCompositorWorkspace);
+      this->dataPtr->ogreCompositorWorkspace = nullptr;
+    }
+    if (this->dataPtr->particleNoiseListener)
+    {
+      this->ogreCamera->removeListener(
+          this->dataPtr->particleNoiseListener.get());
+      this->dataPtr->particleNoiseListener.reset();
+    }
+
+    for (size_t i = 0u; i < 2u; ++i)
+    {
+      this->dataPtr->ogreDepthTexture[i]->scheduleTransitionTo(
+          Ogre::GpuResidency::OnStorage);
+      this->dataPtr->ogreDepthTexture[i]->setResolution(
+          this->ImageWidth(), this->ImageHeight());
+      this->dataPtr->ogreDepthTexture[i]->scheduleTransitionTo(
+          Ogre::GpuResidency::Resident);
+    }
+
+    // the buffers are allocated at the new size on the next PostRender
+    delete [] this->dataPtr->depthBuffer;
+    this->dataPtr->depthBuffer = nullptr;
+    delete [] this->dataPtr->depthImage;
+    this->dataPtr->depthImage = nullptr;
+    delete [] this->dataPtr->pointCloudImage;
+    this->dataPtr->pointCloudImage = nullptr;
+
+    const double aspectRatio = this->AspectRatio();
+    const double vfov = this->LimitFOV(
+        2.0 * atan(tan(this->HFOV().Radian() / 2.0) / aspectRatio));
+    this->ogreCamera->setFOVy(Ogre::Radian((Ogre::Real)vfov));
+    this->ogreCamera->setAspectRatio((Ogre::Real)aspectRatio);
+  }
 
   if (!this->dataPtr->ogreCompositorWorkspace)
     this->CreateWorkspaceInstance();
@@ -1267,3 +1314,9 @@ Ogre::Camera *Ogre2DepthCamera::OgreCamera() const
 {
   return this->ogreCamera;
 }
+
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2DepthCamera::OutputTexture() const
+{
+  return this->dataPtr->ogreDepthTexture[1];
+}
@@ -15,6 +15,10 @@
  *
 */
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 // Note this include is placed in the src file because
 // otherwise ogre produces compile errors
 #if defined(_MSC_VER)
@@ -46,21 +50,116 @@
   #pragma warning(pop)
 #endif
 
+namespace
+{
+  /// \brief Max number of disjoint dirty ranges tracked between two
+  /// updates. More ranges than this fall back to a full upload.
+  const std::size_t kMaxDirtyRanges = 32u;
+}
+
 /// \brief Private implementation
 class gz::rendering::Ogre2DynamicRenderablePrivate
 {
-  /// \brief list of colors at each point
-  public: std::vector<gz::math::Color> colors;
+  /// \brief Map a point index to its storage slot. The two only differ
+  /// when the point list is used as a ring buffer.
+  /// \param[in] _index Point index, 0 being the oldest point
+  /// \return Storage slot of the point
+  public: unsigned int Slot(unsigned int _index) const
+  {
+    if (this->maxPointCount == 0u)
+      return _index;
+    return (this->ringStart + _index) % this->maxPointCount;
+  }
+
+  /// \brief Mark the storage slots [_start, _end) as needing an upload
+  /// \param[in] _start First dirty slot
+  /// \param[in] _end One past the last dirty slot
+  public: void MarkDirty(unsigned int _start, unsigned int _end)
+  {
+    this->dirty = true;
+    if (this->fullUpdate)
+      return;
 
-  /// \brief List of vertices for the mesh
-  public: std::vector<gz::math::Vector3d> vertices;
+    if (!this->dirtyRanges.empty())
+    {
+      auto &last = this->dirtyRanges.back();
+      if (_start <= last.second && _end >= last.first)
+      {
+        last.first = std::min(last.first, _start);
+        last.second = std::max(last.second, _end);
+        return;
+      }
+    }
+
+    if (this->dirtyRanges.size() >= kMaxDirtyRanges)
+    {
+      this->MarkAllDirty();
+      return;
+    }
+    this->dirtyRanges.emplace_back(_start, _end);
+  }
+
+  /// \brief Mark the whole buffer as needing an upload
+  public: void MarkAllDirty()
+  {
+    this->dirty = true;
+    this->fullUpdate = true;
+    this->dirtyRanges.clear();
+  }
+
+  /// \brief Reorder the ring buffer storage so slot and point index match
+  public: void Linearize()
+  {
+    if (this->ringStart == 0u)
+      return;
+
+    std::rotate(this->vertices.begin(),
+        this->vertices.begin() + this->ringStart * 3u, this->vertices.end());
+    std::rotate(this->colors.begin(),
+        this->colors.begin() + this->ringStart * 4u, this->colors.end());
+    this->ringStart = 0u;
+  }
+
+  /// \brief Packed rgba colors of each point, 4 floats per point
+  public: std::vector<float> colors;
+
+  /// \brief Packed xyz positions of the vertices, 3 floats per vertex.
+  /// Stored in single precision, the format used by the vertex buffer, so
+  /// updates do not need any per-vertex conversion.
+  public: std::vector<float> vertices;
 
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
 
+  /// \brief True if the whole vertex buffer needs to be uploaded on the
+  /// next update, false if only dirtyRanges need to be
+  public: bool fullUpdate = true;
+
+  /// \brief Storage slot ranges [first, second) modified since the last
+  /// update
+  public: std::vector<std::pair<unsigned int, unsigned int>> dirtyRanges;
+
+  /// \brief Max number of points kept when used as a ring buffer, 0 if
+  /// the point list is unbounded
+  public: unsigned int maxPointCount = 0u;
+
+  /// \brief Storage slot of the oldest point when used as a ring buffer
+  public: unsigned int ringStart = 0u;
+
+  /// \brief Bounds of the points uploaded so far. Partial updates only
+  /// grow the bounds; they are recomputed once enough points changed.
+  public: Ogre::Aabb bounds;
+
+  /// \brief Number of points merged into the bounds since they were last
+  /// recomputed from scratch
+  public: std::size_t boundsAge = 0u;
+
   /// \brief Render operation type
   public: Ogre::OperationType operationType;
 
+  /// \brief Render operation type the current vao was created with
+  public: Ogre::OperationType vaoOperationType;
+
   /// \brief Ogre submesh
   public: Ogre::SubMesh *subMesh = nullptr;
 
@@ -73,7 +172,8 @@ class gz::rendering::Ogre2DynamicRenderablePrivate
   /// \brief Ogre item created from the dynamic geometry
   public: Ogre::Item *ogreItem = nullptr;
 
-  /// \brief raw vertex buffer
+  /// \brief CPU copy of the vertex buffer. Dirty ranges are written here
+  /// and then uploaded.
   public: float *vbuffer = nullptr;
 
   /// \brief Maximum capacity of the currently allocated vertex buffer.
@@ -226,8 +326,15 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   // Prepare vertex buffer
   unsigned int newVertCapacity = this->dataPtr->vertexBufferCapacity;
 
-  unsigned int vertexCount = this->dataPtr->vertices.size();
-  if ((vertexCount > this->dataPtr->vertexBufferCapacity) ||
+  unsigned int vertexCount = this->PointCount();
+  unsigned int ringCapacity = this->dataPtr->maxPointCount;
+  if (ringCapacity > 0u)
+  {
+    // Every point is stored twice, at slot and slot + ringCapacity, so the
+    // newest ringCapacity points are always contiguous in the buffer
+    newVertCapacity = ringCapacity * 2u;
+  }
+  else if ((vertexCount > this->dataPtr->vertexBufferCapacity) ||
       (!this->dataPtr->vertexBufferCapacity))
   {
     // vertexCount exceeds current capacity!
@@ -253,7 +360,10 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   }
 
   // recreate vao if needed
-  if (newVertCapacity != this->dataPtr->vertexBufferCapacity)
+  bool vaoRecreated = false;
+  if (newVertCapacity != this->dataPtr->vertexBufferCapacity ||
+      !this->dataPtr->vao ||
+      this->dataPtr->vaoOperationType != this->dataPtr->operationType)
   {
     this->dataPtr->vertexBufferCapacity = newVertCapacity;
 
@@ -273,10 +383,12 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     vertexElements.push_back(
         Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_NORMAL));
 
-    // create vertex buffer
+    // create vertex buffer. BT_DEFAULT buffers support partial uploads,
+    // persistent mapped ones would need the whole buffer rewritten every
+    // frame as they are multi-buffered by the vao manager.
     this->dataPtr->vertexBuffer = vaoManager->createVertexBuffer(
         vertexElements, this->dataPtr->vertexBufferCapacity,
-        Ogre::BT_DYNAMIC_PERSISTENT, this->dataPtr->vbuffer, false);
+        Ogre::BT_DEFAULT, this->dataPtr->vbuffer, false);
 
     Ogre::VertexBufferPackedVec vertexBuffers;
     vertexBuffers.push_back(this->dataPtr->vertexBuffer);
@@ -286,66 +398,99 @@ void Ogre2DynamicRenderable::UpdateBuffer()
 
     this->dataPtr->vao = vaoManager->createVertexArrayObject(vertexBuffers,
         indexBuffer, this->dataPtr->operationType);
+    this->dataPtr->vaoOperationType = this->dataPtr->operationType;
 
     this->dataPtr->subMesh->mVao[Ogre::VpNormal].push_back(this->dataPtr->vao);
     // Use the same geometry for shadow casting.
     this->dataPtr->subMesh->mVao[Ogre::VpShadow].push_back(this->dataPtr->vao);
+
+    this->dataPtr->MarkAllDirty();
+    vaoRecreated = true;
   }
 
-  // map buffer and update the geometry
-  Ogre::Aabb bbox;
-  float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
-      this->dataPtr->vertexBuffer->map(
-      0, this->dataPtr->vertexBuffer->getNumElements()));
+  const float *positions = this->dataPtr->vertices.data();
+  float *vbuffer = this->dataPtr->vbuffer;
+  Ogre::OperationType opType = this->dataPtr->operationType;
 
-  // fill vertices
-  for (unsigned int i = 0; i < vertexCount; ++i)
+  std::vector<std::pair<unsigned int, unsigned int>> ranges;
+  if (this->dataPtr->fullUpdate)
   {
-    unsigned int idx = i*6;
-    Ogre::Vector3 v = Ogre2Conversions::Convert(this->dataPtr->vertices[i]);
-    vertices[idx] = v.x;
-    vertices[idx+1] = v.y;
-    vertices[idx+2] = v.z;
-
-    bbox.merge(v);
+    ranges.emplace_back(0u, vertexCount);
+    this->dataPtr->bounds = Ogre::Aabb();
+    this->dataPtr->boundsAge = 0u;
+  }
+  else
+  {
+    ranges.swap(this->dataPtr->dirtyRanges);
   }
 
-  // fill the rest of the buffer with the position of the last vertex to avoid
-  // the geometry connecting back to 0, 0, 0
-  if (vertexCount > 0 && vertexCount < this->dataPtr->vertexBufferCapacity)
+  for (const auto &range : ranges)
   {
-    math::Vector3d lastVertex = this->dataPtr->vertices[vertexCount-1];
-    for (unsigned int i = vertexCount; i < this->dataPtr->vertexBufferCapacity;
-        ++i)
+    unsigned int start = std::min(range.first, vertexCount);
+    unsigned int end = std::min(range.second, vertexCount);
+    if (start >= end)
+      continue;
+
+    // fill vertices, and colors for points
+    for (unsigned int i = start; i < end; ++i)
+    {
+      unsigned int idx = i*6;
+      vbuffer[idx] = positions[i*3];
+      vbuffer[idx+1] = positions[i*3+1];
+      vbuffer[idx+2] = positions[i*3+2];
+
+      this->dataPtr->bounds.merge(Ogre::Vector3(positions + i*3));
+    }
+    this->dataPtr->boundsAge += end - start;
+    this->GenerateColors(opType, start, end, vbuffer);
+
+    // fill normals. A moved vertex also changes the normals of the
+    // vertices sharing a triangle with it.
+    unsigned int normalStart = start;
+    unsigned int normalEnd = end;
+    this->GenerateNormals(opType, positions, vertexCount, normalStart,
+        normalEnd, vbuffer);
+
+    this->dataPtr->vertexBuffer->upload(vbuffer + normalStart * 6,
+        normalStart, normalEnd - normalStart);
+
+    if (ringCapacity > 0u)
     {
-      unsigned int idx = i * 6;
-      vertices[idx] = lastVertex.X();
-      vertices[idx+1] = lastVertex.Y();
-      vertices[idx+2] = lastVertex.Z();
-
-      vertices[idx+3] = 0;
-      vertices[idx+4] = 0;
-      vertices[idx+5] = 1;
+      // keep the mirrored copy in the second half of the buffer in sync
+      memcpy(vbuffer + (normalStart + ringCapacity) * 6,
+          vbuffer + normalStart * 6,
+          (normalEnd - normalStart) * 6 * sizeof(float));
+      this->dataPtr->vertexBuffer->upload(
+          vbuffer + (normalStart + ringCapacity) * 6,
+          normalStart + ringCapacity, normalEnd - normalStart);
     }
   }
 
-  // fill normals
-  this->GenerateNormals(this->dataPtr->operationType, this->dataPtr->vertices,
-      vertices);
-
-  // fill colors for points
-  this->GenerateColors(this->dataPtr->operationType, this->dataPtr->vertices,
-      vertices);
+  // Partial updates only grow the bounds. Recompute them once as many
+  // points as the buffer holds have changed so the cost stays O(1) per
+  // changed point.
+  if (this->dataPtr->boundsAge > vertexCount)
+  {
+    this->dataPtr->bounds = Ogre::Aabb();
+    for (unsigned int i = 0; i < vertexCount; ++i)
+      this->dataPtr->bounds.merge(Ogre::Vector3(positions + i*3));
+    this->dataPtr->boundsAge = 0u;
+  }
 
-  // unmap buffer
-  this->dataPtr->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+  // only draw the points in use; the rest of the buffer is left untouched
+  this->dataPtr->vao->setPrimitiveRange(
+      ringCapacity > 0u ? this->dataPtr->ringStart : 0u, vertexCount);
 
   // Set the bounds to get frustum culling and LOD to work correctly.
   Ogre::Mesh *mesh = this->dataPtr->subMesh->mParent;
-  mesh->_setBounds(bbox, true);
+  mesh->_setBounds(this->dataPtr->bounds, true);
 
   // update item aabb
-  if (this->dataPtr->ogreItem)
+  if (this->dataPtr->ogreItem && !vaoRecreated)
+  {
+    this->dataPtr->ogreItem->setLocalAabb(mesh->getAabb());
+  }
+  else if (this->dataPtr->ogreItem)
   {
     bool castShadows = this->dataPtr->ogreItem->getCastShadows();
     auto lowLevelMat = this->dataPtr->ogreItem->getSubItem(0)->getMaterial();
@@ -373,6 +518,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     }
   }
 
+  this->dataPtr->fullUpdate = false;
   this->dataPtr->dirty = false;
 }
 
@@ -409,6 +555,19 @@ void Ogre2DynamicRenderable::SetOperationType(MarkerType _opType)
       gzerr << "Unknown render operation type[" << _opType << "]\n";
       return;
   }
+
+  if (this->dataPtr->maxPointCount > 0u &&
+      this->dataPtr->operationType != Ogre::OperationType::OT_POINT_LIST &&
+      this->dataPtr->operationType != Ogre::OperationType::OT_LINE_STRIP)
+  {
+    gzwarn << "Max point count is only supported for points and line "
+           << "strips, the point list is no longer bounded\n";
+    this->dataPtr->Linearize();
+    this->dataPtr->maxPointCount = 0u;
+  }
+
+  // normals and colors depend on the operation type
+  this->dataPtr->MarkAllDirty();
 }
 
 //////////////////////////////////////////////////
@@ -450,15 +609,33 @@ MarkerType Ogre2DynamicRenderable::OperationType() const
 void Ogre2DynamicRenderable::AddPoint(const math::Vector3d &_pt,
                                       const math::Color &_color)
 {
-  this->dataPtr->vertices.push_back(_pt);
-
   // todo(anyone)
   // setting material works but vertex coloring only works for points
   // It requires using an unlit datablock:
   // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
-  this->dataPtr->colors.push_back(_color);
+  const float pt[3] = {static_cast<float>(_pt.X()),
+      static_cast<float>(_pt.Y()), static_cast<float>(_pt.Z())};
+  const float color[4] = {_color.R(), _color.G(), _color.B(), _color.A()};
 
-  this->dataPtr->dirty = true;
+  unsigned int slot = this->PointCount();
+  if (this->dataPtr->maxPointCount > 0u &&
+      slot >= this->dataPtr->maxPointCount)
+  {
+    // ring buffer is full, overwrite the oldest point
+    slot = this->dataPtr->ringStart;
+    this->dataPtr->ringStart =
+        (this->dataPtr->ringStart + 1u) % this->dataPtr->maxPointCount;
+    std::copy(pt, pt + 3, this->dataPtr->vertices.begin() + slot * 3u);
+    std::copy(color, color + 4, this->dataPtr->colors.begin() + slot * 4u);
+  }
+  else
+  {
+    this->dataPtr->vertices.insert(this->dataPtr->vertices.end(), pt, pt + 3);
+    this->dataPtr->colors.insert(this->dataPtr->colors.end(), color,
+        color + 4);
+  }
+
+  this->dataPtr->MarkDirty(slot, slot + 1u);
 }
 
 /////////////////////////////////////////////////
@@ -468,30 +645,99 @@ void Ogre2DynamicRenderable::AddPoint(double _x, double _y, double _z,
   this->AddPoint(math::Vector3d(_x, _y, _z), _color);
 }
 
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetPoints(const float *_xyz, const float *_rgba,
+                                       std::size_t _count)
+{
+  // only keep the newest points if the point list is bounded
+  std::size_t first = 0u;
+  if (this->dataPtr->maxPointCount > 0u &&
+      _count > this->dataPtr->maxPointCount)
+  {
+    first = _count - this->dataPtr->maxPointCount;
+  }
+
+  this->dataPtr->vertices.assign(_xyz + first * 3u, _xyz + _count * 3u);
+  if (_rgba)
+  {
+    this->dataPtr->colors.assign(_rgba + first * 4u, _rgba + _count * 4u);
+  }
+  else
+  {
+    this->dataPtr->colors.assign((_count - first) * 4u, 1.0f);
+  }
+
+  this->dataPtr->ringStart = 0u;
+  this->dataPtr->MarkAllDirty();
+}
+
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetPoints(std::vector<float> &&_xyz,
+                                       std::vector<float> &&_rgba)
+{
+  std::size_t count = _xyz.size() / 3u;
+  if (_xyz.size() != count * 3u ||
+      (!_rgba.empty() && _rgba.size() != count * 4u))
+  {
+    gzerr << "Point buffer sizes [" << _xyz.size() << ", " << _rgba.size()
+           << "] do not hold 3 position and 4 color components per point\n";
+    return;
+  }
+
+  std::size_t first = 0u;
+  if (this->dataPtr->maxPointCount > 0u &&
+      count > this->dataPtr->maxPointCount)
+  {
+    first = count - this->dataPtr->maxPointCount;
+  }
+
+  this->dataPtr->vertices = std::move(_xyz);
+  this->dataPtr->vertices.erase(this->dataPtr->vertices.begin(),
+      this->dataPtr->vertices.begin() + first * 3u);
+  if (_rgba.empty())
+  {
+    this->dataPtr->colors.assign((count - first) * 4u, 1.0f);
+  }
+  else
+  {
+    this->dataPtr->colors = std::move(_rgba);
+    this->dataPtr->colors.erase(this->dataPtr->colors.begin(),
+        this->dataPtr->colors.begin() + first * 4u);
+  }
+
+  this->dataPtr->ringStart = 0u;
+  this->dataPtr->MarkAllDirty();
+}
+
 /////////////////////////////////////////////////
 void Ogre2DynamicRenderable::SetPoint(unsigned int _index,
                                       const math::Vector3d &_value)
 {
-  if (_index >= this->dataPtr->vertices.size())
+  if (_index >= this->PointCount())
   {
     gzerr << "Point index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->vertices.size()-1 << "]\n";
+           << static_cast<int>(this->PointCount()) - 1 << "]\n";
     return;
   }
 
-  this->dataPtr->vertices[_index] = _value;
+  unsigned int slot = this->dataPtr->Slot(_index);
+  float *v = this->dataPtr->vertices.data() + slot * 3u;
+  v[0] = static_cast<float>(_value.X());
+  v[1] = static_cast<float>(_value.Y());
+  v[2] = static_cast<float>(_value.Z());
 
-  this->dataPtr->dirty = true;
+  this->dataPtr->MarkDirty(slot, slot + 1u);
 }
 
 /////////////////////////////////////////////////
 void Ogre2DynamicRenderable::SetColor(unsigned int _index,
                                       const math::Color &_color)
 {
-  if (_index >= this->dataPtr->colors.size())
+  if (_index >= this->dataPtr->colors.size() / 4u)
   {
     gzerr << "Point color index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->colors.size()-1 << "]\n";
+           << static_cast<int>(this->dataPtr->colors.size() / 4u) - 1
+           << "]\n";
     return;
   }
 
@@ -500,32 +746,76 @@ void Ogre2DynamicRenderable::SetColor(unsigned int _index,
   // vertex coloring only works for points.
   // Full implementation requires using an unlit datablock:
   // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
-  this->dataPtr->colors[_index] = _color;
-
-  this->dataPtr->dirty = true;
+  unsigned int slot = this->dataPtr->Slot(_index);
+  float *c = this->dataPtr->colors.data() + slot * 4u;
+  c[0] = _color.R();
+  c[1] = _color.G();
+  c[2] = _color.B();
+  c[3] = _color.A();
+
+  this->dataPtr->MarkDirty(slot, slot + 1u);
 }
 
 /////////////////////////////////////////////////
 math::Vector3d Ogre2DynamicRenderable::Point(
     const unsigned int _index) const
 {
-  if (_index >= this->dataPtr->vertices.size())
+  if (_index >= this->PointCount())
   {
     gzerr << "Point index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->vertices.size()-1 << "]\n";
+           << static_cast<int>(this->PointCount()) - 1 << "]\n";
 
     return math::Vector3d(math::INF_D,
                                     math::INF_D,
                                     math::INF_D);
   }
 
-  return this->dataPtr->vertices[_index];
+  const float *v =
+      this->dataPtr->vertices.data() + this->dataPtr->Slot(_index) * 3u;
+  return math::Vector3d(v[0], v[1], v[2]);
 }
 
 /////////////////////////////////////////////////
 unsigned int Ogre2DynamicRenderable::PointCount() const
 {
-  return this->dataPtr->vertices.size();
+  return static_cast<unsigned int>(this->dataPtr->vertices.size() / 3u);
+}
+
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetMaxPointCount(unsigned int _count)
+{
+  if (_count == this->dataPtr->maxPointCount)
+    return;
+
+  if (_count > 0u &&
+      this->dataPtr->operationType != Ogre::OperationType::OT_POINT_LIST &&
+      this->dataPtr->operationType != Ogre::OperationType::OT_LINE_STRIP)
+  {
+    gzerr << "Max point count is only supported for points and line "
+           << "strips\n";
+    return;
+  }
+
+  // drop the oldest points that no longer fit
+  this->dataPtr->Linearize();
+  unsigned int count = this->PointCount();
+  if (_count > 0u && count > _count)
+  {
+    unsigned int first = count - _count;
+    this->dataPtr->vertices.erase(this->dataPtr->vertices.begin(),
+        this->dataPtr->vertices.begin() + first * 3u);
+    this->dataPtr->colors.erase(this->dataPtr->colors.begin(),
+        this->dataPtr->colors.begin() + first * 4u);
+  }
+
+  this->dataPtr->maxPointCount = _count;
+  this->dataPtr->MarkAllDirty();
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2DynamicRenderable::MaxPointCount() const
+{
+  return this->dataPtr->maxPointCount;
 }
 
 /////////////////////////////////////////////////
@@ -536,7 +826,8 @@ void Ogre2DynamicRenderable::Clear()
 
   this->dataPtr->vertices.clear();
   this->dataPtr->colors.clear();
-  this->dataPtr->dirty = true;
+  this->dataPtr->ringStart = 0u;
+  this->dataPtr->MarkAllDirty();
 }
 
 //////////////////////////////////////////////////
@@ -571,9 +862,9 @@ void Ogre2DynamicRenderable::SetMaterial(MaterialPtr _material, bool _unique)
 
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
-  const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
+  const float *_vertices, unsigned int _vertexCount, unsigned int &_start,
+  unsigned int &_end, float *_vbuffer)
 {
-  unsigned int vertexCount = _vertices.size();
   // Each vertex occupies 6 elements in the vbuffer float array:
   // vbuffer[i]   : position x
   // vbuffer[i+1] : position y
@@ -581,6 +872,21 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
   // vbuffer[i+3] : normal x
   // vbuffer[i+4] : normal y
   // vbuffer[i+5] : normal z
+  auto vertex = [&_vertices](unsigned int _i)
+  {
+    return Ogre::Vector3(_vertices + _i * 3);
+  };
+  auto normal = [&_vbuffer](unsigned int _i)
+  {
+    return Ogre::Vector3(_vbuffer + _i * 6 + 3);
+  };
+  auto setNormal = [&_vbuffer](unsigned int _i, const Ogre::Vector3 &_n)
+  {
+    _vbuffer[_i*6+3] = _n.x;
+    _vbuffer[_i*6+4] = _n.y;
+    _vbuffer[_i*6+5] = _n.z;
+  };
+
   switch (_opType)
   {
     case Ogre::OperationType::OT_POINT_LIST:
@@ -589,127 +895,90 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
       return;
     case Ogre::OperationType::OT_TRIANGLE_LIST:
     {
-      if (vertexCount < 3)
-        return;
+      // flat shading, only the triangles containing dirty vertices change
+      _start = _start / 3 * 3;
+      _end = std::min(_vertexCount, (_end + 2) / 3 * 3);
 
-      for (unsigned int i = 0; i < vertexCount / 3; ++i)
+      for (unsigned int idx = _start; idx + 2 < _end; idx += 3)
       {
-        unsigned int idx = i*3;
-        unsigned int idx1 = idx * 6;
-        unsigned int idx2 = idx1 + 6;
-        unsigned int idx3 = idx2 + 6;
-        math::Vector3d v1 = _vertices[idx];
-        math::Vector3d v2 = _vertices[idx+1];
-        math::Vector3d v3 = _vertices[idx+2];
-        math::Vector3d n = (v1 - v2).Cross((v1 - v3));
-
-        _vbuffer[idx1+3] = n.X();
-        _vbuffer[idx1+4] = n.Y();
-        _vbuffer[idx1+5] = n.Z();
-        _vbuffer[idx2+3] = n.X();
-        _vbuffer[idx2+4] = n.Y();
-        _vbuffer[idx2+5] = n.Z();
-        _vbuffer[idx3+3] = n.X();
-        _vbuffer[idx3+4] = n.Y();
-        _vbuffer[idx3+5] = n.Z();
+        Ogre::Vector3 v1 = vertex(idx);
+        Ogre::Vector3 v2 = vertex(idx+1);
+        Ogre::Vector3 v3 = vertex(idx+2);
+        Ogre::Vector3 n = (v1 - v2).crossProduct(v1 - v3);
+
+        setNormal(idx, n);
+        setNormal(idx+1, n);
+        setNormal(idx+2, n);
       }
 
       break;
     }
     case Ogre::OperationType::OT_TRIANGLE_STRIP:
+    case Ogre::OperationType::OT_TRIANGLE_FAN:
     {
-      if (vertexCount < 3)
+      // Smooth shading: the normal of a vertex is the normalized sum of the
+      // normals of the triangles sharing it. Triangle n uses vertices
+      // n, n+1 and n+2 in a strip so a moved vertex affects its two
+      // neighbors on each side. All triangles of a fan share vertex 0 so
+      // the whole fan is regenerated.
+      if (_opType == Ogre::OperationType::OT_TRIANGLE_STRIP)
+      {
+        _start = _start >= 2 ? _start - 2 : 0;
+        _end = std::min(_vertexCount, _end + 2);
+      }
+      else
+      {
+        _start = 0;
+        _end = _vertexCount;
+      }
+
+      if (_vertexCount < 3)
         return;
 
-      bool even = false;
-      for (unsigned int i = 0; i < vertexCount - 2; ++i)
+      for (unsigned int i = _start; i < _end; ++i)
+        setNormal(i, Ogre::Vector3::ZERO);
+
+      unsigned int firstTri = _start >= 2 ? _start - 2 : 0;
+      unsigned int lastTri = std::min(_end, _vertexCount - 2);
+      for (unsigned int t = firstTri; t < lastTri; ++t)
       {
-        math::Vector3d v1;
-        math::Vector3d v2;
-        math::Vector3d v3 = _vertices[i+2];
-
-        // For odd n, vertices n, n+1, and n+2 define triangle n.
-        // For even n, vertices n+1, n, and n+2 define triangle n.
-        unsigned int idx1;
-        unsigned int idx2;
-        unsigned int idx3 = (i+2) * 6;
-        if (even)
+        unsigned int idx[3];
+        if (_opType == Ogre::OperationType::OT_TRIANGLE_FAN)
         {
-          v1 = _vertices[i+1];
-          v2 = _vertices[i];
-          idx1 = (i+1) * 6;
-          idx2 = i*6;
+          idx[0] = 0;
+          idx[1] = t+1;
+          idx[2] = t+2;
+        }
+        else if (t % 2 == 1)
+        {
+          // For odd n, vertices n+1, n, and n+2 define triangle n.
+          idx[0] = t+1;
+          idx[1] = t;
+          idx[2] = t+2;
         }
         else
         {
-          v1 = _vertices[i];
-          v2 = _vertices[i+1];
-          idx1 = i*6;
-          idx2 = (i+1) * 6;
+          // For even n, vertices n, n+1, and n+2 define triangle n.
+          idx[0] = t;
+          idx[1] = t+1;
+          idx[2] = t+2;
         }
-        even = !even;
-
-        math::Vector3d n = (v1 - v2).Cross((v1 - v3));
-        math::Vector3d n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
-        math::Vector3d n2(_vbuffer[idx2+3], _vbuffer[idx2+4], _vbuffer[idx2+5]);
-        math::Vector3d n3(_vbuffer[idx3+3], _vbuffer[idx3+4], _vbuffer[idx3+5]);
-
-        math::Vector3d n1a = ((n1 + n)/2);
-        n1a.Normalize();
-        math::Vector3d n2a = ((n2 + n)/2);
-        n2a.Normalize();
-        math::Vector3d n3a = ((n3 + n)/2);
-        n3a.Normalize();
-
-        _vbuffer[idx1+3] = n1a.X();
-        _vbuffer[idx1+4] = n1a.Y();
-        _vbuffer[idx1+5] = n1a.Z();
-        _vbuffer[idx2+3] = n2a.X();
-        _vbuffer[idx2+4] = n2a.Y();
-        _vbuffer[idx2+5] = n2a.Z();
-        _vbuffer[idx3+3] = n3a.X();
-        _vbuffer[idx3+4] = n3a.Y();
-        _vbuffer[idx3+5] = n3a.Z();
-      }
 
-      break;
-    }
-    case Ogre::OperationType::OT_TRIANGLE_FAN:
-    {
-      if (vertexCount < 3)
-        return;
-
-      unsigned int idx1 = 0;
-      math::Vector3d v1 = _vertices[0];
+        Ogre::Vector3 v1 = vertex(idx[0]);
+        Ogre::Vector3 n = (v1 - vertex(idx[1])).crossProduct(
+            v1 - vertex(idx[2]));
+        for (unsigned int k : idx)
+        {
+          if (k >= _start && k < _end)
+            setNormal(k, normal(k) + n);
+        }
+      }
 
-      for (unsigned int i = 0; i < vertexCount - 2; ++i)
+      for (unsigned int i = _start; i < _end; ++i)
       {
-        unsigned int idx2 = (i+1) * 6;
-        unsigned int idx3 = idx2 + 6;
-        math::Vector3d v2 = _vertices[i+1];
-        math::Vector3d v3 = _vertices[i+2];
-        math::Vector3d n = (v1 - v2).Cross((v1 - v3));
-
-        math::Vector3d n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
-        math::Vector3d n2(_vbuffer[idx2+3], _vbuffer[idx2+4], _vbuffer[idx2+5]);
-        math::Vector3d n3(_vbuffer[idx3+3], _vbuffer[idx3+4], _vbuffer[idx3+5]);
-
-        math::Vector3d n1a = ((n1 + n)/2);
-        n1a.Normalize();
-        math::Vector3d n2a = ((n2 + n)/2);
-        n2a.Normalize();
-        math::Vector3d n3a = ((n3 + n)/2);
-        n3a.Normalize();
-
-        _vbuffer[idx1+3] = n1a.X();
-        _vbuffer[idx1+4] = n1a.Y();
-        _vbuffer[idx1+5] = n1a.Z();
-        _vbuffer[idx2+3] = n2a.X();
-        _vbuffer[idx2+4] = n2a.Y();
-        _vbuffer[idx2+5] = n2a.Z();
-        _vbuffer[idx3+3] = n3a.X();
-        _vbuffer[idx3+4] = n3a.Y();
-        _vbuffer[idx3+5] = n3a.Z();
+        Ogre::Vector3 n = normal(i);
+        n.normalise();
+        setNormal(i, n);
       }
 
       break;
@@ -721,10 +990,10 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
 
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::GenerateColors(Ogre::OperationType _opType,
-  const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
+  unsigned int _start, unsigned int _end, float *_vbuffer)
 {
   // Skip if colors haven't been setup per-vertex correctly.
-  if (_vertices.size() != this->dataPtr->colors.size())
+  if (_end * 4 > this->dataPtr->colors.size())
     return;
 
   // Each vertex occupies 6 elements in the vbuffer float array. Normally,
@@ -740,15 +1009,13 @@ void Ogre2DynamicRenderable::GenerateColors(Ogre::OperationType _opType,
   {
     case Ogre::OperationType::OT_POINT_LIST:
     {
-      for (unsigned int i = 0; i < this->dataPtr->vertexBufferCapacity; ++i)
+      const float *colors = this->dataPtr->colors.data();
+      for (unsigned int i = _start; i < _end; ++i)
       {
-        math::Color color = i < this->dataPtr->colors.size() ?
-            this->dataPtr->colors[i] : this->dataPtr->colors.back();
-
         unsigned int idx = i * 6;
-        _vbuffer[idx+3] = color.R();
-        _vbuffer[idx+4] = color.G();
-        _vbuffer[idx+5] = color.B();
+        _vbuffer[idx+3] = colors[i*4];
+        _vbuffer[idx+4] = colors[i*4+1];
+        _vbuffer[idx+5] = colors[i*4+2];
       }
 
       break;
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "gz/rendering/ogre2/Ogre2DynamicRenderable.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+using namespace gz;
+using namespace rendering;
+
+class Ogre2DynamicRenderableTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2DynamicRenderableTest, SetPoints)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  Ogre2DynamicRenderable renderable(scene);
+  renderable.SetOperationType(MT_POINTS);
+
+  const float xyz[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  renderable.SetPoints(xyz, nullptr, 3u);
+  ASSERT_EQ(3u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(0, 1, 2), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(3, 4, 5), renderable.Point(1));
+  EXPECT_EQ(math::Vector3d(6, 7, 8), renderable.Point(2));
+  renderable.Update();
+
+  // replacing the points with moved buffers
+  renderable.SetPoints(std::vector<float>{-1, -2, -3},
+      std::vector<float>{1, 0, 0, 1});
+  ASSERT_EQ(1u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(-1, -2, -3), renderable.Point(0));
+
+  // mismatched buffer sizes are rejected and keep the current points
+  renderable.SetPoints(std::vector<float>{0, 1, 2, 3, 4, 5},
+      std::vector<float>{1, 0, 0, 1});
+  ASSERT_EQ(1u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(-1, -2, -3), renderable.Point(0));
+  renderable.Update();
+
+  renderable.Clear();
+  EXPECT_EQ(0u, renderable.PointCount());
+
+  renderable.Destroy();
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2DynamicRenderableTest, RingBuffer)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  Ogre2DynamicRenderable renderable(scene);
+  renderable.SetOperationType(MT_LINE_STRIP);
+  renderable.SetMaxPointCount(3u);
+  EXPECT_EQ(3u, renderable.MaxPointCount());
+
+  // adding past the limit drops the oldest points
+  for (unsigned int i = 0; i < 5u; ++i)
+  {
+    renderable.AddPoint(math::Vector3d(i, 0, 0), math::Color::White);
+    renderable.Update();
+  }
+  ASSERT_EQ(3u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(2, 0, 0), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(3, 0, 0), renderable.Point(1));
+  EXPECT_EQ(math::Vector3d(4, 0, 0), renderable.Point(2));
+
+  // indices are relative to the oldest point once the buffer wrapped
+  renderable.SetPoint(0, math::Vector3d(9, 0, 0));
+  EXPECT_EQ(math::Vector3d(9, 0, 0), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(4, 0, 0), renderable.Point(2));
+  renderable.Update();
+
+  // lowering the limit keeps the newest points
+  renderable.SetMaxPointCount(2u);
+  ASSERT_EQ(2u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(3, 0, 0), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(4, 0, 0), renderable.Point(1));
+
+  // bulk updates also keep the newest points
+  const float xyz[] = {0, 0, 0, 1, 0, 0, 2, 0, 0, 3, 0, 0};
+  renderable.SetPoints(xyz, nullptr, 4u);
+  ASSERT_EQ(2u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(2, 0, 0), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(3, 0, 0), renderable.Point(1));
+  renderable.AddPoint(math::Vector3d(7, 0, 0), math::Color::White);
+  ASSERT_EQ(2u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(3, 0, 0), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(7, 0, 0), renderable.Point(1));
+  renderable.Update();
+
+  // removing the limit keeps the points in order
+  renderable.SetMaxPointCount(0u);
+  renderable.AddPoint(math::Vector3d(8, 0, 0), math::Color::White);
+  ASSERT_EQ(3u, renderable.PointCount());
+  EXPECT_EQ(math::Vector3d(3, 0, 0), renderable.Point(0));
+  EXPECT_EQ(math::Vector3d(8, 0, 0), renderable.Point(2));
+
+  // only points and line strips can be bounded
+  renderable.SetOperationType(MT_TRIANGLE_LIST);
+  renderable.SetMaxPointCount(2u);
+  EXPECT_EQ(0u, renderable.MaxPointCount());
+
+  renderable.Destroy();
+  engine->DestroyScene(scene);
+}
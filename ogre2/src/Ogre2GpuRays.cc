@@ -479,7 +479,7 @@ void Ogre2LaserRetroMaterialSwitcher::passPreExecute(
       // like we do with Items (it should be impossible?)
       const Ogre::Vector4 customParameter =
         Ogre::Vector4(color, color, color, 1.0);
-      heightmap->Terra()->SetSolidColor(1u, customParameter);
+      heightmap->SetSolidColor(1u, customParameter);
     }
   }
 
@@ -542,7 +542,7 @@ void Ogre2LaserRetroMaterialSwitcher::passPosExecute(
   {
     auto heightmap = h.lock();
     if (heightmap)
-      heightmap->Terra()->UnsetSolidColors();
+      heightmap->UnsetSolidColors();
   }
 
   engine->SetGzOgreRenderingMode(GORM_NORMAL);
@@ -1406,3 +1406,9 @@ RenderTargetPtr Ogre2GpuRays::RenderTarget() const
 {
   return this->dataPtr->renderTexture;
 }
+
+//////////////////////////////////////////////////
+Ogre::TextureGpu *Ogre2GpuRays::OutputTexture() const
+{
+  return this->dataPtr->secondPassTexture;
+}
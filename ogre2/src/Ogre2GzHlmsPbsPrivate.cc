@@ -218,6 +218,9 @@ namespace Ogre
     const uint32 instanceIdx = HlmsPbs::fillBuffersForV1(
       _cache, _queuedRenderable, _casterPass, _lastCacheHash, _commandBuffer);
 
+    if (this->trackDatablocks)
+      this->TrackDatablock(_queuedRenderable);
+
     if ((this->gzOgreRenderingMode == GORM_SOLID_COLOR ||
          this->gzOgreRenderingMode == GORM_SOLID_THERMAL_COLOR_TEXTURED) &&
         !_casterPass)
@@ -260,6 +263,9 @@ namespace Ogre
     const uint32 instanceIdx = HlmsPbs::fillBuffersForV2(
       _cache, _queuedRenderable, _casterPass, _lastCacheHash, _commandBuffer);
 
+    if (this->trackDatablocks)
+      this->TrackDatablock(_queuedRenderable);
+
     if ((this->gzOgreRenderingMode == GORM_SOLID_COLOR ||
          this->gzOgreRenderingMode == GORM_SOLID_THERMAL_COLOR_TEXTURED) &&
         !_casterPass)
@@ -326,6 +332,20 @@ namespace Ogre
     this->currPerObjectDataBuffer = nullptr;
     this->lastMainConstBuffer = nullptr;
     this->currPerObjectDataPtr = nullptr;
+    this->lastDrawnDatablock = nullptr;
+  }
+
+  /////////////////////////////////////////////////
+  void Ogre2GzHlmsPbs::TrackDatablock(
+      const QueuedRenderable &_queuedRenderable)
+  {
+    const HlmsDatablock *datablock =
+        _queuedRenderable.renderable->getDatablock();
+    if (datablock != this->lastDrawnDatablock)
+    {
+      this->drawnDatablocks.insert(datablock);
+      this->lastDrawnDatablock = datablock;
+    }
   }
 
   /////////////////////////////////////////////////
@@ -32,6 +32,7 @@
   #pragma warning(pop)
 #endif
 
+#include <unordered_set>
 #include <vector>
 
 namespace Ogre
@@ -221,6 +222,23 @@ namespace Ogre
     public: static void GetDefaultPaths(String &_outDataFolderPath,
                                         StringVector &_outLibraryFoldersPaths);
 
+    /// \brief Record the datablock of a renderable being drawn in
+    /// drawnDatablocks
+    /// \param[in] _queuedRenderable Renderable being drawn
+    private: void TrackDatablock(const QueuedRenderable &_queuedRenderable);
+
+    /// \brief True to record the datablocks drawn in drawnDatablocks.
+    /// Used by the texture budget.
+    public: bool trackDatablocks = false;
+
+    /// \brief Datablocks drawn since the set was last cleared. They may
+    /// have been destroyed since.
+    public: std::unordered_set<const HlmsDatablock *> drawnDatablocks;
+
+    /// \brief Last datablock recorded, to skip consecutive renderables
+    /// sharing a datablock
+    private: const HlmsDatablock *lastDrawnDatablock = nullptr;
+
     /// \brief Contains additional customizations that are modular and
     /// implemented as listener-only
     private: std::vector<Ogre::HlmsListener*> customizations;
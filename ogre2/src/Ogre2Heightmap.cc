@@ -15,10 +15,21 @@
  *
 */
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/common/Util.hh>
+#include <gz/math/Vector2.hh>
 
 #include "gz/rendering/ogre2/Ogre2Heightmap.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
@@ -26,6 +37,9 @@
 #include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
 
+#include "Ogre2HeightmapCache.hh"
+#include "Ogre2HeightmapNormalizer.hh"
+#include "Ogre2WorkQueue.hh"
 #include "Terra/Terra.h"
 
 #ifdef _MSC_VER
@@ -37,6 +51,7 @@
 #include <OgreImage2.h>
 #include <OgreRoot.h>
 #include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
 #include "Terra/Hlms/OgreHlmsTerra.h"
 #include "Terra/Hlms/OgreHlmsTerraDatablock.h"
 #ifdef _MSC_VER
@@ -60,197 +75,616 @@ class gz::rendering::Ogre2HeightmapPrivate
   /// \brief Size of the heightmap data.
   public: unsigned int dataSize{0u};
 
-  /// \brief Pointer to ogre terra object
+  /// \brief Pointer to ogre terra object. For tiled heightmaps, the
+  /// Terra of the anchor tile.
   public: std::unique_ptr<Ogre::Terra> terra{nullptr};
+
+  /// \brief Column and row of a tile of a tiled heightmap
+  public: using TileKey = std::pair<unsigned int, unsigned int>;
+
+  /// \brief Heights of a tile sampled on a worker thread
+  public: struct TileHeights
+  {
+    /// \brief Tile the heights belong to
+    TileKey tile;
+
+    /// \brief Normalized heights
+    std::vector<float> heights;
+
+    /// \brief Number of samples along each side
+    unsigned int size{0u};
+
+    /// \brief Elevation of a normalized height of 0
+    double minElevation{0.0};
+
+    /// \brief False if the tile failed to load
+    bool valid{false};
+  };
+
+  /// \brief Get all Terra instances: the loaded tiles of a tiled
+  /// heightmap, or the only Terra otherwise
+  /// \return Terra instances
+  public: std::vector<Ogre::Terra *> Terras() const;
+
+  /// \brief Get the distance in the XY plane between a point and a tile
+  /// \param[in] _tile Tile
+  /// \param[in] _point Point
+  /// \return Distance, 0 if the point is over the tile
+  public: double TileDistance(const TileKey &_tile,
+      const math::Vector2d &_point) const;
+
+  /// \brief Load the tiles close to a camera and unload far ones. Tiles are
+  /// sampled on worker threads, and a few Terra instances are created per
+  /// call to bound the time spent in a frame.
+  /// \param[in] _desc Descriptor of the tiled heightmap
+  /// \param[in] _camera Camera about to be used for rendering
+  /// \param[in] _sceneManager Scene manager to create Terra in
+  public: void UpdateTiles(const HeightmapDescriptor &_desc,
+      const Ogre::Camera *_camera, Ogre::SceneManager *_sceneManager);
+
+  /// \brief Tile that is always loaded, at the center of a tiled heightmap
+  public: TileKey anchorTile;
+
+  /// \brief Loaded tiles other than the anchor tile
+  public: std::map<TileKey, std::unique_ptr<Ogre::Terra>> tiles;
+
+  /// \brief Tiles being sampled on worker threads
+  public: std::set<TileKey> pendingTiles;
+
+  /// \brief Tiles that failed to load, not requested again
+  public: std::set<TileKey> failedTiles;
+
+  /// \brief Tiles sampled on worker threads, waiting for their Terra
+  public: std::vector<TileHeights> sampledTiles;
+
+  /// \brief Protects sampledTiles
+  public: std::mutex tileMutex;
+
+  /// \brief Min corner of a tiled heightmap in the XY plane
+  public: math::Vector2d tileOrigin;
+
+  /// \brief Size of a tile in the XY plane
+  public: math::Vector2d tileSize;
+
+  /// \brief Datablock shared by all tiles
+  public: Ogre::HlmsDatablock *datablock{nullptr};
+
+  /// \brief Tile closest to the last camera, returned by Terra()
+  public: Ogre::Terra *activeTerra{nullptr};
+
+  /// \brief Threads sampling tiles. Declared last so it is destroyed,
+  /// and running jobs finished, before the data they write to.
+  public: std::unique_ptr<Ogre2WorkQueue> tilePool;
 };
 
 using namespace gz;
 using namespace rendering;
 
+namespace
+{
+  /// \brief Number of threads sampling tiles, per tiled heightmap
+  const unsigned int kTileThreads = 2u;
+
+  /// \brief Max number of tiles being sampled at once per heightmap
+  const std::size_t kMaxPendingTiles = 4u;
+
+  /// \brief Max number of Terra instances created per update, each one
+  /// uploads a heightmap and builds its normal map on the GPU
+  const unsigned int kMaxTilesCreatedPerUpdate = 1u;
+
+  /// \brief Tiles are unloaded once their distance to the camera exceeds
+  /// the load distance times this factor, so they don't get reloaded when
+  /// the camera moves back and forth along the boundary
+  const double kTileUnloadFactor = 1.5;
+
+  //////////////////////////////////////////////////
+  /// \brief Sample a heightmap and normalize its heights to [0, 1]
+  /// \param[in] _desc Heightmap descriptor
+  /// \param[in] _srcWidth Number of samples along each side
+  /// \param[in] _newWidth Number of samples kept along each side, the last
+  /// row and column are cropped if smaller than _srcWidth
+  /// \param[in] _parallel False to normalize on the calling thread only
+  /// \param[out] _heights Normalized heights, row major
+  void fillHeights(const HeightmapDescriptor &_desc, unsigned int _srcWidth,
+      unsigned int _newWidth, bool _parallel, std::vector<float> &_heights)
+  {
+    // \todo These parameters shouldn't be hardcoded, and instead
+    // parametrized so that they can be made consistent across different
+    // libraries (like gz-physics)
+    bool flipY = false;
+
+    math::Vector3d scale;
+    scale.X(_desc.Size().X() / _newWidth);
+    scale.Y(_desc.Size().Y() / _newWidth);
+    scale.Z(1.0);
+
+    // Construct the heightmap lookup table
+    std::vector<float> lookup;
+    _desc.Data()->FillHeightMap(_desc.Sampling(),
+        _srcWidth, _desc.Size(), scale, flipY, lookup);
+    if (lookup.size() <
+        static_cast<std::size_t>(_srcWidth) * _srcWidth)
+    {
+      _heights.clear();
+      return;
+    }
+    _heights.resize(static_cast<std::size_t>(_newWidth) * _newWidth);
+
+    // Terra is optimized to work with UNORM heightmaps, therefore it assumes
+    // lowest height is 0.
+    // So we move the heightmap so that its min elevation = 0 before feeding to
+    // ogre. It is later translated back by the setOrigin call.
+    Ogre2HeightmapNormalizer::Normalize(lookup.data(), _srcWidth, _newWidth,
+        static_cast<float>(_desc.Data()->MinElevation()),
+        static_cast<float>(_desc.Data()->MaxElevation()), _heights.data(),
+        _parallel);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Sample the heights of a heightmap, or read them from the
+  /// heightmap cache
+  /// \param[in] _desc Heightmap descriptor, with data
+  /// \param[in] _cacheDir Heightmap cache directory, empty if disabled
+  /// \param[in] _warn True to warn when the last row and column of the
+  /// heightmap are cropped
+  /// \param[in] _parallel False to normalize on the calling thread only,
+  /// when called from a tile worker
+  /// \param[out] _heights Normalized heights, row major
+  /// \param[out] _size Number of samples along each side
+  /// \param[out] _minElevation Elevation of a normalized height of 0
+  /// \return True on success
+  bool loadHeights(const HeightmapDescriptor &_desc,
+      const std::string &_cacheDir, bool _warn, bool _parallel,
+      std::vector<float> &_heights, unsigned int &_size,
+      double &_minElevation)
+  {
+    // sampling size along image width and height
+    const bool needsOgre1Compat =
+        math::isPowerOfTwo(_desc.Data()->Width() - 1u);
+    const unsigned int srcWidth =
+      needsOgre1Compat
+        ? ((_desc.Data()->Width() * _desc.Sampling()) -
+           _desc.Sampling() + 1)
+        : (_desc.Data()->Width() * _desc.Sampling());
+
+    if (needsOgre1Compat)
+    {
+      if (_warn)
+      {
+        gzwarn << "Heightmap final sampling should be 2^n"
+               << std::endl << " which differs from ogre1's 2^n+1"
+               << std::endl << "The last row and column will be cropped"
+               << std::endl << "size = (width * sampling) - sampling + 1"
+               << std::endl << "[" << srcWidth << "] = (["
+               << _desc.Data()->Width() << "] * ["
+               << _desc.Sampling() << "]) - ["
+               << _desc.Sampling() << "] + 1"
+            << std::endl;
+      }
+    }
+    else if (!math::isPowerOfTwo(srcWidth))
+    {
+      gzerr << "Heightmap final sampling must satisfy 2^n."
+             << std::endl << "size = width * sampling"
+             << std::endl << "[" << srcWidth << "] = ["
+             << _desc.Data()->Width() << "] * ["
+             << _desc.Sampling() << "]"
+          << std::endl;
+      return false;
+    }
+
+    const unsigned int newWidth =
+      math::isPowerOfTwo(srcWidth) ? srcWidth : (srcWidth - 1u);
+
+    double minElevation = _desc.Data()->MinElevation();
+    double maxElevation = _desc.Data()->MaxElevation();
+
+    // skip sampling and normalization if the heightmap is cached
+    std::string cacheHash;
+    Ogre2HeightmapData cached;
+    if (!_cacheDir.empty())
+      cacheHash = Ogre2HeightmapCache::Hash(_desc);
+    if (!cacheHash.empty() &&
+        Ogre2HeightmapCache::Read(_cacheDir, cacheHash, cached) &&
+        cached.size == newWidth)
+    {
+      _heights = std::move(cached.heights);
+      minElevation = cached.minElevation;
+      maxElevation = cached.maxElevation;
+    }
+    else
+    {
+      fillHeights(_desc, srcWidth, newWidth, _parallel, _heights);
+      if (!cacheHash.empty() && !_heights.empty())
+      {
+        cached.heights = _heights;
+        cached.size = newWidth;
+        cached.minElevation = minElevation;
+        cached.maxElevation = maxElevation;
+        Ogre2HeightmapCache::Write(_cacheDir, cacheHash, cached);
+      }
+    }
+
+    if (_heights.empty())
+    {
+      gzerr << "Failed to load terrain. Heightmap data is empty" << std::endl;
+      return false;
+    }
+
+    _size = newWidth;
+    _minElevation = minElevation;
+    return true;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Create a Terra instance
+  /// \param[in] _desc Heightmap descriptor
+  /// \param[in] _heights Normalized heights returned by loadHeights
+  /// \param[in] _size Number of samples along each side
+  /// \param[in] _minElevation Elevation of a normalized height of 0
+  /// \param[in] _sceneManager Scene manager to create Terra in
+  /// \return Terra instance, without datablock
+  std::unique_ptr<Ogre::Terra> createTerra(const HeightmapDescriptor &_desc,
+      std::vector<float> &_heights, unsigned int _size, double _minElevation,
+      Ogre::SceneManager *_sceneManager)
+  {
+    // Create terrain group, which holds all the individual terrain
+    // instances.
+    // Param 1: Pointer to the scene manager
+    // Param 2: Alignment plane
+    // Param 3: Number of vertices along one edge of the terrain (2^n+1).
+    //          Terrains must be square, with each side a power of 2 in size
+    // Param 4: World size of each terrain instance, in meters.
+
+    Ogre::Image2 image;
+    image.loadDynamicImage(_heights.data(), _size, _size,
+                           1u, Ogre::TextureTypes::Type2D,
+                           Ogre::PFG_R32_FLOAT, false);
+
+    const math::Vector3d size = _desc.Size();
+
+    // The position's Y sign ends up flipped
+    math::Vector3d center(
+        _desc.Position().X(),
+        -_desc.Position().Y(),
+        _desc.Position().Z() + size.Z() * 0.5 + _minElevation);
+
+    Ogre::Root *ogreRoot = Ogre2RenderEngine::Instance()->OgreRoot();
+    Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+    // TODO(anyone): Gazebo doesn't support SCENE_STATIC scene nodes
+    auto terra =
+        std::make_unique<Ogre::Terra>(
+          Ogre::Id::generateNewId<Ogre::MovableObject>(),
+          &_sceneManager->_getEntityMemoryManager(
+            Ogre::/*SCENE_STATIC*/SCENE_DYNAMIC),
+          _sceneManager, 11u, ogreCompMgr, nullptr, true );
+
+    // Does not cast shadows because it uses a raymarching implementation
+    // instead of shadow maps. It does receive shadows from shadow maps
+    // though
+    terra->setCastShadows(false);
+    terra->load(
+          image,
+          Ogre2Conversions::Convert(center),
+          Ogre2Conversions::Convert(size),
+          false,
+          false,
+          _desc.Name());
+    return terra;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Get the descriptor of a tile of a tiled heightmap. It has no
+  /// data but keeps the tile grid so the data can be loaded from it.
+  /// \param[in] _desc Descriptor of the tiled heightmap
+  /// \param[in] _column Column of the tile
+  /// \param[in] _row Row of the tile
+  /// \return Descriptor of the tile
+  HeightmapDescriptor tileDescriptor(const HeightmapDescriptor &_desc,
+      unsigned int _column, unsigned int _row)
+  {
+    const math::Vector3d size = _desc.Size();
+    const double width = size.X() / _desc.TileColumns();
+    const double depth = size.Y() / _desc.TileRows();
+
+    HeightmapDescriptor tile(_desc);
+    tile.SetData(nullptr);
+    tile.SetName(_desc.Name() + "_" + std::to_string(_column) + "_" +
+        std::to_string(_row));
+    tile.SetSize(math::Vector3d(width, depth, size.Z()));
+    tile.SetPosition(math::Vector3d(
+        _desc.Position().X() - size.X() * 0.5 + (_column + 0.5) * width,
+        _desc.Position().Y() - size.Y() * 0.5 + (_row + 0.5) * depth,
+        _desc.Position().Z()));
+    return tile;
+  }
+}
+
 //////////////////////////////////////////////////
-Ogre2Heightmap::Ogre2Heightmap(const HeightmapDescriptor &_desc)
-    : BaseHeightmap(_desc), dataPtr(std::make_unique<Ogre2HeightmapPrivate>())
+std::vector<Ogre::Terra *> Ogre2HeightmapPrivate::Terras() const
 {
+  std::vector<Ogre::Terra *> terras;
+  if (this->terra)
+    terras.push_back(this->terra.get());
+  for (const auto &tile : this->tiles)
+    terras.push_back(tile.second.get());
+  return terras;
 }
 
 //////////////////////////////////////////////////
-Ogre2Heightmap::~Ogre2Heightmap()
+double Ogre2HeightmapPrivate::TileDistance(const TileKey &_tile,
+    const math::Vector2d &_point) const
 {
+  const double minX = this->tileOrigin.X() + _tile.first * this->tileSize.X();
+  const double minY = this->tileOrigin.Y() + _tile.second * this->tileSize.Y();
+  const double dx = std::max({0.0, minX - _point.X(),
+      _point.X() - (minX + this->tileSize.X())});
+  const double dy = std::max({0.0, minY - _point.Y(),
+      _point.Y() - (minY + this->tileSize.Y())});
+  return std::sqrt(dx * dx + dy * dy);
 }
 
 //////////////////////////////////////////////////
-void Ogre2Heightmap::Init()
+void Ogre2HeightmapPrivate::UpdateTiles(const HeightmapDescriptor &_desc,
+    const Ogre::Camera *_camera, Ogre::SceneManager *_sceneManager)
 {
-  Ogre2Object::Init();
+  // tiles are attached where the anchor tile was attached by the visual
+  Ogre::SceneNode *node = this->terra->getParentSceneNode();
+  if (!node)
+    return;
+
+  // Terra is positioned in world coordinates
+  const Ogre::Vector3 cameraPos = _camera->getDerivedPosition();
+  const math::Vector2d point(cameraPos.x, cameraPos.y);
+  double loadDistance = _desc.TileLoadDistance();
+  if (loadDistance <= 0.0)
+    loadDistance = std::max(this->tileSize.X(), this->tileSize.Y());
+  const double unloadDistance = loadDistance * kTileUnloadFactor;
 
-  if (this->descriptor.Data() == nullptr)
+  for (auto it = this->tiles.begin(); it != this->tiles.end();)
   {
-    gzerr << "Failed to initialize: null heightmap data." << std::endl;
-    return;
+    if (this->TileDistance(it->first, point) > unloadDistance)
+      it = this->tiles.erase(it);
+    else
+      ++it;
   }
 
-  if (this->descriptor.Name().empty())
-    this->descriptor.SetName(this->Name());
+  // create Terra instances of sampled tiles, closest first
+  std::vector<TileHeights> sampled;
+  {
+    std::lock_guard<std::mutex> lock(this->tileMutex);
+    sampled.swap(this->sampledTiles);
+  }
+  std::stable_sort(sampled.begin(), sampled.end(),
+      [this, &point](const TileHeights &_a, const TileHeights &_b)
+      {
+        return this->TileDistance(_a.tile, point) <
+            this->TileDistance(_b.tile, point);
+      });
+  unsigned int created = 0u;
+  auto next = sampled.begin();
+  for (; next != sampled.end() && created < kMaxTilesCreatedPerUpdate; ++next)
+  {
+    this->pendingTiles.erase(next->tile);
+    if (!next->valid)
+    {
+      this->failedTiles.insert(next->tile);
+      continue;
+    }
+    if (this->TileDistance(next->tile, point) > unloadDistance)
+      continue;
+
+    auto tile = tileDescriptor(_desc, next->tile.first, next->tile.second);
+    auto terra = createTerra(tile, next->heights, next->size,
+        next->minElevation, _sceneManager);
+    terra->setDatablock(this->datablock);
+    terra->getUserObjectBindings().setUserAny(
+        this->terra->getUserObjectBindings().getUserAny());
+    for (size_t i = 1u; i < 3u; ++i)
+    {
+      if (this->terra->HasSolidColor(i))
+        terra->SetSolidColor(i, this->terra->SolidColor(i));
+    }
+    this->tiles[next->tile] = std::move(terra);
+    ++created;
+  }
+  if (next != sampled.end())
+  {
+    std::lock_guard<std::mutex> lock(this->tileMutex);
+    this->sampledTiles.insert(this->sampledTiles.end(),
+        std::make_move_iterator(next), std::make_move_iterator(sampled.end()));
+  }
 
-  // Add paths
-  for (auto i = 0u; i < this->descriptor.TextureCount(); ++i)
+  // follow the anchor tile if the heightmap was moved to another visual,
+  // or the visual was hidden
+  for (auto &tile : this->tiles)
   {
-    auto texture = this->descriptor.TextureByIndex(i);
-    Ogre2RenderEngine::Instance()->AddResourcePath(texture->Diffuse());
-    Ogre2RenderEngine::Instance()->AddResourcePath(texture->Normal());
+    Ogre::Terra *terra = tile.second.get();
+    if (terra->getParentSceneNode() != node)
+    {
+      if (terra->getParentSceneNode())
+        terra->getParentSceneNode()->detachObject(terra);
+      node->attachObject(terra);
+    }
+    terra->setVisibilityFlags(this->terra->getVisibilityFlags());
+    terra->setVisible(this->terra->getVisible());
   }
 
-  // \todo These parameters shouldn't be hardcoded, and instead parametrized so
-  // that they can be made consistent across different libraries (like
-  // gz-physics)
-  bool flipY = false;
-  // sampling size along image width and height
-  const bool needsOgre1Compat =
-      math::isPowerOfTwo(this->descriptor.Data()->Width() - 1u);
-  const unsigned int srcWidth =
-    needsOgre1Compat
-      ? ((this->descriptor.Data()->Width() * this->descriptor.Sampling()) -
-         this->descriptor.Sampling() + 1)
-      : (this->descriptor.Data()->Width() * this->descriptor.Sampling());
-
-  if (needsOgre1Compat)
+  // pick the tile the camera is over, or the closest one
+  double closest = this->TileDistance(this->anchorTile, point);
+  this->activeTerra = this->terra.get();
+  for (const auto &tile : this->tiles)
   {
-    gzwarn << "Heightmap final sampling should be 2^n"
-           << std::endl << " which differs from ogre1's 2^n+1"
-           << std::endl << "The last row and column will be cropped"
-           << std::endl << "size = (width * sampling) - sampling + 1"
-           << std::endl << "[" << srcWidth << "] = (["
-           << this->descriptor.Data()->Width() << "] * ["
-           << this->descriptor.Sampling() << "]) - ["
-           << this->descriptor.Sampling() << "] + 1"
-        << std::endl;
+    const double distance = this->TileDistance(tile.first, point);
+    if (distance < closest)
+    {
+      closest = distance;
+      this->activeTerra = tile.second.get();
+    }
   }
-  else if (!math::isPowerOfTwo(srcWidth))
+
+  // request missing tiles within the load distance, closest first
+  const unsigned int columns = _desc.TileColumns();
+  const unsigned int rows = _desc.TileRows();
+  const double minColumn = std::floor((point.X() - loadDistance -
+      this->tileOrigin.X()) / this->tileSize.X());
+  const double maxColumn = std::floor((point.X() + loadDistance -
+      this->tileOrigin.X()) / this->tileSize.X());
+  const double minRow = std::floor((point.Y() - loadDistance -
+      this->tileOrigin.Y()) / this->tileSize.Y());
+  const double maxRow = std::floor((point.Y() + loadDistance -
+      this->tileOrigin.Y()) / this->tileSize.Y());
+  if (maxColumn < 0.0 || maxRow < 0.0 || minColumn >= columns ||
+      minRow >= rows)
   {
-    gzerr << "Heightmap final sampling must satisfy 2^n."
-           << std::endl << "size = width * sampling"
-           << std::endl << "[" << srcWidth << "] = ["
-           << this->descriptor.Data()->Width() << "] * ["
-           << this->descriptor.Sampling() << "]"
-        << std::endl;
     return;
   }
 
-  const unsigned int newWidth =
-    math::isPowerOfTwo(srcWidth) ? srcWidth : (srcWidth - 1u);
-
-  math::Vector3d scale;
-  scale.X(this->descriptor.Size().X() / newWidth);
-  scale.Y(this->descriptor.Size().Y() / newWidth);
-  scale.Z(1.0);
-
-  // Construct the heightmap lookup table
-  std::vector<float> lookup;
-  this->descriptor.Data()->FillHeightMap(this->descriptor.Sampling(),
-      srcWidth, this->descriptor.Size(), scale, flipY, lookup);
-  this->dataPtr->heights.reserve(newWidth * newWidth);
-
-  // Terra is optimized to work with UNORM heightmaps, therefore it assumes
-  // lowest height is 0.
-  // So we move the heightmap so that its min elevation = 0 before feeding to
-  // ogre. It is later translated back by the setOrigin call.
-  //
-  // Obtain min and max elevation and bring everything to range [0; 1]
-  // Terra should support non-normalized ranges but there are a couple
-  // bugs preventing that, so it's just easier to normalize the data
-  double minElevation = this->descriptor.Data()->MinElevation();
-  double maxElevation = this->descriptor.Data()->MaxElevation();
-
-  for (unsigned int y = 0; y < newWidth; ++y)
+  std::vector<std::pair<double, TileKey>> missing;
+  const auto lastColumn =
+      static_cast<unsigned int>(std::min(maxColumn, columns - 1.0));
+  const auto lastRow = static_cast<unsigned int>(std::min(maxRow, rows - 1.0));
+  for (auto c = static_cast<unsigned int>(std::max(minColumn, 0.0));
+       c <= lastColumn; ++c)
   {
-    for (unsigned int x = 0; x < newWidth; ++x)
+    for (auto r = static_cast<unsigned int>(std::max(minRow, 0.0));
+         r <= lastRow; ++r)
     {
-      const size_t index = y * srcWidth + x;
-      float heightVal = lookup[index];
-
-      // Sanity check in case we get NaNs from gz-common, this prevents a crash
-      // in Ogre
-      if (!std::isfinite(heightVal))
-        heightVal = minElevation;
-
-      if (heightVal < minElevation || heightVal > maxElevation)
+      const TileKey key(c, r);
+      if (key == this->anchorTile || this->tiles.count(key) > 0u ||
+          this->pendingTiles.count(key) > 0u ||
+          this->failedTiles.count(key) > 0u)
       {
-        gzerr << "Internal error: height [" << heightVal
-               << "] is out of bounds [" << minElevation << " / "
-               << maxElevation << "]" << std::endl;
+        continue;
       }
-      this->dataPtr->heights.push_back(heightVal);
+      const double distance = this->TileDistance(key, point);
+      if (distance <= loadDistance)
+        missing.emplace_back(distance, key);
     }
   }
+  if (missing.empty())
+    return;
+  std::sort(missing.begin(), missing.end());
 
-  // min and max elevations collected. Now normalize
-  const float heightDiff = maxElevation - minElevation;
-  const float invHeightDiff =
-      fabsf( heightDiff ) < 1e-6f ? 1.0f : (1.0f / heightDiff);
-  for (float &heightVal : this->dataPtr->heights)
+  if (!this->tilePool)
+    this->tilePool = std::make_unique<Ogre2WorkQueue>(kTileThreads);
+  const std::string cacheDir =
+      Ogre2RenderEngine::Instance()->HeightmapCacheDir();
+  for (const auto &m : missing)
   {
-    heightVal = (heightVal - minElevation) * invHeightDiff;
-    assert( heightVal >= 0 );
+    if (this->pendingTiles.size() >= kMaxPendingTiles)
+      break;
+
+    const TileKey key = m.second;
+    this->pendingTiles.insert(key);
+    auto tile = tileDescriptor(_desc, key.first, key.second);
+    this->tilePool->Add([this, tile, key, cacheDir]() mutable
+    {
+      TileHeights sampledTile;
+      sampledTile.tile = key;
+      tile.SetData(tile.LoadTile(key.first, key.second));
+      if (tile.Data() == nullptr)
+      {
+        gzerr << "Unable to load heightmap tile [" << tile.Name() << "]"
+              << std::endl;
+      }
+      else
+      {
+        // tiles are sampled in parallel already, so each tile is
+        // normalized on its worker instead of on another pool
+        sampledTile.valid = loadHeights(tile, cacheDir, false, false,
+            sampledTile.heights, sampledTile.size, sampledTile.minElevation);
+      }
+      std::lock_guard<std::mutex> lock(this->tileMutex);
+      this->sampledTiles.push_back(std::move(sampledTile));
+    });
   }
+}
 
-  this->dataPtr->dataSize = newWidth;
+//////////////////////////////////////////////////
+Ogre2Heightmap::Ogre2Heightmap(const HeightmapDescriptor &_desc)
+    : BaseHeightmap(_desc), dataPtr(std::make_unique<Ogre2HeightmapPrivate>())
+{
+}
 
-  if (this->dataPtr->heights.empty())
+//////////////////////////////////////////////////
+Ogre2Heightmap::~Ogre2Heightmap()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::Init()
+{
+  Ogre2Object::Init();
+
+  const bool tiled = this->descriptor.TileColumns() > 0u;
+  if (!tiled && this->descriptor.Data() == nullptr)
   {
-    gzerr << "Failed to load terrain. Heightmap data is empty" << std::endl;
+    gzerr << "Failed to initialize: null heightmap data." << std::endl;
     return;
   }
 
-  // Create terrain group, which holds all the individual terrain instances.
-  // Param 1: Pointer to the scene manager
-  // Param 2: Alignment plane
-  // Param 3: Number of vertices along one edge of the terrain (2^n+1).
-  //          Terrains must be square, with each side a power of 2 in size
-  // Param 4: World size of each terrain instance, in meters.
-
-  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  if (this->descriptor.Name().empty())
+    this->descriptor.SetName(this->Name());
 
-  Ogre::Image2 image;
-  image.loadDynamicImage(this->dataPtr->heights.data(), newWidth, newWidth,
-                         1u, Ogre::TextureTypes::Type2D,
-                         Ogre::PFG_R32_FLOAT, false);
+  // Add paths
+  for (auto i = 0u; i < this->descriptor.TextureCount(); ++i)
+  {
+    auto texture = this->descriptor.TextureByIndex(i);
+    Ogre2RenderEngine::Instance()->AddResourcePath(texture->Diffuse());
+    Ogre2RenderEngine::Instance()->AddResourcePath(texture->Normal());
+  }
 
-  const math::Vector3d size = this->descriptor.Size();
+  // A tiled heightmap starts with the tile at its center, which stays
+  // loaded so there always is a Terra to attach to the parent visual. The
+  // other tiles are loaded around cameras by UpdateForRender.
+  HeightmapDescriptor desc = this->descriptor;
+  if (tiled)
+  {
+    const math::Vector3d size = this->descriptor.Size();
+    const math::Vector3d position = this->descriptor.Position();
+    this->dataPtr->tileSize.Set(size.X() / this->descriptor.TileColumns(),
+        size.Y() / this->descriptor.TileRows());
+    this->dataPtr->tileOrigin.Set(position.X() - size.X() * 0.5,
+        position.Y() - size.Y() * 0.5);
+    this->dataPtr->anchorTile = Ogre2HeightmapPrivate::TileKey(
+        this->descriptor.TileColumns() / 2u, this->descriptor.TileRows() / 2u);
+
+    const auto &anchor = this->dataPtr->anchorTile;
+    desc = tileDescriptor(this->descriptor, anchor.first, anchor.second);
+    desc.SetData(this->descriptor.LoadTile(anchor.first, anchor.second));
+    if (desc.Data() == nullptr)
+    {
+      gzerr << "Failed to initialize: unable to load tile [" << anchor.first
+            << ", " << anchor.second << "] of tiled heightmap." << std::endl;
+      return;
+    }
+  }
 
-  // The position's Y sign ends up flipped
-  math::Vector3d center(
-      this->descriptor.Position().X(),
-      -this->descriptor.Position().Y(),
-      this->descriptor.Position().Z() + size.Z() * 0.5 + minElevation);
+  double minElevation = 0.0;
+  if (!loadHeights(desc, Ogre2RenderEngine::Instance()->HeightmapCacheDir(),
+      true, true, this->dataPtr->heights, this->dataPtr->dataSize,
+      minElevation))
+  {
+    return;
+  }
 
+  auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
   Ogre::Root *ogreRoot = Ogre2RenderEngine::Instance()->OgreRoot();
-  Ogre::SceneManager *ogreSceneManager = ogreScene->OgreSceneManager();
-  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
-
-  // TODO(anyone): Gazebo doesn't support SCENE_STATIC scene nodes
-  this->dataPtr->terra =
-      std::make_unique<Ogre::Terra>(
-        Ogre::Id::generateNewId<Ogre::MovableObject>(),
-        &ogreSceneManager->_getEntityMemoryManager(
-          Ogre::/*SCENE_STATIC*/SCENE_DYNAMIC),
-        ogreSceneManager, 11u, ogreCompMgr, nullptr, true );
-
-  // Does not cast shadows because it uses a raymarching implementation
-  // instead of shadow maps. It does receive shadows from shadow maps though
-  this->dataPtr->terra->setCastShadows(false);
-  this->dataPtr->terra->load(
-        image,
-        Ogre2Conversions::Convert(center),
-        Ogre2Conversions::Convert(size),
-        false,
-        false,
-        this->descriptor.Name());
+
+  this->dataPtr->terra = createTerra(desc, this->dataPtr->heights,
+      this->dataPtr->dataSize, minElevation, ogreScene->OgreSceneManager());
+  this->dataPtr->activeTerra = this->dataPtr->terra.get();
   this->dataPtr->autoSkirtValue =
       this->dataPtr->terra->getCustomSkirtMinHeight();
   this->dataPtr->terra->setDatablock(
         ogreRoot->getHlmsManager()->
         getHlms(Ogre::HLMS_USER3)->getDefaultDatablock());
 
+  // texture sizes are relative to a tile of tiled heightmaps
+  const math::Vector3d size = desc.Size();
+
   Ogre::Hlms *hlmsTerra =
           ogreRoot->getHlmsManager()->getHlms(Ogre::HLMS_USER3);
 
@@ -376,6 +810,7 @@ void Ogre2Heightmap::Init()
   }
 
   this->dataPtr->terra->setDatablock(datablock);
+  this->dataPtr->datablock = datablock;
 
   gzmsg << "Loading heightmap: " << this->descriptor.Name() << std::endl;
   auto time = std::chrono::steady_clock::now();
@@ -394,15 +829,11 @@ void Ogre2Heightmap::PreRender()
 ///////////////////////////////////////////////////
 void Ogre2Heightmap::UpdateForRender(Ogre::Camera *_activeCamera)
 {
-  if (this->dataPtr->skirtMinHeight >= 0)
+  if (this->descriptor.TileColumns() > 0u)
   {
-    this->dataPtr->terra->setCustomSkirtMinHeight(
-          this->dataPtr->skirtMinHeight);
-  }
-  else
-  {
-    this->dataPtr->terra->setCustomSkirtMinHeight(
-          this->dataPtr->autoSkirtValue);
+    auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+    this->dataPtr->UpdateTiles(this->descriptor, _activeCamera,
+        ogreScene->OgreSceneManager());
   }
 
   // Get the first directional light
@@ -417,16 +848,24 @@ void Ogre2Heightmap::UpdateForRender(Ogre::Camera *_activeCamera)
       break;
     }
   }
+  const Ogre::Vector3 lightDir = directionalLight ?
+      Ogre2Conversions::Convert(directionalLight->Direction()) :
+      Ogre::Vector3::NEGATIVE_UNIT_Y;
 
-  this->dataPtr->terra->setCamera(_activeCamera);
-  if (directionalLight)
-  {
-    this->dataPtr->terra->update(
-          Ogre2Conversions::Convert(directionalLight->Direction()));
-  }
-  else
+  for (Ogre::Terra *terra : this->dataPtr->Terras())
   {
-    this->dataPtr->terra->update(Ogre::Vector3::NEGATIVE_UNIT_Y);
+    if (this->dataPtr->skirtMinHeight >= 0)
+    {
+      terra->setCustomSkirtMinHeight(this->dataPtr->skirtMinHeight);
+    }
+    else if (terra == this->dataPtr->terra.get())
+    {
+      // other tiles keep the value auto-calculated when they were loaded
+      terra->setCustomSkirtMinHeight(this->dataPtr->autoSkirtValue);
+    }
+
+    terra->setCamera(_activeCamera);
+    terra->update(lightDir);
   }
 }
 
@@ -451,5 +890,21 @@ MaterialPtr Ogre2Heightmap::Material() const
 //////////////////////////////////////////////////
 Ogre::Terra* Ogre2Heightmap::Terra()
 {
+  if (this->descriptor.TileColumns() > 0u)
+    return this->dataPtr->activeTerra;
   return this->dataPtr->terra.get();
 }
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::SetSolidColor(size_t _idx, const Ogre::Vector4 &_color)
+{
+  for (Ogre::Terra *terra : this->dataPtr->Terras())
+    terra->SetSolidColor(_idx, _color);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Heightmap::UnsetSolidColors()
+{
+  for (Ogre::Terra *terra : this->dataPtr->Terras())
+    terra->UnsetSolidColors();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/common/Console.hh>
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Util.hh>
+#include <gz/common/Uuid.hh>
+#include <gz/common/geospatial/HeightmapData.hh>
+
+#include "Ogre2HeightmapCache.hh"
+#include "Ogre2MappedFile.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Magic number at the start of every cache file
+  const uint32_t kMagic = 0x484d5a47u;
+
+  /// \brief Version of the cache file format. Bump it whenever the format
+  /// or the preprocessing done by Ogre2Heightmap changes.
+  const uint32_t kVersion = 1u;
+
+  /// \brief Extension of cache files
+  const char kExtension[] = ".gzheightmap";
+
+  //////////////////////////////////////////////////
+  /// \brief Write a value to a stream
+  /// \param[in,out] _stream Stream to write to
+  /// \param[in] _value Value to write
+  template <typename T>
+  void write(std::ostream &_stream, const T &_value)
+  {
+    _stream.write(reinterpret_cast<const char *>(&_value), sizeof(T));
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2HeightmapCache::Hash(const HeightmapDescriptor &_desc)
+{
+  auto data = _desc.Data();
+  if (!data || data->Filename().empty())
+    return std::string();
+
+  Ogre2MappedFile file(data->Filename());
+  if (!file.data)
+    return std::string();
+
+  // hash the options first, then the file content
+  std::string options;
+  auto append = [&options](const auto &_value)
+  {
+    options.append(reinterpret_cast<const char *>(&_value), sizeof(_value));
+  };
+  append(kVersion);
+  append(data->Width());
+  append(data->Height());
+  append(data->MinElevation());
+  append(data->MaxElevation());
+  append(_desc.Sampling());
+  append(_desc.Size().X());
+  append(_desc.Size().Y());
+  append(_desc.Size().Z());
+
+  return common::sha1(common::sha1(options) +
+      common::sha1(file.data, file.size));
+}
+
+//////////////////////////////////////////////////
+bool Ogre2HeightmapCache::Read(const std::string &_dir,
+    const std::string &_hash, Ogre2HeightmapData &_data)
+{
+  std::string path = common::joinPaths(_dir, _hash + kExtension);
+  Ogre2MappedFile file(path);
+  if (!file.data)
+    return false;
+
+  uint32_t magic = 0u;
+  uint32_t version = 0u;
+  if (!file.Read(magic) || magic != kMagic ||
+      !file.Read(version) || version != kVersion)
+  {
+    gzwarn << "Ignoring heightmap cache file with unknown format [" << path
+           << "]" << std::endl;
+    return false;
+  }
+
+  Ogre2HeightmapData data;
+  uint32_t size = 0u;
+  bool valid = file.Read(size) && file.Read(data.minElevation) &&
+      file.Read(data.maxElevation) &&
+      static_cast<uint64_t>(size) * size <= file.size / sizeof(float);
+  if (valid)
+  {
+    data.size = size;
+    data.heights.resize(static_cast<std::size_t>(size) * size);
+    valid = file.ReadArray(data.heights.data(), data.heights.size());
+  }
+
+  if (!valid || data.heights.empty())
+  {
+    gzwarn << "Ignoring truncated heightmap cache file [" << path << "]"
+           << std::endl;
+    return false;
+  }
+
+  _data = std::move(data);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2HeightmapCache::Write(const std::string &_dir,
+    const std::string &_hash, const Ogre2HeightmapData &_data)
+{
+  if (!common::isDirectory(_dir) && !common::createDirectories(_dir))
+  {
+    gzerr << "Unable to create heightmap cache directory [" << _dir << "]"
+           << std::endl;
+    return false;
+  }
+
+  // write to a unique temporary file first so readers never see a
+  // partially written entry
+  std::string path = common::joinPaths(_dir, _hash + kExtension);
+  std::string tmpPath = path + "." + common::Uuid().String() + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    write(file, kMagic);
+    write(file, kVersion);
+    write(file, static_cast<uint32_t>(_data.size));
+    write(file, _data.minElevation);
+    write(file, _data.maxElevation);
+    file.write(reinterpret_cast<const char *>(_data.heights.data()),
+        static_cast<std::streamsize>(_data.heights.size() * sizeof(float)));
+    if (!file)
+    {
+      gzerr << "Unable to write heightmap cache file [" << tmpPath << "]"
+             << std::endl;
+      file.close();
+      common::removeFile(tmpPath);
+      return false;
+    }
+  }
+
+  if (!common::moveFile(tmpPath, path))
+  {
+    common::removeFile(tmpPath);
+    return false;
+  }
+  return true;
+}
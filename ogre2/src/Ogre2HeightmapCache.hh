@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2HEIGHTMAPCACHE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2HEIGHTMAPCACHE_HH_
+
+#include <string>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/HeightmapDescriptor.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Heightfield of a heightmap, ready to be loaded by Terra
+struct Ogre2HeightmapData
+{
+  /// \brief Heights normalized to [0, 1], row major
+  std::vector<float> heights;
+
+  /// \brief Number of samples along each side
+  unsigned int size = 0u;
+
+  /// \brief Elevation of a normalized height of 0
+  double minElevation = 0.0;
+
+  /// \brief Elevation of a normalized height of 1
+  double maxElevation = 0.0;
+};
+
+/// \brief On-disk cache of preprocessed heightmaps. Each heightfield is
+/// stored in a flat binary file named after a SHA1 hash of the source
+/// image or DEM file and of the descriptor options that affect sampling,
+/// so a heightmap whose file changes gets a new entry. Files are written
+/// to a temporary name and renamed so concurrent writers never produce
+/// partial entries. All functions are safe to call from any thread.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2HeightmapCache
+{
+  /// \brief Compute the cache key of a heightmap
+  /// \param[in] _desc Heightmap descriptor
+  /// \return SHA1 hash of the source file and sampling options, or an
+  /// empty string if the heightmap was not loaded from a file
+  public: static std::string Hash(const HeightmapDescriptor &_desc);
+
+  /// \brief Read a cache entry. The file is memory mapped where supported.
+  /// \param[in] _dir Cache directory
+  /// \param[in] _hash Cache key returned by Hash
+  /// \param[out] _data Heightfield
+  /// \return True if the entry exists and is valid
+  public: static bool Read(const std::string &_dir, const std::string &_hash,
+      Ogre2HeightmapData &_data);
+
+  /// \brief Write a cache entry
+  /// \param[in] _dir Cache directory, created if missing
+  /// \param[in] _hash Cache key returned by Hash
+  /// \param[in] _data Heightfield
+  /// \return True on success
+  public: static bool Write(const std::string &_dir, const std::string &_hash,
+      const Ogre2HeightmapData &_data);
+};
+}
+}
+}
+#endif
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Image.hh>
+#include <gz/common/TempDirectory.hh>
+#include <gz/common/geospatial/ImageHeightmap.hh>
+
+#include "gz/rendering/Heightmap.hh"
+#include "gz/rendering/HeightmapDescriptor.hh"
+#include "gz/rendering/Scene.hh"
+
+#include "Ogre2HeightmapCache.hh"
+#include "Ogre2RenderingTest.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Write a grayscale heightmap image
+/// \param[in] _path Path of the image
+/// \param[in] _size Number of pixels along each side
+/// \param[in] _peak Value of the center pixel, the others are 0
+/// \return Descriptor of a heightmap loaded from the image
+HeightmapDescriptor writeHeightmap(const std::string &_path,
+    unsigned int _size, unsigned char _peak)
+{
+  std::vector<unsigned char> pixels(_size * _size, 0u);
+  pixels[(_size / 2u) * _size + _size / 2u] = _peak;
+  common::Image image;
+  image.SetFromData(pixels.data(), _size, _size, common::Image::L_INT8);
+  image.SavePNG(_path);
+
+  auto data = std::make_shared<common::ImageHeightmap>();
+  data->Load(_path);
+  HeightmapDescriptor desc;
+  desc.SetName("heightmap");
+  desc.SetData(data);
+  desc.SetSize({16, 16, 4});
+  desc.SetSampling(1u);
+  return desc;
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2HeightmapCache, RoundTrip)
+{
+  common::TempDirectory tempDir("ogre2_heightmap_cache");
+  std::string cacheDir = common::joinPaths(tempDir.Path(), "cache");
+  std::string imagePath = common::joinPaths(tempDir.Path(), "heights.png");
+  HeightmapDescriptor desc = writeHeightmap(imagePath, 17u, 255u);
+
+  // heightmaps not loaded from a file have no key
+  EXPECT_TRUE(Ogre2HeightmapCache::Hash(HeightmapDescriptor()).empty());
+
+  std::string hash = Ogre2HeightmapCache::Hash(desc);
+  ASSERT_FALSE(hash.empty());
+  EXPECT_EQ(hash, Ogre2HeightmapCache::Hash(desc));
+
+  Ogre2HeightmapData data;
+  EXPECT_FALSE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+
+  Ogre2HeightmapData written;
+  written.size = 4u;
+  written.minElevation = -1.5;
+  written.maxElevation = 3.25;
+  for (unsigned int i = 0u; i < written.size * written.size; ++i)
+    written.heights.push_back(static_cast<float>(i) / 15.0f);
+  ASSERT_TRUE(Ogre2HeightmapCache::Write(cacheDir, hash, written));
+
+  // the entry reads back identical, with no temporary file left behind
+  ASSERT_TRUE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+  EXPECT_EQ(written.size, data.size);
+  EXPECT_DOUBLE_EQ(written.minElevation, data.minElevation);
+  EXPECT_DOUBLE_EQ(written.maxElevation, data.maxElevation);
+  EXPECT_EQ(written.heights, data.heights);
+  std::vector<std::string> files;
+  for (common::DirIter it(cacheDir); it != common::DirIter(); ++it)
+    files.push_back(common::basename(*it));
+  ASSERT_EQ(1u, files.size());
+  EXPECT_EQ(0u, files[0].find(hash));
+  EXPECT_EQ(std::string::npos, files[0].find(".tmp"));
+
+  // truncated and foreign files are rejected
+  std::string entry = common::joinPaths(cacheDir, files[0]);
+  std::vector<char> bytes;
+  {
+    std::ifstream file(entry, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+  }
+  ASSERT_GT(bytes.size(), 8u);
+  {
+    std::ofstream file(entry, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(),
+        static_cast<std::streamsize>(bytes.size() - sizeof(float)));
+  }
+  EXPECT_FALSE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+  bytes[0] = ~bytes[0];
+  {
+    std::ofstream file(entry, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  }
+  EXPECT_FALSE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+
+  // a change of the image or of the sampling options changes the key
+  HeightmapDescriptor sampled = desc;
+  sampled.SetSampling(2u);
+  EXPECT_NE(hash, Ogre2HeightmapCache::Hash(sampled));
+  HeightmapDescriptor changed = writeHeightmap(imagePath, 17u, 128u);
+  EXPECT_NE(hash, Ogre2HeightmapCache::Hash(changed));
+}
+
+/// \brief Tests of heightmaps loaded with a heightmap cache, see
+/// Ogre2RenderEngine::HeightmapCacheDir
+class Ogre2HeightmapCacheTest : public Ogre2RenderingTest
+{
+  /// \brief Load the render engine with a heightmap cache
+  public: static void SetUpTestSuite()
+  {
+    tempDir = std::make_unique<common::TempDirectory>(
+        "ogre2_heightmap_cache_engine");
+    LoadEngine({{"heightmapCacheDir",
+        common::joinPaths(tempDir->Path(), "cache")}});
+  }
+
+  /// \brief Destroy the render engine and the cache
+  public: static void TearDownTestSuite()
+  {
+    Ogre2RenderingTest::TearDownTestSuite();
+    tempDir.reset();
+  }
+
+  /// \brief Directory of the cache and of the heightmap images
+  protected: static inline std::unique_ptr<common::TempDirectory> tempDir;
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2HeightmapCacheTest, Heightmap)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  const std::string cacheDir = engine->HeightmapCacheDir();
+  HeightmapDescriptor desc = writeHeightmap(
+      common::joinPaths(tempDir->Path(), "heights.png"), 17u, 255u);
+  const std::string hash = Ogre2HeightmapCache::Hash(desc);
+  ASSERT_FALSE(hash.empty());
+
+  // the first load samples the image and writes the entry
+  HeightmapPtr heightmap = scene->CreateHeightmap(desc);
+  ASSERT_NE(nullptr, heightmap);
+  Ogre2HeightmapData data;
+  ASSERT_TRUE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+  EXPECT_EQ(16u, data.size);
+  ASSERT_EQ(16u * 16u, data.heights.size());
+  float peak = 0.0f;
+  for (float height : data.heights)
+  {
+    EXPECT_GE(height, 0.0f);
+    EXPECT_LE(height, 1.0f);
+    peak = std::max(peak, height);
+  }
+  EXPECT_GT(peak, 0.0f);
+
+  // a later load uses the entry instead of sampling the image again, so
+  // a fake entry with the same key is not overwritten
+  Ogre2HeightmapData fake = data;
+  std::fill(fake.heights.begin(), fake.heights.end(), 0.25f);
+  ASSERT_TRUE(Ogre2HeightmapCache::Write(cacheDir, hash, fake));
+  desc.SetName("heightmap_cached");
+  HeightmapPtr cached = scene->CreateHeightmap(desc);
+  ASSERT_NE(nullptr, cached);
+  ASSERT_TRUE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+  EXPECT_EQ(fake.heights, data.heights);
+
+  // an invalid entry is replaced
+  {
+    std::ofstream file(common::joinPaths(cacheDir, hash + ".gzheightmap"),
+        std::ios::binary | std::ios::trunc);
+    file << "invalid";
+  }
+  desc.SetName("heightmap_resampled");
+  HeightmapPtr resampled = scene->CreateHeightmap(desc);
+  ASSERT_NE(nullptr, resampled);
+  ASSERT_TRUE(Ogre2HeightmapCache::Read(cacheDir, hash, data));
+  EXPECT_EQ(16u * 16u, data.heights.size());
+
+  engine->DestroyScene(scene);
+}
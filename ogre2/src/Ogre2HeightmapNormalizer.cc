@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gz/common/Console.hh>
+#include <gz/common/WorkerPool.hh>
+
+#include "Ogre2HeightmapNormalizer.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Min number of heights processed by each task. Smaller
+  /// heightmaps are processed on the calling thread.
+  const std::size_t kMinHeightsPerTask = 1u << 16u;
+
+  /// \brief Protects rowPool. Held for a whole normalization, since
+  /// WorkerPool::WaitForResults waits for the work of every caller and
+  /// each normalization already uses all the threads.
+  std::mutex rowPoolMutex;
+
+  /// \brief Threads normalizing rows, created on first use and reused by
+  /// all heightmaps
+  std::unique_ptr<common::WorkerPool> rowPool;
+
+  //////////////////////////////////////////////////
+  /// \brief Copy, sanitize and normalize a range of rows of a heightmap.
+  /// The inner loop has no branches and only tests the source samples so
+  /// compilers can vectorize it.
+  /// \param[in] _lookup Sampled heights, _srcWidth per row
+  /// \param[in] _srcWidth Number of samples per row in _lookup
+  /// \param[in] _newWidth Number of samples per row in _heights
+  /// \param[in] _beginRow First row to process
+  /// \param[in] _endRow One past the last row to process
+  /// \param[in] _minElevation Min elevation of the heightmap
+  /// \param[in] _maxElevation Max elevation of the heightmap
+  /// \param[out] _heights Normalized heights, _newWidth per row
+  /// \param[out] _stats Statistics of the processed rows
+  void processRows(const float *_lookup, unsigned int _srcWidth,
+      unsigned int _newWidth, unsigned int _beginRow, unsigned int _endRow,
+      float _minElevation, float _maxElevation, float *_heights,
+      Ogre2HeightStats &_stats)
+  {
+    const float heightDiff = _maxElevation - _minElevation;
+    const float invHeightDiff =
+        std::fabs(heightDiff) < 1e-6f ? 1.0f : (1.0f / heightDiff);
+
+    for (unsigned int y = _beginRow; y < _endRow; ++y)
+    {
+      const float *src = _lookup + static_cast<std::size_t>(y) * _srcWidth;
+      float *dst = _heights + static_cast<std::size_t>(y) * _newWidth;
+      unsigned int nonFinite = 0u;
+      unsigned int outOfBounds = 0u;
+      for (unsigned int x = 0; x < _newWidth; ++x)
+      {
+        // Sanity check in case we get NaNs from gz-common, this prevents a
+        // crash in Ogre. A float is NaN or infinite if all its exponent
+        // bits are set.
+        uint32_t bits;
+        std::memcpy(&bits, &src[x], sizeof(bits));
+        const bool finite = (bits & 0x7f800000u) != 0x7f800000u;
+        const float heightVal = finite ? src[x] : _minElevation;
+        nonFinite += !finite;
+        outOfBounds +=
+            ((src[x] < _minElevation) | (src[x] > _maxElevation)) & finite;
+        dst[x] = (heightVal - _minElevation) * invHeightDiff;
+      }
+      _stats.nonFinite += nonFinite;
+      _stats.outOfBounds += outOfBounds;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2HeightStats Ogre2HeightmapNormalizer::Normalize(const float *_lookup,
+    unsigned int _srcWidth, unsigned int _newWidth, float _minElevation,
+    float _maxElevation, float *_heights, bool _parallel)
+{
+  // split rows among threads
+  const unsigned int threadCount = _parallel ?
+      std::max(1u, std::thread::hardware_concurrency()) : 1u;
+  const unsigned int minRowsPerTask = static_cast<unsigned int>(
+      std::max<std::size_t>(1u,
+      kMinHeightsPerTask / std::max(1u, _newWidth)));
+  const unsigned int rowsPerTask = std::max(minRowsPerTask,
+      (_newWidth + threadCount - 1u) / threadCount);
+  const unsigned int taskCount =
+      (_newWidth + rowsPerTask - 1u) / rowsPerTask;
+
+  std::vector<Ogre2HeightStats> stats(std::max(1u, taskCount));
+  if (taskCount <= 1u)
+  {
+    processRows(_lookup, _srcWidth, _newWidth, 0u, _newWidth,
+        _minElevation, _maxElevation, _heights, stats[0]);
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(rowPoolMutex);
+    if (!rowPool)
+      rowPool = std::make_unique<common::WorkerPool>();
+    for (unsigned int t = 0u; t < taskCount; ++t)
+    {
+      const unsigned int begin = t * rowsPerTask;
+      const unsigned int end = std::min(begin + rowsPerTask, _newWidth);
+      rowPool->AddWork([&, t, begin, end]()
+      {
+        processRows(_lookup, _srcWidth, _newWidth, begin, end,
+            _minElevation, _maxElevation, _heights, stats[t]);
+      });
+    }
+    rowPool->WaitForResults();
+  }
+
+  // report problems once per heightmap instead of once per sample
+  Ogre2HeightStats total;
+  for (const auto &taskStats : stats)
+  {
+    total.nonFinite += taskStats.nonFinite;
+    total.outOfBounds += taskStats.outOfBounds;
+  }
+  if (total.nonFinite > 0u)
+  {
+    gzwarn << "Replaced [" << total.nonFinite << "] non finite heights "
+           << "with the min elevation [" << _minElevation << "]"
+           << std::endl;
+  }
+  if (total.outOfBounds > 0u)
+  {
+    // rare, so the observed range is only computed here
+    float lowest = _minElevation;
+    float highest = _maxElevation;
+    for (unsigned int y = 0; y < _newWidth; ++y)
+    {
+      for (unsigned int x = 0; x < _newWidth; ++x)
+      {
+        const float heightVal =
+            _lookup[static_cast<std::size_t>(y) * _srcWidth + x];
+        if (std::isfinite(heightVal))
+        {
+          lowest = std::min(lowest, heightVal);
+          highest = std::max(highest, heightVal);
+        }
+      }
+    }
+    gzerr << "Internal error: [" << total.outOfBounds << "] heights are "
+          << "out of bounds [" << _minElevation << " / " << _maxElevation
+          << "], heights span [" << lowest << " / " << highest << "]"
+          << std::endl;
+  }
+  return total;
+}
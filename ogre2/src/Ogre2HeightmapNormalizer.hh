@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2HEIGHTMAPNORMALIZER_HH_
+#define GZ_RENDERING_OGRE2_OGRE2HEIGHTMAPNORMALIZER_HH_
+
+#include <cstddef>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Statistics gathered while normalizing heights
+struct Ogre2HeightStats
+{
+  /// \brief Number of NaN or infinite heights
+  std::size_t nonFinite = 0u;
+
+  /// \brief Number of finite heights outside of the elevation range
+  std::size_t outOfBounds = 0u;
+};
+
+/// \brief Normalizes sampled heights to [0, 1], since Terra is optimized
+/// for UNORM heightmaps and has bugs with other ranges
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2HeightmapNormalizer
+{
+  /// \brief Copy, sanitize and normalize heights. Non finite heights are
+  /// replaced with the min elevation. Large heightmaps are split across a
+  /// pool of threads shared by all heightmaps, smaller ones are processed
+  /// on the calling thread. Problems are reported once per call, with
+  /// the number of heights affected.
+  /// \param[in] _lookup Sampled heights, _srcWidth per row
+  /// \param[in] _srcWidth Number of samples per row in _lookup
+  /// \param[in] _newWidth Number of rows and of samples per row kept in
+  /// _heights, the last rows and columns of _lookup are cropped if smaller
+  /// than _srcWidth
+  /// \param[in] _minElevation Elevation normalized to 0
+  /// \param[in] _maxElevation Elevation normalized to 1
+  /// \param[out] _heights Normalized heights, _newWidth * _newWidth
+  /// \param[in] _parallel False to only use the calling thread, e.g. when
+  /// called from another pool
+  /// \return Statistics of the heights
+  public: static Ogre2HeightStats Normalize(const float *_lookup,
+      unsigned int _srcWidth, unsigned int _newWidth, float _minElevation,
+      float _maxElevation, float *_heights, bool _parallel = true);
+};
+}
+}
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gz/common/Console.hh>
+#include <gz/math/Rand.hh>
+
+#include "Ogre2HeightmapNormalizer.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Count the occurrences of a string
+/// \param[in] _str String to search in
+/// \param[in] _sub String to search for
+/// \return Number of occurrences
+std::size_t countOf(const std::string &_str, const std::string &_sub)
+{
+  std::size_t result = 0u;
+  for (std::size_t pos = _str.find(_sub); pos != std::string::npos;
+      pos = _str.find(_sub, pos + _sub.size()))
+  {
+    ++result;
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Normalize heights one at a time
+/// \param[in] _lookup Sampled heights, _srcWidth per row
+/// \param[in] _srcWidth Number of samples per row in _lookup
+/// \param[in] _newWidth Number of rows and samples per row kept
+/// \param[in] _min Min elevation
+/// \param[in] _max Max elevation
+/// \return Normalized heights
+std::vector<float> scalarNormalize(const std::vector<float> &_lookup,
+    unsigned int _srcWidth, unsigned int _newWidth, float _min, float _max)
+{
+  std::vector<float> result;
+  for (unsigned int y = 0u; y < _newWidth; ++y)
+  {
+    for (unsigned int x = 0u; x < _newWidth; ++x)
+    {
+      float h = _lookup[y * _srcWidth + x];
+      if (!std::isfinite(h))
+        h = _min;
+      result.push_back((h - _min) / (_max - _min));
+    }
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2HeightmapNormalizerTest, Normalize)
+{
+  // large enough to be split across threads, with the last row and
+  // column cropped
+  const unsigned int srcWidth = 1025u;
+  const unsigned int newWidth = 1024u;
+  math::Rand::Seed(3u);
+  std::vector<float> lookup(srcWidth * srcWidth);
+  for (auto &h : lookup)
+    h = static_cast<float>(math::Rand::DblUniform(-5.0, 20.0));
+
+  const std::vector<float> expected =
+      scalarNormalize(lookup, srcWidth, newWidth, -5.0f, 20.0f);
+
+  for (bool parallel : {true, false})
+  {
+    std::vector<float> heights(newWidth * newWidth, -1.0f);
+    Ogre2HeightStats stats = Ogre2HeightmapNormalizer::Normalize(
+        lookup.data(), srcWidth, newWidth, -5.0f, 20.0f, heights.data(),
+        parallel);
+    EXPECT_EQ(0u, stats.nonFinite);
+    EXPECT_EQ(0u, stats.outOfBounds);
+    ASSERT_EQ(expected.size(), heights.size());
+    for (std::size_t i = 0u; i < expected.size(); ++i)
+      ASSERT_NEAR(expected[i], heights[i], 1e-6f) << i;
+  }
+
+  // a flat heightmap is normalized to 0
+  std::vector<float> flat(16u, 2.0f);
+  std::vector<float> heights(16u, -1.0f);
+  Ogre2HeightmapNormalizer::Normalize(flat.data(), 4u, 4u, 2.0f, 2.0f,
+      heights.data());
+  EXPECT_EQ(std::vector<float>(16u, 0.0f), heights);
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2HeightmapNormalizerTest, Diagnostics)
+{
+  common::Console::SetVerbosity(4);
+
+  const unsigned int width = 512u;
+  std::vector<float> lookup(width * width, 1.0f);
+  for (unsigned int i = 0u; i < 100u; ++i)
+    lookup[i * 997u] = std::numeric_limits<float>::quiet_NaN();
+  for (unsigned int i = 0u; i < 10u; ++i)
+    lookup[i * 1009u + 1u] = std::numeric_limits<float>::infinity();
+  for (unsigned int i = 0u; i < 30u; ++i)
+    lookup[i * 5003u + 2u] = (i % 2u) ? 12.0f : -3.0f;
+
+  std::vector<float> heights(width * width);
+  testing::internal::CaptureStderr();
+  Ogre2HeightStats stats = Ogre2HeightmapNormalizer::Normalize(
+      lookup.data(), width, width, 0.0f, 10.0f, heights.data());
+  const std::string output = testing::internal::GetCapturedStderr();
+
+  EXPECT_EQ(110u, stats.nonFinite);
+  EXPECT_EQ(30u, stats.outOfBounds);
+
+  // one warning and one error for the whole heightmap, with the counts
+  EXPECT_EQ(1u, countOf(output, "non finite heights")) << output;
+  EXPECT_EQ(1u, countOf(output, "Replaced [110]")) << output;
+  EXPECT_EQ(1u, countOf(output, "out of bounds")) << output;
+  EXPECT_EQ(1u, countOf(output, "[30] heights")) << output;
+  EXPECT_EQ(1u, countOf(output, "heights span [-3 / 12]")) << output;
+
+  // non finite heights are replaced with the min elevation
+  EXPECT_FLOAT_EQ(0.0f, heights[0]);
+  EXPECT_FLOAT_EQ(0.0f, heights[1]);
+  EXPECT_FLOAT_EQ(0.1f, heights[width]);
+
+  // no problem, no output
+  std::fill(lookup.begin(), lookup.end(), 1.0f);
+  testing::internal::CaptureStderr();
+  stats = Ogre2HeightmapNormalizer::Normalize(lookup.data(), width, width,
+      0.0f, 10.0f, heights.data());
+  EXPECT_TRUE(testing::internal::GetCapturedStderr().empty());
+  EXPECT_EQ(0u, stats.nonFinite);
+  EXPECT_EQ(0u, stats.outOfBounds);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Image.hh>
+#include <gz/common/TempDirectory.hh>
+#include <gz/common/geospatial/ImageHeightmap.hh>
+#include <gz/math/Helpers.hh>
+
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/HeightmapDescriptor.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+#include "gz/rendering/ogre2/Ogre2Heightmap.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreSceneNode.h>
+#include "Terra/Terra.h"
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of the tiles loaded by tiled heightmaps
+class Ogre2HeightmapTest : public Ogre2RenderingTest
+{
+  /// \brief Get the column of the tile of a Terra instance, for a row of
+  /// tiles 10 m wide starting at x = -25 m
+  /// \param[in] _terra Terra instance of a tile
+  /// \return Column of the tile
+  protected: static int Column(const Ogre::Terra *_terra)
+  {
+    // Terra stores its origin Y-up, which keeps the X axis
+    const double centerX = _terra->getTerrainOriginRaw().x +
+        _terra->getXZDimensions().x * 0.5;
+    return static_cast<int>(std::floor((centerX + 25.0) / 10.0));
+  }
+
+  /// \brief Get the columns of the loaded tiles of a heightmap, which are
+  /// all attached to the node of the tile that is always loaded
+  /// \param[in] _heightmap Heightmap
+  /// \return Columns of the loaded tiles
+  protected: static std::set<int> LoadedColumns(Ogre2HeightmapPtr _heightmap)
+  {
+    std::set<int> columns;
+    Ogre::SceneNode *node =
+        _heightmap->OgreObject()->getParentSceneNode();
+    if (!node)
+      return columns;
+    for (size_t i = 0u; i < node->numAttachedObjects(); ++i)
+    {
+      Ogre::MovableObject *obj = node->getAttachedObject(i);
+      if (obj->getMovableType() == "Terra")
+        columns.insert(Column(static_cast<Ogre::Terra *>(obj)));
+    }
+    return columns;
+  }
+
+  /// \brief Render until a condition is met, as tiles are sampled on
+  /// worker threads and created over several frames
+  /// \param[in] _camera Camera to render with
+  /// \param[in] _done Condition
+  /// \return True if the condition was met
+  protected: static bool RenderUntil(CameraPtr _camera,
+      const std::function<bool()> &_done)
+  {
+    for (unsigned int i = 0u; i < 500u; ++i)
+    {
+      _camera->Update();
+      if (_done())
+        return true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2HeightmapTest, TiledHeightmap)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::TempDirectory tempDir("ogre2_heightmap");
+  const std::string imagePath =
+      common::joinPaths(tempDir.Path(), "heights.png");
+  {
+    std::vector<unsigned char> pixels(17u * 17u, 128u);
+    common::Image image;
+    image.SetFromData(pixels.data(), 17u, 17u, common::Image::L_INT8);
+    image.SavePNG(imagePath);
+  }
+  auto data = std::make_shared<common::ImageHeightmap>();
+  ASSERT_EQ(0, data->Load(imagePath));
+
+  // a row of 5 tiles 10 m wide, the tile at the center is always loaded.
+  // Tiles load within 2 m of the camera and unload past 3 m.
+  std::mutex mutex;
+  std::vector<unsigned int> requested;
+  HeightmapDescriptor desc;
+  desc.SetName("tiled");
+  desc.SetSize({50, 10, 2});
+  desc.SetSampling(1u);
+  desc.SetTileLoadDistance(2.0);
+  desc.SetTiles(5u, 1u,
+      [&](unsigned int _column, unsigned int)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        requested.push_back(_column);
+        return data;
+      });
+
+  auto heightmap = std::dynamic_pointer_cast<Ogre2Heightmap>(
+      scene->CreateHeightmap(desc));
+  ASSERT_NE(nullptr, heightmap);
+  VisualPtr vis = scene->CreateVisual();
+  vis->AddGeometry(heightmap);
+  scene->RootVisual()->AddChild(vis);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  camera->SetLocalRotation(0.0, GZ_PI * 0.5, 0.0);
+  scene->RootVisual()->AddChild(camera);
+
+  // over the center tile, its neighbours are 5 m away
+  camera->SetLocalPosition(0.0, 0.0, 20.0);
+  camera->Update();
+  EXPECT_EQ(std::set<int>({2}), LoadedColumns(heightmap));
+  EXPECT_EQ(2, Column(heightmap->Terra()));
+
+  // over tile 3, 2 m away from tile 4
+  camera->SetLocalPosition(13.0, 0.0, 20.0);
+  EXPECT_TRUE(RenderUntil(camera, [&]()
+      {
+        return LoadedColumns(heightmap) == std::set<int>({2, 3, 4});
+      }));
+  EXPECT_EQ(std::set<int>({2, 3, 4}), LoadedColumns(heightmap));
+  EXPECT_EQ(3, Column(heightmap->Terra()));
+
+  // over tile 4, 2.5 m away from tile 3 which is kept
+  camera->SetLocalPosition(17.5, 0.0, 20.0);
+  camera->Update();
+  EXPECT_EQ(std::set<int>({2, 3, 4}), LoadedColumns(heightmap));
+  EXPECT_EQ(4, Column(heightmap->Terra()));
+
+  // 4 m away from tile 3 which is unloaded
+  camera->SetLocalPosition(19.0, 0.0, 20.0);
+  camera->Update();
+  EXPECT_EQ(std::set<int>({2, 4}), LoadedColumns(heightmap));
+  EXPECT_EQ(4, Column(heightmap->Terra()));
+
+  // across the heightmap, over tile 1 and 2 m away from tile 0
+  camera->SetLocalPosition(-13.0, 0.0, 20.0);
+  EXPECT_TRUE(RenderUntil(camera, [&]()
+      {
+        return LoadedColumns(heightmap) == std::set<int>({0, 1, 2});
+      }));
+  EXPECT_EQ(std::set<int>({0, 1, 2}), LoadedColumns(heightmap));
+  EXPECT_EQ(1, Column(heightmap->Terra()));
+
+  // each tile was loaded once
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::multiset<unsigned int> columns(requested.begin(), requested.end());
+    EXPECT_EQ(std::multiset<unsigned int>({0u, 1u, 2u, 3u, 4u}), columns);
+  }
+
+  engine->DestroyScene(scene);
+}
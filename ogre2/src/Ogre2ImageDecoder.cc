@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <utility>
+
+#include "Ogre2ImageDecoder.hh"
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2RgbaImage Ogre2ImageDecoder::Rgba(const common::Image &_img)
+{
+  Ogre2RgbaImage rgba;
+  if (_img.Valid())
+  {
+    // need to be 4 channels for gpu texture
+    rgba.data = _img.RGBAData();
+    rgba.width = _img.Width();
+    rgba.height = _img.Height();
+  }
+  return rgba;
+}
+
+//////////////////////////////////////////////////
+std::shared_future<Ogre2RgbaImage> Ogre2ImageDecoder::Decode(
+    const std::string &_name, const std::string &_path)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->pending.find(_name);
+  if (it != this->pending.end())
+    return it->second;
+
+  auto task = std::make_shared<std::packaged_task<Ogre2RgbaImage()>>(
+      [_path]()
+      {
+        return Rgba(common::Image(_path));
+      });
+  std::shared_future<Ogre2RgbaImage> result = task->get_future().share();
+  this->pending[_name] = result;
+
+  if (!this->pool)
+    this->pool = std::make_unique<common::WorkerPool>();
+  this->pool->AddWork([task]() { (*task)(); });
+  return result;
+}
+
+//////////////////////////////////////////////////
+void Ogre2ImageDecoder::Release(const std::string &_name)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->pending.erase(_name);
+}
+
+//////////////////////////////////////////////////
+std::size_t Ogre2ImageDecoder::DecodeCount() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->pending.size();
+}
+
+//////////////////////////////////////////////////
+void Ogre2ImageDecoder::Clear()
+{
+  std::unique_ptr<common::WorkerPool> workers;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    workers = std::move(this->pool);
+    this->pending.clear();
+  }
+  // the pool joins its threads once their work is done
+  if (workers)
+    workers->WaitForResults();
+}
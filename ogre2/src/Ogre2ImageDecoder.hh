@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2IMAGEDECODER_HH_
+#define GZ_RENDERING_OGRE2_OGRE2IMAGEDECODER_HH_
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gz/common/Image.hh>
+#include <gz/common/WorkerPool.hh>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Decoded image with 4 channels of 8 bits per pixel
+struct Ogre2RgbaImage
+{
+  /// \brief Pixel data, top row first
+  std::vector<unsigned char> data;
+
+  /// \brief Width in pixels
+  unsigned int width = 0u;
+
+  /// \brief Height in pixels
+  unsigned int height = 0u;
+};
+
+/// \brief Decodes image files to RGBA on worker threads. It is owned by
+/// Ogre2RenderEngine, which waits for the pending decodes when it is
+/// destroyed. Decodes are keyed by texture name so materials sharing a
+/// texture share one decode.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2ImageDecoder
+{
+  /// \brief Convert an image to RGBA. Safe to call from any thread.
+  /// \param[in] _img Image to convert
+  /// \return RGBA image, empty if _img is not valid
+  public: static Ogre2RgbaImage Rgba(const common::Image &_img);
+
+  /// \brief Decode an image file on a worker thread, unless a decode of
+  /// the same texture is already pending
+  /// \param[in] _name Name of the texture
+  /// \param[in] _path Path of the image file
+  /// \return Decoded image, empty if the file can not be decoded
+  public: std::shared_future<Ogre2RgbaImage> Decode(
+      const std::string &_name, const std::string &_path);
+
+  /// \brief Forget the decode of a texture once it has been used, so
+  /// its pixels are freed
+  /// \param[in] _name Name of the texture
+  public: void Release(const std::string &_name);
+
+  /// \brief Get the number of decodes that were requested and not
+  /// released yet
+  /// \return Number of decodes
+  public: std::size_t DecodeCount() const;
+
+  /// \brief Wait for the pending decodes and forget all of them
+  public: void Clear();
+
+  /// \brief Protects pending and pool
+  private: mutable std::mutex mutex;
+
+  /// \brief Decodes by texture name
+  private: std::unordered_map<std::string, std::shared_future<Ogre2RgbaImage>>
+      pending;
+
+  /// \brief Worker threads decoding images, created on first use
+  private: std::unique_ptr<common::WorkerPool> pool;
+};
+}
+}
+}
+#endif
@@ -25,6 +25,10 @@
 #endif
 #endif
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <gz/common/Console.hh>
 
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
@@ -47,22 +51,84 @@
   #pragma warning(pop)
 #endif
 
+namespace
+{
+  /// \brief Append a point to a packed xyz vertex list
+  /// \param[in,out] _vertices Vertex list
+  /// \param[in] _pt Point to append
+  void appendPoint(std::vector<float> &_vertices,
+      const gz::math::Vector3d &_pt)
+  {
+    _vertices.push_back(static_cast<float>(_pt.X()));
+    _vertices.push_back(static_cast<float>(_pt.Y()));
+    _vertices.push_back(static_cast<float>(_pt.Z()));
+  }
+
+  /// \brief Append a copy of the last point of a packed xyz vertex list
+  /// \param[in,out] _vertices Vertex list, must not be empty
+  void repeatLastPoint(std::vector<float> &_vertices)
+  {
+    std::size_t last = _vertices.size() - 3u;
+    for (std::size_t k = 0; k < 3u; ++k)
+      _vertices.push_back(_vertices[last + k]);
+  }
+}
+
 class gz::rendering::Ogre2LidarVisualPrivate
 {
-  /// \brief Non Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> noHitRayStrips;
+  /// \brief Create a renderable and attach it to a scene node
+  /// \param[in] _scene Scene the renderable belongs to
+  /// \param[in] _node Scene node to attach the renderable to
+  /// \param[in] _type Render operation type
+  /// \param[in] _material Name of the material, empty to keep the default
+  /// \return The new renderable
+  public: std::shared_ptr<Ogre2DynamicRenderable> CreateRenderable(
+              ScenePtr _scene, Ogre::SceneNode *_node, MarkerType _type,
+              const std::string &_material)
+  {
+    auto renderable = std::make_shared<Ogre2DynamicRenderable>(_scene);
+    renderable->SetOperationType(_type);
+    if (!_material.empty())
+      renderable->SetMaterial(_scene->Material(_material), false);
+    _node->attachObject(renderable->OgreObject());
+    return renderable;
+  }
+
+  /// \brief Non hitting ray strips of all vertical layers. Layers are
+  /// joined with degenerate triangles so they are drawn in a single call.
+  public: std::shared_ptr<Ogre2DynamicRenderable> noHitRayStrips;
 
-  /// \brief Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayStrips;
+  /// \brief Hitting ray strips of all vertical layers, joined the same way
+  /// as noHitRayStrips
+  public: std::shared_ptr<Ogre2DynamicRenderable> rayStrips;
 
-  /// \brief Dead Zone Geometry DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> deadZoneRayFans;
+  /// \brief Dead zone geometry of all vertical layers as a triangle list
+  public: std::shared_ptr<Ogre2DynamicRenderable> deadZoneRayFans;
 
-  /// \brief Lidar Ray DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayLines;
+  /// \brief Ray lines of all vertical layers
+  public: std::shared_ptr<Ogre2DynamicRenderable> rayLines;
 
-  /// \brief Lidar Points DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> points;
+  /// \brief Points of all vertical layers
+  public: std::shared_ptr<Ogre2DynamicRenderable> points;
+
+  /// \brief Scratch vertex list for noHitRayStrips, kept to reuse its
+  /// memory across updates
+  public: std::vector<float> noHitRayStripVertices;
+
+  /// \brief Scratch vertex list for rayStrips
+  public: std::vector<float> rayStripVertices;
+
+  /// \brief Scratch vertex list for deadZoneRayFans
+  public: std::vector<float> deadZoneVertices;
+
+  /// \brief Scratch vertex list for rayLines
+  public: std::vector<float> rayLineVertices;
+
+  /// \brief Scratch vertex list for points
+  public: std::vector<float> pointVertices;
+
+  /// \brief Scratch color list for points
+  public: std::vector<float> pointColors;
 
   /// \brief Lidar visual type
   public: LidarVisualType lidarVisType =
@@ -110,34 +176,15 @@ void Ogre2LidarVisual::PreRender()
 void Ogre2LidarVisual::Destroy()
 {
   BaseLidarVisual::Destroy();
-  for (auto ray : this->dataPtr->noHitRayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayLines)
+  for (auto *renderable : {&this->dataPtr->noHitRayStrips,
+      &this->dataPtr->rayStrips, &this->dataPtr->rayLines,
+      &this->dataPtr->deadZoneRayFans, &this->dataPtr->points})
   {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->deadZoneRayFans)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->points)
-  {
-    ray->Clear();
-    ray.reset();
+    if (*renderable)
+    {
+      (*renderable)->Clear();
+      renderable->reset();
+    }
   }
 
   this->dataPtr->lidarPoints.clear();
@@ -187,11 +234,11 @@ void Ogre2LidarVisual::ClearPoints()
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::ClearVisualData()
 {
-  this->dataPtr->noHitRayStrips.clear();
-  this->dataPtr->deadZoneRayFans.clear();
-  this->dataPtr->rayLines.clear();
-  this->dataPtr->rayStrips.clear();
-  this->dataPtr->points.clear();
+  this->dataPtr->noHitRayStrips.reset();
+  this->dataPtr->deadZoneRayFans.reset();
+  this->dataPtr->rayLines.reset();
+  this->dataPtr->rayStrips.reset();
+  this->dataPtr->points.reset();
 }
 
 //////////////////////////////////////////////////
@@ -219,8 +266,7 @@ void Ogre2LidarVisual::Update()
 
   bool clearVisuals = false;
 
-  if (this->lidarVisualType != this->dataPtr->lidarVisType
-        || !this->displayNonHitting)
+  if (this->lidarVisualType != this->dataPtr->lidarVisType)
   {
     clearVisuals = true;
   }
@@ -265,98 +311,78 @@ void Ogre2LidarVisual::Update()
     return;
   }
 
-  // Process each point from received data
-  // Every line segment, and every triangle is saved separately,
-  // as a pointer to a DynamicLine
-  // This initializes and updates only the selected DynamicLine variables
-  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  bool showStrips =
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS;
+  bool showLines = showStrips ||
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES;
+  bool showPoints =
+      this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS;
+
+  // All vertical layers of a given type share a single renderable, so
+  // a lidar costs at most one draw call per type regardless of its number
+  // of layers. The renderables are only created when the visual type
+  // changes, after that their buffers are updated in place.
+  if (showLines && !this->dataPtr->rayLines)
   {
-    horizontalAngle = this->minHorizontalAngle;
-
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES ||
-        this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-    {
-      if (j+1 > this->dataPtr->rayLines.size())
-      {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
-
-        renderable->SetOperationType(MT_LINE_LIST);
-        MaterialPtr mat = this->Scene()->Material("Lidar/BlueRay");
-        renderable->SetMaterial(mat, false);
-
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->rayLines.push_back(renderable);
-
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_STRIP);
-          mat = this->Scene()->Material("Lidar/LightBlueStrips");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->noHitRayStrips.push_back(renderable);
-
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_FAN);
-          mat = this->Scene()->Material("Lidar/TransBlack");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->deadZoneRayFans.push_back(renderable);
-          this->dataPtr->deadZoneRayFans[j]->AddPoint(
-                      gz::math::Vector3d::Zero);
-
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_STRIP);
-          mat = this->Scene()->Material("Lidar/BlueStrips");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->rayStrips.push_back(renderable);
-        }
-      }
-    }
+    this->dataPtr->rayLines = this->dataPtr->CreateRenderable(
+        this->Scene(), this->ogreNode, MT_LINE_LIST, "Lidar/BlueRay");
+  }
+  if (showStrips && !this->dataPtr->rayStrips)
+  {
+    this->dataPtr->noHitRayStrips = this->dataPtr->CreateRenderable(
+        this->Scene(), this->ogreNode, MT_TRIANGLE_STRIP,
+        "Lidar/LightBlueStrips");
+    this->dataPtr->deadZoneRayFans = this->dataPtr->CreateRenderable(
+        this->Scene(), this->ogreNode, MT_TRIANGLE_LIST, "Lidar/TransBlack");
+    this->dataPtr->rayStrips = this->dataPtr->CreateRenderable(
+        this->Scene(), this->ogreNode, MT_TRIANGLE_STRIP, "Lidar/BlueStrips");
+  }
+  if (showPoints && !this->dataPtr->points)
+  {
+    this->dataPtr->points = this->dataPtr->CreateRenderable(
+        this->Scene(), this->ogreNode, MT_POINTS, "");
+
+    // use low level programmable material so we can customize point size
+    Ogre::Item *item =
+        dynamic_cast<Ogre::Item *>(this->dataPtr->points->OgreObject());
+    item->setCastShadows(false);
+    item->getSubItem(0)->setMaterial(this->dataPtr->pointsMat);
+  }
 
-    else if (this->dataPtr->lidarVisType ==
-                  LidarVisualType::LVT_POINTS)
-    {
-      if (j+1 > this->dataPtr->points.size())
-      {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
+  std::vector<float> &rayLineVertices = this->dataPtr->rayLineVertices;
+  std::vector<float> &rayStripVertices = this->dataPtr->rayStripVertices;
+  std::vector<float> &noHitRayStripVertices =
+      this->dataPtr->noHitRayStripVertices;
+  std::vector<float> &deadZoneVertices = this->dataPtr->deadZoneVertices;
+  std::vector<float> &pointVertices = this->dataPtr->pointVertices;
+  std::vector<float> &pointColors = this->dataPtr->pointColors;
 
-        renderable->SetOperationType(MT_POINTS);
+  // clear() keeps the capacity so steady state updates do not allocate
+  rayLineVertices.clear();
+  rayStripVertices.clear();
+  noHitRayStripVertices.clear();
+  deadZoneVertices.clear();
+  pointVertices.clear();
+  pointColors.clear();
 
-        // use low level programmable material so we can customize point size
-        Ogre::Item *item = dynamic_cast<Ogre::Item *>(renderable->OgreObject());
-        item->setCastShadows(false);
-        item->getSubItem(0)->setMaterial(this->dataPtr->pointsMat);
+  math::Color pointColor = this->Scene()->Material("Lidar/BlueRay")->Diffuse();
 
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->points.push_back(renderable);
-      }
-    }
+  // Process each point from received data
+  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  {
+    horizontalAngle = this->minHorizontalAngle;
 
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
+    // Join consecutive layers of the strips with two degenerate triangles
+    // by repeating the last vertex of the previous layer here and the first
+    // vertex of this layer below. Layers have an even number of vertices so
+    // the winding order is preserved.
+    if (showStrips && j > 0u && this->horizontalCount > 0u)
     {
-      this->dataPtr->deadZoneRayFans[j]->SetPoint(0, this->offset.Pos());
+      repeatLastPoint(rayStripVertices);
+      repeatLastPoint(noHitRayStripVertices);
     }
 
-    auto pointMat = this->Scene()->Material("Lidar/BlueRay");
-
+    gz::math::Vector3d prevStartPt;
     unsigned count = this->horizontalCount;
     // Process each ray in current scan
     for (unsigned int i = 0; i < count; ++i)
@@ -390,105 +416,78 @@ void Ogre2LidarVisual::Update()
                   (axis * noHitRange) + this->offset.Pos();
 
       // Update the lines and strips that represent each simulated ray.
-
-      // For TRIANGLE_STRIPS Lidar Visual to be displayed
-      if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-        || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
+      if (showLines && (this->displayNonHitting || !inf))
       {
-        if (i >= this->dataPtr->rayLines[j]->PointCount()/2)
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->AddPoint(startPt);
-            this->dataPtr->rayLines[j]->AddPoint(inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->AddPoint(startPt);
-            this->dataPtr->rayStrips[j]->AddPoint(inf ? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->AddPoint(startPt);
-            this->dataPtr->noHitRayStrips[j]->AddPoint(
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayLines[j]->SetPoint(i*2+1, inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayStrips[j]->SetPoint(i*2+1, inf? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2+1,
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          // Draw the triangle fan that indicates the dead zone.
-          if (i+1 >= this->dataPtr->deadZoneRayFans[j]->PointCount())
-            this->dataPtr->deadZoneRayFans[j]->AddPoint(startPt);
-          else
-            this->dataPtr->deadZoneRayFans[j]->SetPoint(i+1, startPt);
-        }
+        appendPoint(rayLineVertices, startPt);
+        appendPoint(rayLineVertices, inf ? noHitPt : pt);
       }
 
-      // For POINTS Lidar Visual to be displayed
-      else if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_POINTS)
+      if (showStrips)
       {
-        if (i >= this->dataPtr->points[j]->PointCount())
+        if (i == 0u && j > 0u)
         {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->AddPoint(inf ? noHitPt : pt,
-                pointMat->Diffuse());
-          }
+          appendPoint(rayStripVertices, startPt);
+          appendPoint(noHitRayStripVertices, startPt);
         }
-        else
+
+        appendPoint(rayStripVertices, startPt);
+        appendPoint(rayStripVertices, inf ? startPt : pt);
+
+        appendPoint(noHitRayStripVertices, startPt);
+        appendPoint(noHitRayStripVertices,
+            inf ? (this->displayNonHitting ? noHitPt : startPt) : pt);
+
+        // Draw the triangles that indicate the dead zone.
+        if (i > 0u)
         {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->SetPoint(i, inf ? noHitPt : pt);
-            this->dataPtr->points[j]->SetColor(i, pointMat->Diffuse());
-          }
+          appendPoint(deadZoneVertices, this->offset.Pos());
+          appendPoint(deadZoneVertices, prevStartPt);
+          appendPoint(deadZoneVertices, startPt);
         }
+        prevStartPt = startPt;
       }
-      horizontalAngle += this->horizontalAngleStep;
-    }
 
-    // Update the DynamicLines pointers after adding points based on type
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-      || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
-    {
-      this->dataPtr->rayLines[j]->Update();
-      if (this->dataPtr->lidarVisType ==
-                      LidarVisualType::LVT_TRIANGLE_STRIPS)
+      if (showPoints && (this->displayNonHitting || !inf))
       {
-        this->dataPtr->rayStrips[j]->Update();
-        this->dataPtr->noHitRayStrips[j]->Update();
-        this->dataPtr->deadZoneRayFans[j]->Update();
+        appendPoint(pointVertices, inf ? noHitPt : pt);
+        pointColors.push_back(pointColor.R());
+        pointColors.push_back(pointColor.G());
+        pointColors.push_back(pointColor.B());
+        pointColors.push_back(pointColor.A());
       }
-    }
-    else if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS)
-    {
-      this->dataPtr->points[j]->Update();
+      horizontalAngle += this->horizontalAngleStep;
     }
     verticalAngle += this->verticalAngleStep;
   }
 
-  if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS &&
-      !this->dataPtr->points.empty())
+  // Upload the new vertices. The renderables keep their vertex buffers as
+  // long as the number of rays does not grow past their capacity.
+  if (showLines)
+  {
+    this->dataPtr->rayLines->SetPoints(rayLineVertices.data(), nullptr,
+        rayLineVertices.size() / 3u);
+    this->dataPtr->rayLines->Update();
+  }
+  if (showStrips)
+  {
+    this->dataPtr->rayStrips->SetPoints(rayStripVertices.data(), nullptr,
+        rayStripVertices.size() / 3u);
+    this->dataPtr->rayStrips->Update();
+    this->dataPtr->noHitRayStrips->SetPoints(noHitRayStripVertices.data(),
+        nullptr, noHitRayStripVertices.size() / 3u);
+    this->dataPtr->noHitRayStrips->Update();
+    this->dataPtr->deadZoneRayFans->SetPoints(deadZoneVertices.data(),
+        nullptr, deadZoneVertices.size() / 3u);
+    this->dataPtr->deadZoneRayFans->Update();
+  }
+  if (showPoints)
+  {
+    this->dataPtr->points->SetPoints(pointVertices.data(),
+        pointColors.data(), pointVertices.size() / 3u);
+    this->dataPtr->points->Update();
+  }
+
+  if (showPoints)
   {
     // point renderables use low level materials
     // get the material and set size uniform variable
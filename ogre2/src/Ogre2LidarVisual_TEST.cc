@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "gz/rendering/LidarVisual.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/ogre2/Ogre2LidarVisual.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreSceneNode.h>
+#include <OgreSubItem.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreVertexArrayObject.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of the renderables of Ogre2LidarVisual
+class Ogre2LidarVisualTest : public Ogre2RenderingTest
+{
+  /// \brief Geometry drawn by one renderable of a lidar visual
+  protected: struct Drawn
+  {
+    /// \brief Number of vertices drawn
+    std::size_t vertexCount = 0u;
+
+    /// \brief Max distance of the vertices along the X axis
+    Ogre::Real maxX = 0;
+  };
+
+  /// \brief Get the geometry drawn by the renderables of a lidar visual
+  /// \param[in] _lidar Lidar visual
+  /// \return Drawn geometry by operation type, sorted by max distance
+  protected: static std::map<Ogre::OperationType, std::vector<Drawn>>
+      Renderables(Ogre2LidarVisualPtr _lidar)
+  {
+    std::map<Ogre::OperationType, std::vector<Drawn>> result;
+    Ogre::SceneNode *node = _lidar->Node();
+    for (size_t i = 0u; i < node->numAttachedObjects(); ++i)
+    {
+      auto *item = dynamic_cast<Ogre::Item *>(node->getAttachedObject(i));
+      if (!item || item->getNumSubItems() == 0u)
+        continue;
+      const auto &vaos =
+          item->getSubItem(0)->getSubMesh()->mVao[Ogre::VpNormal];
+      if (vaos.empty())
+        continue;
+      Drawn drawn;
+      drawn.vertexCount = vaos[0]->getPrimitiveCount();
+      drawn.maxX = item->getLocalAabb().getMaximum().x;
+      result[vaos[0]->getOperationType()].push_back(drawn);
+    }
+    for (auto &r : result)
+    {
+      std::sort(r.second.begin(), r.second.end(),
+          [](const Drawn &_a, const Drawn &_b) { return _a.maxX < _b.maxX; });
+    }
+    return result;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2LidarVisualTest, Layers)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  auto lidar =
+      std::dynamic_pointer_cast<Ogre2LidarVisual>(scene->CreateLidarVisual());
+  ASSERT_NE(nullptr, lidar);
+  scene->RootVisual()->AddChild(lidar);
+
+  // 3 layers of 4 rays, every other ray hits at 2 or 3 m
+  const unsigned int hCount = 4u;
+  const unsigned int vCount = 3u;
+  lidar->SetMinHorizontalAngle(-0.2);
+  lidar->SetMaxHorizontalAngle(0.2);
+  lidar->SetHorizontalRayCount(hCount);
+  lidar->SetMinVerticalAngle(-0.1);
+  lidar->SetMaxVerticalAngle(0.1);
+  lidar->SetVerticalRayCount(vCount);
+  lidar->SetMinRange(0.1);
+  lidar->SetMaxRange(10.0);
+  const double inf = std::numeric_limits<double>::infinity();
+  const std::vector<double> points = {
+      2.0, inf, 3.0, inf,
+      2.0, inf, 3.0, inf,
+      2.0, inf, 3.0, inf};
+  const std::size_t hitCount = 6u;
+
+  // strips of 2 vertices per ray, joined by 2 degenerate vertices between
+  // layers, and a dead zone triangle between consecutive rays
+  const std::size_t stripVertices = vCount * hCount * 2u + (vCount - 1u) * 2u;
+  const std::size_t deadZoneVertices = vCount * (hCount - 1u) * 3u;
+
+  lidar->SetType(LVT_TRIANGLE_STRIPS);
+  for (bool displayNonHitting : {true, false, true})
+  {
+    lidar->SetDisplayNonHitting(displayNonHitting);
+    lidar->SetPoints(points);
+    lidar->Update();
+
+    // a single renderable per type for all layers
+    auto drawn = Renderables(lidar);
+    ASSERT_EQ(1u, drawn[Ogre::OT_LINE_LIST].size());
+    ASSERT_EQ(2u, drawn[Ogre::OT_TRIANGLE_STRIP].size());
+    ASSERT_EQ(1u, drawn[Ogre::OT_TRIANGLE_LIST].size());
+    EXPECT_EQ(0u, drawn[Ogre::OT_POINT_LIST].size());
+
+    // lines of non hitting rays reach the max range
+    const Drawn &lines = drawn[Ogre::OT_LINE_LIST][0];
+    EXPECT_EQ((displayNonHitting ? points.size() : hitCount) * 2u,
+        lines.vertexCount);
+    if (displayNonHitting)
+      EXPECT_GT(lines.maxX, 9.0);
+    else
+      EXPECT_LT(lines.maxX, 3.1);
+
+    // the hit strip stops at hits, the no-hit strip extends to the max
+    // range only when displaying non hitting rays
+    const Drawn &hitStrip = drawn[Ogre::OT_TRIANGLE_STRIP][0];
+    const Drawn &noHitStrip = drawn[Ogre::OT_TRIANGLE_STRIP][1];
+    EXPECT_EQ(stripVertices, hitStrip.vertexCount);
+    EXPECT_EQ(stripVertices, noHitStrip.vertexCount);
+    EXPECT_GT(hitStrip.maxX, 2.9);
+    EXPECT_LT(hitStrip.maxX, 3.1);
+    if (displayNonHitting)
+      EXPECT_GT(noHitStrip.maxX, 9.0);
+    else
+      EXPECT_LT(noHitStrip.maxX, 3.1);
+
+    // the dead zone stays within the min range
+    const Drawn &deadZone = drawn[Ogre::OT_TRIANGLE_LIST][0];
+    EXPECT_EQ(deadZoneVertices, deadZone.vertexCount);
+    EXPECT_LT(deadZone.maxX, 0.11);
+  }
+
+  lidar->SetType(LVT_RAY_LINES);
+  lidar->SetPoints(points);
+  lidar->Update();
+  {
+    auto drawn = Renderables(lidar);
+    ASSERT_EQ(1u, drawn[Ogre::OT_LINE_LIST].size());
+    EXPECT_EQ(points.size() * 2u, drawn[Ogre::OT_LINE_LIST][0].vertexCount);
+    EXPECT_EQ(0u, drawn[Ogre::OT_TRIANGLE_STRIP].size());
+    EXPECT_EQ(0u, drawn[Ogre::OT_TRIANGLE_LIST].size());
+  }
+
+  lidar->SetType(LVT_POINTS);
+  for (bool displayNonHitting : {true, false})
+  {
+    lidar->SetDisplayNonHitting(displayNonHitting);
+    lidar->SetPoints(points);
+    lidar->Update();
+
+    auto drawn = Renderables(lidar);
+    ASSERT_EQ(1u, drawn[Ogre::OT_POINT_LIST].size());
+    EXPECT_EQ(0u, drawn[Ogre::OT_LINE_LIST].size());
+    EXPECT_EQ(0u, drawn[Ogre::OT_TRIANGLE_STRIP].size());
+    const Drawn &pts = drawn[Ogre::OT_POINT_LIST][0];
+    EXPECT_EQ(displayNonHitting ? points.size() : hitCount, pts.vertexCount);
+    if (displayNonHitting)
+      EXPECT_GT(pts.maxX, 9.0);
+    else
+      EXPECT_LT(pts.maxX, 3.1);
+  }
+
+  // updates with the same settings reuse the renderables
+  lidar->SetPoints(points);
+  lidar->Update();
+  EXPECT_EQ(1u, Renderables(lidar)[Ogre::OT_POINT_LIST].size());
+
+  engine->DestroyScene(scene);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <fstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include "Ogre2MappedFile.hh"
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2MappedFile::Ogre2MappedFile(const std::string &_path)
+{
+#ifndef _WIN32
+  int fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0)
+  {
+    void *addr = mmap(nullptr, static_cast<std::size_t>(st.st_size),
+        PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED)
+    {
+      this->data = static_cast<const char *>(addr);
+      this->size = static_cast<std::size_t>(st.st_size);
+    }
+  }
+  close(fd);
+#else
+  std::ifstream file(_path, std::ios::binary | std::ios::ate);
+  if (!file)
+    return;
+  this->buffer.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(this->buffer.data(), this->buffer.size()))
+    return;
+  this->data = this->buffer.data();
+  this->size = this->buffer.size();
+#endif
+}
+
+//////////////////////////////////////////////////
+Ogre2MappedFile::~Ogre2MappedFile()
+{
+#ifndef _WIN32
+  if (this->data)
+    munmap(const_cast<char *>(this->data), this->size);
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2MAPPEDFILE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MAPPEDFILE_HH_
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Read-only view of a whole file, memory mapped where supported
+/// and read into memory otherwise
+class Ogre2MappedFile
+{
+  /// \brief Constructor
+  /// \param[in] _path Path of the file
+  public: explicit Ogre2MappedFile(const std::string &_path);
+
+  /// \brief Destructor
+  public: ~Ogre2MappedFile();
+
+  /// \brief Copying is disabled, the mapping is owned by a single instance
+  public: Ogre2MappedFile(const Ogre2MappedFile &) = delete;
+
+  /// \brief Copying is disabled, the mapping is owned by a single instance
+  public: Ogre2MappedFile &operator=(const Ogre2MappedFile &) = delete;
+
+  /// \brief Read a value and advance the read offset
+  /// \param[out] _value Value read
+  /// \return False if the end of the file is reached
+  public: template <typename T> bool Read(T &_value)
+  {
+    return this->ReadArray(&_value, 1u);
+  }
+
+  /// \brief Read an array and advance the read offset
+  /// \param[out] _data Array to fill
+  /// \param[in] _count Number of elements to read
+  /// \return False if the end of the file is reached
+  public: template <typename T> bool ReadArray(T *_data, std::size_t _count)
+  {
+    if (_count > (this->size - this->offset) / sizeof(T))
+      return false;
+    std::memcpy(_data, this->data + this->offset, _count * sizeof(T));
+    this->offset += _count * sizeof(T);
+    return true;
+  }
+
+  /// \brief Start of the file content, null if the file is not readable
+  public: const char *data = nullptr;
+
+  /// \brief Size of the file
+  public: std::size_t size = 0u;
+
+  /// \brief Read offset
+  public: std::size_t offset = 0u;
+
+  /// \brief File content when the file is not memory mapped
+  private: std::vector<char> buffer;
+};
+}
+}
+}
+#endif
@@ -15,6 +15,10 @@
  *
  */
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #ifdef __APPLE__
   #define GL_SILENCE_DEPRECATION
   #include <OpenGL/gl.h>
@@ -30,6 +34,8 @@
 #include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
 
+#include "gz/rendering/base/MarkerExt.hh"
+
 #include "gz/rendering/ogre2/Ogre2Capsule.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2DynamicRenderable.hh"
@@ -51,6 +57,52 @@
   #pragma warning(pop)
 #endif
 
+namespace
+{
+/// \brief Marker extension that uploads points in bulk to the dynamic
+/// renderable of an Ogre2Marker and bounds its point count
+class Ogre2MarkerExt : public gz::rendering::MarkerExt
+{
+  /// \brief Constructor
+  /// \param[in] _marker Marker
+  /// \param[in] _renderable Dynamic renderable of the marker
+  public: Ogre2MarkerExt(gz::rendering::Marker *_marker,
+      gz::rendering::Ogre2DynamicRenderable *_renderable)
+    : MarkerExt(_marker), renderable(_renderable)
+  {
+  }
+
+  // Documentation inherited
+  public: void SetPoints(const float *_xyz, const float *_rgba,
+      std::size_t _count) override
+  {
+    this->renderable->SetPoints(_xyz, _rgba, _count);
+  }
+
+  // Documentation inherited
+  public: void SetPoints(std::vector<float> &&_xyz,
+      std::vector<float> &&_rgba) override
+  {
+    this->renderable->SetPoints(std::move(_xyz), std::move(_rgba));
+  }
+
+  // Documentation inherited
+  public: void SetMaxPointCount(unsigned int _count) override
+  {
+    this->renderable->SetMaxPointCount(_count);
+  }
+
+  // Documentation inherited
+  public: unsigned int MaxPointCount() const override
+  {
+    return this->renderable->MaxPointCount();
+  }
+
+  /// \brief Dynamic renderable of the marker
+  private: gz::rendering::Ogre2DynamicRenderable *renderable;
+};
+}
+
 class gz::rendering::Ogre2MarkerPrivate
 {
   /// \brief Marker material
@@ -65,6 +117,9 @@ class gz::rendering::Ogre2MarkerPrivate
 
   /// \brief DynamicLines Object to display
   public: std::shared_ptr<Ogre2DynamicRenderable> dynamicRenderable;
+
+  /// \brief Marker extension, see Marker::Extension
+  public: std::unique_ptr<Ogre2MarkerExt> ext;
 };
 
 using namespace gz;
@@ -136,6 +191,9 @@ void Ogre2Marker::Destroy()
     this->dataPtr->geom.reset();
   }
 
+  this->SetExtension(nullptr);
+  this->dataPtr->ext.reset();
+
   if (this->dataPtr->dynamicRenderable)
   {
     this->dataPtr->dynamicRenderable->Destroy();
@@ -198,6 +256,9 @@ void Ogre2Marker::Create()
   this->markerType = MT_NONE;
   this->dataPtr->dynamicRenderable.reset(new Ogre2DynamicRenderable(
       this->scene));
+  this->dataPtr->ext = std::make_unique<Ogre2MarkerExt>(this,
+      this->dataPtr->dynamicRenderable.get());
+  this->SetExtension(this->dataPtr->ext.get());
   if (!this->dataPtr->geom)
   {
     this->dataPtr->geom =
@@ -37,6 +37,13 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include <gz/common/Console.hh>
 #include <gz/common/Filesystem.hh>
 #include <gz/common/Image.hh>
@@ -46,9 +53,60 @@
 #include "gz/rendering/ShaderType.hh"
 #include "gz/rendering/ogre2/Ogre2Material.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
 #include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
 
+#include "Ogre2ImageDecoder.hh"
+#include "Ogre2TextureCache.hh"
+
+/// \brief A texture map whose decoding and upload is left to Ogre's texture
+/// streaming threads
+struct Ogre2StreamedTexture
+{
+  /// \brief Path of the texture file
+  std::string path;
+
+  /// \brief Name of the texture in the Ogre texture manager
+  std::string name;
+
+  /// \brief Texture unit the texture is bound to
+  Ogre::PbsTextureTypes type;
+
+  /// \brief RGBA copy of a grayscale emissive map, decoded by the image
+  /// decoder of the render engine. Invalid until the map is found to be
+  /// grayscale.
+  std::shared_future<gz::rendering::Ogre2RgbaImage> rgb;
+};
+
+/// \brief A shader param resolved to the GPU program constant it sets, so
+/// it can be updated without looking the constant up by name
+struct Ogre2ShaderParamHandle
+{
+  /// \brief Param the handle was resolved for. Params are never removed
+  /// and their address is stable, so a different address means the list
+  /// of params changed.
+  const ShaderParam *param = nullptr;
+
+  /// \brief Type of the param when the handle was resolved
+  ShaderParam::ParamType type = ShaderParam::PARAM_NONE;
+
+  /// \brief True if the param is an auto constant, which Ogre updates
+  /// itself once registered
+  bool autoConstant = false;
+
+  /// \brief True if the param has a constant in the GPU program
+  bool found = false;
+
+  /// \brief Physical index of the constant in the GPU program parameters
+  size_t physicalIndex = 0u;
+
+  /// \brief Texture last bound, for texture params
+  std::string texture;
+
+  /// \brief Texture coordinate set last bound, for texture params
+  uint32_t uvSetIndex = 0u;
+};
 
 /// \brief Private data for the Ogre2Material class
 class gz::rendering::Ogre2MaterialPrivate
@@ -85,6 +143,17 @@ class gz::rendering::Ogre2MaterialPrivate
   /// loaded from memory
   public: std::shared_ptr<const common::Image> lightMapData;
 
+  /// \brief True once the datablock changed since the submeshes in
+  /// sharedUsers were last bound to it
+  public: bool datablockChanged = false;
+
+  /// \brief Submeshes bound to a shared datablock with the content of
+  /// this material's datablock, see Ogre2RenderEngine::ShareMaterials
+  public: std::vector<Ogre2SubMesh *> sharedUsers;
+
+  /// \brief Streamed texture maps waiting for their metadata
+  public: std::vector<Ogre2StreamedTexture> streamedTextures;
+
   /// \brief Path to vertex shader program.
   public: std::string vertexShaderPath;
 
@@ -97,6 +166,12 @@ class gz::rendering::Ogre2MaterialPrivate
   /// \brief Parameters to be bound to the fragment shader
   public: ShaderParamsPtr fragmentShaderParams;
 
+  /// \brief Resolved shader params of each GPU program parameters object,
+  /// in the iteration order of their ShaderParams. Cleared when a shader
+  /// is set.
+  public: std::unordered_map<const Ogre::GpuProgramParameters *,
+      std::vector<Ogre2ShaderParamHandle>> shaderParamHandles;
+
   /// \brief Material to be used when rendering to special
   /// cameras (e.g. sensors) like Ogre2GpuRays,
   /// Ogre2LaserRetroMaterialSwitcher, etc
@@ -135,6 +210,154 @@ class gz::rendering::Ogre2MaterialPrivate
 using namespace gz;
 using namespace rendering;
 
+namespace
+{
+  //////////////////////////////////////////////////
+  /// \brief Look up the GPU program constant set by a shader param.
+  /// Auto constants are registered with Ogre here.
+  /// \param[in] _name Name of the param
+  /// \param[in] _param The param
+  /// \param[in] _ogreParams GPU program parameters
+  /// \param[out] _handle Resolved param
+  void resolveShaderParam(const std::string &_name,
+      const ShaderParam &_param,
+      const Ogre::GpuProgramParametersSharedPtr &_ogreParams,
+      Ogre2ShaderParamHandle &_handle)
+  {
+    _handle = Ogre2ShaderParamHandle();
+    _handle.param = &_param;
+    _handle.type = _param.Type();
+
+    auto *constantDef =
+        Ogre::GpuProgramParameters::getAutoConstantDefinition(_name);
+    if (constantDef)
+    {
+      _ogreParams->setNamedAutoConstant(_name, constantDef->acType);
+      _handle.autoConstant = true;
+      return;
+    }
+
+    const Ogre::GpuConstantDefinition *def =
+        _ogreParams->_findNamedConstantDefinition(_name);
+    if (def)
+    {
+      _handle.found = true;
+      _handle.physicalIndex = def->physicalIndex;
+      return;
+    }
+
+    // only GLSL sets texture units through a constant
+    bool texture = ShaderParam::PARAM_TEXTURE == _handle.type ||
+        ShaderParam::PARAM_TEXTURE_CUBE == _handle.type;
+    if (texture &&
+        Ogre2RenderEngine::Instance()->GraphicsAPI() != GraphicsAPI::OPENGL)
+    {
+      _handle.found = true;
+      return;
+    }
+
+    gzwarn << "Unable to find GPU program parameter: " << _name << std::endl;
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Create an RGB copy of a grayscale texture. Grayscale emissive
+  /// maps are otherwise rendered red.
+  /// \param[in] _textureMgr Ogre texture manager
+  /// \param[in] _img Image converted to RGBA
+  /// \param[in] _name Name of the RGB texture
+  /// \param[in] _srgb True to load the texture as sRGB
+  void createRgbTexture(Ogre::TextureGpuManager *_textureMgr,
+      const Ogre2RgbaImage &_img, const std::string &_name, bool _srgb)
+  {
+    if (_textureMgr->findTextureNoThrow(_name))
+      return;
+
+    gzmsg << "Grayscale emissive texture detected. Converting to RGB: "
+           << _name << std::endl;
+
+    // create the gpu texture
+    Ogre::uint32 textureFlags = 0;
+    textureFlags |= Ogre::TextureFlags::AutomaticBatching;
+    if (_srgb)
+        textureFlags |= Ogre::TextureFlags::PrefersLoadingFromFileAsSRGB;
+    Ogre::TextureGpu *texture = _textureMgr->createOrRetrieveTexture(
+        _name,
+        Ogre::GpuPageOutStrategy::Discard,
+        textureFlags | Ogre::TextureFlags::ManualTexture,
+        Ogre::TextureTypes::Type2D,
+        Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME,
+        0u);
+
+    texture->setPixelFormat(Ogre::PFG_RGBA8_UNORM_SRGB);
+    texture->setTextureType(Ogre::TextureTypes::Type2D);
+    texture->setNumMipmaps(1u);
+    texture->setResolution(_img.width, _img.height);
+    texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+    texture->waitForData();
+
+    // upload raw color image data to gpu texture
+    Ogre::Image2 image;
+    image.loadDynamicImage(_img.data.data(), false, texture);
+    image.uploadTo(texture, 0, 0);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Bind a texture file to a datablock. If the texture cache is
+  /// enabled and has a GPU-ready copy of the texture, the copy is loaded
+  /// instead and keeps _name as alias. Otherwise the copy is created on a
+  /// worker thread for later loads.
+  /// \param[in] _datablock Datablock to bind the texture to
+  /// \param[in] _type Texture unit
+  /// \param[in] _path Path of the texture file
+  /// \param[in] _name Name of the texture in the Ogre texture manager
+  /// \param[in] _samplerblock Sampler of the texture
+  void bindTexture(Ogre::HlmsPbsDatablock *_datablock,
+      Ogre::PbsTextureTypes _type, const std::string &_path,
+      const std::string &_name, const Ogre::HlmsSamplerblock &_samplerblock)
+  {
+    Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+    Ogre::TextureGpuManager *textureMgr =
+        engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+    std::string cacheDir = engine->TextureCacheDir();
+
+    // reflection maps are cube maps, which are not cached
+    if (!cacheDir.empty() && _type != Ogre::PBSM_REFLECTION &&
+        !textureMgr->findTextureNoThrow(_name))
+    {
+      bool srgb = _datablock->suggestUsingSRGB(_type);
+      std::string cached = Ogre2TextureCache::Find(cacheDir, _path, srgb);
+      if (cached.empty())
+      {
+        Ogre2TextureCache::CreateAsync(cacheDir, _path, srgb);
+      }
+      else
+      {
+        auto &resourceGroupMgr = Ogre::ResourceGroupManager::getSingleton();
+        if (!resourceGroupMgr.resourceLocationExists(cacheDir))
+        {
+          resourceGroupMgr.addResourceLocation(
+              cacheDir, "FileSystem", "General");
+        }
+
+        Ogre::uint32 textureFlags = Ogre::TextureFlags::AutomaticBatching;
+        if (srgb)
+          textureFlags |= Ogre::TextureFlags::PrefersLoadingFromFileAsSRGB;
+        Ogre::TextureGpu *texture = textureMgr->createOrRetrieveTexture(
+            cached, _name,
+            Ogre::GpuPageOutStrategy::Discard,
+            textureFlags,
+            Ogre::TextureTypes::Type2D,
+            Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME,
+            Ogre::HlmsPbsDatablock::suggestFiltersForType(_type));
+        _datablock->setTexture(_type, texture, &_samplerblock);
+        return;
+      }
+    }
+
+    _datablock->setTexture(_type, _name, &_samplerblock);
+  }
+}
+
 //////////////////////////////////////////////////
 Ogre2Material::Ogre2Material()
   : dataPtr(std::make_unique<Ogre2MaterialPrivate>())
@@ -303,6 +526,7 @@ void Ogre2Material::SetSpecular(const math::Color &_color)
 {
   this->ogreDatablock->setSpecular(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -318,6 +542,7 @@ void Ogre2Material::SetEmissive(const math::Color &_color)
 {
   this->ogreDatablock->setEmissive(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -339,6 +564,7 @@ void Ogre2Material::UpdateTransparency()
 
   // from ogre documentation: 0 = full transparency and 1 = fully opaque
   this->ogreDatablock->setTransparency(opacity, mode);
+  this->dataPtr->datablockChanged = true;
 
   // set transparent objects to be in a higher render queue group
   // so they blend properly with heightmaps (render queue 11)
@@ -383,6 +609,7 @@ void Ogre2Material::SetAlphaFromTexture(bool _enabled,
   }
   this->ogreDatablock->setAlphaTestThreshold(_alpha);
   this->ogreDatablock->setTwoSidedLighting(_twoSided);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -416,6 +643,7 @@ void Ogre2Material::SetRenderOrder(const float _renderOrder)
     macroblock.mDepthBiasConstant = _renderOrder;
   }
   this->ogreDatablock->setMacroblock(macroblock);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -428,6 +656,7 @@ bool Ogre2Material::ReceiveShadows() const
 void Ogre2Material::SetReceiveShadows(const bool _receiveShadows)
 {
   this->ogreDatablock->setReceiveShadows(_receiveShadows);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -471,6 +700,7 @@ void Ogre2Material::ClearTexture()
   this->textureName = "";
   this->dataPtr->textureData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_DIFFUSE, this->textureName);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -515,6 +745,7 @@ void Ogre2Material::ClearNormalMap()
   this->normalMapName = "";
   this->dataPtr->normalMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_NORMAL, this->normalMapName);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -564,6 +795,7 @@ void Ogre2Material::ClearRoughnessMap()
   this->roughnessMapName = "";
   this->dataPtr->roughnessMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_ROUGHNESS, this->roughnessMapName);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -613,6 +845,7 @@ void Ogre2Material::ClearMetalnessMap()
   this->metalnessMapName = "";
   this->dataPtr->metalnessMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_METALLIC, this->metalnessMapName);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -664,6 +897,7 @@ void Ogre2Material::ClearEnvironmentMap()
   this->dataPtr->environmentMapData = nullptr;
   this->ogreDatablock->setTexture(
     Ogre::PBSM_REFLECTION, this->environmentMapName);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -713,6 +947,7 @@ void Ogre2Material::ClearEmissiveMap()
   this->emissiveMapName = "";
   this->dataPtr->emissiveMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_EMISSIVE, this->emissiveMapName);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -764,6 +999,7 @@ void Ogre2Material::SetLightMap(const std::string &_name,
     this->SetTextureMapDataImpl(this->lightMapName, _img, type);
   this->ogreDatablock->setTextureUvSource(type, this->lightMapUvSet);
   this->ogreDatablock->setUseEmissiveAsLightmap(true);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -783,12 +1019,14 @@ void Ogre2Material::ClearLightMap()
   if (this->ogreDatablock->getUseEmissiveAsLightmap())
     this->ogreDatablock->setTexture(Ogre::PBSM_EMISSIVE, this->lightMapName);
   this->ogreDatablock->setUseEmissiveAsLightmap(false);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
 void Ogre2Material::SetRoughness(const float _roughness)
 {
   this->ogreDatablock->setRoughness(_roughness);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -801,6 +1039,7 @@ float Ogre2Material::Roughness() const
 void Ogre2Material::SetMetalness(const float _metalness)
 {
   this->ogreDatablock->setMetalness(_metalness);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -812,7 +1051,110 @@ float Ogre2Material::Metalness() const
 //////////////////////////////////////////////////
 void Ogre2Material::PreRender()
 {
+  this->UpdateStreamedTextures();
   this->UpdateShaderParams();
+
+  if (!this->dataPtr->datablockChanged)
+    return;
+  this->dataPtr->datablockChanged = false;
+
+  // copy on write: submeshes sharing a datablock with the previous
+  // content switch to the shared datablock matching the new content.
+  // Other users of the previous datablock are not affected.
+  std::vector<Ogre2SubMesh *> users = this->dataPtr->sharedUsers;
+  for (Ogre2SubMesh *subMesh : users)
+    subMesh->BindDatablock(this);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::AddSharedUser(Ogre2SubMesh *_subMesh)
+{
+  auto &users = this->dataPtr->sharedUsers;
+  if (std::find(users.begin(), users.end(), _subMesh) == users.end())
+    users.push_back(_subMesh);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::RemoveSharedUser(Ogre2SubMesh *_subMesh)
+{
+  auto &users = this->dataPtr->sharedUsers;
+  users.erase(std::remove(users.begin(), users.end(), _subMesh),
+      users.end());
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::UpdateStreamedTextures()
+{
+  if (this->dataPtr->streamedTextures.empty())
+    return;
+
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+      root->getRenderSystem()->getTextureGpuManager();
+
+  auto &streamed = this->dataPtr->streamedTextures;
+  for (auto it = streamed.begin(); it != streamed.end();)
+  {
+    Ogre::TextureGpu *tex = textureMgr->findTextureNoThrow(it->name);
+    // drop textures that were destroyed or replaced in the meantime
+    if (!tex || this->ogreDatablock->getTexture(it->type) != tex)
+    {
+      it = streamed.erase(it);
+      continue;
+    }
+    if (!tex->isMetadataReady())
+    {
+      ++it;
+      continue;
+    }
+
+    // grayscale emissive maps are only detected now, swap them for an RGB
+    // copy once a worker thread has decoded it
+    if (it->type == Ogre::PBSM_EMISSIVE &&
+        !this->ogreDatablock->getUseEmissiveAsLightmap() &&
+        Ogre::PixelFormatGpuUtils::getNumberOfComponents(
+        tex->getPixelFormat()) == 1u)
+    {
+      std::string rgbTexName = "gz_" + it->name;
+      if (!textureMgr->findTextureNoThrow(rgbTexName))
+      {
+        // decoded on the engine's worker threads, once for all the
+        // materials using the map
+        Ogre2ImageDecoder *decoder =
+            Ogre2RenderEngine::Instance()->ImageDecoder();
+        if (!it->rgb.valid())
+          it->rgb = decoder->Decode(it->name, it->path);
+        if (it->rgb.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready)
+        {
+          ++it;
+          continue;
+        }
+        const Ogre2RgbaImage &rgba = it->rgb.get();
+        if (rgba.data.empty())
+        {
+          gzerr << "Unable to decode texture [" << it->path << "]"
+                 << std::endl;
+          decoder->Release(it->name);
+          it = streamed.erase(it);
+          continue;
+        }
+        createRgbTexture(textureMgr, rgba, rgbTexName,
+            this->ogreDatablock->suggestUsingSRGB(it->type));
+        decoder->Release(it->name);
+      }
+      Ogre::HlmsSamplerblock samplerBlockRef;
+      samplerBlockRef.mU = Ogre::TAM_WRAP;
+      samplerBlockRef.mV = Ogre::TAM_WRAP;
+      samplerBlockRef.mW = Ogre::TAM_WRAP;
+      this->ogreDatablock->setTexture(it->type, rgbTexName, &samplerBlockRef);
+      this->dataPtr->datablockChanged = true;
+      tex = textureMgr->findTextureNoThrow(rgbTexName);
+    }
+
+    this->ApplyTextureMetadata(tex, it->type);
+    it = streamed.erase(it);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -848,38 +1190,35 @@ void Ogre2Material::UpdateShaderParams()
 void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
     Ogre::GpuProgramParametersSharedPtr _ogreParams)
 {
+  // constants are looked up by name only when params are added or change
+  // type, or when a shader is set
+  auto &handles = this->dataPtr->shaderParamHandles[_ogreParams.get()];
+  std::size_t i = 0u;
   for (const auto &name_param : *_params)
   {
-    auto *constantDef =
-        Ogre::GpuProgramParameters::getAutoConstantDefinition(name_param.first);
-    if (constantDef)
+    if (i == handles.size())
+      handles.emplace_back();
+    Ogre2ShaderParamHandle &handle = handles[i++];
+    if (handle.param != &name_param.second ||
+        handle.type != name_param.second.Type())
     {
-      _ogreParams->setNamedAutoConstant(name_param.first, constantDef->acType);
-      continue;
+      resolveShaderParam(name_param.first, name_param.second, _ogreParams,
+          handle);
     }
-
-    if (!_ogreParams->_findNamedConstantDefinition(name_param.first) &&
-        !(Ogre2RenderEngine::Instance()->GraphicsAPI() !=
-            GraphicsAPI::OPENGL &&
-            (ShaderParam::PARAM_TEXTURE == name_param.second.Type() ||
-             ShaderParam::PARAM_TEXTURE_CUBE == name_param.second.Type())))
-    {
-      gzwarn << "Unable to find GPU program parameter: "
-              << name_param.first << std::endl;
+    if (handle.autoConstant || !handle.found)
       continue;
-    }
 
     if (ShaderParam::PARAM_FLOAT == name_param.second.Type())
     {
       float value;
       name_param.second.Value(&value);
-      _ogreParams->setNamedConstant(name_param.first, value);
+      _ogreParams->_writeRawConstant(handle.physicalIndex, value);
     }
     else if (ShaderParam::PARAM_INT == name_param.second.Type())
     {
       int value;
       name_param.second.Value(&value);
-      _ogreParams->setNamedConstant(name_param.first, value);
+      _ogreParams->_writeRawConstant(handle.physicalIndex, value);
     }
     else if (ShaderParam::PARAM_FLOAT_BUFFER == name_param.second.Type())
     {
@@ -887,10 +1226,8 @@ void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
       name_param.second.Buffer(buffer);
       uint32_t count = name_param.second.Count();
 
-      // multiple other than 4 is currently only supported by GLSL
-      uint32_t multiple = 1;
-      _ogreParams->setNamedConstant(name_param.first,
-          reinterpret_cast<float*>(buffer.get()), count, multiple);
+      _ogreParams->_writeRawConstants(handle.physicalIndex,
+          reinterpret_cast<float*>(buffer.get()), count);
     }
     else if (ShaderParam::PARAM_INT_BUFFER == name_param.second.Type())
     {
@@ -898,10 +1235,8 @@ void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
       name_param.second.Buffer(buffer);
       uint32_t count = name_param.second.Count();
 
-      // multiple other than 4 is currently only supported by GLSL
-      uint32_t multiple = 1;
-      _ogreParams->setNamedConstant(name_param.first,
-        reinterpret_cast<int*>(buffer.get()), count, multiple);
+      _ogreParams->_writeRawConstants(handle.physicalIndex,
+        reinterpret_cast<int*>(buffer.get()), count);
     }
     else if (ShaderParam::PARAM_TEXTURE == name_param.second.Type() ||
              ShaderParam::PARAM_TEXTURE_CUBE == name_param.second.Type())
@@ -912,6 +1247,13 @@ void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
       name_param.second.Value(value, uvSetIndex);
       ShaderParam::ParamType type = name_param.second.Type();
 
+      // the texture unit only needs to be set up again if the texture
+      // changed
+      if (handle.texture == value && handle.uvSetIndex == uvSetIndex)
+        continue;
+      handle.texture = value;
+      handle.uvSetIndex = uvSetIndex;
+
       std::string baseName = value;
       std::string dirPath = value;
       if (common::isFile(value))
@@ -986,10 +1328,11 @@ void Ogre2Material::UpdateShaderParams(ConstShaderParamsPtr _params,
           GraphicsAPI::OPENGL)
       {
         // set the texture map index
-        _ogreParams->setNamedConstant(name_param.first, &texIndex, 1, 1);
+        _ogreParams->_writeRawConstants(handle.physicalIndex, &texIndex, 1);
       }
     }
   }
+  handles.resize(i);
 }
 
 //////////////////////////////////////////////////
@@ -1094,6 +1437,33 @@ void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
   Ogre::TextureGpuManager *textureMgr =
       root->getRenderSystem()->getTextureGpuManager();
 
+  Ogre::HlmsSamplerblock samplerBlockRef;
+  samplerBlockRef.mU = Ogre::TAM_WRAP;
+  samplerBlockRef.mV = Ogre::TAM_WRAP;
+  samplerBlockRef.mW = Ogre::TAM_WRAP;
+
+  // a new map replaces any map of the same type still streaming
+  auto &streamed = this->dataPtr->streamedTextures;
+  streamed.erase(std::remove_if(streamed.begin(), streamed.end(),
+      [_type](const Ogre2StreamedTexture &_s)
+      {
+        return _s.type == _type;
+      }), streamed.end());
+
+  // In streaming mode, bind the texture without waiting for it. Ogre
+  // decodes and uploads it on its streaming threads and the material is
+  // drawn without the map until it is resident. Decisions that depend on
+  // the pixel format are applied in PreRender once metadata arrives.
+  if (Ogre2RenderEngine::Instance()->StreamTextures())
+  {
+    bindTexture(this->ogreDatablock, _type, _texture, baseName,
+        samplerBlockRef);
+    this->dataPtr->datablockChanged = true;
+    streamed.push_back({_texture, baseName, _type});
+    this->UpdateStreamedTextures();
+    return;
+  }
+
   // workaround for grayscale emissive texture
   // convert to RGB otherwise the emissive map is rendered red
   if (_type == Ogre::PBSM_EMISSIVE &&
@@ -1105,102 +1475,58 @@ void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
     {
       std::string parentPath = common::parentPath(_texture);
       // set a custom name for the rgb texture by appending gz_ prefix
-      std::string rgbTexName = "gz_" + baseName;
-      baseName = rgbTexName;
-      auto tex = textureMgr->findTextureNoThrow(rgbTexName);
-      if (!tex)
-      {
-        gzmsg << "Grayscale emissive texture detected. Converting to RGB: "
-               << rgbTexName << std::endl;
-        // need to be 4 channels for gpu texture
-        unsigned int channels = 4u;
-        unsigned int size = img.Width() * img.Height() * channels;
-        unsigned char *data = new unsigned char[size];
-        for (unsigned int i = 0; i < img.Height(); ++i)
-        {
-          for (unsigned int j = 0; j < img.Width(); ++j)
-          {
-            // flip Y
-            math::Color c = img.Pixel(j, img.Height() - i - 1u);
-            unsigned int idx = i * img.Width() * channels + j * channels;
-            data[idx] = static_cast<uint8_t>(c.R() * 255u);
-            data[idx + 1u] = static_cast<uint8_t>(c.R() * 255u);
-            data[idx + 2u] = static_cast<uint8_t>(c.R() * 255u);
-            data[idx + 3u] = 255u;
-          }
-        }
-
-        // create the gpu texture
-        Ogre::uint32 textureFlags = 0;
-        textureFlags |= Ogre::TextureFlags::AutomaticBatching;
-        if (this->ogreDatablock->suggestUsingSRGB(_type))
-            textureFlags |= Ogre::TextureFlags::PrefersLoadingFromFileAsSRGB;
-        Ogre::TextureGpu *texture = textureMgr->createOrRetrieveTexture(
-            rgbTexName,
-            Ogre::GpuPageOutStrategy::Discard,
-            textureFlags | Ogre::TextureFlags::ManualTexture,
-            Ogre::TextureTypes::Type2D,
-            Ogre::ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME,
-            0u);
-
-        texture->setPixelFormat(Ogre::PFG_RGBA8_UNORM_SRGB);
-        texture->setTextureType(Ogre::TextureTypes::Type2D);
-        texture->setNumMipmaps(1u);
-        texture->setResolution(img.Width(), img.Height());
-        texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
-        texture->waitForData();
-
-        // upload raw color image data to gpu texture
-        Ogre::Image2 image;
-        image.loadDynamicImage(data, false, texture);
-        image.uploadTo(texture, 0, 0);
-        delete [] data;
-      }
+      baseName = "gz_" + baseName;
+      Ogre2RgbaImage rgba = Ogre2ImageDecoder::Rgba(img);
+      createRgbTexture(textureMgr, rgba, baseName,
+          this->ogreDatablock->suggestUsingSRGB(_type));
     }
   }
 
-  Ogre::HlmsSamplerblock samplerBlockRef;
-  samplerBlockRef.mU = Ogre::TAM_WRAP;
-  samplerBlockRef.mV = Ogre::TAM_WRAP;
-  samplerBlockRef.mW = Ogre::TAM_WRAP;
-
-  this->ogreDatablock->setTexture(_type, baseName, &samplerBlockRef);
+  bindTexture(this->ogreDatablock, _type, _texture, baseName,
+      samplerBlockRef);
+  this->dataPtr->datablockChanged = true;
   auto tex = textureMgr->findTextureNoThrow(baseName);
 
   if (tex)
   {
     tex->waitForMetadata();
-    this->dataPtr->hashName = tex->getName().getFriendlyText();
+    if (_type == Ogre::PBSM_DIFFUSE && (this->TextureAlphaEnabled() ||
+        Ogre::PixelFormatGpuUtils::getNumberOfComponents(
+        tex->getPixelFormat()) == 1u))
+    {
+      tex->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+      tex->waitForData();
+    }
+    this->ApplyTextureMetadata(tex, _type);
   }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::ApplyTextureMetadata(Ogre::TextureGpu *_tex,
+    Ogre::PbsTextureTypes _type)
+{
+  this->dataPtr->hashName = _tex->getName().getFriendlyText();
 
   // disable alpha from texture if texture does not have an alpha channel
   // otherwise this becomes a transparent material
   if (_type == Ogre::PBSM_DIFFUSE)
   {
     bool isGrayscale = (Ogre::PixelFormatGpuUtils::getNumberOfComponents(
-            tex->getPixelFormat()) == 1u);
+            _tex->getPixelFormat()) == 1u);
 
-    if (this->TextureAlphaEnabled() || isGrayscale)
+    // only enable alpha from texture if texture has alpha component
+    if (this->TextureAlphaEnabled() &&
+        !Ogre::PixelFormatGpuUtils::hasAlpha(_tex->getPixelFormat()))
     {
-      if (tex)
-      {
-        tex->scheduleTransitionTo(Ogre::GpuResidency::Resident);
-        tex->waitForData();
-
-        // only enable alpha from texture if texture has alpha component
-        if (this->TextureAlphaEnabled() &&
-            !Ogre::PixelFormatGpuUtils::hasAlpha(tex->getPixelFormat()))
-        {
-          this->SetAlphaFromTexture(false, this->AlphaThreshold(),
-              this->TwoSidedEnabled());
-        }
+      this->SetAlphaFromTexture(false, this->AlphaThreshold(),
+          this->TwoSidedEnabled());
+    }
 
-        // treat grayscale texture as RGB
-        if (isGrayscale)
-        {
-          this->ogreDatablock->setUseDiffuseMapAsGrayscale(true);
-        }
-      }
+    // treat grayscale texture as RGB
+    if (isGrayscale)
+    {
+      this->ogreDatablock->setUseDiffuseMapAsGrayscale(true);
+      this->dataPtr->datablockChanged = true;
     }
   }
 }
@@ -1250,6 +1576,7 @@ void Ogre2Material::SetTextureMapDataImpl(const std::string& _name,
   samplerBlockRef.mW = Ogre::TAM_WRAP;
 
   this->ogreDatablock->setTexture(_type, _name, &samplerBlockRef);
+  this->dataPtr->datablockChanged = true;
 
   auto tex = textureMgr->findTextureNoThrow(_name);
 
@@ -1319,6 +1646,7 @@ void Ogre2Material::SetDepthCheckEnabled(bool _enabled)
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthCheck = _enabled;
   this->ogreDatablock->setMacroblock(macroblock);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -1335,6 +1663,7 @@ void Ogre2Material::SetDepthWriteEnabled(bool _enabled)
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthWrite = _enabled;
   this->ogreDatablock->setMacroblock(macroblock);
+  this->dataPtr->datablockChanged = true;
 }
 
 //////////////////////////////////////////////////
@@ -1475,6 +1804,7 @@ void Ogre2Material::SetVertexShader(const std::string &_path)
 
   this->dataPtr->vertexShaderPath = _path;
   this->dataPtr->vertexShaderParams.reset(new ShaderParams);
+  this->dataPtr->shaderParamHandles.clear();
 }
 
 //////////////////////////////////////////////////
@@ -1543,6 +1873,7 @@ void Ogre2Material::SetFragmentShader(const std::string &_path)
   mat->load();
   this->dataPtr->fragmentShaderPath = _path;
   this->dataPtr->fragmentShaderParams.reset(new ShaderParams);
+  this->dataPtr->shaderParamHandles.clear();
 }
 
 //////////////////////////////////////////////////
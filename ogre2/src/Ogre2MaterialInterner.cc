@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbs.h>
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include "Ogre2MaterialInterner.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief A shared datablock
+  struct SharedDatablock
+  {
+    /// \brief The datablock
+    Ogre::HlmsPbsDatablock *datablock = nullptr;
+
+    /// \brief Number of users
+    unsigned int references = 0u;
+  };
+
+  /// \brief Shared datablocks by content key
+  std::unordered_map<std::string, SharedDatablock> sharedDatablocks;
+
+  /// \brief Counter used to name shared datablocks
+  uint64_t sharedDatablockCount = 0u;
+
+  //////////////////////////////////////////////////
+  /// \brief Append the raw bytes of a value to a key
+  /// \param[in,out] _key Key to append to
+  /// \param[in] _value Value to append
+  template <typename T>
+  void append(std::string &_key, const T &_value)
+  {
+    _key.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MaterialInterner::Key(
+    const Ogre::HlmsPbsDatablock *_datablock)
+{
+  std::string key;
+  key.reserve(512u);
+
+  // render state blocks are already shared by the Hlms manager so their
+  // addresses identify their content
+  append(key, _datablock->getMacroblock(false));
+  append(key, _datablock->getMacroblock(true));
+  append(key, _datablock->getBlendblock(false));
+  append(key, _datablock->getBlendblock(true));
+  append(key, _datablock->mShadowConstantBias);
+
+  append(key, _datablock->getWorkflow());
+  append(key, _datablock->getBrdf());
+  append(key, _datablock->getDiffuse());
+  append(key, _datablock->getBackgroundDiffuse());
+  append(key, _datablock->getSpecular());
+  append(key, _datablock->getEmissive());
+  append(key, _datablock->getRoughness());
+  append(key, _datablock->getMetalness());
+  append(key, _datablock->getFresnel());
+  append(key, _datablock->hasSeparateFresnel());
+  append(key, _datablock->getTransparency());
+  append(key, _datablock->getTransparencyMode());
+  append(key, _datablock->getUseAlphaFromTextures());
+  append(key, _datablock->getAlphaTest());
+  append(key, _datablock->getAlphaTestThreshold());
+  append(key, _datablock->getAlphaTestShadowCasterOnly());
+  append(key, _datablock->getTwoSidedLighting());
+  append(key, _datablock->getReceiveShadows());
+  append(key, _datablock->getUseEmissiveAsLightmap());
+  append(key, _datablock->getUseDiffuseMapAsGrayscale());
+  append(key, _datablock->getNormalMapWeight());
+  for (Ogre::uint8 i = 0u; i < 4u; ++i)
+  {
+    append(key, _datablock->getDetailMapBlendMode(i));
+    append(key, _datablock->getDetailMapWeight(i));
+    append(key, _datablock->getDetailNormalWeight(i));
+    append(key, _datablock->getDetailMapOffsetScale(i));
+  }
+  for (Ogre::uint8 i = 0u; i < 3u; ++i)
+    append(key, _datablock->getUserValue(i));
+  append(key, _datablock->getCubemapProbe());
+
+  // textures and samplers are shared by their managers as well
+  for (Ogre::uint8 i = 0u; i < Ogre::NUM_PBSM_TEXTURE_TYPES; ++i)
+  {
+    auto type = static_cast<Ogre::PbsTextureTypes>(i);
+    append(key, _datablock->getTexture(type));
+    append(key, _datablock->getSamplerblock(type));
+    append(key, _datablock->getTextureUvSource(type));
+  }
+
+  return key;
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsPbsDatablock *Ogre2MaterialInterner::Acquire(
+    const Ogre::HlmsPbsDatablock *_datablock, const std::string &_key)
+{
+  SharedDatablock &shared = sharedDatablocks[_key];
+  if (!shared.datablock)
+  {
+    std::string name = "gz::SharedDatablock::" +
+        std::to_string(sharedDatablockCount++);
+    shared.datablock = static_cast<Ogre::HlmsPbsDatablock *>(
+        _datablock->clone(name));
+  }
+  ++shared.references;
+  return shared.datablock;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialInterner::Release(const std::string &_key)
+{
+  auto it = sharedDatablocks.find(_key);
+  if (it == sharedDatablocks.end())
+    return;
+
+  if (--it->second.references == 0u)
+  {
+    // renderables are still linked when their item outlives the submesh,
+    // e.g. at shutdown. The datablock is then left to the Hlms.
+    Ogre::HlmsPbsDatablock *datablock = it->second.datablock;
+    if (datablock->getLinkedRenderables().empty())
+      datablock->getCreator()->destroyDatablock(datablock->getName());
+    sharedDatablocks.erase(it);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MaterialInterner::Clear()
+{
+  sharedDatablocks.clear();
+}
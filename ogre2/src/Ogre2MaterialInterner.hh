@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2MATERIALINTERNER_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MATERIALINTERNER_HH_
+
+#include <string>
+
+#include "gz/rendering/config.hh"
+
+namespace Ogre
+{
+  class HlmsPbsDatablock;
+}
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Interns Pbs datablocks by content. Materials whose datablocks
+/// have identical properties (colors, textures, samplers, PBR parameters
+/// and render state) get a single shared datablock, so their renderables
+/// can be batched and their constants are uploaded once. Shared datablocks
+/// are immutable and reference counted; a user that changes its material
+/// acquires the shared datablock matching the new content instead, leaving
+/// the other users untouched. Must be called from the render thread.
+class Ogre2MaterialInterner
+{
+  /// \brief Compute the content key of a datablock
+  /// \param[in] _datablock Datablock
+  /// \return Key, equal for datablocks that render identically
+  public: static std::string Key(const Ogre::HlmsPbsDatablock *_datablock);
+
+  /// \brief Get the shared datablock with the content of a datablock,
+  /// creating it if needed, and add a reference to it
+  /// \param[in] _datablock Datablock whose content to share
+  /// \param[in] _key Content key of _datablock returned by Key
+  /// \return Shared datablock
+  public: static Ogre::HlmsPbsDatablock *Acquire(
+      const Ogre::HlmsPbsDatablock *_datablock, const std::string &_key);
+
+  /// \brief Remove a reference to a shared datablock, destroying it when
+  /// no reference remains. The datablock must no longer be used by any
+  /// renderable.
+  /// \param[in] _key Content key the datablock was acquired with
+  public: static void Release(const std::string &_key);
+
+  /// \brief Forget all shared datablocks without destroying them. Called
+  /// on shutdown, when the Hlms destroys the remaining datablocks.
+  public: static void Clear();
+};
+}
+}
+}
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "gz/rendering/MeshDescriptor.hh"
+#include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <OgreSubItem.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of datablocks shared between identical materials, see
+/// Ogre2RenderEngine::ShareMaterials
+class Ogre2MaterialShareTest : public Ogre2RenderingTest
+{
+  /// \brief Load the render engine with material sharing
+  public: static void SetUpTestSuite()
+  {
+    LoadEngine({{"shareMaterials", "1"}});
+  }
+
+  /// \brief Get the datablock bound to the first submesh of a mesh
+  /// \param[in] _mesh Mesh
+  /// \return The datablock, null if not found
+  protected: static Ogre::HlmsDatablock *Bound(MeshPtr _mesh)
+  {
+    auto subMesh =
+        std::dynamic_pointer_cast<Ogre2SubMesh>(_mesh->SubMeshByIndex(0u));
+    if (!subMesh || !subMesh->Ogre2SubItem())
+      return nullptr;
+    return subMesh->Ogre2SubItem()->getDatablock();
+  }
+
+  /// \brief Get the datablock of the material of the first submesh of a
+  /// mesh
+  /// \param[in] _mesh Mesh
+  /// \return The datablock, null if not found
+  protected: static Ogre::HlmsPbsDatablock *Own(MeshPtr _mesh)
+  {
+    auto material = std::dynamic_pointer_cast<Ogre2Material>(
+        _mesh->SubMeshByIndex(0u)->Material());
+    return material ? material->Datablock() : nullptr;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialShareTest, CopyOnWrite)
+{
+  ASSERT_TRUE(engine->ShareMaterials());
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(1.0, 0.0, 0.0);
+  material->SetRoughness(0.3f);
+
+  // each submesh gets its own clone of the material, both clones are
+  // bound to one shared datablock
+  MeshPtr meshA = scene->CreateMesh(MeshDescriptor("unit_box"));
+  MeshPtr meshB = scene->CreateMesh(MeshDescriptor("unit_box"));
+  ASSERT_NE(nullptr, meshA);
+  ASSERT_NE(nullptr, meshB);
+  meshA->SetMaterial(material);
+  meshB->SetMaterial(material);
+  ASSERT_NE(meshA->SubMeshByIndex(0u)->Material(),
+      meshB->SubMeshByIndex(0u)->Material());
+
+  Ogre::HlmsDatablock *shared = Bound(meshA);
+  ASSERT_NE(nullptr, shared);
+  EXPECT_EQ(shared, Bound(meshB));
+  EXPECT_NE(shared, Own(meshA));
+  EXPECT_NE(shared, Own(meshB));
+
+  // a change is applied on the next PreRender and only moves the changed
+  // submesh to another datablock
+  meshA->SubMeshByIndex(0u)->Material()->SetDiffuse(0.0, 1.0, 0.0);
+  EXPECT_EQ(shared, Bound(meshA));
+  meshA->PreRender();
+  meshB->PreRender();
+  Ogre::HlmsDatablock *changed = Bound(meshA);
+  ASSERT_NE(nullptr, changed);
+  EXPECT_NE(shared, changed);
+  EXPECT_NE(Own(meshA), changed);
+  EXPECT_EQ(shared, Bound(meshB));
+  EXPECT_EQ(Ogre::Vector3(0.0f, 1.0f, 0.0f),
+      static_cast<Ogre::HlmsPbsDatablock *>(changed)->getDiffuse());
+  EXPECT_EQ(Ogre::Vector3(1.0f, 0.0f, 0.0f),
+      static_cast<Ogre::HlmsPbsDatablock *>(shared)->getDiffuse());
+
+  // reverting the change shares the datablock again
+  meshA->SubMeshByIndex(0u)->Material()->SetDiffuse(1.0, 0.0, 0.0);
+  meshA->PreRender();
+  EXPECT_EQ(shared, Bound(meshA));
+
+  // submeshes that are not shareable bind their own datablock
+  auto subMeshB =
+      std::dynamic_pointer_cast<Ogre2SubMesh>(meshB->SubMeshByIndex(0u));
+  ASSERT_NE(nullptr, subMeshB);
+  subMeshB->Unshare();
+  EXPECT_EQ(Own(meshB), Bound(meshB));
+  EXPECT_EQ(shared, Bound(meshA));
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialShareTest, ClonedState)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // materials that only differ in datablock state without a gz setter
+  // must not share a datablock, as the clone would lose the difference
+  auto materialA =
+      std::dynamic_pointer_cast<Ogre2Material>(scene->CreateMaterial());
+  auto materialB =
+      std::dynamic_pointer_cast<Ogre2Material>(scene->CreateMaterial());
+  ASSERT_NE(nullptr, materialA);
+  ASSERT_NE(nullptr, materialB);
+  materialB->Datablock()->setUserValue(0u, Ogre::Vector4(1, 2, 3, 4));
+
+  MeshPtr meshA = scene->CreateMesh(MeshDescriptor("unit_box"));
+  MeshPtr meshB = scene->CreateMesh(MeshDescriptor("unit_box"));
+  ASSERT_NE(nullptr, meshA);
+  ASSERT_NE(nullptr, meshB);
+  meshA->SetMaterial(materialA, false);
+  meshB->SetMaterial(materialB, false);
+
+  ASSERT_NE(nullptr, Bound(meshB));
+  EXPECT_NE(Bound(meshA), Bound(meshB));
+  EXPECT_EQ(Ogre::Vector4(1, 2, 3, 4),
+      static_cast<Ogre::HlmsPbsDatablock *>(Bound(meshB))->getUserValue(0u));
+
+  engine->DestroyScene(scene);
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/TempDirectory.hh>
+
+#include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2ImageDecoder.hh"
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <OgreRenderSystem.h>
+#include <OgreRoot.h>
+#include <OgreTextureGpuManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of materials whose texture maps are streamed, see
+/// Ogre2RenderEngine::StreamTextures. Streamed maps must end up identical
+/// to the ones Ogre2Material_TEST loads synchronously.
+class Ogre2MaterialStreamTest : public Ogre2RenderingTest
+{
+  /// \brief Load the render engine with texture streaming
+  public: static void SetUpTestSuite()
+  {
+    LoadEngine({{"streamTextures", "1"}});
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialStreamTest, GrayscaleEmissiveMap)
+{
+  ASSERT_TRUE(engine->StreamTextures());
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::TempDirectory tempDir("ogre2_material_stream");
+  std::string path =
+      WriteGrayImage(tempDir.Path(), "gray_emissive.png", 4u, 5u);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetEmissiveMap(path);
+  auto ogreMaterial = std::dynamic_pointer_cast<Ogre2Material>(material);
+  ASSERT_NE(nullptr, ogreMaterial);
+
+  // the map is replaced by an RGB copy once Ogre has loaded its metadata
+  // and a worker thread has decoded it
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  Ogre::TextureGpu *texture = nullptr;
+  for (unsigned int i = 0u; i < 100u; ++i)
+  {
+    textureMgr->waitForStreamingCompletion();
+    material->PreRender();
+    texture = ogreMaterial->Datablock()->getTexture(Ogre::PBSM_EMISSIVE);
+    if (texture && texture->getNameStr().rfind("gz_", 0u) == 0u)
+      break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // with the same orientation as the image file
+  ASSERT_NE(nullptr, texture);
+  EXPECT_EQ(0u, texture->getNameStr().rfind("gz_", 0u));
+  ASSERT_EQ(4u, texture->getWidth());
+  ASSERT_EQ(5u, texture->getHeight());
+  std::vector<uint8_t> pixels = TexturePixels(texture);
+  ASSERT_EQ(4u * 5u * 4u, pixels.size());
+  for (unsigned int y = 0u; y < 5u; ++y)
+  {
+    for (unsigned int x = 0u; x < 4u; ++x)
+    {
+      const uint8_t *pixel = &pixels[(y * 4u + x) * 4u];
+      EXPECT_EQ(GrayValue(x, y), pixel[0]) << x << " " << y;
+      EXPECT_EQ(GrayValue(x, y), pixel[1]) << x << " " << y;
+      EXPECT_EQ(GrayValue(x, y), pixel[2]) << x << " " << y;
+      EXPECT_EQ(255u, pixel[3]) << x << " " << y;
+    }
+  }
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialStreamTest, SharedGrayscaleEmissiveMap)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::TempDirectory tempDir("ogre2_material_stream");
+  std::string path =
+      WriteGrayImage(tempDir.Path(), "shared_emissive.png", 4u, 5u);
+
+  std::vector<std::shared_ptr<Ogre2Material>> materials;
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    MaterialPtr material = scene->CreateMaterial();
+    material->SetEmissiveMap(path);
+    materials.push_back(std::dynamic_pointer_cast<Ogre2Material>(material));
+    ASSERT_NE(nullptr, materials.back());
+  }
+
+  // the materials share one decode of the map
+  Ogre2ImageDecoder *decoder = engine->ImageDecoder();
+  ASSERT_NE(nullptr, decoder);
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  auto converted = [&]()
+  {
+    for (const auto &material : materials)
+    {
+      Ogre::TextureGpu *texture =
+          material->Datablock()->getTexture(Ogre::PBSM_EMISSIVE);
+      if (!texture || texture->getNameStr().rfind("gz_", 0u) != 0u)
+        return false;
+    }
+    return true;
+  };
+  for (unsigned int i = 0u; i < 100u && !converted(); ++i)
+  {
+    textureMgr->waitForStreamingCompletion();
+    for (const auto &material : materials)
+      material->PreRender();
+    EXPECT_LE(decoder->DecodeCount(), 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(converted());
+
+  // all use the same RGB copy, and the decoded pixels are freed
+  Ogre::TextureGpu *texture =
+      materials[0]->Datablock()->getTexture(Ogre::PBSM_EMISSIVE);
+  for (const auto &material : materials)
+  {
+    EXPECT_EQ(texture,
+        material->Datablock()->getTexture(Ogre::PBSM_EMISSIVE));
+  }
+  EXPECT_EQ(0u, decoder->DecodeCount());
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialStreamTest, ImageDecoder)
+{
+  common::TempDirectory tempDir("ogre2_material_stream");
+  std::string path = WriteGrayImage(tempDir.Path(), "decode.png", 4u, 5u);
+
+  Ogre2ImageDecoder decoder;
+  auto first = decoder.Decode("decode", path);
+  auto second = decoder.Decode("decode", path);
+  auto missing = decoder.Decode("missing",
+      common::joinPaths(tempDir.Path(), "missing.png"));
+  EXPECT_EQ(2u, decoder.DecodeCount());
+
+  // clearing waits for the pending decodes
+  decoder.Clear();
+  EXPECT_EQ(0u, decoder.DecodeCount());
+  ASSERT_EQ(std::future_status::ready,
+      first.wait_for(std::chrono::seconds(0)));
+  ASSERT_EQ(std::future_status::ready,
+      second.wait_for(std::chrono::seconds(0)));
+  ASSERT_EQ(std::future_status::ready,
+      missing.wait_for(std::chrono::seconds(0)));
+
+  // both requests of the same texture got the same decode
+  EXPECT_EQ(&first.get(), &second.get());
+  EXPECT_EQ(4u, first.get().width);
+  EXPECT_EQ(5u, first.get().height);
+  EXPECT_EQ(4u * 5u * 4u, first.get().data.size());
+  EXPECT_TRUE(missing.get().data.empty());
+}
@@ -169,7 +169,7 @@ void Ogre2MaterialSwitcher::cameraPreRenderScene(
 
       // TODO(anyone): Retrieve datablock and make sure it's not blending
       // like we do with Items (it should be impossible?)
-      heightmap->Terra()->SetSolidColor(
+      heightmap->SetSolidColor(
         1u, Ogre::Vector4(this->currentColor.R(), this->currentColor.G(),
                           this->currentColor.B(), 1.0));
     }
@@ -231,7 +231,7 @@ void Ogre2MaterialSwitcher::cameraPostRenderScene(
   {
     auto heightmap = h.lock();
     if (heightmap)
-      heightmap->Terra()->UnsetSolidColors();
+      heightmap->UnsetSolidColors();
   }
 
   engine->SetGzOgreRenderingMode(GORM_NORMAL);
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gz/common/TempDirectory.hh>
+
+#include "gz/rendering/GraphicsAPI.hh"
+#include "gz/rendering/ShaderParams.hh"
+#include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <OgreGpuProgramParams.h>
+#include <OgrePass.h>
+#include <OgreTechnique.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+class Ogre2MaterialTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialTest, GrayscaleEmissiveMap)
+{
+  ASSERT_FALSE(engine->StreamTextures());
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::TempDirectory tempDir("ogre2_material");
+  std::string path =
+      WriteGrayImage(tempDir.Path(), "gray_emissive.png", 4u, 5u);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetEmissiveMap(path);
+  auto ogreMaterial = std::dynamic_pointer_cast<Ogre2Material>(material);
+  ASSERT_NE(nullptr, ogreMaterial);
+
+  // the map is replaced by an RGB copy with the same orientation as the
+  // image file
+  Ogre::TextureGpu *texture =
+      ogreMaterial->Datablock()->getTexture(Ogre::PBSM_EMISSIVE);
+  ASSERT_NE(nullptr, texture);
+  EXPECT_EQ(0u, texture->getNameStr().rfind("gz_", 0u));
+  ASSERT_EQ(4u, texture->getWidth());
+  ASSERT_EQ(5u, texture->getHeight());
+  std::vector<uint8_t> pixels = TexturePixels(texture);
+  ASSERT_EQ(4u * 5u * 4u, pixels.size());
+  for (unsigned int y = 0u; y < 5u; ++y)
+  {
+    for (unsigned int x = 0u; x < 4u; ++x)
+    {
+      const uint8_t *pixel = &pixels[(y * 4u + x) * 4u];
+      EXPECT_EQ(GrayValue(x, y), pixel[0]) << x << " " << y;
+      EXPECT_EQ(GrayValue(x, y), pixel[1]) << x << " " << y;
+      EXPECT_EQ(GrayValue(x, y), pixel[2]) << x << " " << y;
+      EXPECT_EQ(255u, pixel[3]) << x << " " << y;
+    }
+  }
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MaterialTest, ShaderParams)
+{
+  if (engine->GraphicsAPI() != GraphicsAPI::OPENGL &&
+      engine->GraphicsAPI() != GraphicsAPI::VULKAN)
+  {
+    GTEST_SKIP() << "Test shaders are only written in GLSL";
+  }
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::TempDirectory tempDir("ogre2_material_params");
+  std::string vertexShader =
+      common::joinPaths(tempDir.Path(), "params_vs.glsl");
+  std::string fragmentShader =
+      common::joinPaths(tempDir.Path(), "params_fs.glsl");
+  std::ofstream(vertexShader) <<
+      "#version ogre_glsl_ver_330\n"
+      "vulkan_layout( OGRE_POSITION ) in vec4 vertex;\n"
+      "vulkan( layout( ogre_P0 ) uniform Params { )\n"
+      "  uniform mat4 worldviewproj_matrix;\n"
+      "vulkan( }; )\n"
+      "out gl_PerVertex { vec4 gl_Position; };\n"
+      "void main() { gl_Position = worldviewproj_matrix * vertex; }\n";
+  std::ofstream(fragmentShader) <<
+      "#version ogre_glsl_ver_330\n"
+      "vulkan_layout( location = 0 ) out vec4 fragColor;\n"
+      "vulkan( layout( ogre_P0 ) uniform Params { )\n"
+      "  uniform vec4 color;\n"
+      "  uniform float scale;\n"
+      "vulkan( }; )\n"
+      "void main() { fragColor = color * scale; }\n";
+
+  auto material =
+      std::dynamic_pointer_cast<Ogre2Material>(scene->CreateMaterial());
+  ASSERT_NE(nullptr, material);
+  material->SetVertexShader(vertexShader);
+  material->SetFragmentShader(fragmentShader);
+
+  ShaderParamsPtr params = material->FragmentShaderParams();
+  ASSERT_NE(nullptr, params);
+  float color[4] = {0.1f, 0.2f, 0.3f, 0.4f};
+  (*params)["color"].InitializeBuffer(4u);
+  (*params)["color"].UpdateBuffer(color);
+  (*params)["scale"] = 0.5f;
+  material->PreRender();
+
+  Ogre::GpuProgramParametersSharedPtr ogreParams = material->Material()->
+      getTechnique(0u)->getPass(0u)->getFragmentProgramParameters();
+  auto value = [&ogreParams](const std::string &_name, std::size_t _i)
+  {
+    const Ogre::GpuConstantDefinition *def =
+        ogreParams->_findNamedConstantDefinition(_name);
+    return def ? ogreParams->getFloatPointer(def->physicalIndex)[_i] : -1.0f;
+  };
+  for (std::size_t i = 0u; i < 4u; ++i)
+    EXPECT_FLOAT_EQ(color[i], value("color", i));
+  EXPECT_FLOAT_EQ(0.5f, value("scale", 0u));
+
+  // changed values are written through the resolved handles
+  (*params)["scale"] = 2.0f;
+  material->PreRender();
+  EXPECT_FLOAT_EQ(2.0f, value("scale", 0u));
+  EXPECT_FLOAT_EQ(color[0], value("color", 0u));
+
+  // an added param can move the others in the iteration order, their
+  // handles are then resolved again
+  (*params)["missing"] = 1.0f;
+  (*params)["scale"] = 4.0f;
+  color[0] = 0.9f;
+  (*params)["color"].UpdateBuffer(color);
+  material->PreRender();
+  EXPECT_FLOAT_EQ(4.0f, value("scale", 0u));
+  EXPECT_FLOAT_EQ(0.9f, value("color", 0u));
+
+  // params set before a new shader are dropped with the handles
+  material->SetFragmentShader(fragmentShader);
+  params = material->FragmentShaderParams();
+  ASSERT_NE(nullptr, params);
+  (*params)["scale"] = 8.0f;
+  material->PreRender();
+  ogreParams = material->Material()->
+      getTechnique(0u)->getPass(0u)->getFragmentProgramParameters();
+  EXPECT_FLOAT_EQ(8.0f, value("scale", 0u));
+
+  engine->DestroyScene(scene);
+}
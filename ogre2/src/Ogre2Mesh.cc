@@ -38,8 +38,11 @@
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2Mesh.hh"
 #include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
 
+#include "Ogre2MaterialInterner.hh"
+
 /// brief Private implementation of the Ogre2Mesh class
 class gz::rendering::Ogre2MeshPrivate
 {
@@ -51,6 +54,17 @@ class gz::rendering::Ogre2SubMeshPrivate
   /// \brief name of the mesh inside the mesh manager to be able to
   /// remove it
   public: std::string subMeshName;
+
+  /// \brief Content key of the shared datablock bound to the sub item,
+  /// empty if the datablock of the material itself is bound
+  public: std::string sharedKey;
+
+  /// \brief False once the submesh needs a datablock of its own
+  public: bool shareable = true;
+
+  /// \brief Material registered as bound to the shared datablock, null if
+  /// the datablock of the material itself is bound
+  public: Ogre2Material *sharedMaterial = nullptr;
 };
 
 using namespace gz;
@@ -304,6 +318,8 @@ void Ogre2SubMesh::SetMeshName(const std::string &_name)
 //////////////////////////////////////////////////
 void Ogre2SubMesh::Destroy()
 {
+  this->ReleaseSharedDatablock();
+
   auto meshManager = Ogre::MeshManager::getSingletonPtr();
   if (meshManager)
   {
@@ -353,37 +369,87 @@ void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
   if (!derived->FragmentShader().empty() && !derived->VertexShader().empty())
   {
     this->ogreSubItem->setMaterial(derived->Material());
+    this->ReleaseSharedDatablock();
   }
   // Pbs Hlms material
-  else
+  else if (derived->Datablock())
   {
-    auto datablock =
-        static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock());
-    if (datablock)
-    {
-      this->ogreSubItem->setDatablock(datablock);
-
-      // update render queue group based on material transparency setting
-      if (datablock->getTransparencyMode() == Ogre::HlmsPbsDatablock::None)
-      {
-        // by default, ogre items are in render queue 10
-        // these are hardcoded in ogre-next and there does not seem to be
-        // an enum of function to retrieve this default render queue group
-        this->ogreSubItem->getParent()->setRenderQueueGroup(10);
-      }
-      else
-      {
-        // put in render queue group 200
-        // v2 entities can be placed in groups 0-99 or 200-224
-        this->ogreSubItem->getParent()->setRenderQueueGroup(200);
-      }
-    }
+    this->BindDatablock(derived.get());
   }
 
   // set cast shadows
   this->ogreSubItem->getParent()->setCastShadows(_material->CastShadows());
 }
 
+//////////////////////////////////////////////////
+void Ogre2SubMesh::BindDatablock(Ogre2Material *_material)
+{
+  std::string oldKey = this->dataPtr->sharedKey;
+  this->dataPtr->sharedKey.clear();
+  if (this->dataPtr->sharedMaterial)
+    this->dataPtr->sharedMaterial->RemoveSharedUser(this);
+  this->dataPtr->sharedMaterial = nullptr;
+
+  Ogre::HlmsPbsDatablock *datablock = _material->Datablock();
+  if (this->dataPtr->shareable &&
+      Ogre2RenderEngine::Instance()->ShareMaterials())
+  {
+    this->dataPtr->sharedKey = Ogre2MaterialInterner::Key(datablock);
+    datablock = Ogre2MaterialInterner::Acquire(datablock,
+        this->dataPtr->sharedKey);
+    this->dataPtr->sharedMaterial = _material;
+    _material->AddSharedUser(this);
+  }
+  this->ogreSubItem->setDatablock(datablock);
+
+  // release after binding so a datablock kept by this submesh survives
+  if (!oldKey.empty())
+    Ogre2MaterialInterner::Release(oldKey);
+
+  // update render queue group based on material transparency setting
+  if (datablock->getTransparencyMode() == Ogre::HlmsPbsDatablock::None)
+  {
+    // by default, ogre items are in render queue 10
+    // these are hardcoded in ogre-next and there does not seem to be
+    // an enum of function to retrieve this default render queue group
+    this->ogreSubItem->getParent()->setRenderQueueGroup(10);
+  }
+  else
+  {
+    // put in render queue group 200
+    // v2 entities can be placed in groups 0-99 or 200-224
+    this->ogreSubItem->getParent()->setRenderQueueGroup(200);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2SubMesh::Unshare()
+{
+  this->dataPtr->shareable = false;
+  if (this->dataPtr->sharedKey.empty())
+    return;
+
+  Ogre2MaterialPtr derived =
+      std::dynamic_pointer_cast<Ogre2Material>(this->material);
+  if (derived && derived->Datablock())
+    this->BindDatablock(derived.get());
+}
+
+//////////////////////////////////////////////////
+void Ogre2SubMesh::ReleaseSharedDatablock()
+{
+  if (this->dataPtr->sharedMaterial)
+  {
+    this->dataPtr->sharedMaterial->RemoveSharedUser(this);
+    this->dataPtr->sharedMaterial = nullptr;
+  }
+  if (!this->dataPtr->sharedKey.empty())
+  {
+    Ogre2MaterialInterner::Release(this->dataPtr->sharedKey);
+    this->dataPtr->sharedKey.clear();
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2SubMesh::Init()
 {
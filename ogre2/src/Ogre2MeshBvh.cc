@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <string>
+
+#include <gz/common/SubMesh.hh>
+
+#include "gz/rendering/ogre2/Ogre2Conversions.hh"
+
+#include "Ogre2MeshBvh.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreMath.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Max number of triangles stored in a leaf node
+  const uint32_t kMaxLeafTriangles = 4u;
+
+  /// \brief Traversal stack size. The tree is split at the median so its
+  /// depth never exceeds 32 for 32 bit triangle counts.
+  const unsigned int kStackSize = 64u;
+
+  /// \brief Default max number of triangles of the cached hierarchies,
+  /// about 150 MB of vertices
+  const std::size_t kDefaultMaxCachedTriangles = 4000000u;
+
+  /// \brief Cached hierarchy and the mesh it was built from
+  struct BvhCacheEntry
+  {
+    /// \brief Mesh the hierarchy was built from
+    const common::Mesh *mesh = nullptr;
+
+    /// \brief Index count of the mesh when the hierarchy was built
+    unsigned int indexCount = 0u;
+
+    /// \brief The hierarchy, ready once the thread building it is done
+    std::shared_future<std::shared_ptr<const Ogre2MeshBvh>> bvh;
+
+    /// \brief Number of triangles of the hierarchy, 0 while it is built
+    std::size_t triangleCount = 0u;
+
+    /// \brief Value of bvhCacheClock when the entry was last acquired
+    uint64_t lastUse = 0u;
+  };
+
+  /// \brief Mutex protecting the hierarchy cache
+  std::mutex bvhCacheMutex;
+
+  /// \brief Hierarchy cache keyed by mesh name
+  std::map<std::string, BvhCacheEntry> bvhCache;
+
+  /// \brief Number of acquisitions, used to find the least recently used
+  /// entries
+  uint64_t bvhCacheClock = 0u;
+
+  /// \brief Sum of the triangle counts of the cached hierarchies
+  std::size_t bvhCacheTriangles = 0u;
+
+  /// \brief Max number of triangles of the cached hierarchies
+  std::size_t bvhCacheMaxTriangles = kDefaultMaxCachedTriangles;
+
+  //////////////////////////////////////////////////
+  /// \brief Drop the least recently used hierarchies until the cache is
+  /// within its budget. Hierarchies still being built or in use by a query
+  /// are kept alive by their users. Must be called with bvhCacheMutex
+  /// locked.
+  /// \param[in] _keep Name of an entry that must not be dropped
+  void pruneBvhCache(const std::string &_keep)
+  {
+    while (bvhCacheTriangles > bvhCacheMaxTriangles)
+    {
+      auto oldest = bvhCache.end();
+      for (auto it = bvhCache.begin(); it != bvhCache.end(); ++it)
+      {
+        if (it->first == _keep || it->second.triangleCount == 0u)
+          continue;
+        if (oldest == bvhCache.end() ||
+            it->second.lastUse < oldest->second.lastUse)
+        {
+          oldest = it;
+        }
+      }
+      if (oldest == bvhCache.end())
+        return;
+      bvhCacheTriangles -= oldest->second.triangleCount;
+      bvhCache.erase(oldest);
+    }
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Ray / axis aligned box slab test
+  /// \param[in] _min Box min corner
+  /// \param[in] _max Box max corner
+  /// \param[in] _origin Ray origin
+  /// \param[in] _invDir Component-wise inverse of the ray direction
+  /// \param[in] _maxDist Ignore boxes entered beyond this distance
+  /// \param[out] _entry Distance at which the ray enters the box
+  /// \return True if the ray hits the box before _maxDist
+  bool rayBoxIntersect(const Ogre::Vector3 &_min, const Ogre::Vector3 &_max,
+      const Ogre::Vector3 &_origin, const Ogre::Vector3 &_invDir,
+      Ogre::Real _maxDist, Ogre::Real &_entry)
+  {
+    Ogre::Real tmin = 0;
+    Ogre::Real tmax = _maxDist;
+    for (int i = 0; i < 3; ++i)
+    {
+      Ogre::Real t1 = (_min[i] - _origin[i]) * _invDir[i];
+      Ogre::Real t2 = (_max[i] - _origin[i]) * _invDir[i];
+      if (t1 > t2)
+        std::swap(t1, t2);
+      // NaN (origin on a slab of a flat box with zero direction) compares
+      // false so it leaves the interval untouched
+      if (t1 > tmin)
+        tmin = t1;
+      if (t2 < tmax)
+        tmax = t2;
+      if (tmin > tmax)
+        return false;
+    }
+    _entry = tmin;
+    return true;
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2MeshBvh::Ogre2MeshBvh(const common::Mesh &_mesh)
+{
+  std::vector<Ogre::Vector3> triangles;
+  for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+  {
+    auto submesh = _mesh.SubMeshByIndex(i).lock();
+    if (!submesh || submesh->VertexCount() < 3u)
+      continue;
+    unsigned int indexCount = submesh->IndexCount();
+    for (unsigned int k = 0; k + 2 < indexCount; k += 3)
+    {
+      for (unsigned int v = 0; v < 3u; ++v)
+      {
+        triangles.push_back(Ogre2Conversions::Convert(
+            submesh->Vertex(submesh->Index(k + v))));
+      }
+    }
+  }
+
+  uint32_t triCount = static_cast<uint32_t>(triangles.size() / 3u);
+  if (triCount == 0u)
+    return;
+
+  std::vector<Ogre::Vector3> centroids(triCount);
+  for (uint32_t t = 0; t < triCount; ++t)
+  {
+    centroids[t] = (triangles[t * 3] + triangles[t * 3 + 1] +
+        triangles[t * 3 + 2]) / 3.0f;
+  }
+
+  this->order.resize(triCount);
+  std::iota(this->order.begin(), this->order.end(), 0u);
+
+  this->nodes.reserve(2u * (triCount / kMaxLeafTriangles + 1u));
+  this->nodes.emplace_back();
+  this->Build(0u, 0u, triCount, triangles, centroids);
+
+  // store triangles in leaf order so leaves reference contiguous memory
+  this->vertices.resize(triangles.size());
+  for (uint32_t t = 0; t < triCount; ++t)
+  {
+    uint32_t src = this->order[t] * 3u;
+    this->vertices[t * 3] = triangles[src];
+    this->vertices[t * 3 + 1] = triangles[src + 1];
+    this->vertices[t * 3 + 2] = triangles[src + 2];
+  }
+  this->order.clear();
+  this->order.shrink_to_fit();
+  this->nodes.shrink_to_fit();
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshBvh::Build(uint32_t _nodeIdx, uint32_t _start, uint32_t _count,
+    const std::vector<Ogre::Vector3> &_triangles,
+    const std::vector<Ogre::Vector3> &_centroids)
+{
+  Ogre::Vector3 bmin(std::numeric_limits<Ogre::Real>::max());
+  Ogre::Vector3 bmax(-std::numeric_limits<Ogre::Real>::max());
+  Ogre::Vector3 cmin = bmin;
+  Ogre::Vector3 cmax = bmax;
+  for (uint32_t i = _start; i < _start + _count; ++i)
+  {
+    uint32_t t = this->order[i];
+    for (uint32_t v = 0; v < 3u; ++v)
+    {
+      bmin.makeFloor(_triangles[t * 3 + v]);
+      bmax.makeCeil(_triangles[t * 3 + v]);
+    }
+    cmin.makeFloor(_centroids[t]);
+    cmax.makeCeil(_centroids[t]);
+  }
+
+  this->nodes[_nodeIdx].min = bmin;
+  this->nodes[_nodeIdx].max = bmax;
+
+  // split along the axis with the largest centroid extent
+  Ogre::Vector3 extent = cmax - cmin;
+  int axis = 0;
+  if (extent.y > extent[axis])
+    axis = 1;
+  if (extent.z > extent[axis])
+    axis = 2;
+
+  if (_count <= kMaxLeafTriangles || extent[axis] <= 0)
+  {
+    this->nodes[_nodeIdx].start = _start;
+    this->nodes[_nodeIdx].count = _count;
+    return;
+  }
+
+  uint32_t half = _count / 2u;
+  auto first = this->order.begin() + _start;
+  std::nth_element(first, first + half, first + _count,
+      [&](uint32_t _a, uint32_t _b)
+      {
+        return _centroids[_a][axis] < _centroids[_b][axis];
+      });
+
+  uint32_t left = static_cast<uint32_t>(this->nodes.size());
+  this->nodes.emplace_back();
+  this->nodes.emplace_back();
+  this->nodes[_nodeIdx].start = left;
+  this->nodes[_nodeIdx].count = 0u;
+
+  this->Build(left, _start, half, _triangles, _centroids);
+  this->Build(left + 1u, _start + half, _count - half, _triangles,
+      _centroids);
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshBvh::Intersect(const Ogre::Ray &_ray, bool _positiveSide,
+    bool _negativeSide, Ogre::Real &_distance) const
+{
+  if (this->nodes.empty())
+    return false;
+
+  const Ogre::Vector3 &origin = _ray.getOrigin();
+  const Ogre::Vector3 &dir = _ray.getDirection();
+  Ogre::Vector3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+
+  Ogre::Real best = _distance < 0 ?
+      std::numeric_limits<Ogre::Real>::max() : _distance;
+  bool hit = false;
+
+  uint32_t stack[kStackSize];
+  unsigned int stackSize = 0u;
+  Ogre::Real entry = 0;
+  if (!rayBoxIntersect(this->nodes[0].min, this->nodes[0].max, origin,
+      invDir, best, entry))
+  {
+    return false;
+  }
+  stack[stackSize++] = 0u;
+
+  while (stackSize > 0u)
+  {
+    const Node &node = this->nodes[stack[--stackSize]];
+
+    if (node.count > 0u)
+    {
+      for (uint32_t t = node.start; t < node.start + node.count; ++t)
+      {
+        std::pair<bool, Ogre::Real> result = Ogre::Math::intersects(_ray,
+            this->vertices[t * 3], this->vertices[t * 3 + 1],
+            this->vertices[t * 3 + 2], _positiveSide, _negativeSide);
+        if (result.first && result.second < best)
+        {
+          best = result.second;
+          hit = true;
+        }
+      }
+      continue;
+    }
+
+    // visit the nearer child first by pushing it last
+    Ogre::Real entryA = 0;
+    Ogre::Real entryB = 0;
+    const Node &childA = this->nodes[node.start];
+    const Node &childB = this->nodes[node.start + 1u];
+    bool hitA = rayBoxIntersect(childA.min, childA.max, origin, invDir,
+        best, entryA);
+    bool hitB = rayBoxIntersect(childB.min, childB.max, origin, invDir,
+        best, entryB);
+    if (hitA && hitB)
+    {
+      if (entryA < entryB)
+      {
+        stack[stackSize++] = node.start + 1u;
+        stack[stackSize++] = node.start;
+      }
+      else
+      {
+        stack[stackSize++] = node.start;
+        stack[stackSize++] = node.start + 1u;
+      }
+    }
+    else if (hitA)
+    {
+      stack[stackSize++] = node.start;
+    }
+    else if (hitB)
+    {
+      stack[stackSize++] = node.start + 1u;
+    }
+  }
+
+  if (hit)
+    _distance = best;
+  return hit;
+}
+
+//////////////////////////////////////////////////
+size_t Ogre2MeshBvh::TriangleCount() const
+{
+  return this->vertices.size() / 3u;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const Ogre2MeshBvh> Ogre2MeshBvh::Acquire(
+    const common::Mesh *_mesh)
+{
+  if (!_mesh)
+    return nullptr;
+
+  const std::string name = _mesh->Name();
+  const unsigned int indexCount = _mesh->IndexCount();
+  std::promise<std::shared_ptr<const Ogre2MeshBvh>> promise;
+  std::shared_future<std::shared_ptr<const Ogre2MeshBvh>> cached;
+  {
+    std::lock_guard<std::mutex> lock(bvhCacheMutex);
+    BvhCacheEntry &entry = bvhCache[name];
+    entry.lastUse = ++bvhCacheClock;
+    if (entry.bvh.valid() && entry.mesh == _mesh &&
+        entry.indexCount == indexCount)
+    {
+      cached = entry.bvh;
+    }
+    else
+    {
+      // build outside of the lock so queries of other meshes are not
+      // blocked. Threads acquiring the same mesh meanwhile wait for this
+      // build.
+      bvhCacheTriangles -= entry.triangleCount;
+      entry.mesh = _mesh;
+      entry.indexCount = indexCount;
+      entry.triangleCount = 0u;
+      entry.bvh = promise.get_future().share();
+    }
+  }
+
+  // wait outside of the lock if another thread is building it
+  if (cached.valid())
+    return cached.get();
+
+  std::shared_ptr<const Ogre2MeshBvh> bvh;
+  try
+  {
+    bvh = std::make_shared<const Ogre2MeshBvh>(*_mesh);
+  }
+  catch (...)
+  {
+    // let waiting threads see the failure and the next call retry
+    promise.set_exception(std::current_exception());
+    std::lock_guard<std::mutex> lock(bvhCacheMutex);
+    auto it = bvhCache.find(name);
+    if (it != bvhCache.end() && it->second.mesh == _mesh &&
+        it->second.triangleCount == 0u)
+    {
+      bvhCache.erase(it);
+    }
+    throw;
+  }
+  promise.set_value(bvh);
+
+  std::lock_guard<std::mutex> lock(bvhCacheMutex);
+  auto it = bvhCache.find(name);
+  // the entry may have been cleared or rebuilt for another mesh meanwhile
+  if (it != bvhCache.end() && it->second.mesh == _mesh &&
+      it->second.indexCount == indexCount && it->second.triangleCount == 0u)
+  {
+    it->second.triangleCount = std::max<std::size_t>(bvh->TriangleCount(), 1u);
+    bvhCacheTriangles += it->second.triangleCount;
+    pruneBvhCache(name);
+  }
+  return bvh;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshBvh::ClearCache()
+{
+  std::lock_guard<std::mutex> lock(bvhCacheMutex);
+  bvhCache.clear();
+  bvhCacheTriangles = 0u;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshBvh::SetMaxCachedTriangles(std::size_t _count)
+{
+  std::lock_guard<std::mutex> lock(bvhCacheMutex);
+  bvhCacheMaxTriangles = _count;
+  pruneBvhCache(std::string());
+}
+
+//////////////////////////////////////////////////
+std::size_t Ogre2MeshBvh::CachedTriangles()
+{
+  std::lock_guard<std::mutex> lock(bvhCacheMutex);
+  return bvhCacheTriangles;
+}
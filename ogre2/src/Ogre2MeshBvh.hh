@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifndef GZ_RENDERING_OGRE2_OGRE2MESHBVH_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MESHBVH_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreRay.h>
+#include <OgreVector3.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Bounding volume hierarchy over the triangles of a common::Mesh,
+/// used to speed up CPU ray / mesh intersection tests. The tree is built
+/// in mesh-local space so it can be shared by every Item that references
+/// the mesh; rays are transformed into local space before traversal.
+/// Once built, an Ogre2MeshBvh is immutable and safe to query from
+/// multiple threads.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2MeshBvh
+{
+  /// \brief Constructor. Builds the hierarchy from all submeshes.
+  /// \param[in] _mesh Mesh to build the hierarchy for
+  public: explicit Ogre2MeshBvh(const common::Mesh &_mesh);
+
+  /// \brief Destructor
+  public: ~Ogre2MeshBvh() = default;
+
+  /// \brief Get the hierarchy for the given mesh, building and caching it
+  /// on first use. The cache is keyed by mesh name and is rebuilt if the
+  /// mesh registered under that name changes. The hierarchy is built
+  /// without holding the cache lock; threads acquiring the same mesh
+  /// meanwhile wait for the build. The least recently acquired hierarchies
+  /// are dropped once the cache exceeds its triangle budget, see
+  /// SetMaxCachedTriangles.
+  /// \param[in] _mesh Mesh to get the hierarchy for
+  /// \return Shared hierarchy, or nullptr if _mesh is null
+  public: static std::shared_ptr<const Ogre2MeshBvh> Acquire(
+      const common::Mesh *_mesh);
+
+  /// \brief Remove all cached hierarchies
+  public: static void ClearCache();
+
+  /// \brief Set the max number of triangles of the cached hierarchies.
+  /// The hierarchy most recently acquired is always kept, even if larger.
+  /// \param[in] _count Max triangle count, 4 million by default
+  public: static void SetMaxCachedTriangles(std::size_t _count);
+
+  /// \brief Get the number of triangles of the cached hierarchies
+  /// \return Triangle count
+  public: static std::size_t CachedTriangles();
+
+  /// \brief Find the closest triangle hit by a ray.
+  /// \param[in] _ray Ray in mesh-local space. The direction does not need
+  /// to be normalized; distances are expressed in multiples of it.
+  /// \param[in] _positiveSide True to accept hits on the front face
+  /// \param[in] _negativeSide True to accept hits on the back face
+  /// \param[in,out] _distance Only hits closer than the input value are
+  /// considered (pass a negative value for no limit). On a hit, set to the
+  /// distance of the closest hit.
+  /// \return True if a triangle closer than _distance was hit
+  public: bool Intersect(const Ogre::Ray &_ray, bool _positiveSide,
+      bool _negativeSide, Ogre::Real &_distance) const;
+
+  /// \brief Get the number of triangles in the hierarchy
+  /// \return Triangle count
+  public: size_t TriangleCount() const;
+
+  /// \brief Recursively build the subtree covering the given triangles
+  /// \param[in] _nodeIdx Index of the node to fill in
+  /// \param[in] _start First entry in the triangle order
+  /// \param[in] _count Number of triangles covered by the node
+  /// \param[in] _triangles Triangle vertices, three per triangle
+  /// \param[in] _centroids Triangle centroids
+  private: void Build(uint32_t _nodeIdx, uint32_t _start, uint32_t _count,
+      const std::vector<Ogre::Vector3> &_triangles,
+      const std::vector<Ogre::Vector3> &_centroids);
+
+  /// \brief Hierarchy node. Leaves have count > 0 and reference
+  /// [start, start + count) in the triangle array. Inner nodes have
+  /// count == 0 and their children stored at start and start + 1.
+  private: struct Node
+  {
+    /// \brief Bounding box min corner
+    Ogre::Vector3 min;
+
+    /// \brief Bounding box max corner
+    Ogre::Vector3 max;
+
+    /// \brief First triangle (leaf) or first child (inner node)
+    uint32_t start = 0u;
+
+    /// \brief Number of triangles, 0 for inner nodes
+    uint32_t count = 0u;
+  };
+
+  /// \brief Hierarchy nodes, root at index 0
+  private: std::vector<Node> nodes;
+
+  /// \brief Triangle vertices, three per triangle, in leaf order
+  private: std::vector<Ogre::Vector3> vertices;
+
+  /// \brief Triangle order used while building
+  private: std::vector<uint32_t> order;
+};
+}
+}
+}
+
+#endif
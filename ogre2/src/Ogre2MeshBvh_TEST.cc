@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/SubMesh.hh>
+#include <gz/math/Pose3.hh>
+#include <gz/math/Rand.hh>
+
+#include "gz/rendering/MeshDescriptor.hh"
+#include "gz/rendering/RayQuery.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+#include "gz/rendering/ogre2/Ogre2RayQuery.hh"
+
+#include "Ogre2MeshBvh.hh"
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreMath.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+/// \brief Create a mesh of random triangles within a unit cube, with
+/// overlapping triangles facing both ways
+/// \param[in] _name Mesh name
+/// \param[in] _triangles Number of triangles
+/// \return New mesh
+std::unique_ptr<common::Mesh> randomMesh(const std::string &_name,
+    unsigned int _triangles)
+{
+  auto mesh = std::make_unique<common::Mesh>();
+  mesh->SetName(_name);
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (unsigned int t = 0u; t < _triangles; ++t)
+  {
+    math::Vector3d center(math::Rand::DblUniform(-1.0, 1.0),
+        math::Rand::DblUniform(-1.0, 1.0), math::Rand::DblUniform(-1.0, 1.0));
+    for (unsigned int v = 0u; v < 3u; ++v)
+    {
+      subMesh.AddVertex(center + math::Vector3d(
+          math::Rand::DblUniform(-0.2, 0.2),
+          math::Rand::DblUniform(-0.2, 0.2),
+          math::Rand::DblUniform(-0.2, 0.2)));
+      subMesh.AddNormal(math::Vector3d::UnitZ);
+      subMesh.AddIndex(t * 3u + v);
+    }
+  }
+  mesh->AddSubMesh(subMesh);
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the vertices of the triangles of a mesh, three per triangle
+/// \param[in] _mesh Mesh
+/// \return Triangle vertices
+std::vector<Ogre::Vector3> triangles(const common::Mesh &_mesh)
+{
+  std::vector<Ogre::Vector3> result;
+  auto subMesh = _mesh.SubMeshByIndex(0u).lock();
+  for (unsigned int i = 0u; i < subMesh->IndexCount(); ++i)
+  {
+    const math::Vector3d &v = subMesh->Vertex(subMesh->Index(i));
+    result.emplace_back(static_cast<Ogre::Real>(v.X()),
+        static_cast<Ogre::Real>(v.Y()), static_cast<Ogre::Real>(v.Z()));
+  }
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the closest triangle hit by a ray by testing every triangle
+/// \param[in] _triangles Triangle vertices, three per triangle
+/// \param[in] _ray Ray
+/// \param[in] _positiveSide True to accept hits on the front face
+/// \param[in] _negativeSide True to accept hits on the back face
+/// \param[in] _maxDistance Max hit distance, negative for no limit
+/// \return Distance of the closest hit, negative if none
+Ogre::Real bruteForce(const std::vector<Ogre::Vector3> &_triangles,
+    const Ogre::Ray &_ray, bool _positiveSide, bool _negativeSide,
+    Ogre::Real _maxDistance)
+{
+  Ogre::Real best = _maxDistance;
+  for (std::size_t t = 0u; t + 2u < _triangles.size(); t += 3u)
+  {
+    auto hit = Ogre::Math::intersects(_ray, _triangles[t],
+        _triangles[t + 1u], _triangles[t + 2u], _positiveSide,
+        _negativeSide);
+    if (hit.first && (best < 0 || hit.second < best))
+      best = hit.second;
+  }
+  return best == _maxDistance ? -1.0f : best;
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2MeshBvhTest, Intersect)
+{
+  math::Rand::Seed(7u);
+  auto mesh = randomMesh("bvh_intersect", 500u);
+  const std::vector<Ogre::Vector3> tris = triangles(*mesh);
+
+  Ogre2MeshBvh bvh(*mesh);
+  EXPECT_EQ(500u, bvh.TriangleCount());
+
+  unsigned int hits = 0u;
+  for (unsigned int i = 0u; i < 500u; ++i)
+  {
+    // unnormalized directions from outside and inside the mesh
+    Ogre::Vector3 origin(
+        static_cast<Ogre::Real>(math::Rand::DblUniform(-2.0, 2.0)),
+        static_cast<Ogre::Real>(math::Rand::DblUniform(-2.0, 2.0)),
+        static_cast<Ogre::Real>(math::Rand::DblUniform(-2.0, 2.0)));
+    Ogre::Vector3 target(
+        static_cast<Ogre::Real>(math::Rand::DblUniform(-1.0, 1.0)),
+        static_cast<Ogre::Real>(math::Rand::DblUniform(-1.0, 1.0)),
+        static_cast<Ogre::Real>(math::Rand::DblUniform(-1.0, 1.0)));
+    Ogre::Ray ray(origin, (target - origin) * 0.5f);
+
+    for (Ogre::Real maxDistance : {-1.0f, 1.5f})
+    {
+      for (auto sides : {std::make_pair(true, false),
+          std::make_pair(false, true), std::make_pair(true, true)})
+      {
+        Ogre::Real expected = bruteForce(tris, ray, sides.first,
+            sides.second, maxDistance);
+        Ogre::Real distance = maxDistance;
+        bool hit = bvh.Intersect(ray, sides.first, sides.second, distance);
+        ASSERT_EQ(expected >= 0, hit) << i;
+        if (!hit)
+          continue;
+        ++hits;
+        EXPECT_NEAR(expected, distance, 1e-4) << i;
+      }
+    }
+  }
+  EXPECT_GT(hits, 100u);
+
+  // an empty mesh is never hit
+  common::Mesh empty;
+  Ogre2MeshBvh emptyBvh(empty);
+  EXPECT_EQ(0u, emptyBvh.TriangleCount());
+  Ogre::Real distance = -1.0f;
+  EXPECT_FALSE(emptyBvh.Intersect(Ogre::Ray(Ogre::Vector3::ZERO,
+      Ogre::Vector3::UNIT_X), true, true, distance));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2MeshBvhTest, Cache)
+{
+  Ogre2MeshBvh::ClearCache();
+  EXPECT_EQ(nullptr, Ogre2MeshBvh::Acquire(nullptr));
+
+  math::Rand::Seed(7u);
+  auto mesh = randomMesh("bvh_cache", 10u);
+  auto bvh = Ogre2MeshBvh::Acquire(mesh.get());
+  ASSERT_NE(nullptr, bvh);
+  EXPECT_EQ(10u, bvh->TriangleCount());
+  EXPECT_EQ(bvh, Ogre2MeshBvh::Acquire(mesh.get()));
+  EXPECT_EQ(10u, Ogre2MeshBvh::CachedTriangles());
+
+  // changing the mesh rebuilds the hierarchy
+  auto subMesh = mesh->SubMeshByIndex(0u).lock();
+  subMesh->AddVertex(math::Vector3d(0, 0, 0));
+  subMesh->AddVertex(math::Vector3d(1, 0, 0));
+  subMesh->AddVertex(math::Vector3d(0, 1, 0));
+  for (unsigned int i = 30u; i < 33u; ++i)
+    subMesh->AddIndex(i);
+  auto changed = Ogre2MeshBvh::Acquire(mesh.get());
+  EXPECT_NE(bvh, changed);
+  EXPECT_EQ(11u, changed->TriangleCount());
+  EXPECT_EQ(11u, Ogre2MeshBvh::CachedTriangles());
+
+  // so does a different mesh registered under the same name
+  auto other = randomMesh("bvh_cache", 20u);
+  auto otherBvh = Ogre2MeshBvh::Acquire(other.get());
+  EXPECT_NE(changed, otherBvh);
+  EXPECT_EQ(20u, otherBvh->TriangleCount());
+  EXPECT_EQ(20u, Ogre2MeshBvh::CachedTriangles());
+
+  // and clearing the cache
+  Ogre2MeshBvh::ClearCache();
+  EXPECT_EQ(0u, Ogre2MeshBvh::CachedTriangles());
+  auto rebuilt = Ogre2MeshBvh::Acquire(other.get());
+  EXPECT_NE(otherBvh, rebuilt);
+  EXPECT_EQ(20u, Ogre2MeshBvh::CachedTriangles());
+
+  // the least recently used hierarchies are dropped past the budget,
+  // hierarchies still in use stay valid
+  Ogre2MeshBvh::SetMaxCachedTriangles(50u);
+  auto a = randomMesh("bvh_a", 20u);
+  auto b = randomMesh("bvh_b", 20u);
+  auto bvhA = Ogre2MeshBvh::Acquire(a.get());
+  Ogre2MeshBvh::Acquire(other.get());
+  EXPECT_EQ(40u, Ogre2MeshBvh::CachedTriangles());
+  auto bvhB = Ogre2MeshBvh::Acquire(b.get());
+  EXPECT_EQ(40u, Ogre2MeshBvh::CachedTriangles());
+  EXPECT_EQ(20u, bvhA->TriangleCount());
+  EXPECT_EQ(rebuilt, Ogre2MeshBvh::Acquire(other.get()));
+  EXPECT_EQ(bvhB, Ogre2MeshBvh::Acquire(b.get()));
+  EXPECT_NE(bvhA, Ogre2MeshBvh::Acquire(a.get()));
+
+  // the hierarchy just acquired is kept even if over the budget
+  Ogre2MeshBvh::SetMaxCachedTriangles(10u);
+  EXPECT_EQ(0u, Ogre2MeshBvh::CachedTriangles());
+  auto big = randomMesh("bvh_big", 30u);
+  auto bigBvh = Ogre2MeshBvh::Acquire(big.get());
+  EXPECT_EQ(30u, Ogre2MeshBvh::CachedTriangles());
+  EXPECT_EQ(bigBvh, Ogre2MeshBvh::Acquire(big.get()));
+
+  Ogre2MeshBvh::SetMaxCachedTriangles(4000000u);
+  Ogre2MeshBvh::ClearCache();
+}
+
+/// \brief Tests of ray queries against mesh hierarchies
+class Ogre2MeshBvhRayQueryTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MeshBvhRayQueryTest, NegativeScale)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  math::Rand::Seed(11u);
+  const std::string meshName = "bvh_negative_scale";
+  std::unique_ptr<common::Mesh> mesh = randomMesh(meshName, 200u);
+  const std::vector<Ogre::Vector3> localTris = triangles(*mesh);
+  common::MeshManager::Instance()->AddMesh(mesh.release());
+
+  // a mirroring transform flips the winding of the triangles
+  const math::Pose3d pose(0.5, -1.0, 0.0, 0.3, -0.2, 0.7);
+  const math::Vector3d scale(-1.5, 2.0, 1.0);
+  VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(scene->CreateMesh(MeshDescriptor(meshName)));
+  visual->SetLocalPose(pose);
+  visual->SetLocalScale(scale);
+  scene->RootVisual()->AddChild(visual);
+
+  std::vector<Ogre::Vector3> worldTris;
+  for (const auto &v : localTris)
+  {
+    math::Vector3d p = pose.Rot() * (scale * math::Vector3d(v.x, v.y, v.z)) +
+        pose.Pos();
+    worldTris.emplace_back(static_cast<Ogre::Real>(p.X()),
+        static_cast<Ogre::Real>(p.Y()), static_cast<Ogre::Real>(p.Z()));
+  }
+
+  // rays through every triangle centroid from both sides, plus misses
+  std::vector<RayQueryRay> rays;
+  for (std::size_t t = 0u; t < worldTris.size(); t += 3u)
+  {
+    Ogre::Vector3 c =
+        (worldTris[t] + worldTris[t + 1u] + worldTris[t + 2u]) / 3.0f;
+    math::Vector3d centroid(c.x, c.y, c.z);
+    RayQueryRay ray;
+    ray.origin = centroid + math::Vector3d(0, 0, 10);
+    ray.direction = -math::Vector3d::UnitZ;
+    rays.push_back(ray);
+    ray.origin = centroid - math::Vector3d(0, 0, 10);
+    ray.direction = math::Vector3d::UnitZ;
+    rays.push_back(ray);
+  }
+  for (unsigned int i = 0u; i < 20u; ++i)
+  {
+    RayQueryRay ray;
+    ray.origin = math::Vector3d(20.0, 0.0, 0.0);
+    ray.direction = math::Vector3d(1.0, math::Rand::DblUniform(-1.0, 1.0),
+        math::Rand::DblUniform(-1.0, 1.0));
+    rays.push_back(ray);
+  }
+
+  auto rayQuery =
+      std::dynamic_pointer_cast<Ogre2RayQuery>(scene->CreateRayQuery());
+  ASSERT_NE(nullptr, rayQuery);
+  std::vector<RayQueryResult> results(rays.size());
+  rayQuery->ClosestPoints(rays.data(), results.data(), rays.size());
+
+  // ray queries only hit front faces, as seen in world space
+  unsigned int hits = 0u;
+  for (std::size_t i = 0u; i < rays.size(); ++i)
+  {
+    const math::Vector3d dir = rays[i].direction.Normalized();
+    Ogre::Ray ray(Ogre::Vector3(static_cast<Ogre::Real>(rays[i].origin.X()),
+        static_cast<Ogre::Real>(rays[i].origin.Y()),
+        static_cast<Ogre::Real>(rays[i].origin.Z())),
+        Ogre::Vector3(static_cast<Ogre::Real>(dir.X()),
+        static_cast<Ogre::Real>(dir.Y()), static_cast<Ogre::Real>(dir.Z())));
+    Ogre::Real expected = bruteForce(worldTris, ray, true, false, -1.0f);
+    ASSERT_EQ(expected >= 0, static_cast<bool>(results[i])) << i;
+    if (expected < 0)
+      continue;
+    ++hits;
+    EXPECT_NEAR(expected, results[i].distance, 1e-3) << i;
+    EXPECT_EQ(visual->Id(), results[i].objectId) << i;
+  }
+  // about one ray per triangle hits its front face
+  EXPECT_GE(hits, 200u);
+
+  // the single ray query agrees
+  rayQuery->SetOrigin(rays[0].origin);
+  rayQuery->SetDirection(rays[0].direction);
+  RayQueryResult result = rayQuery->ClosestPoint();
+  EXPECT_EQ(static_cast<bool>(results[0]), static_cast<bool>(result));
+  if (result)
+    EXPECT_NEAR(results[0].distance, result.distance, 1e-3);
+
+  engine->DestroyScene(scene);
+  common::MeshManager::Instance()->RemoveMesh(meshName);
+}
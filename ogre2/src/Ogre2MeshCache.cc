@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/common/Console.hh>
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Mesh.hh>
+#include <gz/common/SubMesh.hh>
+#include <gz/common/Util.hh>
+#include <gz/common/Uuid.hh>
+
+#include "Ogre2MappedFile.hh"
+#include "Ogre2MeshCache.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Magic number at the start of every cache file
+  const uint32_t kMagic = 0x434d5a47u;
+
+  /// \brief Version of the cache file format. Bump it whenever the format
+  /// or the packing done by Ogre2MeshFactory changes.
+  const uint32_t kVersion = 4u;
+
+  /// \brief Extension of cache files
+  const char kExtension[] = ".gzmesh";
+
+  //////////////////////////////////////////////////
+  /// \brief Append raw bytes to a buffer
+  /// \param[in,out] _buffer Buffer to append to
+  /// \param[in] _value Value to append
+  template <typename T>
+  void append(std::vector<char> &_buffer, const T &_value)
+  {
+    const char *bytes = reinterpret_cast<const char *>(&_value);
+    _buffer.insert(_buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Append an array to a buffer
+  /// \param[in,out] _buffer Buffer to append to
+  /// \param[in] _data Array to append
+  /// \param[in] _count Number of elements
+  template <typename T>
+  void appendArray(std::vector<char> &_buffer, const T *_data,
+      std::size_t _count)
+  {
+    const char *bytes = reinterpret_cast<const char *>(_data);
+    _buffer.insert(_buffer.end(), bytes, bytes + _count * sizeof(T));
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Append a string prefixed by its length to a buffer
+  /// \param[in,out] _buffer Buffer to append to
+  /// \param[in] _str String to append
+  void appendString(std::vector<char> &_buffer, const std::string &_str)
+  {
+    append(_buffer, static_cast<uint32_t>(_str.size()));
+    appendArray(_buffer, _str.data(), _str.size());
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Append the components of a vector to a buffer
+  /// \param[in,out] _buffer Buffer to append to
+  /// \param[in] _vec Vector to append
+  void appendVector3(std::vector<char> &_buffer, const math::Vector3d &_vec)
+  {
+    append(_buffer, _vec.X());
+    append(_buffer, _vec.Y());
+    append(_buffer, _vec.Z());
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Read an index array prefixed by its size
+  /// \param[in,out] _file File to read from
+  /// \param[out] _indices Indices read
+  /// \return False if the file is truncated
+  bool readIndices(Ogre2MappedFile &_file, std::vector<uint32_t> &_indices)
+  {
+    uint64_t count = 0u;
+    if (!_file.Read(count) || count > _file.size / sizeof(uint32_t))
+      return false;
+    _indices.resize(static_cast<std::size_t>(count));
+    return _file.ReadArray(_indices.data(), _indices.size());
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshCache::Hash(const MeshDescriptor &_desc,
+    bool _compactVertices, bool _optimize)
+{
+  std::vector<char> buffer;
+  append(buffer, kVersion);
+  append(buffer, _compactVertices);
+  append(buffer, _optimize);
+  appendString(buffer, _desc.subMeshName);
+  append(buffer, _desc.centerSubMesh);
+  std::vector<MeshDescriptor::LodLevel> lodLevels = _desc.LodLevels();
+  append(buffer, static_cast<uint32_t>(lodLevels.size()));
+  for (const auto &lod : lodLevels)
+    append(buffer, lod.triangleRatio);
+
+  const common::Mesh &mesh = *_desc.mesh;
+  const double bounds[6] = {mesh.Min().X(), mesh.Min().Y(), mesh.Min().Z(),
+      mesh.Max().X(), mesh.Max().Y(), mesh.Max().Z()};
+  appendArray(buffer, bounds, 6u);
+  for (unsigned int i = 0; i < mesh.SubMeshCount(); ++i)
+  {
+    auto s = mesh.SubMeshByIndex(i).lock();
+    if (!s)
+      continue;
+
+    appendString(buffer, s->Name());
+    append(buffer, static_cast<int>(s->SubMeshPrimitiveType()));
+    const auto materialIndex = s->GetMaterialIndex();
+    append(buffer, materialIndex ? static_cast<int>(*materialIndex) : -1);
+
+    append(buffer, s->VertexCount());
+    for (unsigned int j = 0; j < s->VertexCount(); ++j)
+      appendVector3(buffer, s->Vertex(j));
+
+    append(buffer, s->NormalCount());
+    for (unsigned int j = 0; j < s->NormalCount(); ++j)
+      appendVector3(buffer, s->Normal(j));
+
+    append(buffer, s->TexCoordSetCount());
+    for (unsigned int k = 0; k < s->TexCoordSetCount(); ++k)
+    {
+      append(buffer, s->TexCoordCountBySet(k));
+      for (unsigned int j = 0; j < s->TexCoordCountBySet(k); ++j)
+      {
+        const math::Vector2d &uv = s->TexCoordBySet(j, k);
+        append(buffer, uv.X());
+        append(buffer, uv.Y());
+      }
+    }
+
+    append(buffer, s->IndexCount());
+    for (unsigned int j = 0; j < s->IndexCount(); ++j)
+      append(buffer, s->Index(j));
+  }
+
+  return common::sha1(buffer.data(), buffer.size());
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshCache::Read(const std::string &_dir, const std::string &_hash,
+    const MeshDescriptor &_desc, Ogre2MeshData &_data)
+{
+  std::string path = common::joinPaths(_dir, _hash + kExtension);
+  Ogre2MappedFile file(path);
+  if (!file.data)
+    return false;
+
+  uint32_t magic = 0u;
+  uint32_t version = 0u;
+  if (!file.Read(magic) || magic != kMagic ||
+      !file.Read(version) || version != kVersion)
+  {
+    gzwarn << "Ignoring mesh cache file with unknown format [" << path
+           << "]" << std::endl;
+    return false;
+  }
+
+  Ogre2MeshData data;
+  double bounds[6];
+  uint32_t subMeshCount = 0u;
+  bool valid = file.ReadArray(bounds, 6u) && file.Read(subMeshCount);
+  data.min.Set(bounds[0], bounds[1], bounds[2]);
+  data.max.Set(bounds[3], bounds[4], bounds[5]);
+
+  for (uint32_t i = 0; valid && i < subMeshCount; ++i)
+  {
+    Ogre2SubMeshData subMesh;
+    uint32_t nameSize = 0u;
+    uint32_t operationType = 0u;
+    uint32_t elementCount = 0u;
+    uint64_t byteCount = 0u;
+
+    valid = file.Read(nameSize) && nameSize <= file.size;
+    if (valid)
+    {
+      subMesh.name.resize(nameSize);
+      valid = file.ReadArray(&subMesh.name[0], nameSize);
+    }
+    valid = valid && file.Read(operationType) &&
+        file.Read(subMesh.materialIndex) && file.Read(elementCount);
+    for (uint32_t e = 0; valid && e < elementCount; ++e)
+    {
+      uint32_t element[2];
+      valid = file.ReadArray(element, 2u);
+      subMesh.vertexElements.push_back(Ogre::VertexElement2(
+          static_cast<Ogre::VertexElementType>(element[0]),
+          static_cast<Ogre::VertexElementSemantic>(element[1])));
+    }
+    valid = valid && file.Read(subMesh.vertexCount) &&
+        file.Read(byteCount) && byteCount <= file.size;
+    if (valid)
+    {
+      subMesh.vertices.resize(static_cast<std::size_t>(byteCount));
+      valid = file.ReadArray(subMesh.vertices.data(),
+          subMesh.vertices.size());
+    }
+    uint32_t lodCount = 0u;
+    valid = valid && readIndices(file, subMesh.indices) &&
+        file.Read(lodCount) && lodCount <= file.size;
+    if (valid)
+      subMesh.lodIndices.resize(lodCount);
+    for (uint32_t l = 0; valid && l < lodCount; ++l)
+      valid = readIndices(file, subMesh.lodIndices[l]);
+    if (!valid)
+      break;
+
+    subMesh.operationType = static_cast<Ogre::OperationType>(operationType);
+    if (subMesh.materialIndex >= 0)
+    {
+      subMesh.material = _desc.mesh->MaterialByIndex(
+          static_cast<unsigned int>(subMesh.materialIndex));
+    }
+    data.subMeshes.push_back(std::move(subMesh));
+  }
+
+  if (!valid)
+  {
+    gzwarn << "Ignoring truncated mesh cache file [" << path << "]"
+           << std::endl;
+    return false;
+  }
+
+  _data = std::move(data);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshCache::Write(const std::string &_dir, const std::string &_hash,
+    const Ogre2MeshData &_data)
+{
+  if (!common::isDirectory(_dir) && !common::createDirectories(_dir))
+  {
+    gzerr << "Unable to create mesh cache directory [" << _dir << "]"
+           << std::endl;
+    return false;
+  }
+
+  std::vector<char> buffer;
+  append(buffer, kMagic);
+  append(buffer, kVersion);
+  const double bounds[6] = {_data.min.X(), _data.min.Y(), _data.min.Z(),
+      _data.max.X(), _data.max.Y(), _data.max.Z()};
+  appendArray(buffer, bounds, 6u);
+  append(buffer, static_cast<uint32_t>(_data.subMeshes.size()));
+  for (const auto &subMesh : _data.subMeshes)
+  {
+    appendString(buffer, subMesh.name);
+    append(buffer, static_cast<uint32_t>(subMesh.operationType));
+    append(buffer, subMesh.materialIndex);
+    append(buffer, static_cast<uint32_t>(subMesh.vertexElements.size()));
+    for (const auto &element : subMesh.vertexElements)
+    {
+      append(buffer, static_cast<uint32_t>(element.mType));
+      append(buffer, static_cast<uint32_t>(element.mSemantic));
+    }
+    append(buffer, subMesh.vertexCount);
+    append(buffer, static_cast<uint64_t>(subMesh.vertices.size()));
+    appendArray(buffer, subMesh.vertices.data(), subMesh.vertices.size());
+    append(buffer, static_cast<uint64_t>(subMesh.indices.size()));
+    appendArray(buffer, subMesh.indices.data(), subMesh.indices.size());
+    append(buffer, static_cast<uint32_t>(subMesh.lodIndices.size()));
+    for (const auto &lod : subMesh.lodIndices)
+    {
+      append(buffer, static_cast<uint64_t>(lod.size()));
+      appendArray(buffer, lod.data(), lod.size());
+    }
+  }
+
+  // write to a unique temporary file first so readers never see a
+  // partially written entry
+  std::string path = common::joinPaths(_dir, _hash + kExtension);
+  std::string tmpPath = path + "." + common::Uuid().String() + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.write(buffer.data(), static_cast<std::streamsize>(
+        buffer.size())))
+    {
+      gzerr << "Unable to write mesh cache file [" << tmpPath << "]"
+             << std::endl;
+      return false;
+    }
+  }
+
+  if (!common::moveFile(tmpPath, path))
+  {
+    common::removeFile(tmpPath);
+    return false;
+  }
+  return true;
+}
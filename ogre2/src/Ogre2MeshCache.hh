@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2MESHCACHE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MESHCACHE_HH_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gz/common/Material.hh>
+#include <gz/math/Vector3.hh>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/MeshDescriptor.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreRenderOperation.h>
+#include <Vao/OgreVertexElements.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief CPU side data of a submesh, ready to be copied to GPU buffers
+struct Ogre2SubMeshData
+{
+  /// \brief Name of the submesh
+  std::string name;
+
+  /// \brief Render operation type
+  Ogre::OperationType operationType = Ogre::OT_TRIANGLE_LIST;
+
+  /// \brief Layout of a vertex
+  Ogre::VertexElement2Vec vertexElements;
+
+  /// \brief Interleaved vertex data, laid out as described by
+  /// vertexElements
+  std::vector<uint8_t> vertices;
+
+  /// \brief Number of vertices
+  uint32_t vertexCount = 0u;
+
+  /// \brief Index data
+  std::vector<uint32_t> indices;
+
+  /// \brief Index data of each generated level of detail, empty for non
+  /// indexed submeshes
+  std::vector<std::vector<uint32_t>> lodIndices;
+
+  /// \brief Index of the material in the source mesh, -1 if none
+  int materialIndex = -1;
+
+  /// \brief Material of the submesh, null to use the default material
+  common::MaterialPtr material;
+};
+
+/// \brief CPU side data of a mesh, ready to be copied to GPU buffers
+struct Ogre2MeshData
+{
+  /// \brief Submeshes
+  std::vector<Ogre2SubMeshData> subMeshes;
+
+  /// \brief Min corner of the mesh bounds
+  math::Vector3d min;
+
+  /// \brief Max corner of the mesh bounds
+  math::Vector3d max;
+
+  /// \brief Screen ratio below which each generated level of detail is
+  /// drawn. Taken from the descriptor, not stored in the cache.
+  std::vector<double> lodScreenRatios;
+};
+
+/// \brief On-disk cache of packed mesh data, including generated levels
+/// of detail. Each mesh is stored in a flat binary file named after a SHA1
+/// hash of the source mesh data and of the descriptor options that affect
+/// packing, so a mesh whose content changes gets a new entry. Files are
+/// written to a temporary name and renamed so concurrent writers never
+/// produce partial entries. Materials are not stored; they are looked up in
+/// the source mesh when an entry is read.
+/// All functions are safe to call from any thread.
+class Ogre2MeshCache
+{
+  /// \brief Compute the cache key of a mesh
+  /// \param[in] _desc Loaded mesh descriptor
+  /// \param[in] _compactVertices True if the compact vertex layout is used
+  /// \param[in] _optimize True if triangle and vertex order is optimized
+  /// \return SHA1 hash of the mesh content and packing options
+  public: static std::string Hash(const MeshDescriptor &_desc,
+      bool _compactVertices, bool _optimize);
+
+  /// \brief Read a cache entry. The file is memory mapped where supported.
+  /// \param[in] _dir Cache directory
+  /// \param[in] _hash Cache key returned by Hash
+  /// \param[in] _desc Loaded mesh descriptor, used to resolve materials
+  /// \param[out] _data Packed mesh data
+  /// \return True if the entry exists and is valid
+  public: static bool Read(const std::string &_dir, const std::string &_hash,
+      const MeshDescriptor &_desc, Ogre2MeshData &_data);
+
+  /// \brief Write a cache entry
+  /// \param[in] _dir Cache directory, created if missing
+  /// \param[in] _hash Cache key returned by Hash
+  /// \param[in] _data Packed mesh data
+  /// \return True on success
+  public: static bool Write(const std::string &_dir, const std::string &_hash,
+      const Ogre2MeshData &_data);
+};
+}
+}
+}
+#endif
@@ -15,8 +15,16 @@
  *
  */
 
-
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/common/Material.hh>
@@ -24,6 +32,7 @@
 #include <gz/common/Skeleton.hh>
 #include <gz/common/SkeletonAnimation.hh>
 #include <gz/common/SubMesh.hh>
+#include <gz/common/WorkerPool.hh>
 
 #include <gz/math/Matrix4.hh>
 
@@ -35,42 +44,353 @@
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
 
+#include "Ogre2MeshCache.hh"
+#include "Ogre2MeshOptimizer.hh"
+#include "Ogre2MeshSimplifier.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
+#include <OgreBitwise.h>
 #include <OgreHardwareBufferManager.h>
 #include <OgreItem.h>
 #include <OgreKeyFrame.h>
+#include <OgreLodStrategy.h>
+#include <OgreLodStrategyManager.h>
+#include <OgreMatrix3.h>
 #include <OgreMesh2.h>
 #include <OgreMeshManager.h>
 #include <OgreMeshManager2.h>
 #include <OgreOldBone.h>
 #include <OgreOldSkeletonManager.h>
+#include <OgrePixelCountLodStrategy.h>
+#include <OgreQuaternion.h>
 #include <OgreSceneManager.h>
 #include <OgreSkeleton.h>
 #include <OgreSubItem.h>
 #include <OgreSubMesh.h>
 #include <OgreSubMesh2.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVaoManager.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
+using namespace gz;
+using namespace rendering;
+
+/// \brief A mesh created asynchronously
+struct Ogre2AsyncMeshJob
+{
+  /// \brief Loaded descriptor of the mesh
+  MeshDescriptor desc;
+
+  /// \brief Packed mesh data, filled by a worker thread
+  Ogre2MeshData data;
+
+  /// \brief Mesh cache directory, empty if disabled
+  std::string cacheDir;
+
+  /// \brief True to use the compact vertex layout
+  bool compactVertices = false;
+
+  /// \brief True to optimize triangle and vertex order
+  bool optimize = false;
+
+  /// \brief True if the mesh data is packed by a worker thread
+  bool async = false;
+
+  /// \brief True if the worker thread packed the mesh data successfully
+  bool prepared = false;
+
+  /// \brief Callback receiving the created mesh
+  std::function<void(Ogre2MeshPtr)> callback;
+};
+
 /// \brief Private data for the Ogre2MeshFactory class
 class gz::rendering::Ogre2MeshFactoryPrivate
 {
+  /// \brief Pack the submeshes of a mesh into interleaved vertex and index
+  /// arrays. Only reads the mesh descriptor so it is safe to call from any
+  /// thread.
+  /// \param[in] _desc Mesh descriptor
+  /// \param[in] _compactVertices True to use the compact vertex layout
+  /// \param[in] _optimize True to optimize triangle and vertex order
+  /// \param[out] _data Packed mesh data
+  /// \return True on success
+  public: static bool PrepareMeshData(const MeshDescriptor &_desc,
+              bool _compactVertices, bool _optimize, Ogre2MeshData &_data);
+
+  /// \brief Get the packed data of a mesh from the mesh cache, or pack it
+  /// with PrepareMeshData and add it to the cache. Safe to call from any
+  /// thread.
+  /// \param[in] _desc Mesh descriptor
+  /// \param[in] _cacheDir Mesh cache directory, empty to disable the cache
+  /// \param[in] _compactVertices True to use the compact vertex layout
+  /// \param[in] _optimize True to optimize triangle and vertex order
+  /// \param[out] _data Packed mesh data
+  /// \return True on success
+  public: static bool LoadMeshData(const MeshDescriptor &_desc,
+              const std::string &_cacheDir, bool _compactVertices,
+              bool _optimize, Ogre2MeshData &_data);
+
+  /// \brief Create a v2 mesh from packed mesh data. Must be called from
+  /// the render thread.
+  /// \param[in] _scene Scene creating the submesh materials
+  /// \param[in] _name Name of the mesh
+  /// \param[in] _data Packed mesh data
+  /// \return True on success
+  public: bool CreateMesh(Ogre2ScenePtr _scene, const std::string &_name,
+              const Ogre2MeshData &_data);
+
+  /// \brief Create the material of a submesh
+  /// \param[in] _scene Scene creating the material
+  /// \param[in] _material Material of the submesh, null to use the default
+  /// material
+  /// \return The material
+  public: MaterialPtr CreateMaterial(Ogre2ScenePtr _scene,
+              const common::MaterialPtr &_material);
+
   /// \brief Vector with the template materials, we keep the pointer to be
   /// able to remove it when nobody is using it.
   public: std::vector<MaterialPtr> materialCache;
+
+  /// \brief Mutex protecting readyJobs
+  public: std::mutex asyncMutex;
+
+  /// \brief Asynchronous jobs waiting for their mesh to be created on the
+  /// render thread
+  public: std::vector<std::shared_ptr<Ogre2AsyncMeshJob>> readyJobs;
+
+  /// \brief Worker threads packing mesh data, created on first use.
+  /// Declared last so it is destroyed first, while the jobs it runs can
+  /// still access readyJobs.
+  public: std::unique_ptr<common::WorkerPool> workerPool;
 };
 
+namespace
+{
+  //////////////////////////////////////////////////
+  /// \brief Convert a submesh primitive type to an ogre operation type
+  /// \param[in] _type Primitive type
+  /// \param[out] _opType Ogre operation type
+  /// \return False if the primitive type is unknown
+  bool convertPrimitiveType(common::SubMesh::PrimitiveType _type,
+      Ogre::OperationType &_opType)
+  {
+    switch (_type)
+    {
+      case common::SubMesh::TRIANGLES:
+        _opType = Ogre::OT_TRIANGLE_LIST;
+        return true;
+      case common::SubMesh::LINES:
+        _opType = Ogre::OT_LINE_LIST;
+        return true;
+      case common::SubMesh::LINESTRIPS:
+        _opType = Ogre::OT_LINE_STRIP;
+        return true;
+      case common::SubMesh::TRIFANS:
+        _opType = Ogre::OT_TRIANGLE_FAN;
+        return true;
+      case common::SubMesh::TRISTRIPS:
+        _opType = Ogre::OT_TRIANGLE_STRIP;
+        return true;
+      case common::SubMesh::POINTS:
+        _opType = Ogre::OT_POINT_LIST;
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// \brief Max absolute coordinate of the vertices of a submesh for which
+  /// half float positions are used by the compact vertex layout. Half floats
+  /// have an 11 bit significand so the rounding error stays below 1 mm.
+  const float kMaxHalfPosition = 2.048f;
+
+  //////////////////////////////////////////////////
+  /// \brief Convert a float in [-1, 1] to a 16 bit signed normalized int
+  /// \param[in] _value Value to convert
+  /// \return Converted value
+  int16_t floatToSnorm16(float _value)
+  {
+    return static_cast<int16_t>(
+        std::round(std::clamp(_value, -1.0f, 1.0f) * 32767.0f));
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Encode a normal as a QTangent, a quaternion rotating the
+  /// tangent frame. The tangent is an arbitrary vector perpendicular to
+  /// the normal since submeshes have no tangents.
+  /// \param[in] _normal Normal to encode
+  /// \param[out] _qtangent The 4 components of the QTangent
+  void encodeQTangent(const float *_normal, int16_t *_qtangent)
+  {
+    Ogre::Vector3 normal(_normal[0], _normal[1], _normal[2]);
+    if (normal.normalise() <= 0)
+      normal = Ogre::Vector3::UNIT_Z;
+    Ogre::Vector3 tangent = normal.perpendicular();
+    Ogre::Vector3 binormal = normal.crossProduct(tangent);
+
+    Ogre::Matrix3 tbn;
+    tbn.FromAxes(tangent, binormal, normal);
+    Ogre::Quaternion q(tbn);
+    q.normalise();
+
+    // w is kept positive, a negative w would flag a reflected frame
+    if (q.w < 0)
+      q = -q;
+    const Ogre::Real bias = 1.0f / 32767.0f;
+    if (q.w < bias)
+    {
+      Ogre::Real factor = std::sqrt(1 - bias * bias);
+      q.w = bias;
+      q.x *= factor;
+      q.y *= factor;
+      q.z *= factor;
+    }
+
+    _qtangent[0] = floatToSnorm16(q.x);
+    _qtangent[1] = floatToSnorm16(q.y);
+    _qtangent[2] = floatToSnorm16(q.z);
+    _qtangent[3] = floatToSnorm16(q.w);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Write the vertex buffer data and layout of a submesh
+  /// \param[in] _floats Interleaved float vertices: position, normal if
+  /// _hasNormals, then _texCoordSetCount texture coordinates
+  /// \param[in] _hasNormals True if vertices have a normal
+  /// \param[in] _texCoordSetCount Number of texture coordinate sets
+  /// \param[in] _compact True to use half float positions when they are
+  /// accurate enough, QTangent normals and half float texture coordinates
+  /// \param[in,out] _subMesh Submesh whose vertices and vertexElements are
+  /// written
+  void packVertices(const std::vector<float> &_floats, bool _hasNormals,
+      std::size_t _texCoordSetCount, bool _compact,
+      Ogre2SubMeshData &_subMesh)
+  {
+    std::size_t floatsPerVertex =
+        3u + (_hasNormals ? 3u : 0u) + 2u * _texCoordSetCount;
+    _subMesh.vertexElements.clear();
+
+    if (!_compact)
+    {
+      _subMesh.vertexElements.push_back(
+          Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+      if (_hasNormals)
+      {
+        _subMesh.vertexElements.push_back(
+            Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_NORMAL));
+      }
+      for (std::size_t k = 0u; k < _texCoordSetCount; ++k)
+      {
+        _subMesh.vertexElements.push_back(Ogre::VertexElement2(
+            Ogre::VET_FLOAT2, Ogre::VES_TEXTURE_COORDINATES));
+      }
+      const uint8_t *bytes = reinterpret_cast<const uint8_t *>(_floats.data());
+      _subMesh.vertices.assign(bytes, bytes + _floats.size() * sizeof(float));
+      return;
+    }
+
+    float maxPosition = 0.0f;
+    for (std::size_t i = 0; i < _floats.size(); i += floatsPerVertex)
+    {
+      for (std::size_t k = 0; k < 3u; ++k)
+        maxPosition = std::max(maxPosition, std::abs(_floats[i + k]));
+    }
+    bool halfPosition = maxPosition <= kMaxHalfPosition;
+
+    _subMesh.vertexElements.push_back(Ogre::VertexElement2(
+        halfPosition ? Ogre::VET_HALF4 : Ogre::VET_FLOAT3,
+        Ogre::VES_POSITION));
+    if (_hasNormals)
+    {
+      _subMesh.vertexElements.push_back(
+          Ogre::VertexElement2(Ogre::VET_SHORT4_SNORM, Ogre::VES_NORMAL));
+    }
+    for (std::size_t k = 0u; k < _texCoordSetCount; ++k)
+    {
+      _subMesh.vertexElements.push_back(Ogre::VertexElement2(
+          Ogre::VET_HALF2, Ogre::VES_TEXTURE_COORDINATES));
+    }
+
+    std::size_t bytesPerVertex = (halfPosition ? 8u : 12u) +
+        (_hasNormals ? 8u : 0u) + 4u * _texCoordSetCount;
+    _subMesh.vertices.resize(_subMesh.vertexCount * bytesPerVertex);
+    uint8_t *out = _subMesh.vertices.data();
+    const float *in = _floats.data();
+    for (uint32_t v = 0; v < _subMesh.vertexCount; ++v)
+    {
+      if (halfPosition)
+      {
+        uint16_t position[4] = {Ogre::Bitwise::floatToHalf(in[0]),
+            Ogre::Bitwise::floatToHalf(in[1]),
+            Ogre::Bitwise::floatToHalf(in[2]),
+            Ogre::Bitwise::floatToHalf(1.0f)};
+        std::memcpy(out, position, sizeof(position));
+        out += sizeof(position);
+      }
+      else
+      {
+        std::memcpy(out, in, 3u * sizeof(float));
+        out += 3u * sizeof(float);
+      }
+      in += 3u;
+
+      if (_hasNormals)
+      {
+        int16_t qtangent[4];
+        encodeQTangent(in, qtangent);
+        std::memcpy(out, qtangent, sizeof(qtangent));
+        out += sizeof(qtangent);
+        in += 3u;
+      }
+
+      for (std::size_t k = 0u; k < _texCoordSetCount; ++k)
+      {
+        uint16_t uv[2] = {Ogre::Bitwise::floatToHalf(in[0]),
+            Ogre::Bitwise::floatToHalf(in[1])};
+        std::memcpy(out, uv, sizeof(uv));
+        out += sizeof(uv);
+        in += 2u;
+      }
+    }
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Create an immutable index buffer, using 16 bit indices when
+  /// all vertices can be addressed with them. 0xFFFF is not used as it
+  /// restarts strips.
+  /// \param[in] _vaoManager Vao manager creating the buffer
+  /// \param[in] _indices Indices
+  /// \param[in] _vertexCount Number of vertices the indices refer to
+  /// \return The index buffer, null if _indices is empty
+  Ogre::IndexBufferPacked *createIndexBuffer(Ogre::VaoManager *_vaoManager,
+      const std::vector<uint32_t> &_indices, uint32_t _vertexCount)
+  {
+    if (_indices.empty())
+      return nullptr;
+
+    // immutable buffers copy their data on creation
+    if (_vertexCount <= 0xFFFFu)
+    {
+      std::vector<uint16_t> indices16(_indices.begin(), _indices.end());
+      return _vaoManager->createIndexBuffer(
+          Ogre::IndexBufferPacked::IT_16BIT, indices16.size(),
+          Ogre::BT_IMMUTABLE, indices16.data(), false);
+    }
+    return _vaoManager->createIndexBuffer(
+        Ogre::IndexBufferPacked::IT_32BIT, _indices.size(),
+        Ogre::BT_IMMUTABLE, const_cast<uint32_t *>(_indices.data()), false);
+  }
+}
+
 /// \brief Private data for the Ogre2SubMeshStoreFactory class
 class gz::rendering::Ogre2SubMeshStoreFactoryPrivate
 {
 };
 
-using namespace gz;
-using namespace rendering;
-
 //////////////////////////////////////////////////
 Ogre2MeshFactory::Ogre2MeshFactory(Ogre2ScenePtr _scene) :
   scene(_scene), dataPtr(std::make_unique<Ogre2MeshFactoryPrivate>())
@@ -139,6 +459,96 @@ Ogre2MeshPtr Ogre2MeshFactory::Create(const MeshDescriptor &_desc)
   return mesh;
 }
 
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::CreateAsync(const MeshDescriptor &_desc,
+    std::function<void(Ogre2MeshPtr)> _callback)
+{
+  auto job = std::make_shared<Ogre2AsyncMeshJob>();
+  job->desc = _desc;
+  job->desc.Load();
+  job->callback = std::move(_callback);
+
+  // meshes that are invalid, already loaded or that have a skeleton are
+  // handled synchronously on the next PreRender
+  if (!this->Validate(job->desc) || this->IsLoaded(job->desc) ||
+      job->desc.mesh->HasSkeleton())
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->asyncMutex);
+    this->dataPtr->readyJobs.push_back(job);
+    return;
+  }
+
+  job->async = true;
+  job->cacheDir = Ogre2RenderEngine::Instance()->MeshCacheDir();
+  job->compactVertices = Ogre2RenderEngine::Instance()->CompactMeshVertices();
+  job->optimize = Ogre2RenderEngine::Instance()->OptimizeMeshes();
+  if (!this->dataPtr->workerPool)
+    this->dataPtr->workerPool = std::make_unique<common::WorkerPool>();
+
+  Ogre2MeshFactoryPrivate *priv = this->dataPtr.get();
+  this->dataPtr->workerPool->AddWork([job, priv]()
+      {
+        job->prepared = Ogre2MeshFactoryPrivate::LoadMeshData(job->desc,
+            job->cacheDir, job->compactVertices, job->optimize, job->data);
+        std::lock_guard<std::mutex> lock(priv->asyncMutex);
+        priv->readyJobs.push_back(job);
+      });
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::ProcessAsyncLoads()
+{
+  std::vector<std::shared_ptr<Ogre2AsyncMeshJob>> jobs;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->asyncMutex);
+    jobs.swap(this->dataPtr->readyJobs);
+  }
+
+  for (auto &job : jobs)
+  {
+    if (job->async && !job->prepared)
+    {
+      gzerr << "Failed to load mesh [" << job->desc.meshName << "]"
+             << std::endl;
+      job->callback(nullptr);
+      continue;
+    }
+
+    // the mesh may have been created by another job meanwhile
+    if (job->prepared && !this->IsLoaded(job->desc))
+    {
+      Ogre2RenderEngine::Instance()->AddResourcePath(job->desc.mesh->Path());
+      std::string name = this->MeshName(job->desc);
+      if (!this->dataPtr->CreateMesh(this->scene, name, job->data))
+      {
+        job->callback(nullptr);
+        continue;
+      }
+      this->ogreMeshes.push_back(name);
+    }
+
+    // release the packed data before creating the item
+    job->data = Ogre2MeshData();
+    job->callback(this->Create(job->desc));
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshFactory::CancelAsyncLoads()
+{
+  if (this->dataPtr->workerPool)
+    this->dataPtr->workerPool->WaitForResults();
+
+  std::vector<std::shared_ptr<Ogre2AsyncMeshJob>> jobs;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->asyncMutex);
+    jobs.swap(this->dataPtr->readyJobs);
+  }
+
+  for (auto &job : jobs)
+    job->callback(nullptr);
+}
+
 //////////////////////////////////////////////////
 Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
 {
@@ -197,13 +607,46 @@ bool Ogre2MeshFactory::IsLoaded(const MeshDescriptor &_desc)
 
 //////////////////////////////////////////////////
 bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
+{
+  Ogre2RenderEngine::Instance()->AddResourcePath(_desc.mesh->Path());
+
+  // Ogre 2.x skeletons are created from v1 skeletons when importing a v1
+  // mesh so skeletal meshes still go through a v1 mesh
+  if (_desc.mesh->HasSkeleton())
+    return this->LoadV1Impl(_desc);
+
+  Ogre2MeshData data;
+  Ogre2RenderEngine *engine = Ogre2RenderEngine::Instance();
+  if (!Ogre2MeshFactoryPrivate::LoadMeshData(_desc, engine->MeshCacheDir(),
+      engine->CompactMeshVertices(), engine->OptimizeMeshes(), data))
+  {
+    return false;
+  }
+
+  std::string name = this->MeshName(_desc);
+  if (!this->dataPtr->CreateMesh(this->scene, name, data))
+    return false;
+  this->ogreMeshes.push_back(name);
+
+  if (data.subMeshes.empty())
+  {
+    std::string msg = "Unable to load mesh: '" + _desc.meshName + "'";
+    if (!_desc.subMeshName.empty())
+      msg += ", submesh: '" + _desc.subMeshName + "'";
+    msg += ". Mesh will be empty.";
+    gzwarn << msg << std::endl;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::LoadV1Impl(const MeshDescriptor &_desc)
 {
   Ogre::v1::MeshPtr ogreMesh;
   std::string name;
   std::string group;
 
-  Ogre2RenderEngine::Instance()->AddResourcePath(_desc.mesh->Path());
-
   try
   {
     name = this->MeshName(_desc);
@@ -323,33 +766,8 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
 
       ogreSubMesh = ogreMesh->createSubMesh(subMesh.Name());
       ogreSubMesh->useSharedVertices = false;
-      if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIANGLES)
-      {
-        ogreSubMesh->operationType =
-            Ogre::OT_TRIANGLE_LIST;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::LINES)
-      {
-        ogreSubMesh->operationType = Ogre::OT_LINE_LIST;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::LINESTRIPS)
-      {
-        ogreSubMesh->operationType = Ogre::OT_LINE_STRIP;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRIFANS)
-      {
-        ogreSubMesh->operationType = Ogre::OT_TRIANGLE_FAN;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::TRISTRIPS)
-      {
-        ogreSubMesh->operationType =
-            Ogre::OT_TRIANGLE_STRIP;
-      }
-      else if (subMesh.SubMeshPrimitiveType() == common::SubMesh::POINTS)
-      {
-        ogreSubMesh->operationType = Ogre::OT_POINT_LIST;
-      }
-      else
+      if (!convertPrimitiveType(subMesh.SubMeshPrimitiveType(),
+          ogreSubMesh->operationType))
       {
         gzerr << "Unknown primitive type["
               << subMesh.SubMeshPrimitiveType() << "]\n";
@@ -475,18 +893,7 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
         material = _desc.mesh->MaterialByIndex(subMeshIdx.value());
       }
 
-      MaterialPtr mat = this->scene->CreateMaterial();
-      if (material)
-      {
-        mat->CopyFrom(*material);
-        this->dataPtr->materialCache.push_back(mat);
-      }
-      else
-      {
-        MaterialPtr defaultMat = this->scene->Material("Default/White");
-        if (defaultMat != nullptr)
-          mat->CopyFrom(defaultMat);
-      }
+      MaterialPtr mat = this->dataPtr->CreateMaterial(this->scene, material);
       ogreSubMesh->setMaterialName(mat->Name());
     }
 
@@ -543,6 +950,351 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
   return true;
 }
 
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::PrepareMeshData(const MeshDescriptor &_desc,
+    bool _compactVertices, bool _optimize, Ogre2MeshData &_data)
+{
+  _data.max = _desc.mesh->Max();
+  _data.min = _desc.mesh->Min();
+
+  if (!_data.max.IsFinite())
+  {
+    gzerr << "Max bounding box is not finite[" << _data.max << "]"
+           << std::endl;
+    return false;
+  }
+
+  if (!_data.min.IsFinite())
+  {
+    gzerr << "Min bounding box is not finite[" << _data.min << "]"
+           << std::endl;
+    return false;
+  }
+
+  std::vector<MeshDescriptor::LodLevel> lodLevels = _desc.LodLevels();
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+  {
+    // if submesh is specified then load only that particular submesh
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (!s || (!_desc.subMeshName.empty() && s->Name() != _desc.subMeshName))
+    {
+      continue;
+    }
+
+    // Vertex buffers can not be empty, so an empty submesh gets a single
+    // degenerate triangle that draws nothing. It still needs an entry to
+    // keep submesh indices the same as in the source mesh.
+    if (s->VertexCount() == 0u)
+    {
+      Ogre2SubMeshData subMeshData;
+      subMeshData.name = s->Name();
+      subMeshData.vertexCount = 3u;
+      subMeshData.indices = {0u, 1u, 2u};
+      subMeshData.lodIndices.assign(lodLevels.size(), subMeshData.indices);
+      packVertices(std::vector<float>(3u * 3u, 0.0f), false, 0u,
+          _compactVertices, subMeshData);
+      if (const auto subMeshIdx = s->GetMaterialIndex())
+      {
+        subMeshData.materialIndex = static_cast<int>(subMeshIdx.value());
+        subMeshData.material =
+            _desc.mesh->MaterialByIndex(subMeshIdx.value());
+      }
+      _data.subMeshes.push_back(std::move(subMeshData));
+      continue;
+    }
+
+    // Copy the original submesh. We may need to modify the vertices, and
+    // we don't want to change the original.
+    common::SubMesh subMesh(*s.get());
+
+    // Recenter the vertices if requested.
+    if (_desc.centerSubMesh)
+      subMesh.Center(math::Vector3d::Zero);
+
+    Ogre2SubMeshData subMeshData;
+    subMeshData.name = subMesh.Name();
+    if (!convertPrimitiveType(subMesh.SubMeshPrimitiveType(),
+        subMeshData.operationType))
+    {
+      gzerr << "Unknown primitive type["
+            << subMesh.SubMeshPrimitiveType() << "]\n";
+    }
+
+    // Interleaved layout: position, normal, then every texture coordinate
+    // set
+    bool hasNormals = subMesh.NormalCount() > 0u;
+    std::vector<unsigned int> texCoordSets;
+    for (unsigned int k = 0u; k < subMesh.TexCoordSetCount(); ++k)
+    {
+      if (subMesh.TexCoordCountBySet(k) > 0u)
+        texCoordSets.push_back(k);
+    }
+
+    std::size_t floatsPerVertex =
+        3u + (hasNormals ? 3u : 0u) + 2u * texCoordSets.size();
+    subMeshData.vertexCount = subMesh.VertexCount();
+    std::vector<float> floats(subMeshData.vertexCount * floatsPerVertex);
+
+    float *vertices = floats.data();
+    for (unsigned int j = 0; j < subMesh.VertexCount(); ++j)
+    {
+      const math::Vector3d &v = subMesh.Vertex(j);
+      *vertices++ = static_cast<float>(v.X());
+      *vertices++ = static_cast<float>(v.Y());
+      *vertices++ = static_cast<float>(v.Z());
+
+      if (hasNormals)
+      {
+        const math::Vector3d &n = subMesh.Normal(j);
+        *vertices++ = static_cast<float>(n.X());
+        *vertices++ = static_cast<float>(n.Y());
+        *vertices++ = static_cast<float>(n.Z());
+      }
+
+      for (unsigned int k : texCoordSets)
+      {
+        const math::Vector2d &uv = subMesh.TexCoordBySet(j, k);
+        *vertices++ = static_cast<float>(uv.X());
+        *vertices++ = static_cast<float>(uv.Y());
+      }
+    }
+
+    subMeshData.indices.resize(subMesh.IndexCount());
+    for (unsigned int j = 0; j < subMesh.IndexCount(); ++j)
+      subMeshData.indices[j] = static_cast<uint32_t>(subMesh.Index(j));
+
+    bool optimize = _optimize &&
+        subMeshData.operationType == Ogre::OT_TRIANGLE_LIST &&
+        !subMeshData.indices.empty() &&
+        *std::max_element(subMeshData.indices.begin(),
+            subMeshData.indices.end()) < subMeshData.vertexCount;
+
+    // Reorder triangles before generating levels of detail, which keep the
+    // order of the triangles they retain
+    if (optimize)
+    {
+      Ogre2MeshOptimizer::OptimizeTriangleOrder(subMeshData.indices,
+          floats.data(), subMeshData.vertexCount, floatsPerVertex);
+    }
+
+    // Levels of detail only replace the index buffer so the vertex buffer
+    // is shared by all levels
+    if (!lodLevels.empty())
+    {
+      bool simplify = subMeshData.operationType == Ogre::OT_TRIANGLE_LIST &&
+          !subMeshData.indices.empty();
+      std::unique_ptr<Ogre2MeshSimplifier> simplifier;
+      if (simplify)
+      {
+        simplifier = std::make_unique<Ogre2MeshSimplifier>(
+            floats.data(), subMeshData.vertexCount, floatsPerVertex,
+            subMeshData.indices);
+      }
+      for (const auto &lod : lodLevels)
+      {
+        if (!simplify)
+        {
+          subMeshData.lodIndices.push_back(subMeshData.indices);
+          continue;
+        }
+
+        std::size_t target = static_cast<std::size_t>(
+            lod.triangleRatio * subMeshData.indices.size() / 3.0) * 3u;
+        const std::vector<uint32_t> &lodIndices =
+            simplifier->Simplify(std::max<std::size_t>(target, 3u));
+        // index buffers can not be empty either
+        if (lodIndices.empty())
+        {
+          subMeshData.lodIndices.push_back(subMeshData.lodIndices.empty() ?
+              subMeshData.indices : subMeshData.lodIndices.back());
+        }
+        else
+        {
+          subMeshData.lodIndices.push_back(lodIndices);
+        }
+      }
+    }
+
+    // Collapsed edges change which vertices triangles share, so levels of
+    // detail are reordered for the vertex cache again. Vertices are then
+    // sorted by first use in the full detail level, followed by any vertex
+    // only used by a level of detail.
+    if (optimize)
+    {
+      std::vector<std::vector<uint32_t> *> indexLists = {&subMeshData.indices};
+      for (auto &lodIndices : subMeshData.lodIndices)
+      {
+        Ogre2MeshOptimizer::OptimizeVertexCache(lodIndices,
+            subMeshData.vertexCount);
+        indexLists.push_back(&lodIndices);
+      }
+      subMeshData.vertexCount = Ogre2MeshOptimizer::OptimizeVertexFetch(
+          floats, floatsPerVertex, subMeshData.indices, indexLists);
+    }
+
+    packVertices(floats, hasNormals, texCoordSets.size(), _compactVertices,
+        subMeshData);
+
+    if (const auto subMeshIdx = subMesh.GetMaterialIndex())
+    {
+      subMeshData.materialIndex = static_cast<int>(subMeshIdx.value());
+      subMeshData.material = _desc.mesh->MaterialByIndex(subMeshIdx.value());
+    }
+
+    _data.subMeshes.push_back(std::move(subMeshData));
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::LoadMeshData(const MeshDescriptor &_desc,
+    const std::string &_cacheDir, bool _compactVertices, bool _optimize,
+    Ogre2MeshData &_data)
+{
+  _data.lodScreenRatios.clear();
+  for (const auto &lod : _desc.LodLevels())
+    _data.lodScreenRatios.push_back(lod.screenRatio);
+
+  if (_cacheDir.empty())
+    return PrepareMeshData(_desc, _compactVertices, _optimize, _data);
+
+  std::string hash = Ogre2MeshCache::Hash(_desc, _compactVertices,
+      _optimize);
+  std::vector<double> lodScreenRatios = _data.lodScreenRatios;
+  if (Ogre2MeshCache::Read(_cacheDir, hash, _desc, _data))
+  {
+    _data.lodScreenRatios = lodScreenRatios;
+    return true;
+  }
+
+  if (!PrepareMeshData(_desc, _compactVertices, _optimize, _data))
+    return false;
+
+  Ogre2MeshCache::Write(_cacheDir, hash, _data);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshFactoryPrivate::CreateMesh(Ogre2ScenePtr _scene,
+    const std::string &_name, const Ogre2MeshData &_data)
+{
+  Ogre::VaoManager *vaoManager = _scene->OgreSceneManager()->
+      getDestinationRenderSystem()->getVaoManager();
+
+  Ogre::MeshPtr ogreMesh;
+  try
+  {
+    ogreMesh = Ogre::MeshManager::getSingleton().createManual(_name,
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    for (const auto &subMeshData : _data.subMeshes)
+    {
+      // The data is copied to the GPU and not kept as a shadow copy
+      Ogre::VertexBufferPacked *vertexBuffer = vaoManager->createVertexBuffer(
+          subMeshData.vertexElements, subMeshData.vertexCount,
+          Ogre::BT_IMMUTABLE,
+          const_cast<uint8_t *>(subMeshData.vertices.data()), false);
+
+      Ogre::IndexBufferPacked *indexBuffer = createIndexBuffer(vaoManager,
+          subMeshData.indices, subMeshData.vertexCount);
+
+      Ogre::VertexBufferPackedVec vertexBuffers;
+      vertexBuffers.push_back(vertexBuffer);
+      Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+          vertexBuffers, indexBuffer, subMeshData.operationType);
+
+      Ogre::SubMesh *ogreSubMesh = ogreMesh->createSubMesh();
+      ogreSubMesh->mVao[Ogre::VpNormal].push_back(vao);
+      // Use the same geometry for shadow casting.
+      ogreSubMesh->mVao[Ogre::VpShadow].push_back(vao);
+
+      // Every level of detail shares the vertex buffer. Ogre destroys
+      // buffers shared by several vaos only once.
+      for (const auto &lodIndices : subMeshData.lodIndices)
+      {
+        Ogre::IndexBufferPacked *lodIndexBuffer = createIndexBuffer(
+            vaoManager, lodIndices, subMeshData.vertexCount);
+        Ogre::VertexArrayObject *lodVao =
+            vaoManager->createVertexArrayObject(vertexBuffers,
+            lodIndexBuffer, subMeshData.operationType);
+        ogreSubMesh->mVao[Ogre::VpNormal].push_back(lodVao);
+        ogreSubMesh->mVao[Ogre::VpShadow].push_back(lodVao);
+      }
+      ogreMesh->nameSubMesh(subMeshData.name,
+          static_cast<uint16_t>(ogreMesh->getNumSubMeshes() - 1u));
+
+      MaterialPtr mat = this->CreateMaterial(_scene, subMeshData.material);
+      ogreSubMesh->setMaterialName(mat->Name());
+    }
+
+    ogreMesh->_setBounds(Ogre::Aabb::newFromExtents(
+        Ogre2Conversions::Convert(_data.min),
+        Ogre2Conversions::Convert(_data.max)), false);
+    ogreMesh->_setBoundingSphereRadius(
+        static_cast<Ogre::Real>((_data.max - _data.min).Length()));
+
+    if (!_data.lodScreenRatios.empty())
+    {
+      // Generated levels of detail are selected by each camera from the
+      // fraction of its image covered by the mesh. Ogre selects the level
+      // of detail of every item with the default strategy, so it is only
+      // changed once a mesh with generated levels of detail is created.
+      // This applies to all scenes of the engine, including meshes loaded
+      // with distance based levels of detail, until the Ogre root is
+      // destroyed with the engine. See MeshDescriptor::SetLodLevels.
+      Ogre::LodStrategy *strategy =
+          Ogre::ScreenRatioPixelCountLodStrategy::getSingletonPtr();
+      Ogre::LodStrategyManager &lodStrategyManager =
+          Ogre::LodStrategyManager::getSingleton();
+      if (lodStrategyManager.getDefaultStrategy() != strategy)
+        lodStrategyManager.setDefaultStrategy(strategy);
+
+      // v2 meshes have no public setter for their lod values, the mesh
+      // serializer and importV1 fill this array directly
+      auto *lodValues = const_cast<Ogre::Mesh::LodValueArray *>(
+          ogreMesh->_getLodValueArray());
+      lodValues->clear();
+      lodValues->push_back(strategy->getBaseValue());
+      for (double ratio : _data.lodScreenRatios)
+      {
+        lodValues->push_back(strategy->transformUserValue(
+            static_cast<Ogre::Real>(ratio)));
+      }
+    }
+  }
+  catch(Ogre::Exception &e)
+  {
+    gzerr << "Unable to insert mesh[" << e.getDescription() << "]"
+        << std::endl;
+    // removing the mesh also destroys the buffers of its submeshes
+    if (ogreMesh)
+      Ogre::MeshManager::getSingleton().remove(_name);
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+MaterialPtr Ogre2MeshFactoryPrivate::CreateMaterial(Ogre2ScenePtr _scene,
+    const common::MaterialPtr &_material)
+{
+  MaterialPtr mat = _scene->CreateMaterial();
+  if (_material)
+  {
+    mat->CopyFrom(*_material);
+    this->materialCache.push_back(mat);
+  }
+  else
+  {
+    MaterialPtr defaultMat = _scene->Material("Default/White");
+    if (defaultMat != nullptr)
+      mat->CopyFrom(defaultMat);
+  }
+  return mat;
+}
+
 //////////////////////////////////////////////////
 std::string Ogre2MeshFactory::MeshName(const MeshDescriptor &_desc)
 {
@@ -550,6 +1302,8 @@ std::string Ogre2MeshFactory::MeshName(const MeshDescriptor &_desc)
   ss << _desc.meshName << "::";
   ss << _desc.subMeshName << "::";
   ss << ((_desc.centerSubMesh) ? "CENTERED" : "ORIGINAL");
+  for (const auto &lod : _desc.LodLevels())
+    ss << "::LOD_" << lod.triangleRatio << "_" << lod.screenRatio;
   return ss.str();
 }
 
@@ -574,6 +1328,22 @@ bool Ogre2MeshFactory::Validate(const MeshDescriptor &_desc)
     return false;
   }
 
+  double triangleRatio = 1.0;
+  double screenRatio = 1.0;
+  for (const auto &lod : _desc.LodLevels())
+  {
+    if (lod.triangleRatio <= 0.0 || lod.triangleRatio > triangleRatio ||
+        lod.screenRatio <= 0.0 || lod.screenRatio > screenRatio)
+    {
+      gzerr << "Invalid level of detail for mesh [" << _desc.meshName
+             << "], ratios must be in (0, 1] and decrease from one level to "
+             << "the next" << std::endl;
+      return false;
+    }
+    triangleRatio = lod.triangleRatio;
+    screenRatio = lod.screenRatio;
+  }
+
   return true;
 }
 
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <gz/common/Mesh.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/SubMesh.hh>
+
+#include "gz/rendering/MeshDescriptor.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreBitwise.h>
+#include <OgreItem.h>
+#include <OgreMesh2.h>
+#include <OgreQuaternion.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreAsyncTicket.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVertexArrayObject.h>
+#include <Vao/OgreVertexBufferPacked.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of the compact vertex layout, see
+/// Ogre2RenderEngine::CompactMeshVertices
+class Ogre2MeshFactoryCompactTest : public Ogre2RenderingTest
+{
+  /// \brief Load the render engine with the compact vertex layout
+  public: static void SetUpTestSuite()
+  {
+    LoadEngine({{"compactMeshVertices", "1"}});
+  }
+
+  /// \brief Get the vao of the full detail level of the first submesh of a
+  /// mesh
+  /// \param[in] _mesh Mesh
+  /// \return The vao, null if not found
+  protected: static Ogre::VertexArrayObject *Vao(MeshPtr _mesh)
+  {
+    auto ogreMesh = std::dynamic_pointer_cast<Ogre2Mesh>(_mesh);
+    if (!ogreMesh)
+      return nullptr;
+    auto *item = dynamic_cast<Ogre::Item *>(ogreMesh->OgreObject());
+    if (!item || item->getMesh()->getNumSubMeshes() == 0u)
+      return nullptr;
+    const auto &vaos = item->getMesh()->getSubMesh(0)->mVao[Ogre::VpNormal];
+    return vaos.empty() ? nullptr : vaos[0];
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MeshFactoryCompactTest, HalfPositions)
+{
+  EXPECT_TRUE(engine->CompactMeshVertices());
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  const common::Mesh *box =
+      common::MeshManager::Instance()->MeshByName("unit_box");
+  ASSERT_NE(nullptr, box);
+  auto subMesh = box->SubMeshByIndex(0u).lock();
+  ASSERT_NE(nullptr, subMesh);
+  ASSERT_GT(subMesh->NormalCount(), 0u);
+  ASSERT_GT(subMesh->TexCoordCountBySet(0u), 0u);
+
+  MeshPtr mesh = scene->CreateMesh(MeshDescriptor("unit_box"));
+  ASSERT_NE(nullptr, mesh);
+  Ogre::VertexArrayObject *vao = Vao(mesh);
+  ASSERT_NE(nullptr, vao);
+  ASSERT_EQ(1u, vao->getVertexBuffers().size());
+  Ogre::VertexBufferPacked *vertexBuffer = vao->getVertexBuffers()[0];
+
+  // the box fits in the range of half float positions
+  const Ogre::VertexElement2Vec &elements =
+      vertexBuffer->getVertexElements();
+  ASSERT_EQ(3u, elements.size());
+  EXPECT_EQ(Ogre::VET_HALF4, elements[0].mType);
+  EXPECT_EQ(Ogre::VES_POSITION, elements[0].mSemantic);
+  EXPECT_EQ(Ogre::VET_SHORT4_SNORM, elements[1].mType);
+  EXPECT_EQ(Ogre::VES_NORMAL, elements[1].mSemantic);
+  EXPECT_EQ(Ogre::VET_HALF2, elements[2].mType);
+  EXPECT_EQ(Ogre::VES_TEXTURE_COORDINATES, elements[2].mSemantic);
+  ASSERT_EQ(20u, vertexBuffer->getBytesPerElement());
+
+  ASSERT_NE(nullptr, vao->getIndexBuffer());
+  EXPECT_EQ(Ogre::IndexBufferPacked::IT_16BIT,
+      vao->getIndexBuffer()->getIndexType());
+  EXPECT_EQ(subMesh->IndexCount(), vao->getIndexBuffer()->getNumElements());
+
+  // decode the vertices, which keep their order as meshes are not
+  // optimized
+  ASSERT_EQ(subMesh->VertexCount(), vertexBuffer->getNumElements());
+  Ogre::AsyncTicketPtr ticket =
+      vertexBuffer->readRequest(0u, vertexBuffer->getNumElements());
+  const auto *data = static_cast<const uint8_t *>(ticket->map());
+  ASSERT_NE(nullptr, data);
+  for (unsigned int v = 0u; v < subMesh->VertexCount(); ++v)
+  {
+    const uint8_t *vertex = data + v * 20u;
+    uint16_t position[4];
+    std::memcpy(position, vertex, sizeof(position));
+    int16_t qtangent[4];
+    std::memcpy(qtangent, vertex + 8u, sizeof(qtangent));
+    uint16_t uv[2];
+    std::memcpy(uv, vertex + 16u, sizeof(uv));
+
+    const math::Vector3d &p = subMesh->Vertex(v);
+    EXPECT_NEAR(p.X(), Ogre::Bitwise::halfToFloat(position[0]), 1e-3);
+    EXPECT_NEAR(p.Y(), Ogre::Bitwise::halfToFloat(position[1]), 1e-3);
+    EXPECT_NEAR(p.Z(), Ogre::Bitwise::halfToFloat(position[2]), 1e-3);
+    EXPECT_FLOAT_EQ(1.0f, Ogre::Bitwise::halfToFloat(position[3]));
+
+    // the normal is the z axis of the tangent frame
+    Ogre::Quaternion q(qtangent[3] / 32767.0f, qtangent[0] / 32767.0f,
+        qtangent[1] / 32767.0f, qtangent[2] / 32767.0f);
+    EXPECT_GT(q.w, 0.0f);
+    q.normalise();
+    Ogre::Vector3 normal = q.zAxis();
+    const math::Vector3d &n = subMesh->Normal(v).Normalized();
+    EXPECT_NEAR(n.X(), normal.x, 1e-3);
+    EXPECT_NEAR(n.Y(), normal.y, 1e-3);
+    EXPECT_NEAR(n.Z(), normal.z, 1e-3);
+
+    const math::Vector2d &t = subMesh->TexCoordBySet(v, 0u);
+    EXPECT_NEAR(t.X(), Ogre::Bitwise::halfToFloat(uv[0]), 1e-3);
+    EXPECT_NEAR(t.Y(), Ogre::Bitwise::halfToFloat(uv[1]), 1e-3);
+  }
+  ticket->unmap();
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MeshFactoryCompactTest, FloatPositions)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // too large for half float positions to stay accurate
+  common::Mesh commonMesh;
+  commonMesh.SetName("compact_large_triangle");
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  subMesh.AddVertex(math::Vector3d(0, 0, 0));
+  subMesh.AddVertex(math::Vector3d(10, 0, 0));
+  subMesh.AddVertex(math::Vector3d(0, 10, 0));
+  subMesh.AddIndex(0u);
+  subMesh.AddIndex(1u);
+  subMesh.AddIndex(2u);
+  commonMesh.AddSubMesh(subMesh);
+
+  MeshPtr mesh = scene->CreateMesh(MeshDescriptor(&commonMesh));
+  ASSERT_NE(nullptr, mesh);
+  Ogre::VertexArrayObject *vao = Vao(mesh);
+  ASSERT_NE(nullptr, vao);
+  ASSERT_EQ(1u, vao->getVertexBuffers().size());
+  Ogre::VertexBufferPacked *vertexBuffer = vao->getVertexBuffers()[0];
+
+  const Ogre::VertexElement2Vec &elements =
+      vertexBuffer->getVertexElements();
+  ASSERT_EQ(1u, elements.size());
+  EXPECT_EQ(Ogre::VET_FLOAT3, elements[0].mType);
+  ASSERT_EQ(12u, vertexBuffer->getBytesPerElement());
+
+  Ogre::AsyncTicketPtr ticket =
+      vertexBuffer->readRequest(0u, vertexBuffer->getNumElements());
+  const auto *data = static_cast<const float *>(ticket->map());
+  ASSERT_NE(nullptr, data);
+  EXPECT_FLOAT_EQ(10.0f, data[3]);
+  EXPECT_FLOAT_EQ(10.0f, data[7]);
+  ticket->unmap();
+
+  engine->DestroyScene(scene);
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "gz/rendering/MeshDescriptor.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreLodStrategyManager.h>
+#include <OgreMesh2.h>
+#include <OgrePixelCountLodStrategy.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVertexArrayObject.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+class Ogre2MeshFactoryTest : public Ogre2RenderingTest
+{
+  /// \brief Get the v2 mesh of a mesh
+  /// \param[in] _mesh Mesh
+  /// \return The v2 mesh
+  protected: static Ogre::MeshPtr OgreMesh(MeshPtr _mesh)
+  {
+    auto ogreMesh = std::dynamic_pointer_cast<Ogre2Mesh>(_mesh);
+    if (!ogreMesh)
+      return Ogre::MeshPtr();
+    auto *item = dynamic_cast<Ogre::Item *>(ogreMesh->OgreObject());
+    return item ? item->getMesh() : Ogre::MeshPtr();
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MeshFactoryTest, LodLevels)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  Ogre::LodStrategy *screenRatio =
+      Ogre::ScreenRatioPixelCountLodStrategy::getSingletonPtr();
+
+  // meshes without levels of detail have a single level
+  MeshPtr box = scene->CreateMesh(MeshDescriptor("unit_box"));
+  ASSERT_NE(nullptr, box);
+  Ogre::MeshPtr ogreBox = OgreMesh(box);
+  ASSERT_TRUE(ogreBox);
+  EXPECT_EQ(1u, ogreBox->getSubMesh(0)->mVao[Ogre::VpNormal].size());
+
+  std::vector<MeshDescriptor::LodLevel> levels(2u);
+  levels[0].triangleRatio = 0.5;
+  levels[0].screenRatio = 0.2;
+  levels[1].triangleRatio = 0.1;
+  levels[1].screenRatio = 0.05;
+  MeshDescriptor::SetLodLevels("unit_sphere", levels);
+
+  MeshPtr sphere = scene->CreateMesh(MeshDescriptor("unit_sphere"));
+  MeshDescriptor::SetLodLevels("unit_sphere", {});
+  ASSERT_NE(nullptr, sphere);
+  Ogre::MeshPtr ogreSphere = OgreMesh(sphere);
+  ASSERT_TRUE(ogreSphere);
+  EXPECT_EQ(screenRatio,
+      Ogre::LodStrategyManager::getSingleton().getDefaultStrategy());
+
+  // full detail level followed by one per generated level of detail,
+  // each switched to at a smaller screen ratio
+  const auto *lodValues = ogreSphere->_getLodValueArray();
+  ASSERT_EQ(3u, lodValues->size());
+  EXPECT_EQ(screenRatio->transformUserValue(0.2f), (*lodValues)[1]);
+  EXPECT_EQ(screenRatio->transformUserValue(0.05f), (*lodValues)[2]);
+
+  ASSERT_EQ(1u, ogreSphere->getNumSubMeshes());
+  const auto &vaos = ogreSphere->getSubMesh(0)->mVao[Ogre::VpNormal];
+  ASSERT_EQ(3u, vaos.size());
+  std::size_t indexCount = vaos[0]->getIndexBuffer()->getNumElements();
+  for (std::size_t i = 1u; i < vaos.size(); ++i)
+  {
+    // levels of detail share the vertex buffer of the full detail level
+    EXPECT_EQ(vaos[0]->getVertexBuffers(), vaos[i]->getVertexBuffers());
+
+    ASSERT_NE(nullptr, vaos[i]->getIndexBuffer());
+    std::size_t lodIndexCount = vaos[i]->getIndexBuffer()->getNumElements();
+    EXPECT_GT(lodIndexCount, 0u);
+    EXPECT_EQ(0u, lodIndexCount % 3u);
+    EXPECT_LT(lodIndexCount, indexCount);
+    indexCount = lodIndexCount;
+  }
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2MeshFactoryTest, ClearLodLevels)
+{
+  std::vector<MeshDescriptor::LodLevel> levels(1u);
+  MeshDescriptor::SetLodLevels("unit_sphere", levels);
+  MeshDescriptor::SetLodLevels("unit_cylinder", levels);
+  EXPECT_EQ(1u, MeshDescriptor("unit_sphere").LodLevels().size());
+  EXPECT_EQ(1u, MeshDescriptor("unit_cylinder").LodLevels().size());
+
+  // the registry is shared by all meshes, clearing it resets every mesh
+  MeshDescriptor::ClearLodLevels();
+  EXPECT_TRUE(MeshDescriptor("unit_sphere").LodLevels().empty());
+  EXPECT_TRUE(MeshDescriptor("unit_cylinder").LodLevels().empty());
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "Ogre2MeshOptimizer.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Size of the post-transform vertex cache Tipsify optimizes for
+  const uint32_t kCacheSize = 16u;
+
+  /// \brief Max number of triangles in a cluster sorted for overdraw.
+  /// Smaller clusters sort better but each cluster boundary costs a few
+  /// cache misses.
+  const std::size_t kMaxClusterTriangles = 256u;
+
+  /// \brief Marks unused vertices when remapping
+  const uint32_t kUnused = std::numeric_limits<uint32_t>::max();
+
+  //////////////////////////////////////////////////
+  /// \brief Reorder triangles with Tipsify
+  /// \param[in] _indices Triangle list indices
+  /// \param[in] _vertexCount Number of vertices
+  /// \param[out] _triangles Triangles in their new order
+  /// \param[out] _clusters Index in _triangles of the first triangle of
+  /// each cluster, i.e. where the vertex cache was effectively flushed
+  void tipsify(const std::vector<uint32_t> &_indices, uint32_t _vertexCount,
+      std::vector<uint32_t> &_triangles, std::vector<std::size_t> &_clusters)
+  {
+    const std::size_t triangleCount = _indices.size() / 3u;
+
+    // triangles around each vertex
+    std::vector<uint32_t> liveTriangles(_vertexCount, 0u);
+    for (auto index : _indices)
+      ++liveTriangles[index];
+    std::vector<uint32_t> offsets(_vertexCount + 1u, 0u);
+    for (uint32_t v = 0u; v < _vertexCount; ++v)
+      offsets[v + 1u] = offsets[v] + liveTriangles[v];
+    std::vector<uint32_t> adjacency(_indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0u; i < _indices.size(); ++i)
+      adjacency[fill[_indices[i]]++] = static_cast<uint32_t>(i / 3u);
+
+    std::vector<uint32_t> cacheTime(_vertexCount, 0u);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    uint32_t time = kCacheSize + 1u;
+    uint32_t cursor = 0u;
+
+    _triangles.clear();
+    _triangles.reserve(triangleCount);
+    _clusters.clear();
+
+    // find the first vertex that is used
+    int64_t fanning = -1;
+    while (cursor < _vertexCount)
+    {
+      if (liveTriangles[cursor] > 0u)
+      {
+        fanning = cursor;
+        break;
+      }
+      ++cursor;
+    }
+    bool flushed = true;
+
+    while (fanning >= 0)
+    {
+      if (flushed)
+        _clusters.push_back(_triangles.size());
+
+      candidates.clear();
+      const auto f = static_cast<uint32_t>(fanning);
+      for (uint32_t a = offsets[f]; a < offsets[f + 1u]; ++a)
+      {
+        uint32_t t = adjacency[a];
+        if (emitted[t])
+          continue;
+        _triangles.push_back(t);
+        emitted[t] = true;
+        for (unsigned int c = 0u; c < 3u; ++c)
+        {
+          uint32_t v = _indices[t * 3u + c];
+          deadEnd.push_back(v);
+          candidates.push_back(v);
+          --liveTriangles[v];
+          if (time - cacheTime[v] > kCacheSize)
+            cacheTime[v] = time++;
+        }
+      }
+
+      // pick the candidate that will still be in the cache after its
+      // remaining triangles are emitted, preferring the oldest one
+      fanning = -1;
+      int64_t bestPriority = -1;
+      for (auto v : candidates)
+      {
+        if (liveTriangles[v] == 0u)
+          continue;
+        int64_t priority = 0;
+        if (time - cacheTime[v] + 2u * liveTriangles[v] <= kCacheSize)
+          priority = time - cacheTime[v];
+        if (priority > bestPriority)
+        {
+          bestPriority = priority;
+          fanning = v;
+        }
+      }
+      flushed = false;
+      if (fanning >= 0)
+        continue;
+
+      // dead end, go back to a recently used vertex
+      while (!deadEnd.empty())
+      {
+        uint32_t v = deadEnd.back();
+        deadEnd.pop_back();
+        if (liveTriangles[v] > 0u)
+        {
+          fanning = v;
+          break;
+        }
+      }
+      if (fanning >= 0)
+        continue;
+
+      // nothing left nearby, start over from the next unused vertex
+      flushed = true;
+      while (cursor < _vertexCount)
+      {
+        if (liveTriangles[cursor] > 0u)
+        {
+          fanning = cursor;
+          break;
+        }
+        ++cursor;
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t> &_indices,
+    uint32_t _vertexCount)
+{
+  _indices.resize(_indices.size() / 3u * 3u);
+  if (_indices.size() < 6u)
+    return;
+
+  std::vector<uint32_t> triangles;
+  std::vector<std::size_t> clusters;
+  tipsify(_indices, _vertexCount, triangles, clusters);
+
+  std::vector<uint32_t> result;
+  result.reserve(_indices.size());
+  for (auto t : triangles)
+    result.insert(result.end(), _indices.begin() + t * 3u,
+        _indices.begin() + t * 3u + 3u);
+  _indices.swap(result);
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshOptimizer::OptimizeTriangleOrder(
+    std::vector<uint32_t> &_indices, const float *_vertices,
+    uint32_t _vertexCount, std::size_t _stride)
+{
+  _indices.resize(_indices.size() / 3u * 3u);
+  if (_indices.size() < 6u)
+    return;
+
+  std::vector<uint32_t> triangles;
+  std::vector<std::size_t> clusters;
+  tipsify(_indices, _vertexCount, triangles, clusters);
+
+  // split large clusters so they can be sorted
+  std::vector<std::size_t> bounds;
+  for (std::size_t c = 0u; c < clusters.size(); ++c)
+  {
+    std::size_t end = c + 1u < clusters.size() ? clusters[c + 1u] :
+        triangles.size();
+    for (std::size_t b = clusters[c]; b < end; b += kMaxClusterTriangles)
+      bounds.push_back(b);
+  }
+  bounds.push_back(triangles.size());
+  const std::size_t clusterCount = bounds.size() - 1u;
+
+  // area weighted centroid and normal of each cluster
+  std::vector<double> centroids(clusterCount * 3u, 0.0);
+  std::vector<double> normals(clusterCount * 3u, 0.0);
+  double meshCentroid[3] = {0.0, 0.0, 0.0};
+  double meshArea = 0.0;
+  for (std::size_t c = 0u; c < clusterCount; ++c)
+  {
+    double area = 0.0;
+    for (std::size_t i = bounds[c]; i < bounds[c + 1u]; ++i)
+    {
+      const uint32_t *tri = &_indices[triangles[i] * 3u];
+      const float *p0 = _vertices + tri[0] * _stride;
+      const float *p1 = _vertices + tri[1] * _stride;
+      const float *p2 = _vertices + tri[2] * _stride;
+      double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+      double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+      double n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                     e1[2] * e2[0] - e1[0] * e2[2],
+                     e1[0] * e2[1] - e1[1] * e2[0]};
+      double a = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (unsigned int k = 0u; k < 3u; ++k)
+      {
+        centroids[c * 3u + k] += a * (p0[k] + p1[k] + p2[k]) / 3.0;
+        normals[c * 3u + k] += n[k];
+      }
+      area += a;
+    }
+    for (unsigned int k = 0u; k < 3u; ++k)
+      meshCentroid[k] += centroids[c * 3u + k];
+    meshArea += area;
+    if (area > 0.0)
+    {
+      for (unsigned int k = 0u; k < 3u; ++k)
+        centroids[c * 3u + k] /= area;
+    }
+  }
+  if (meshArea > 0.0)
+  {
+    for (unsigned int k = 0u; k < 3u; ++k)
+      meshCentroid[k] /= meshArea;
+  }
+
+  // clusters facing away from the center are more likely to occlude
+  // others, draw them first
+  std::vector<double> sortKeys(clusterCount, 0.0);
+  for (std::size_t c = 0u; c < clusterCount; ++c)
+  {
+    const double *n = &normals[c * 3u];
+    double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (length <= 0.0)
+      continue;
+    for (unsigned int k = 0u; k < 3u; ++k)
+      sortKeys[c] += (centroids[c * 3u + k] - meshCentroid[k]) * n[k];
+    sortKeys[c] /= length;
+  }
+  std::vector<std::size_t> order(clusterCount);
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(),
+      [&sortKeys](std::size_t _a, std::size_t _b)
+      {
+        return sortKeys[_a] > sortKeys[_b];
+      });
+
+  std::vector<uint32_t> result;
+  result.reserve(_indices.size());
+  for (auto c : order)
+  {
+    for (std::size_t i = bounds[c]; i < bounds[c + 1u]; ++i)
+    {
+      auto t = triangles[i];
+      result.insert(result.end(), _indices.begin() + t * 3u,
+          _indices.begin() + t * 3u + 3u);
+    }
+  }
+  _indices.swap(result);
+}
+
+//////////////////////////////////////////////////
+uint32_t Ogre2MeshOptimizer::OptimizeVertexFetch(
+    std::vector<float> &_vertices, std::size_t _stride,
+    const std::vector<uint32_t> &_indices,
+    const std::vector<std::vector<uint32_t> *> &_indexLists)
+{
+  const auto vertexCount = static_cast<uint32_t>(_vertices.size() / _stride);
+  std::vector<uint32_t> remap(vertexCount, kUnused);
+  uint32_t next = 0u;
+  for (auto index : _indices)
+  {
+    if (remap[index] == kUnused)
+      remap[index] = next++;
+  }
+  for (auto list : _indexLists)
+  {
+    for (auto index : *list)
+    {
+      if (remap[index] == kUnused)
+        remap[index] = next++;
+    }
+  }
+
+  std::vector<float> result(static_cast<std::size_t>(next) * _stride);
+  for (uint32_t v = 0u; v < vertexCount; ++v)
+  {
+    if (remap[v] == kUnused)
+      continue;
+    std::memcpy(&result[remap[v] * _stride], &_vertices[v * _stride],
+        _stride * sizeof(float));
+  }
+  _vertices.swap(result);
+
+  for (auto list : _indexLists)
+  {
+    for (auto &index : *list)
+      index = remap[index];
+  }
+  return next;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2MESHOPTIMIZER_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MESHOPTIMIZER_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Reorders indexed triangle lists and their vertices so the GPU
+/// fetches and shades fewer vertices and pixels. Triangles are ordered for
+/// the post-transform vertex cache with Tipsify (Sander et al., "Fast
+/// Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007),
+/// then the resulting clusters are sorted so that triangles facing away
+/// from the mesh center, which are likely to occlude the others, are drawn
+/// first. Finally vertices are sorted by first use for vertex fetch
+/// locality. None of this changes what is rendered.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2MeshOptimizer
+{
+  /// \brief Reorder triangles for the vertex cache and to reduce overdraw
+  /// \param[in,out] _indices Triangle list indices. A trailing partial
+  /// triangle is dropped.
+  /// \param[in] _vertices Interleaved vertex data starting with a float3
+  /// position
+  /// \param[in] _vertexCount Number of vertices
+  /// \param[in] _stride Number of floats per vertex
+  public: static void OptimizeTriangleOrder(std::vector<uint32_t> &_indices,
+      const float *_vertices, uint32_t _vertexCount, std::size_t _stride);
+
+  /// \brief Reorder triangles for the vertex cache only
+  /// \param[in,out] _indices Triangle list indices. A trailing partial
+  /// triangle is dropped.
+  /// \param[in] _vertexCount Number of vertices
+  public: static void OptimizeVertexCache(std::vector<uint32_t> &_indices,
+      uint32_t _vertexCount);
+
+  /// \brief Sort vertices by first use in _indices and drop vertices no
+  /// index list uses. Vertices only used by other index lists follow, in
+  /// order of first use. Every index list is remapped to the new order.
+  /// \param[in,out] _vertices Interleaved vertex data
+  /// \param[in] _stride Number of floats per vertex
+  /// \param[in] _indices Index list defining the new vertex order
+  /// \param[in,out] _indexLists Index lists to remap, _indices included
+  /// \return New number of vertices
+  public: static uint32_t OptimizeVertexFetch(std::vector<float> &_vertices,
+      std::size_t _stride, const std::vector<uint32_t> &_indices,
+      const std::vector<std::vector<uint32_t> *> &_indexLists);
+};
+}
+}
+}
+#endif
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Ogre2MeshOptimizer.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Vertex position
+using Position = std::array<float, 3>;
+
+/// \brief Triangle as its vertex positions, rotated so the smallest
+/// position comes first, which keeps the winding
+using Triangle = std::array<Position, 3>;
+
+/////////////////////////////////////////////////
+/// \brief Get the sorted triangles of a mesh by vertex position, so they
+/// can be compared across vertex and triangle reorders
+/// \param[in] _vertices Interleaved vertex data starting with a position
+/// \param[in] _stride Number of floats per vertex
+/// \param[in] _indices Triangle list indices
+/// \return Sorted triangles
+std::vector<Triangle> triangles(const std::vector<float> &_vertices,
+    std::size_t _stride, const std::vector<uint32_t> &_indices)
+{
+  std::vector<Triangle> result;
+  for (std::size_t t = 0u; t + 3u <= _indices.size(); t += 3u)
+  {
+    Triangle tri;
+    for (unsigned int c = 0u; c < 3u; ++c)
+    {
+      for (unsigned int k = 0u; k < 3u; ++k)
+        tri[c][k] = _vertices[_indices[t + c] * _stride + k];
+    }
+    std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()),
+        tri.end());
+    result.push_back(tri);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a grid of _size by _size quads in the XY plane
+/// \param[out] _vertices Vertex positions
+/// \param[out] _indices Triangle list indices
+void grid(uint32_t _size, std::vector<float> &_vertices,
+    std::vector<uint32_t> &_indices)
+{
+  for (uint32_t y = 0u; y <= _size; ++y)
+  {
+    for (uint32_t x = 0u; x <= _size; ++x)
+    {
+      _vertices.push_back(static_cast<float>(x));
+      _vertices.push_back(static_cast<float>(y));
+      _vertices.push_back(0.0f);
+    }
+  }
+  for (uint32_t y = 0u; y < _size; ++y)
+  {
+    for (uint32_t x = 0u; x < _size; ++x)
+    {
+      uint32_t v = y * (_size + 1u) + x;
+      _indices.insert(_indices.end(), {v, v + 1u, v + _size + 2u});
+      _indices.insert(_indices.end(), {v, v + _size + 2u, v + _size + 1u});
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2MeshOptimizerTest, OptimizeVertexCache)
+{
+  std::vector<float> vertices;
+  std::vector<uint32_t> indices;
+  grid(8u, vertices, indices);
+  const uint32_t vertexCount = static_cast<uint32_t>(vertices.size() / 3u);
+
+  std::vector<uint32_t> optimized = indices;
+  Ogre2MeshOptimizer::OptimizeVertexCache(optimized, vertexCount);
+  ASSERT_EQ(indices.size(), optimized.size());
+  EXPECT_EQ(triangles(vertices, 3u, indices),
+      triangles(vertices, 3u, optimized));
+
+  // a trailing partial triangle is dropped
+  optimized = indices;
+  optimized.push_back(0u);
+  optimized.push_back(1u);
+  Ogre2MeshOptimizer::OptimizeVertexCache(optimized, vertexCount);
+  ASSERT_EQ(indices.size(), optimized.size());
+  EXPECT_EQ(triangles(vertices, 3u, indices),
+      triangles(vertices, 3u, optimized));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2MeshOptimizerTest, OptimizeTriangleOrder)
+{
+  std::vector<float> vertices;
+  std::vector<uint32_t> indices;
+  grid(8u, vertices, indices);
+  const uint32_t vertexCount = static_cast<uint32_t>(vertices.size() / 3u);
+
+  std::vector<uint32_t> optimized = indices;
+  optimized.push_back(0u);
+  Ogre2MeshOptimizer::OptimizeTriangleOrder(optimized, vertices.data(),
+      vertexCount, 3u);
+  ASSERT_EQ(indices.size(), optimized.size());
+  EXPECT_EQ(triangles(vertices, 3u, indices),
+      triangles(vertices, 3u, optimized));
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2MeshOptimizerTest, OptimizeVertexFetch)
+{
+  // the last vertex is unused and the one before is only used by the
+  // level of detail
+  std::vector<float> vertices = {
+      1, 1, 0,
+      0, 0, 0,
+      2, 0, 0,
+      0, 1, 0,
+      1, 0, 0,
+      5, 5, 5};
+  const std::vector<float> original = vertices;
+  const std::vector<uint32_t> indices = {1, 4, 0, 1, 0, 3};
+  const std::vector<uint32_t> lodIndices = {1, 4, 0, 4, 2, 0};
+
+  std::vector<uint32_t> optimized = indices;
+  std::vector<uint32_t> optimizedLod = lodIndices;
+  uint32_t vertexCount = Ogre2MeshOptimizer::OptimizeVertexFetch(vertices,
+      3u, optimized, {&optimized, &optimizedLod});
+  EXPECT_EQ(5u, vertexCount);
+  ASSERT_EQ(vertexCount * 3u, vertices.size());
+
+  // vertices are sorted by first use in the full detail level, then in
+  // the level of detail
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 0, 2, 3}), optimized);
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 1, 4, 2}), optimizedLod);
+  EXPECT_EQ(triangles(original, 3u, indices),
+      triangles(vertices, 3u, optimized));
+  EXPECT_EQ(triangles(original, 3u, lodIndices),
+      triangles(vertices, 3u, optimizedLod));
+}
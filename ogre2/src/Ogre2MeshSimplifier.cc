@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#include "Ogre2MeshSimplifier.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Quadric stored as the upper triangle of a symmetric 4x4 matrix
+  using Quadric = std::array<double, 10>;
+
+  /// \brief Edge collapse candidate
+  struct Collapse
+  {
+    /// \brief Error introduced by the collapse
+    double cost;
+
+    /// \brief Position id that moves
+    uint32_t from;
+
+    /// \brief Position id it moves to
+    uint32_t to;
+  };
+
+  /// \brief Hash of the bits of a position
+  struct PositionHash
+  {
+    /// \brief Hash a position
+    /// \param[in] _key Bits of the position
+    /// \return Hash value
+    std::size_t operator()(const std::array<uint32_t, 3> &_key) const
+    {
+      return (_key[0] * 73856093u) ^ (_key[1] * 19349663u) ^
+          (_key[2] * 83492791u);
+    }
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Compute the cross product of two triangle edges
+  /// \param[in] _p0 First corner
+  /// \param[in] _p1 Second corner
+  /// \param[in] _p2 Third corner
+  /// \param[out] _n Unnormalized triangle normal
+  void triangleNormal(const float *_p0, const float *_p1, const float *_p2,
+      double _n[3])
+  {
+    double e1[3] = {_p1[0] - _p0[0], _p1[1] - _p0[1], _p1[2] - _p0[2]};
+    double e2[3] = {_p2[0] - _p0[0], _p2[1] - _p0[1], _p2[2] - _p0[2]};
+    _n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+    _n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+    _n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Evaluate the error of a quadric at a position
+  /// \param[in] _q Quadric
+  /// \param[in] _p Position
+  /// \return Squared distance error
+  double quadricError(const Quadric &_q, const float *_p)
+  {
+    double x = _p[0];
+    double y = _p[1];
+    double z = _p[2];
+    return _q[0] * x * x + 2 * _q[1] * x * y + 2 * _q[2] * x * z +
+        2 * _q[3] * x + _q[4] * y * y + 2 * _q[5] * y * z + 2 * _q[6] * y +
+        _q[7] * z * z + 2 * _q[8] * z + _q[9];
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2MeshSimplifier::Ogre2MeshSimplifier(const float *_vertices,
+    uint32_t _vertexCount, std::size_t _stride,
+    const std::vector<uint32_t> &_indices)
+  : vertices(_vertices), stride(_stride)
+{
+  // drop a trailing partial triangle and triangles referencing vertices
+  // out of range
+  this->indices.reserve(_indices.size());
+  for (std::size_t t = 0; t + 3u <= _indices.size(); t += 3u)
+  {
+    if (_indices[t] < _vertexCount && _indices[t + 1u] < _vertexCount &&
+        _indices[t + 2u] < _vertexCount)
+    {
+      this->indices.insert(this->indices.end(), _indices.begin() + t,
+          _indices.begin() + t + 3u);
+    }
+  }
+
+  // merge vertices with the same position
+  std::unordered_map<std::array<uint32_t, 3>, uint32_t, PositionHash> ids;
+  this->positionIds.resize(_vertexCount);
+  for (uint32_t v = 0; v < _vertexCount; ++v)
+  {
+    std::array<uint32_t, 3> key;
+    std::memcpy(key.data(), this->Position(v), sizeof(key));
+    auto it = ids.emplace(key, static_cast<uint32_t>(ids.size())).first;
+    if (it->second == this->positionVertex.size())
+      this->positionVertex.push_back(v);
+    this->positionIds[v] = it->second;
+  }
+
+  std::size_t positionCount = this->positionVertex.size();
+  this->positionVertexOffsets.assign(positionCount + 1u, 0u);
+  for (uint32_t id : this->positionIds)
+    ++this->positionVertexOffsets[id + 1u];
+  std::partial_sum(this->positionVertexOffsets.begin(),
+      this->positionVertexOffsets.end(), this->positionVertexOffsets.begin());
+  this->positionVertexList.resize(_vertexCount);
+  std::vector<uint32_t> fill(this->positionVertexOffsets.begin(),
+      this->positionVertexOffsets.end() - 1);
+  for (uint32_t v = 0; v < _vertexCount; ++v)
+    this->positionVertexList[fill[this->positionIds[v]]++] = v;
+
+  // accumulate the area weighted plane quadrics of the triangles around
+  // each position and lock positions on open borders
+  this->quadrics.assign(positionCount, Quadric{});
+  this->locked.assign(positionCount, false);
+  std::unordered_map<uint64_t, uint32_t> edgeUse;
+  for (std::size_t t = 0; t < this->indices.size(); t += 3u)
+  {
+    uint32_t p[3];
+    for (unsigned int k = 0; k < 3u; ++k)
+      p[k] = this->positionIds[this->indices[t + k]];
+
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      uint32_t a = std::min(p[k], p[(k + 1u) % 3u]);
+      uint32_t b = std::max(p[k], p[(k + 1u) % 3u]);
+      if (a != b)
+        ++edgeUse[(static_cast<uint64_t>(a) << 32) | b];
+    }
+
+    double n[3];
+    triangleNormal(this->Position(this->indices[t]),
+        this->Position(this->indices[t + 1u]),
+        this->Position(this->indices[t + 2u]), n);
+    double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (length <= 0.0)
+      continue;
+    double area = 0.5 * length;
+    double a = n[0] / length;
+    double b = n[1] / length;
+    double c = n[2] / length;
+    const float *p0 = this->Position(this->indices[t]);
+    double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+    Quadric q = {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c,
+        c * d, d * d};
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      for (unsigned int i = 0; i < q.size(); ++i)
+        this->quadrics[p[k]][i] += q[i] * area;
+    }
+  }
+
+  for (const auto &edge : edgeUse)
+  {
+    if (edge.second == 1u)
+    {
+      this->locked[static_cast<uint32_t>(edge.first >> 32)] = true;
+      this->locked[static_cast<uint32_t>(edge.first & 0xffffffffu)] = true;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+const std::vector<uint32_t> &Ogre2MeshSimplifier::Simplify(
+    std::size_t _targetIndexCount)
+{
+  while (this->indices.size() > _targetIndexCount)
+  {
+    std::size_t trianglesToRemove =
+        (this->indices.size() - _targetIndexCount + 2u) / 3u;
+    if (this->CollapsePass(trianglesToRemove) == 0u)
+      break;
+  }
+  return this->indices;
+}
+
+//////////////////////////////////////////////////
+std::size_t Ogre2MeshSimplifier::CollapsePass(std::size_t _trianglesToRemove)
+{
+  std::size_t positionCount = this->positionVertex.size();
+  std::size_t triangleCount = this->indices.size() / 3u;
+
+  // triangles around each position
+  this->adjacencyOffsets.assign(positionCount + 1u, 0u);
+  for (uint32_t index : this->indices)
+    ++this->adjacencyOffsets[this->positionIds[index] + 1u];
+  std::partial_sum(this->adjacencyOffsets.begin(),
+      this->adjacencyOffsets.end(), this->adjacencyOffsets.begin());
+  this->adjacencyList.resize(this->indices.size());
+  std::vector<uint32_t> fill(this->adjacencyOffsets.begin(),
+      this->adjacencyOffsets.end() - 1);
+  for (std::size_t i = 0; i < this->indices.size(); ++i)
+  {
+    this->adjacencyList[fill[this->positionIds[this->indices[i]]]++] =
+        static_cast<uint32_t>(i / 3u);
+  }
+
+  // unique edges
+  std::vector<uint64_t> edges;
+  edges.reserve(this->indices.size());
+  for (std::size_t t = 0; t < triangleCount; ++t)
+  {
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      uint32_t a = this->positionIds[this->indices[t * 3u + k]];
+      uint32_t b = this->positionIds[this->indices[t * 3u + (k + 1u) % 3u]];
+      if (a != b)
+      {
+        edges.push_back((static_cast<uint64_t>(std::min(a, b)) << 32) |
+            std::max(a, b));
+      }
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  // cheapest direction of each edge
+  std::vector<Collapse> collapses;
+  collapses.reserve(edges.size());
+  for (uint64_t edge : edges)
+  {
+    uint32_t a = static_cast<uint32_t>(edge >> 32);
+    uint32_t b = static_cast<uint32_t>(edge & 0xffffffffu);
+    Quadric q = this->quadrics[a];
+    for (unsigned int i = 0; i < q.size(); ++i)
+      q[i] += this->quadrics[b][i];
+
+    double costAB = this->locked[a] ? std::numeric_limits<double>::max() :
+        quadricError(q, this->Position(this->positionVertex[b]));
+    double costBA = this->locked[b] ? std::numeric_limits<double>::max() :
+        quadricError(q, this->Position(this->positionVertex[a]));
+    if (this->locked[a] && this->locked[b])
+      continue;
+    if (costAB <= costBA)
+      collapses.push_back({costAB, a, b});
+    else
+      collapses.push_back({costBA, b, a});
+  }
+  std::sort(collapses.begin(), collapses.end(),
+      [](const Collapse &_a, const Collapse &_b)
+      {
+        return _a.cost < _b.cost;
+      });
+
+  // collapse independent edges in order of increasing cost
+  std::vector<uint32_t> remap(this->positionIds.size());
+  std::iota(remap.begin(), remap.end(), 0u);
+  std::vector<bool> touched(positionCount, false);
+  std::size_t removed = 0u;
+  std::size_t collapsed = 0u;
+  for (const Collapse &c : collapses)
+  {
+    if (removed >= _trianglesToRemove)
+      break;
+    if (touched[c.from] || touched[c.to] ||
+        !this->PreservesOrientation(c.from, c.to))
+    {
+      continue;
+    }
+
+    // move every vertex at the position onto the target vertex with the
+    // closest attributes
+    for (uint32_t i = this->positionVertexOffsets[c.from];
+        i < this->positionVertexOffsets[c.from + 1u]; ++i)
+    {
+      uint32_t v = this->positionVertexList[i];
+      const float *attrV = this->vertices + v * this->stride;
+      double best = std::numeric_limits<double>::max();
+      for (uint32_t j = this->positionVertexOffsets[c.to];
+          j < this->positionVertexOffsets[c.to + 1u]; ++j)
+      {
+        uint32_t w = this->positionVertexList[j];
+        const float *attrW = this->vertices + w * this->stride;
+        double dist = 0.0;
+        for (std::size_t k = 3u; k < this->stride; ++k)
+          dist += (attrV[k] - attrW[k]) * (attrV[k] - attrW[k]);
+        if (dist < best)
+        {
+          best = dist;
+          remap[v] = w;
+        }
+      }
+    }
+
+    for (unsigned int i = 0; i < this->quadrics[c.to].size(); ++i)
+      this->quadrics[c.to][i] += this->quadrics[c.from][i];
+
+    // triangles around the moved position can not take part in another
+    // collapse during this pass since the adjacency is not updated
+    touched[c.from] = true;
+    touched[c.to] = true;
+    for (uint32_t i = this->adjacencyOffsets[c.from];
+        i < this->adjacencyOffsets[c.from + 1u]; ++i)
+    {
+      uint32_t t = this->adjacencyList[i];
+      bool hasTarget = false;
+      for (unsigned int k = 0; k < 3u; ++k)
+      {
+        uint32_t p = this->positionIds[this->indices[t * 3u + k]];
+        touched[p] = true;
+        hasTarget = hasTarget || p == c.to;
+      }
+      if (hasTarget)
+        ++removed;
+    }
+    ++collapsed;
+  }
+
+  // apply the collapses and drop degenerate triangles
+  std::size_t out = 0u;
+  for (std::size_t t = 0; t < triangleCount; ++t)
+  {
+    uint32_t v0 = remap[this->indices[t * 3u]];
+    uint32_t v1 = remap[this->indices[t * 3u + 1u]];
+    uint32_t v2 = remap[this->indices[t * 3u + 2u]];
+    uint32_t p0 = this->positionIds[v0];
+    uint32_t p1 = this->positionIds[v1];
+    uint32_t p2 = this->positionIds[v2];
+    if (p0 == p1 || p1 == p2 || p0 == p2)
+      continue;
+    this->indices[out++] = v0;
+    this->indices[out++] = v1;
+    this->indices[out++] = v2;
+  }
+  this->indices.resize(out);
+
+  return collapsed;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshSimplifier::PreservesOrientation(uint32_t _from,
+    uint32_t _to) const
+{
+  const float *target = this->Position(this->positionVertex[_to]);
+  for (uint32_t i = this->adjacencyOffsets[_from];
+      i < this->adjacencyOffsets[_from + 1u]; ++i)
+  {
+    uint32_t t = this->adjacencyList[i];
+    const float *before[3];
+    const float *after[3];
+    bool hasTarget = false;
+    for (unsigned int k = 0; k < 3u; ++k)
+    {
+      uint32_t v = this->indices[t * 3u + k];
+      uint32_t p = this->positionIds[v];
+      hasTarget = hasTarget || p == _to;
+      before[k] = this->Position(v);
+      after[k] = (p == _from) ? target : before[k];
+    }
+
+    // triangles containing the edge are removed by the collapse
+    if (hasTarget)
+      continue;
+
+    double n0[3];
+    double n1[3];
+    triangleNormal(before[0], before[1], before[2], n0);
+    triangleNormal(after[0], after[1], after[2], n1);
+    if (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2] <= 0.0)
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+const float *Ogre2MeshSimplifier::Position(uint32_t _vertex) const
+{
+  return this->vertices + static_cast<std::size_t>(_vertex) * this->stride;
+}
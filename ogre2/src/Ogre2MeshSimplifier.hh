@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2MESHSIMPLIFIER_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MESHSIMPLIFIER_HH_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Simplifies an indexed triangle list by quadric error edge
+/// collapse to generate levels of detail. Vertices are only ever collapsed
+/// onto other existing vertices, so every level of detail is an index
+/// buffer over the original vertex buffer. Vertices sharing a position are
+/// collapsed together, each onto the target vertex with the closest
+/// attributes, which preserves normal and texture seams. Vertices on open
+/// borders are never moved. Simplification is progressive: each call to
+/// Simplify continues from the result of the previous one.
+class Ogre2MeshSimplifier
+{
+  /// \brief Constructor
+  /// \param[in] _vertices Interleaved vertex data. The first 3 floats of
+  /// each vertex are its position; the remaining floats are attributes.
+  /// \param[in] _vertexCount Number of vertices
+  /// \param[in] _stride Number of floats per vertex, at least 3
+  /// \param[in] _indices Triangle list indices. Triangles referencing a
+  /// vertex out of range are dropped.
+  public: Ogre2MeshSimplifier(const float *_vertices, uint32_t _vertexCount,
+      std::size_t _stride, const std::vector<uint32_t> &_indices);
+
+  /// \brief Collapse edges until at most _targetIndexCount indices remain
+  /// or no edge can be collapsed without flipping a triangle
+  /// \param[in] _targetIndexCount Target number of indices
+  /// \return Indices of the simplified triangle list
+  public: const std::vector<uint32_t> &Simplify(
+      std::size_t _targetIndexCount);
+
+  /// \brief Run one pass collapsing a set of independent edges
+  /// \param[in] _trianglesToRemove Number of triangles to remove
+  /// \return Number of edges collapsed
+  private: std::size_t CollapsePass(std::size_t _trianglesToRemove);
+
+  /// \brief Check if moving a position flips any triangle around it
+  /// \param[in] _from Position that moves
+  /// \param[in] _to Position it moves to
+  /// \return True if no triangle flips or becomes degenerate
+  private: bool PreservesOrientation(uint32_t _from, uint32_t _to) const;
+
+  /// \brief Get the position of a vertex
+  /// \param[in] _vertex Vertex index
+  /// \return Pointer to the 3 position floats
+  private: const float *Position(uint32_t _vertex) const;
+
+  /// \brief Interleaved vertex data
+  private: const float *vertices = nullptr;
+
+  /// \brief Number of floats per vertex
+  private: std::size_t stride = 3u;
+
+  /// \brief Current triangle list
+  private: std::vector<uint32_t> indices;
+
+  /// \brief Position id of each vertex. Vertices with bitwise equal
+  /// positions share an id.
+  private: std::vector<uint32_t> positionIds;
+
+  /// \brief First vertex of each position id
+  private: std::vector<uint32_t> positionVertex;
+
+  /// \brief Vertices of each position id, offsets in positionVertexList
+  private: std::vector<uint32_t> positionVertexOffsets;
+
+  /// \brief Vertices of each position id
+  private: std::vector<uint32_t> positionVertexList;
+
+  /// \brief Error quadric of each position id, upper triangle of a
+  /// symmetric 4x4 matrix
+  private: std::vector<std::array<double, 10>> quadrics;
+
+  /// \brief True for position ids on an open border
+  private: std::vector<bool> locked;
+
+  /// \brief Triangles around each position id, offsets in adjacencyList.
+  /// Rebuilt every pass.
+  private: std::vector<uint32_t> adjacencyOffsets;
+
+  /// \brief Triangles around each position id. Rebuilt every pass.
+  private: std::vector<uint32_t> adjacencyList;
+};
+}
+}
+}
+#endif
@@ -0,0 +1,539 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifdef __APPLE__
+  #define GL_SILENCE_DEPRECATION
+  #include <OpenGL/gl.h>
+  #include <OpenGL/glext.h>
+#else
+#ifndef _WIN32
+  #include <GL/gl.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gz/common/Console.hh>
+
+#include "gz/rendering/ogre2/Ogre2DepthCamera.hh"
+#include "gz/rendering/ogre2/Ogre2GpuRays.hh"
+#include "gz/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "gz/rendering/ogre2/Ogre2PointCloudVisual.hh"
+#include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreMaterialManager.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
+#include <OgreRoot.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#include <OgreSubMesh2.h>
+#include <OgreTechnique.h>
+#include <OgreTextureGpu.h>
+#include <Vao/OgreVaoManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace
+{
+  /// \brief Size of a vertex: float3 position followed by ubyte4 color
+  const std::size_t kVertexSize = 16u;
+
+  /// \brief Index of the renderable custom parameter holding the point
+  /// size and decimation distance, see point_cloud_visual_vs.glsl
+  const size_t kPointParamsIndex = 0u;
+
+  /// \brief Name of the low level material used to draw the points
+  const char kPointCloudMaterialName[] = "PointCloudVisualPoint";
+
+  /// \brief Name of the material reconstructing points from GpuRays ranges
+  const char kRaysMaterialName[] = "PointCloudVisualRaysPoint";
+
+  /// \brief Name of the material reading points from a DepthCamera
+  const char kDepthMaterialName[] = "PointCloudVisualDepthPoint";
+}
+
+/// \brief A chunk of points drawn by a single item
+struct Ogre2PointCloudChunk
+{
+  /// \brief Mesh holding the chunk vertex buffer
+  Ogre::MeshPtr mesh;
+
+  /// \brief Item drawing the mesh
+  Ogre::Item *item = nullptr;
+};
+
+namespace
+{
+  //////////////////////////////////////////////////
+  /// \brief Destroy the item, mesh and vertex buffer of a chunk
+  /// \param[in] _sceneManager Scene manager that created the item
+  /// \param[in,out] _chunk Chunk to destroy
+  void destroyChunk(Ogre::SceneManager *_sceneManager,
+      Ogre2PointCloudChunk &_chunk)
+  {
+    Ogre::VaoManager *vaoManager =
+        _sceneManager->getDestinationRenderSystem()->getVaoManager();
+
+    _sceneManager->destroyItem(_chunk.item);
+    _chunk.item = nullptr;
+
+    // the shadow vao is the same as the normal one
+    Ogre::SubMesh *subMesh = _chunk.mesh->getSubMesh(0);
+    subMesh->mVao[Ogre::VpShadow].clear();
+    subMesh->destroyVaos(subMesh->mVao[Ogre::VpNormal], vaoManager);
+
+    Ogre::MeshManager::getSingleton().remove(_chunk.mesh->getName());
+    _chunk.mesh.setNull();
+  }
+}
+
+/// \brief Private data for the Ogre2PointCloudVisual class
+class gz::rendering::Ogre2PointCloudVisualPrivate
+{
+  /// \brief Point chunks
+  public: std::vector<Ogre2PointCloudChunk> chunks;
+
+  /// \brief Total number of points
+  public: std::size_t pointCount = 0u;
+
+  /// \brief Low level material used to draw the points
+  public: Ogre::MaterialPtr pointsMat;
+
+  /// \brief Item drawing the output of the source sensor
+  public: Ogre2PointCloudChunk sourceChunk;
+
+  /// \brief Output texture of the source sensor bound to sourceMat
+  public: Ogre::TextureGpu *sourceTexture = nullptr;
+
+  /// \brief Width of sourceTexture when sourceChunk was created
+  public: uint32_t sourceWidth = 0u;
+
+  /// \brief Height of sourceTexture when sourceChunk was created
+  public: uint32_t sourceHeight = 0u;
+
+  /// \brief Copy of the source material with the sensor texture bound.
+  /// It is unique to this visual since it references the sensor texture.
+  public: Ogre::MaterialPtr sourceMat;
+};
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2PointCloudVisual::Ogre2PointCloudVisual()
+  : dataPtr(new Ogre2PointCloudVisualPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2PointCloudVisual::~Ogre2PointCloudVisual()
+{
+  this->Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::Init()
+{
+  BasePointCloudVisual::Init();
+
+  // enable GL_PROGRAM_POINT_SIZE so we can set gl_PointSize in vertex shader
+  auto engine = Ogre2RenderEngine::Instance();
+  std::string renderSystemName =
+      engine->OgreRoot()->getRenderSystem()->getFriendlyName();
+  if (renderSystemName.find("OpenGL") != std::string::npos)
+  {
+#ifdef __APPLE__
+    glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+#else
+#ifndef _WIN32
+    glEnable(GL_PROGRAM_POINT_SIZE);
+#endif
+#endif
+  }
+  this->dataPtr->pointsMat =
+      Ogre::MaterialManager::getSingleton().getByName(
+      kPointCloudMaterialName);
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::PreRender()
+{
+  BasePointCloudVisual::PreRender();
+
+  // The material is shared by all point clouds so per visual parameters
+  // are passed as renderable custom parameters
+  Ogre::Vector4 params(static_cast<Ogre::Real>(this->pointSize),
+      static_cast<Ogre::Real>(this->decimationDistance), 0, 0);
+  for (auto &chunk : this->dataPtr->chunks)
+  {
+    Ogre::SubItem *subItem = chunk.item->getSubItem(0);
+    if (!subItem->hasCustomParameter(kPointParamsIndex) ||
+        subItem->getCustomParameter(kPointParamsIndex) != params)
+    {
+      subItem->setCustomParameter(kPointParamsIndex, params);
+    }
+  }
+
+  this->UpdateSource();
+  if (this->dataPtr->sourceChunk.item)
+  {
+    this->dataPtr->sourceChunk.item->getSubItem(0)->setCustomParameter(
+        kPointParamsIndex, params);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::Destroy()
+{
+  this->ClearPoints();
+  this->DestroySource();
+  this->source.reset();
+  this->dataPtr->pointsMat.setNull();
+  BasePointCloudVisual::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::SetPoints(const float *_xyz,
+    const uint8_t *_rgba, std::size_t _count)
+{
+  this->ClearPoints();
+
+  if (!_xyz || _count == 0u)
+    return;
+
+  if (_count > std::numeric_limits<uint32_t>::max())
+  {
+    gzerr << "Point cloud [" << this->Name() << "] has too many points ["
+           << _count << "]" << std::endl;
+    return;
+  }
+
+  // Split the points at the median of the longest axis of their bounds
+  // until chunks are small enough. Chunks are then compact in space which
+  // makes frustum culling them effective.
+  std::vector<uint32_t> order(_count);
+  std::iota(order.begin(), order.end(), 0u);
+
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+  ranges.emplace_back(0u, _count);
+  while (!ranges.empty())
+  {
+    std::size_t start = ranges.back().first;
+    std::size_t count = ranges.back().second;
+    ranges.pop_back();
+
+    if (count <= this->chunkSize)
+    {
+      this->CreateChunk(_xyz, _rgba, order.data() + start, count);
+      continue;
+    }
+
+    float minPt[3];
+    float maxPt[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      minPt[k] = std::numeric_limits<float>::max();
+      maxPt[k] = std::numeric_limits<float>::lowest();
+    }
+    for (std::size_t i = start; i < start + count; ++i)
+    {
+      const float *p = _xyz + static_cast<std::size_t>(order[i]) * 3u;
+      for (int k = 0; k < 3; ++k)
+      {
+        minPt[k] = std::min(minPt[k], p[k]);
+        maxPt[k] = std::max(maxPt[k], p[k]);
+      }
+    }
+
+    int axis = 0;
+    for (int k = 1; k < 3; ++k)
+    {
+      if (maxPt[k] - minPt[k] > maxPt[axis] - minPt[axis])
+        axis = k;
+    }
+
+    std::size_t half = count / 2u;
+    auto first = order.begin() + start;
+    std::nth_element(first, first + half, first + count,
+        [&](uint32_t _a, uint32_t _b)
+        {
+          return _xyz[static_cast<std::size_t>(_a) * 3u + axis] <
+              _xyz[static_cast<std::size_t>(_b) * 3u + axis];
+        });
+
+    ranges.emplace_back(start, half);
+    ranges.emplace_back(start + half, count - half);
+  }
+
+  this->dataPtr->pointCount = _count;
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::CreateChunk(const float *_xyz,
+    const uint8_t *_rgba, const uint32_t *_indices, std::size_t _count)
+{
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  // pack vertices
+  std::vector<unsigned char> vertices(_count * kVertexSize);
+  Ogre::Vector3 minPt(std::numeric_limits<Ogre::Real>::max());
+  Ogre::Vector3 maxPt(std::numeric_limits<Ogre::Real>::lowest());
+  const uint8_t white[4] = {255u, 255u, 255u, 255u};
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    const float *p = _xyz + static_cast<std::size_t>(_indices[i]) * 3u;
+    unsigned char *v = vertices.data() + i * kVertexSize;
+    std::memcpy(v, p, 3u * sizeof(float));
+    std::memcpy(v + 3u * sizeof(float),
+        _rgba ? _rgba + static_cast<std::size_t>(_indices[i]) * 4u : white,
+        4u);
+
+    Ogre::Vector3 pt(p[0], p[1], p[2]);
+    minPt.makeFloor(pt);
+    maxPt.makeCeil(pt);
+  }
+
+  Ogre::VertexElement2Vec vertexElements;
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_POSITION));
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_UBYTE4_NORM, Ogre::VES_DIFFUSE));
+
+  // the data is uploaded on creation, no shadow copy is kept on the CPU
+  Ogre::VertexBufferPacked *vertexBuffer = vaoManager->createVertexBuffer(
+      vertexElements, _count, Ogre::BT_DEFAULT, vertices.data(), false);
+
+  Ogre2PointCloudChunk chunk;
+  chunk.item = this->CreateItem(vertexBuffer,
+      Ogre::Aabb::newFromExtents(minPt, maxPt), this->dataPtr->pointsMat);
+  chunk.mesh = chunk.item->getMesh();
+  this->dataPtr->chunks.push_back(chunk);
+}
+
+//////////////////////////////////////////////////
+Ogre::Item *Ogre2PointCloudVisual::CreateItem(
+    Ogre::VertexBufferPacked *_vertexBuffer, const Ogre::Aabb &_bounds,
+    const Ogre::MaterialPtr &_material)
+{
+  static unsigned int chunkId = 0u;
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+
+  Ogre::VertexBufferPackedVec vertexBuffers;
+  vertexBuffers.push_back(_vertexBuffer);
+  Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+      vertexBuffers, nullptr, Ogre::OT_POINT_LIST);
+
+  Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().createManual(
+      "point_cloud_chunk_" + std::to_string(chunkId++),
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+  Ogre::SubMesh *subMesh = mesh->createSubMesh();
+  subMesh->mVao[Ogre::VpNormal].push_back(vao);
+  subMesh->mVao[Ogre::VpShadow].push_back(vao);
+  mesh->_setBounds(_bounds, false);
+
+  Ogre::Item *item = sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
+  item->setCastShadows(false);
+  item->getSubItem(0)->setMaterial(_material);
+  item->getSubItem(0)->setCustomParameter(kPointParamsIndex,
+      Ogre::Vector4(static_cast<Ogre::Real>(this->pointSize),
+      static_cast<Ogre::Real>(this->decimationDistance), 0, 0));
+
+  // set user data for mouse queries
+  item->getUserObjectBindings().setUserAny(Ogre::Any(this->Id()));
+  item->setVisibilityFlags(this->visibilityFlags
+      & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+  this->ogreNode->attachObject(item);
+
+  return item;
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::ClearPoints()
+{
+  if (!this->scene)
+    return;
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  for (auto &chunk : this->dataPtr->chunks)
+    destroyChunk(sceneManager, chunk);
+  this->dataPtr->chunks.clear();
+  this->dataPtr->pointCount = 0u;
+}
+
+//////////////////////////////////////////////////
+std::size_t Ogre2PointCloudVisual::PointCount() const
+{
+  return this->dataPtr->pointCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::UpdateSource()
+{
+  Ogre::TextureGpu *texture = nullptr;
+  const char *materialName = nullptr;
+  Ogre::Vector4 angles(0, 0, 0, 0);
+  Ogre::Vector4 ranges(0, 0, 0, 0);
+  bool isRays = false;
+  if (auto rays = std::dynamic_pointer_cast<Ogre2GpuRays>(this->source))
+  {
+    texture = rays->OutputTexture();
+    materialName = kRaysMaterialName;
+    isRays = true;
+    angles = Ogre::Vector4(
+        static_cast<Ogre::Real>(rays->AngleMin().Radian()),
+        static_cast<Ogre::Real>(rays->AngleMax().Radian()),
+        static_cast<Ogre::Real>(rays->VerticalAngleMin().Radian()),
+        static_cast<Ogre::Real>(rays->VerticalAngleMax().Radian()));
+    ranges = Ogre::Vector4(static_cast<Ogre::Real>(rays->NearClipPlane()),
+        static_cast<Ogre::Real>(rays->FarClipPlane()), 0, 0);
+  }
+  else if (auto depth =
+      std::dynamic_pointer_cast<Ogre2DepthCamera>(this->source))
+  {
+    texture = depth->OutputTexture();
+    materialName = kDepthMaterialName;
+    ranges = Ogre::Vector4(static_cast<Ogre::Real>(depth->NearClipPlane()),
+        static_cast<Ogre::Real>(depth->FarClipPlane()), 0, 0);
+  }
+
+  // the sensor recreates its texture when its resolution changes and
+  // destroys it with the sensor
+  if (texture != this->dataPtr->sourceTexture ||
+      (texture && (texture->getWidth() != this->dataPtr->sourceWidth ||
+      texture->getHeight() != this->dataPtr->sourceHeight)))
+  {
+    this->DestroySource();
+    if (texture)
+      this->CreateSource(texture, materialName, ranges.y);
+  }
+
+  if (this->dataPtr->sourceMat.isNull())
+    return;
+
+  Ogre::GpuProgramParametersSharedPtr vertParams =
+      this->dataPtr->sourceMat->getTechnique(0)->getPass(0)->
+      getVertexProgramParameters();
+  if (isRays)
+    vertParams->setNamedConstant("angles", angles);
+  vertParams->setNamedConstant("ranges", ranges);
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::CreateSource(Ogre::TextureGpu *_texture,
+    const std::string &_materialName, double _maxRange)
+{
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  Ogre::VaoManager *vaoManager =
+      sceneManager->getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  Ogre::MaterialPtr mat =
+      Ogre::MaterialManager::getSingleton().getByName(_materialName);
+  if (mat.isNull())
+  {
+    gzerr << "Unable to find material [" << _materialName << "]"
+           << std::endl;
+    return;
+  }
+
+  // the material references the sensor texture so it is unique per visual
+  this->dataPtr->sourceMat = mat->clone(
+      this->Name() + "_" + std::to_string(this->Id()) + "_" + _materialName);
+  this->dataPtr->sourceMat->load();
+  this->dataPtr->sourceMat->getTechnique(0)->getPass(0)->
+      getTextureUnitState(0)->setTexture(_texture);
+
+  // one vertex per texel holding its pixel coordinates, the vertex shader
+  // fetches the texel and computes the position of the point
+  uint32_t width = _texture->getWidth();
+  uint32_t height = _texture->getHeight();
+  std::vector<float> pixels(static_cast<std::size_t>(width) * height * 2u);
+  std::size_t idx = 0u;
+  for (uint32_t y = 0; y < height; ++y)
+  {
+    for (uint32_t x = 0; x < width; ++x)
+    {
+      pixels[idx++] = static_cast<float>(x);
+      pixels[idx++] = static_cast<float>(y);
+    }
+  }
+
+  Ogre::VertexElement2Vec vertexElements;
+  vertexElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT2, Ogre::VES_POSITION));
+  Ogre::VertexBufferPacked *vertexBuffer = vaoManager->createVertexBuffer(
+      vertexElements, width * height, Ogre::BT_DEFAULT, pixels.data(),
+      false);
+
+  // points are within the max range of the sensor
+  Ogre::Aabb bounds = Ogre::Aabb::BOX_INFINITE;
+  if (std::isfinite(_maxRange))
+  {
+    bounds = Ogre::Aabb(Ogre::Vector3::ZERO,
+        Ogre::Vector3(static_cast<Ogre::Real>(_maxRange)));
+  }
+
+  this->dataPtr->sourceChunk.item = this->CreateItem(vertexBuffer, bounds,
+      this->dataPtr->sourceMat);
+  this->dataPtr->sourceChunk.mesh =
+      this->dataPtr->sourceChunk.item->getMesh();
+  this->dataPtr->sourceTexture = _texture;
+  this->dataPtr->sourceWidth = width;
+  this->dataPtr->sourceHeight = height;
+}
+
+//////////////////////////////////////////////////
+void Ogre2PointCloudVisual::DestroySource()
+{
+  if (this->dataPtr->sourceChunk.item)
+  {
+    destroyChunk(this->scene->OgreSceneManager(), this->dataPtr->sourceChunk);
+  }
+
+  if (!this->dataPtr->sourceMat.isNull())
+  {
+    Ogre::MaterialManager::getSingleton().remove(
+        this->dataPtr->sourceMat->getName());
+    this->dataPtr->sourceMat.setNull();
+  }
+
+  this->dataPtr->sourceTexture = nullptr;
+  this->dataPtr->sourceWidth = 0u;
+  this->dataPtr->sourceHeight = 0u;
+}
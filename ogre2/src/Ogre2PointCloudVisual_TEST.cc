@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <gz/math/Helpers.hh>
+
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/DepthCamera.hh"
+#include "gz/rendering/DirectionalLight.hh"
+#include "gz/rendering/Image.hh"
+#include "gz/rendering/Material.hh"
+#include "gz/rendering/PointCloudVisual.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+#include "gz/rendering/ogre2/Ogre2DepthCamera.hh"
+#include "gz/rendering/ogre2/Ogre2PointCloudVisual.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreItem.h>
+#include <OgreSceneNode.h>
+#include <OgreSubItem.h>
+#include <OgreSubMesh2.h>
+#include <OgreTextureGpu.h>
+#include <Vao/OgreVertexArrayObject.h>
+#include <Vao/OgreVertexBufferPacked.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of the chunks and rendering of Ogre2PointCloudVisual
+class Ogre2PointCloudVisualTest : public Ogre2RenderingTest
+{
+  /// \brief Chunk of points drawn by one item
+  protected: struct Chunk
+  {
+    /// \brief Number of points
+    std::size_t pointCount = 0u;
+
+    /// \brief Bounds of the points
+    Ogre::Aabb bounds;
+  };
+
+  /// \brief Create a point cloud visual attached to the root visual
+  /// \param[in] _scene Scene
+  /// \return Point cloud visual
+  protected: static Ogre2PointCloudVisualPtr CreatePointCloud(
+      ScenePtr _scene)
+  {
+    auto pointCloud = std::dynamic_pointer_cast<Ogre2PointCloudVisual>(
+        _scene->Extension()->CreateExt("point_cloud"));
+    if (pointCloud)
+      _scene->RootVisual()->AddChild(pointCloud);
+    return pointCloud;
+  }
+
+  /// \brief Get the chunks drawn by a point cloud visual
+  /// \param[in] _pointCloud Point cloud visual
+  /// \return Chunks, sorted by min corner along X
+  protected: static std::vector<Chunk> Chunks(
+      Ogre2PointCloudVisualPtr _pointCloud)
+  {
+    std::vector<Chunk> result;
+    Ogre::SceneNode *node = _pointCloud->Node();
+    for (size_t i = 0u; i < node->numAttachedObjects(); ++i)
+    {
+      auto *item = dynamic_cast<Ogre::Item *>(node->getAttachedObject(i));
+      if (!item || item->getNumSubItems() == 0u)
+        continue;
+      const auto &vaos =
+          item->getSubItem(0)->getSubMesh()->mVao[Ogre::VpNormal];
+      if (vaos.empty() || vaos[0]->getVertexBuffers().empty())
+        continue;
+      Chunk chunk;
+      chunk.pointCount = vaos[0]->getVertexBuffers()[0]->getNumElements();
+      chunk.bounds = item->getLocalAabb();
+      result.push_back(chunk);
+    }
+    std::sort(result.begin(), result.end(),
+        [](const Chunk &_a, const Chunk &_b)
+        {
+          return _a.bounds.getMinimum().x < _b.bounds.getMinimum().x;
+        });
+    return result;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2PointCloudVisualTest, Chunks)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  auto pointCloud = CreatePointCloud(scene);
+  ASSERT_NE(nullptr, pointCloud);
+
+  pointCloud->SetChunkSize(64u);
+  const std::size_t chunkSize = pointCloud->ChunkSize();
+  ASSERT_EQ(64u, chunkSize);
+
+  // points along a line in X, shuffled so chunks can't rely on their order
+  auto line = [](std::size_t _count)
+  {
+    std::vector<float> xyz;
+    for (std::size_t i = 0u; i < _count; ++i)
+    {
+      const std::size_t x = (i * 37u) % _count;
+      xyz.insert(xyz.end(), {static_cast<float>(x), 0.5f, -1.0f});
+    }
+    return xyz;
+  };
+
+  // exactly one chunk
+  std::vector<float> xyz = line(chunkSize);
+  pointCloud->SetPoints(xyz.data(), nullptr, chunkSize);
+  std::vector<Chunk> chunks = Chunks(pointCloud);
+  ASSERT_EQ(1u, chunks.size());
+  EXPECT_EQ(chunkSize, chunks[0].pointCount);
+  EXPECT_EQ(Ogre::Vector3(0.0f, 0.5f, -1.0f), chunks[0].bounds.getMinimum());
+  EXPECT_EQ(Ogre::Vector3(static_cast<Ogre::Real>(chunkSize - 1u), 0.5f,
+      -1.0f), chunks[0].bounds.getMaximum());
+
+  // one more point splits the cloud
+  xyz = line(chunkSize + 1u);
+  pointCloud->SetPoints(xyz.data(), nullptr, chunkSize + 1u);
+  chunks = Chunks(pointCloud);
+  ASSERT_EQ(2u, chunks.size());
+  EXPECT_EQ(chunkSize + 1u, chunks[0].pointCount + chunks[1].pointCount);
+
+  // four times as many points make four full chunks that cover disjoint
+  // ranges of the line
+  xyz = line(chunkSize * 4u);
+  pointCloud->SetPoints(xyz.data(), nullptr, chunkSize * 4u);
+  EXPECT_EQ(chunkSize * 4u, pointCloud->PointCount());
+  chunks = Chunks(pointCloud);
+  ASSERT_EQ(4u, chunks.size());
+  for (std::size_t c = 0u; c < chunks.size(); ++c)
+  {
+    EXPECT_EQ(chunkSize, chunks[c].pointCount) << c;
+    EXPECT_FLOAT_EQ(static_cast<float>(c * chunkSize),
+        chunks[c].bounds.getMinimum().x) << c;
+    EXPECT_FLOAT_EQ(static_cast<float>((c + 1u) * chunkSize - 1u),
+        chunks[c].bounds.getMaximum().x) << c;
+    EXPECT_FLOAT_EQ(0.5f, chunks[c].bounds.getMaximum().y) << c;
+    EXPECT_FLOAT_EQ(-1.0f, chunks[c].bounds.getMinimum().z) << c;
+  }
+
+  // clearing removes the chunks
+  pointCloud->ClearPoints();
+  EXPECT_TRUE(Chunks(pointCloud).empty());
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2PointCloudVisualTest, Capture)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+  auto pointCloud = CreatePointCloud(scene);
+  ASSERT_NE(nullptr, pointCloud);
+
+  // a dense square of points 5 m in front of the camera, red on the left
+  // (+Y) and green on the right (-Y), split across several chunks
+  std::vector<float> xyz;
+  std::vector<uint8_t> rgba;
+  for (int y = -20; y <= 20; ++y)
+  {
+    if (y == 0)
+      continue;
+    for (int z = -20; z <= 20; ++z)
+    {
+      xyz.insert(xyz.end(), {5.0f, y * 0.05f, z * 0.05f});
+      if (y > 0)
+        rgba.insert(rgba.end(), {255u, 0u, 0u, 255u});
+      else
+        rgba.insert(rgba.end(), {0u, 255u, 0u, 255u});
+    }
+  }
+  pointCloud->SetChunkSize(256u);
+  pointCloud->SetPointSize(4.0);
+  pointCloud->SetPoints(xyz.data(), rgba.data(), xyz.size() / 3u);
+  EXPECT_GT(Chunks(pointCloud).size(), 1u);
+
+  const unsigned int width = 64u;
+  const unsigned int height = 64u;
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetImageFormat(PF_R8G8B8);
+  camera->SetHFOV(GZ_PI / 3);
+  scene->RootVisual()->AddChild(camera);
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  const auto *data = image.Data<unsigned char>();
+  ASSERT_NE(nullptr, data);
+  auto pixel = [&](unsigned int _x, unsigned int _y)
+  {
+    return data + (_y * width + _x) * 3u;
+  };
+
+  // the square spans about 22 pixels around the center of the image
+  const unsigned int cx = width / 2u;
+  const unsigned int cy = height / 2u;
+  for (unsigned int dy : {0u, 4u})
+  {
+    const unsigned char *red = pixel(cx - 6u, cy + dy - 2u);
+    EXPECT_GT(red[0], 200u);
+    EXPECT_LT(red[1], 50u);
+    EXPECT_LT(red[2], 50u);
+
+    const unsigned char *green = pixel(cx + 6u, cy + dy - 2u);
+    EXPECT_LT(green[0], 50u);
+    EXPECT_GT(green[1], 200u);
+    EXPECT_LT(green[2], 50u);
+  }
+
+  // the background is left untouched
+  for (const unsigned char *bg : {pixel(1u, 1u), pixel(width - 2u, 1u),
+      pixel(1u, height - 2u), pixel(width - 2u, height - 2u)})
+  {
+    EXPECT_LT(bg[0], 10u);
+    EXPECT_LT(bg[1], 10u);
+    EXPECT_LT(bg[2], 10u);
+  }
+
+  // without points nothing is drawn
+  pointCloud->ClearPoints();
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_LT(pixel(cx - 6u, cy)[0], 10u);
+  EXPECT_LT(pixel(cx + 6u, cy)[1], 10u);
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2PointCloudVisualTest, DepthCameraSource)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+  scene->SetAmbientLight(0.3, 0.3, 0.3);
+
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  light->SetDirection(1.0, 0.0, -0.5);
+  scene->RootVisual()->AddChild(light);
+
+  // a red box only seen by the depth camera
+  const uint32_t boxFlags = 0x01u;
+  const uint32_t pointCloudFlags = 0x02u;
+  MaterialPtr red = scene->CreateMaterial();
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  red->SetEmissive(1.0, 0.0, 0.0);
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(3.0, 0.0, 0.0);
+  box->SetLocalScale(0.5, 2.0, 2.0);
+  box->SetMaterial(red);
+  box->SetVisibilityFlags(boxFlags);
+  scene->RootVisual()->AddChild(box);
+
+  DepthCameraPtr depth = scene->CreateDepthCamera();
+  ASSERT_NE(nullptr, depth);
+  depth->SetImageWidth(32u);
+  depth->SetImageHeight(24u);
+  depth->SetNearClipPlane(0.1);
+  depth->SetFarClipPlane(10.0);
+  depth->SetHFOV(GZ_PI / 3);
+  depth->SetVisibilityMask(boxFlags);
+  depth->CreateDepthTexture();
+  scene->RootVisual()->AddChild(depth);
+
+  auto pointCloud = CreatePointCloud(scene);
+  ASSERT_NE(nullptr, pointCloud);
+  pointCloud->SetVisibilityFlags(pointCloudFlags);
+  pointCloud->SetPointSize(4.0);
+  pointCloud->SetSource(depth);
+  EXPECT_EQ(depth, pointCloud->Source());
+
+  // the main camera sees the points but not the box
+  const unsigned int width = 64u;
+  const unsigned int height = 64u;
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetImageFormat(PF_R8G8B8);
+  camera->SetHFOV(GZ_PI / 3);
+  camera->SetVisibilityMask(~boxFlags);
+  scene->RootVisual()->AddChild(camera);
+
+  Image image = camera->CreateImage();
+  auto redPixels = [&]()
+  {
+    const auto *data = image.Data<unsigned char>();
+    unsigned int count = 0u;
+    for (unsigned int i = 0u; i < width * height; ++i)
+    {
+      if (data[i * 3u] > 50u && data[i * 3u + 1u] < 50u &&
+          data[i * 3u + 2u] < 50u)
+      {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  // one point per pixel of the depth image, the box spans about 40 pixels
+  // across the image
+  depth->Update();
+  camera->Capture(image);
+  std::vector<Chunk> chunks = Chunks(pointCloud);
+  ASSERT_EQ(1u, chunks.size());
+  EXPECT_EQ(32u * 24u, chunks[0].pointCount);
+  const unsigned int drawn = redPixels();
+  EXPECT_GT(drawn, 400u);
+  const unsigned char *center =
+      image.Data<unsigned char>() + (height / 2u * width + width / 2u) * 3u;
+  EXPECT_GT(center[0], 50u);
+
+  // the visual follows the new resolution of its source
+  depth->SetImageWidth(64u);
+  depth->SetImageHeight(48u);
+  depth->Update();
+  auto ogreDepth = std::dynamic_pointer_cast<Ogre2DepthCamera>(depth);
+  ASSERT_NE(nullptr, ogreDepth);
+  ASSERT_NE(nullptr, ogreDepth->OutputTexture());
+  EXPECT_EQ(64u, ogreDepth->OutputTexture()->getWidth());
+  EXPECT_EQ(48u, ogreDepth->OutputTexture()->getHeight());
+
+  camera->Capture(image);
+  chunks = Chunks(pointCloud);
+  ASSERT_EQ(1u, chunks.size());
+  EXPECT_EQ(64u * 48u, chunks[0].pointCount);
+  EXPECT_GT(redPixels(), 400u);
+
+  // without a source nothing is drawn
+  pointCloud->SetSource(nullptr);
+  camera->Capture(image);
+  EXPECT_TRUE(Chunks(pointCloud).empty());
+  EXPECT_EQ(0u, redPixels());
+
+  engine->DestroyScene(scene);
+}
@@ -15,10 +15,18 @@
  *
  */
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <gz/common/Console.hh>
 #include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
 #include <gz/common/SubMesh.hh>
+#include <gz/common/WorkerPool.hh>
 
 #include "gz/rendering/ogre2/Ogre2Camera.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
@@ -30,6 +38,8 @@
 #include "gz/rendering/ogre2/Ogre2SelectionBuffer.hh"
 #include "gz/rendering/ogre2/Ogre2ThermalCamera.hh"
 
+#include "Ogre2MeshBvh.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -56,11 +66,158 @@ class gz::rendering::Ogre2RayQueryPrivate
 
   /// \brief thread that ray query is created in
   public: std::thread::id threadId;
+
+  /// \brief Mesh instance gathered by the broad phase of a batched query
+  public: struct Candidate
+  {
+    /// \brief Triangle hierarchy of the mesh
+    std::shared_ptr<const Ogre2MeshBvh> bvh;
+
+    /// \brief World to mesh local transform
+    Ogre::Matrix4 invTransform;
+
+    /// \brief Linear part of invTransform, used for ray directions
+    Ogre::Matrix3 invLinear;
+
+    /// \brief World space bounds of the item
+    Ogre::Aabb worldAabb;
+
+    /// \brief True if the transform flips triangle winding
+    bool mirrored = false;
+
+    /// \brief Id of the object that owns the mesh
+    unsigned int objectId = 0u;
+  };
+
+  /// \brief Candidates of the last batched query. Kept around to avoid
+  /// reallocating every call.
+  public: std::vector<Candidate> candidates;
+
+  /// \brief Worker pool used to intersect batched rays in parallel.
+  /// Created on first use.
+  public: std::unique_ptr<common::WorkerPool> workerPool;
+
+  /// \brief Get the common::Mesh an Ogre item was created from
+  /// \param[in] _item Ogre item
+  /// \return Mesh registered in the MeshManager, or nullptr
+  public: static const common::Mesh *MeshFromItem(const Ogre::Item *_item);
+
+  /// \brief Intersect a range of rays against the current candidates
+  /// \param[in] _rays Rays to test
+  /// \param[out] _results Results for each ray
+  /// \param[in] _begin Index of the first ray to test
+  /// \param[in] _end One past the index of the last ray to test
+  /// \param[in] _maxDistance Max hit distance, <= 0 for no limit
+  public: void IntersectCandidates(const RayQueryRay *_rays,
+      RayQueryResult *_results, std::size_t _begin, std::size_t _end,
+      double _maxDistance) const;
 };
 
 using namespace gz;
 using namespace rendering;
 
+/// \brief Number of rays below which batched queries are not split into
+/// parallel tasks
+static const std::size_t kMinRaysPerTask = 256u;
+
+//////////////////////////////////////////////////
+/// \brief Check if a ray enters a box before a given distance
+/// \param[in] _origin Ray origin
+/// \param[in] _direction Unit ray direction
+/// \param[in] _box Box to test
+/// \param[in] _maxDistance Max distance, negative for no limit
+/// \return True if the ray enters the box within _maxDistance
+static bool rayHitsAabb(const Ogre::Vector3 &_origin,
+    const Ogre::Vector3 &_direction, const Ogre::Aabb &_box,
+    Ogre::Real _maxDistance)
+{
+  Ogre::Vector3 boxMin = _box.getMinimum();
+  Ogre::Vector3 boxMax = _box.getMaximum();
+  Ogre::Real tMin = 0.0f;
+  Ogre::Real tMax = _maxDistance >= 0.0f ? _maxDistance :
+      std::numeric_limits<Ogre::Real>::max();
+  for (int a = 0; a < 3; ++a)
+  {
+    if (std::abs(_direction[a]) < 1e-12f)
+    {
+      // parallel to the slab
+      if (_origin[a] < boxMin[a] || _origin[a] > boxMax[a])
+        return false;
+      continue;
+    }
+    Ogre::Real inv = 1.0f / _direction[a];
+    Ogre::Real t0 = (boxMin[a] - _origin[a]) * inv;
+    Ogre::Real t1 = (boxMax[a] - _origin[a]) * inv;
+    if (t0 > t1)
+      std::swap(t0, t1);
+    tMin = std::max(tMin, t0);
+    tMax = std::min(tMax, t1);
+    if (tMin > tMax)
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *Ogre2RayQueryPrivate::MeshFromItem(
+    const Ogre::Item *_item)
+{
+  // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
+  // the params passed in the MeshDescriptor when loading the mesh
+  // so strip off the suffix
+  std::string meshName = _item->getMesh()->getName();
+  size_t idx = meshName.find("::");
+  if (idx != std::string::npos)
+    meshName = meshName.substr(0, idx);
+
+  return common::MeshManager::Instance()->MeshByName(meshName);
+}
+
+//////////////////////////////////////////////////
+void Ogre2RayQueryPrivate::IntersectCandidates(const RayQueryRay *_rays,
+    RayQueryResult *_results, std::size_t _begin, std::size_t _end,
+    double _maxDistance) const
+{
+  for (std::size_t i = _begin; i < _end; ++i)
+  {
+    RayQueryResult &result = _results[i];
+    result = RayQueryResult();
+
+    math::Vector3d dir = _rays[i].direction;
+    if (!_rays[i].origin.IsFinite() || !dir.IsFinite() ||
+        dir.SquaredLength() <= 0.0)
+    {
+      continue;
+    }
+    dir.Normalize();
+
+    Ogre::Vector3 origin = Ogre2Conversions::Convert(_rays[i].origin);
+    Ogre::Vector3 direction = Ogre2Conversions::Convert(dir);
+
+    // the local direction is not renormalized so distances along local
+    // rays are world distances and can be compared across candidates
+    Ogre::Real distance = _maxDistance > 0.0 ?
+        static_cast<Ogre::Real>(_maxDistance) : -1.0f;
+    const Candidate *hitCandidate = nullptr;
+    for (const auto &c : this->candidates)
+    {
+      if (!rayHitsAabb(origin, direction, c.worldAabb, distance))
+        continue;
+      Ogre::Ray localRay(c.invTransform.transformAffine(origin),
+          c.invLinear * direction);
+      if (c.bvh->Intersect(localRay, !c.mirrored, c.mirrored, distance))
+        hitCandidate = &c;
+    }
+
+    if (hitCandidate)
+    {
+      result.distance = distance;
+      result.point = Ogre2Conversions::Convert(origin + direction * distance);
+      result.objectId = hitCandidate->objectId;
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 Ogre2RayQuery::Ogre2RayQuery()
     : dataPtr(new Ogre2RayQueryPrivate)
@@ -238,69 +395,125 @@ RayQueryResult Ogre2RayQuery::ClosestPointByIntersection(bool _forceSceneUpdate)
     {
       Ogre::Item *ogreItem = static_cast<Ogre::Item *>(iter->movable);
 
-      // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
-      // the params passed in the MeshDescriptor when loading the mesh
-      // so strip off the suffix
-      std::string meshName = ogreItem->getMesh()->getName();
-      size_t idx = meshName.find("::");
-      if (idx != std::string::npos)
-        meshName = meshName.substr(0, idx);
-
-      const common::Mesh *mesh =
-           common::MeshManager::Instance()->MeshByName(meshName);
+      const common::Mesh *mesh = Ogre2RayQueryPrivate::MeshFromItem(ogreItem);
 
       if (!mesh)
         continue;
 
+      std::shared_ptr<const Ogre2MeshBvh> bvh = Ogre2MeshBvh::Acquire(mesh);
+
+      // transform the ray into mesh local space instead of transforming
+      // every vertex into world space. The direction is not renormalized so
+      // distances along the local ray match distances along the world ray.
       Ogre::Matrix4 transform = ogreItem->_getParentNodeFullTransform();
+      Ogre::Matrix4 invTransform = transform.inverseAffine();
+      Ogre::Matrix3 invLinear;
+      invTransform.extract3x3Matrix(invLinear);
+      Ogre::Ray localRay(invTransform.transformAffine(mouseRay.getOrigin()),
+          invLinear * mouseRay.getDirection());
+
+      // a mirroring transform flips the triangle winding
+      bool mirrored = invLinear.Determinant() < 0;
 
-      // test for hitting individual triangles on the mesh
-      for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+      Ogre::Real hitDistance = static_cast<Ogre::Real>(distance);
+      if (bvh->Intersect(localRay, !mirrored, mirrored, hitDistance))
       {
-        auto s = mesh->SubMeshByIndex(j);
-        auto submesh = s.lock();
-        if (!submesh || submesh->VertexCount() < 3u)
-          continue;
-        unsigned int indexCount = submesh->IndexCount();
-        for (unsigned int k = 0; k < indexCount; k += 3)
-        {
-          if (indexCount <= k+2)
-            continue;
-
-          math::Vector3d vertexA =
-            submesh->Vertex(submesh->Index(k));
-          math::Vector3d vertexB =
-            submesh->Vertex(submesh->Index(k+1));
-          math::Vector3d vertexC =
-            submesh->Vertex(submesh->Index(k+2));
-
-          Ogre::Vector3 worldVertexA =
-              transform * Ogre2Conversions::Convert(vertexA);
-          Ogre::Vector3 worldVertexB =
-              transform * Ogre2Conversions::Convert(vertexB);
-          Ogre::Vector3 worldVertexC =
-              transform * Ogre2Conversions::Convert(vertexC);
-
-          // check for a hit against this triangle
-          std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(mouseRay,
-              worldVertexA, worldVertexB, worldVertexC,
-              true, false);
-
-          // if it was a hit check if its the closest
-          if (hit.first &&
-              (distance < 0.0f || hit.second < distance))
-          {
-            // this is the closest so far, save it off
-            distance = hit.second;
-            result.distance = distance;
-            result.point =
-                Ogre2Conversions::Convert(mouseRay.getPoint(distance));
-            result.objectId = Ogre::any_cast<unsigned int>(userAny);
-          }
-        }
+        // this is the closest so far, save it off
+        distance = hitDistance;
+        result.distance = distance;
+        result.point =
+            Ogre2Conversions::Convert(mouseRay.getPoint(hitDistance));
+        result.objectId = Ogre::any_cast<unsigned int>(userAny);
       }
     }
   }
 
   return result;
 }
+
+//////////////////////////////////////////////////
+void Ogre2RayQuery::ClosestPoints(const RayQueryRay *_rays,
+    RayQueryResult *_results, std::size_t _count, double _maxDistance,
+    uint32_t _visibilityMask, bool _forceSceneUpdate)
+{
+  if (_count == 0u)
+    return;
+
+  Ogre2ScenePtr ogreScene =
+      std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  if (!ogreScene)
+  {
+    for (std::size_t i = 0; i < _count; ++i)
+      _results[i] = RayQueryResult();
+    return;
+  }
+
+  Ogre::SceneManager *sceneManager = ogreScene->OgreSceneManager();
+  if (_forceSceneUpdate)
+    sceneManager->updateSceneGraph();
+
+  // broad phase: gather every visible mesh item once for the whole batch.
+  // This runs on the calling thread since it touches Ogre objects.
+  auto &candidates = this->dataPtr->candidates;
+  candidates.clear();
+  auto it = sceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (it.hasMoreElements())
+  {
+    Ogre::Item *ogreItem = static_cast<Ogre::Item *>(it.getNext());
+    if (!ogreItem->getVisible() ||
+        !(ogreItem->getVisibilityFlags() & _visibilityMask))
+    {
+      continue;
+    }
+
+    auto userAny = ogreItem->getUserObjectBindings().getUserAny();
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+
+    const common::Mesh *mesh = Ogre2RayQueryPrivate::MeshFromItem(ogreItem);
+    if (!mesh)
+      continue;
+
+    Ogre2RayQueryPrivate::Candidate c;
+    c.bvh = Ogre2MeshBvh::Acquire(mesh);
+    if (c.bvh->TriangleCount() == 0u)
+      continue;
+    c.invTransform = ogreItem->_getParentNodeFullTransform().inverseAffine();
+    c.invTransform.extract3x3Matrix(c.invLinear);
+    c.mirrored = c.invLinear.Determinant() < 0;
+    c.worldAabb = ogreItem->getWorldAabb();
+    c.objectId = Ogre::any_cast<unsigned int>(userAny);
+    candidates.push_back(std::move(c));
+  }
+
+  // narrow phase: intersect rays in parallel. Candidates are read only
+  // from here on.
+  unsigned int threadCount =
+      std::max(1u, std::thread::hardware_concurrency());
+  if (_count < 2u * kMinRaysPerTask || threadCount == 1u)
+  {
+    this->dataPtr->IntersectCandidates(_rays, _results, 0u, _count,
+        _maxDistance);
+    return;
+  }
+
+  if (!this->dataPtr->workerPool)
+  {
+    this->dataPtr->workerPool =
+        std::make_unique<common::WorkerPool>(threadCount);
+  }
+
+  std::size_t taskSize = std::max(kMinRaysPerTask,
+      (_count + threadCount - 1u) / threadCount);
+  for (std::size_t begin = 0u; begin < _count; begin += taskSize)
+  {
+    std::size_t end = std::min(begin + taskSize, _count);
+    this->dataPtr->workerPool->AddWork([=]()
+    {
+      this->dataPtr->IntersectCandidates(_rays, _results, begin, end,
+          _maxDistance);
+    });
+  }
+  this->dataPtr->workerPool->WaitForResults();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <gz/math/Rand.hh>
+
+#include "gz/rendering/RayQuery.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Utils.hh"
+#include "gz/rendering/Visual.hh"
+#include "gz/rendering/ogre2/Ogre2RayQuery.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of the batched ray queries of Ogre2RayQuery
+class Ogre2RayQueryTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2RayQueryTest, ClosestPoints)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // a row of boxes and spheres with alternating visibility flags
+  for (unsigned int i = 0u; i < 6u; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(i % 2u ? scene->CreateSphere() : scene->CreateBox());
+    visual->SetLocalPosition(2.0 * i, 0.0, 0.0);
+    visual->SetLocalRotation(0.0, 0.3 * i, 0.2 * i);
+    visual->SetVisibilityFlags(i % 2u ? 0x01 : 0x02);
+    root->AddChild(visual);
+  }
+
+  auto rayQuery =
+      std::dynamic_pointer_cast<Ogre2RayQuery>(scene->CreateRayQuery());
+  ASSERT_NE(nullptr, rayQuery);
+
+  // enough rays for the batch to be split across threads
+  math::Rand::Seed(42u);
+  std::vector<RayQueryRay> rays(2000u);
+  for (auto &ray : rays)
+  {
+    ray.origin = math::Vector3d(math::Rand::DblUniform(-2.0, 12.0),
+        math::Rand::DblUniform(-3.0, 3.0), 5.0);
+    ray.direction = math::Vector3d(math::Rand::DblUniform(-0.5, 0.5),
+        math::Rand::DblUniform(-0.5, 0.5), -1.0);
+  }
+
+  // the batched query matches one query per ray
+  auto expectSame = [&](double _maxDistance, uint32_t _mask)
+  {
+    std::vector<RayQueryResult> batched(rays.size());
+    std::vector<RayQueryResult> expected(rays.size());
+    rayQuery->ClosestPoints(rays.data(), batched.data(), rays.size(),
+        _maxDistance, _mask);
+    closestPoints(rayQuery, rays.data(), expected.data(), rays.size(),
+        _maxDistance, _mask);
+    unsigned int hits = 0u;
+    for (std::size_t i = 0u; i < rays.size(); ++i)
+    {
+      ASSERT_EQ(static_cast<bool>(expected[i]),
+          static_cast<bool>(batched[i])) << i;
+      if (!expected[i])
+        continue;
+      ++hits;
+      EXPECT_EQ(expected[i].objectId, batched[i].objectId) << i;
+      EXPECT_NEAR(expected[i].distance, batched[i].distance, 1e-3) << i;
+      EXPECT_TRUE(expected[i].point.Equal(batched[i].point, 1e-3)) << i;
+    }
+    EXPECT_GT(hits, 0u);
+  };
+  expectSame(-1.0, GZ_VISIBILITY_ALL);
+  expectSame(5.0, GZ_VISIBILITY_ALL);
+  expectSame(-1.0, 0x01);
+  expectSame(-1.0, 0x02);
+
+  // an empty batch is a no-op
+  rayQuery->ClosestPoints(nullptr, nullptr, 0u);
+
+  engine->DestroyScene(scene);
+}
@@ -20,6 +20,9 @@
   // pulled in by anybody (e.g., Boost).
   #include <Winsock2.h>
 #endif
+#include <chrono>
+#include <utility>
+
 #include <gz/common/Console.hh>
 #include <gz/common/Filesystem.hh>
 #include <gz/common/Util.hh>
@@ -28,6 +31,7 @@
 
 #include "gz/rendering/GraphicsAPI.hh"
 #include "gz/rendering/InstallationDirectories.hh"
+#include "gz/rendering/MeshDescriptor.hh"
 #include "gz/rendering/RenderEngineManager.hh"
 #include "gz/rendering/ogre2/Ogre2Includes.hh"
 #include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -38,6 +42,12 @@
 #include "Ogre2GzHlmsPbsPrivate.hh"
 #include "Ogre2GzHlmsTerraPrivate.hh"
 #include "Ogre2GzHlmsUnlitPrivate.hh"
+#include "Ogre2MaterialInterner.hh"
+#include "Ogre2MeshBvh.hh"
+#include "Ogre2ShaderCache.hh"
+#include "Ogre2ImageDecoder.hh"
+#include "Ogre2TextureBudget.hh"
+#include "Ogre2TextureCache.hh"
 
 #include "Terra/Hlms/OgreHlmsTerra.h"
 #include "Terra/Hlms/PbsListener/OgreHlmsPbsTerraShadows.h"
@@ -87,6 +97,49 @@ class GZ_RENDERING_OGRE2_HIDDEN
 
   /// \brief Custom Terra modifications
   public: Ogre::Ogre2GzHlmsTerra *gzHlmsTerra{nullptr};
+
+  /// \brief Directory of the mesh cache, empty if disabled
+  public: std::string meshCacheDir;
+
+  /// \brief Directory of the heightmap cache, empty if disabled
+  public: std::string heightmapCacheDir;
+
+  /// \brief True to pack mesh vertices in the compact layout
+  public: bool compactMeshVertices = false;
+
+  /// \brief True to optimize triangle and vertex order of meshes
+  public: bool optimizeMeshes = false;
+
+  /// \brief True to stream material textures without blocking
+  public: bool streamTextures = false;
+
+  /// \brief Directory of the texture cache, empty if disabled
+  public: std::string textureCacheDir;
+
+  /// \brief True to share datablocks of identical mesh materials
+  public: bool shareMaterials = false;
+
+  /// \brief Texture memory budget
+  public: Ogre2TextureBudget textureBudget;
+
+  /// \brief Decodes images for materials on worker threads
+  public: Ogre2ImageDecoder imageDecoder;
+
+  /// \brief Directory of the shader cache, empty if disabled
+  public: std::string shaderCacheDir;
+
+  /// \brief Subdirectory of shaderCacheDir used by the current GPU and
+  /// driver, empty until the cache is loaded
+  public: std::string shaderCachePath;
+
+  /// \brief True to log the duration of each startup stage
+  public: bool profileStartup = false;
+
+  /// \brief Duration of each startup stage in seconds
+  public: std::vector<std::pair<std::string, double>> startupProfile;
+
+  /// \brief Start time of the current startup stage
+  public: std::chrono::steady_clock::time_point startupStageStart;
 };
 
 using namespace gz;
@@ -151,8 +204,28 @@ void Ogre2RenderEngine::Destroy()
 
   this->dataPtr->hlmsPbsTerraShadows.reset();
 
+  Ogre2MeshBvh::ClearCache();
+
+  // levels of detail are registered for the whole process, a later engine
+  // starts without them like it starts with the default lod strategy of
+  // its own Ogre root
+  MeshDescriptor::ClearLodLevels();
+
+  // materials are destroyed with the scenes so nothing waits for the
+  // images they were decoding
+  this->dataPtr->imageDecoder.Clear();
+
+  // shared datablocks are destroyed with the Hlms below, a later engine
+  // must not find them
+  Ogre2MaterialInterner::Clear();
+
   if (this->ogreRoot)
   {
+    this->SaveShaderCache();
+
+    // texture cache entries are encoded with Ogre's codecs
+    Ogre2TextureCache::Wait();
+
     // Clean up any textures that may still be in flight.
     Ogre::TextureGpuManager *mgr =
     this->ogreRoot->getRenderSystem()->getTextureGpuManager();
@@ -359,6 +432,50 @@ bool Ogre2RenderEngine::LoadImpl(
         this->dataPtr->graphicsAPI = GraphicsAPI::VULKAN;
   }
 
+  it = _params.find("meshCacheDir");
+  if (it != _params.end())
+    this->dataPtr->meshCacheDir = it->second;
+
+  it = _params.find("heightmapCacheDir");
+  if (it != _params.end())
+    this->dataPtr->heightmapCacheDir = it->second;
+
+  it = _params.find("compactMeshVertices");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->compactMeshVertices;
+
+  it = _params.find("optimizeMeshes");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->optimizeMeshes;
+
+  it = _params.find("streamTextures");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->streamTextures;
+
+  it = _params.find("textureCacheDir");
+  if (it != _params.end())
+    this->dataPtr->textureCacheDir = it->second;
+
+  it = _params.find("shareMaterials");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->shareMaterials;
+
+  it = _params.find("textureBudgetMB");
+  if (it != _params.end())
+  {
+    uint64_t budgetMB = 0u;
+    std::istringstream(it->second) >> budgetMB;
+    this->dataPtr->textureBudget.SetBudget(budgetMB * 1024u * 1024u);
+  }
+
+  it = _params.find("shaderCacheDir");
+  if (it != _params.end())
+    this->dataPtr->shaderCacheDir = it->second;
+
+  it = _params.find("profileStartup");
+  if (it != _params.end())
+    std::istringstream(it->second) >> this->dataPtr->profileStartup;
+
   try
   {
     this->LoadAttempt();
@@ -398,6 +515,9 @@ bool Ogre2RenderEngine::InitImpl()
 //////////////////////////////////////////////////
 void Ogre2RenderEngine::LoadAttempt()
 {
+  this->dataPtr->startupProfile.clear();
+  this->dataPtr->startupStageStart = std::chrono::steady_clock::now();
+
   this->CreateLogger();
   if (!this->useCurrentGLContext &&
       (this->dataPtr->graphicsAPI == GraphicsAPI::OPENGL ||
@@ -405,14 +525,30 @@ void Ogre2RenderEngine::LoadAttempt()
   {
     this->CreateContext();
   }
+  this->EndStartupStage("CreateContext");
 
   this->CreateRoot();
   this->CreateOverlay();
+  this->EndStartupStage("CreateRoot");
   this->LoadPlugins();
+  this->EndStartupStage("LoadPlugins");
   this->CreateRenderSystem();
   this->ogreRoot->initialise(false);
+  this->EndStartupStage("CreateRenderSystem");
   this->CreateRenderWindow();
+  this->EndStartupStage("CreateRenderWindow");
   this->CreateResources();
+  this->EndStartupStage("CreateResources");
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::EndStartupStage(const std::string &_name)
+{
+  auto now = std::chrono::steady_clock::now();
+  double duration = std::chrono::duration<double>(
+      now - this->dataPtr->startupStageStart).count();
+  this->dataPtr->startupProfile.push_back({_name, duration});
+  this->dataPtr->startupStageStart = now;
 }
 
 //////////////////////////////////////////////////
@@ -1164,10 +1300,31 @@ void Ogre2RenderEngine::InitAttempt()
 {
   this->initialized = false;
 
+  this->dataPtr->startupStageStart = std::chrono::steady_clock::now();
+
   // init the resources
   Ogre::ResourceGroupManager::getSingleton().initialiseAllResourceGroups(false);
+  this->EndStartupStage("InitResourceGroups");
+
+  if (!this->dataPtr->shaderCacheDir.empty())
+  {
+    this->dataPtr->shaderCachePath =
+        Ogre2ShaderCache::Directory(this->dataPtr->shaderCacheDir);
+    Ogre2ShaderCache::Load(this->dataPtr->shaderCachePath);
+    this->EndStartupStage("LoadShaderCache");
+  }
 
   this->scenes = Ogre2SceneStorePtr(new Ogre2SceneStore);
+
+  if (this->dataPtr->profileStartup)
+  {
+    double total = 0.0;
+    for (const auto &[name, duration] : this->dataPtr->startupProfile)
+      total += duration;
+    gzmsg << "ogre2 startup took " << total * 1000.0 << " ms" << std::endl;
+    for (const auto &[name, duration] : this->dataPtr->startupProfile)
+      gzmsg << "  " << name << ": " << duration * 1000.0 << " ms" << std::endl;
+  }
 }
 
 /////////////////////////////////////////////////
@@ -1204,6 +1361,102 @@ void Ogre2RenderEngine::SetGzOgreRenderingMode(
   this->dataPtr->gzHlmsTerra->gzOgreRenderingMode = renderingMode;
 }
 
+/////////////////////////////////////////////////
+std::string Ogre2RenderEngine::MeshCacheDir() const
+{
+  return this->dataPtr->meshCacheDir;
+}
+
+/////////////////////////////////////////////////
+std::string Ogre2RenderEngine::HeightmapCacheDir() const
+{
+  return this->dataPtr->heightmapCacheDir;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::CompactMeshVertices() const
+{
+  return this->dataPtr->compactMeshVertices;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::OptimizeMeshes() const
+{
+  return this->dataPtr->optimizeMeshes;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::StreamTextures() const
+{
+  return this->dataPtr->streamTextures;
+}
+
+/////////////////////////////////////////////////
+std::string Ogre2RenderEngine::TextureCacheDir() const
+{
+  return this->dataPtr->textureCacheDir;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2RenderEngine::ShareMaterials() const
+{
+  return this->dataPtr->shareMaterials;
+}
+
+/////////////////////////////////////////////////
+Ogre2TextureStats Ogre2RenderEngine::TextureStats() const
+{
+  if (!this->ogreRoot)
+    return Ogre2TextureStats();
+  return this->dataPtr->textureBudget.Stats(
+      this->ogreRoot->getRenderSystem()->getTextureGpuManager());
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::UpdateTextureBudget()
+{
+  if (this->dataPtr->textureBudget.Budget() == 0u ||
+      !this->dataPtr->gzHlmsPbs)
+  {
+    return;
+  }
+
+  this->dataPtr->gzHlmsPbs->trackDatablocks = true;
+  this->dataPtr->textureBudget.Update(this->ogreRoot->getHlmsManager(),
+      this->ogreRoot->getRenderSystem()->getTextureGpuManager(),
+      this->dataPtr->gzHlmsPbs->drawnDatablocks,
+      std::chrono::steady_clock::now());
+  this->dataPtr->gzHlmsPbs->drawnDatablocks.clear();
+}
+
+/////////////////////////////////////////////////
+std::vector<std::pair<std::string, double>>
+Ogre2RenderEngine::StartupProfile() const
+{
+  return this->dataPtr->startupProfile;
+}
+
+/////////////////////////////////////////////////
+std::string Ogre2RenderEngine::ShaderCacheDir() const
+{
+  return this->dataPtr->shaderCacheDir;
+}
+
+/////////////////////////////////////////////////
+void Ogre2RenderEngine::SaveShaderCache()
+{
+  if (this->dataPtr->shaderCachePath.empty())
+    return;
+
+  Ogre2ShaderCache::Save(this->dataPtr->shaderCachePath);
+}
+
+//////////////////////////////////////////////////
+Ogre2ImageDecoder *Ogre2RenderEngine::ImageDecoder() const
+{
+  return &this->dataPtr->imageDecoder;
+}
+
 /////////////////////////////////////////////////
 Ogre::HlmsPbsTerraShadows *Ogre2RenderEngine::HlmsPbsTerraShadows() const
 {
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gz/common/TempDirectory.hh>
+
+#include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2RenderingTest.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of Ogre2RenderEngine, with a shader cache and startup
+/// profiling
+class Ogre2RenderEngineTest : public Ogre2RenderingTest
+{
+  /// \brief Load the render engine with a shader cache
+  public: static void SetUpTestSuite()
+  {
+    tempDir = std::make_unique<common::TempDirectory>("ogre2_engine");
+    LoadEngine({{"shaderCacheDir", tempDir->Path()},
+        {"profileStartup", "1"}});
+  }
+
+  /// \brief Destroy the render engine and the cache
+  public: static void TearDownTestSuite()
+  {
+    Ogre2RenderingTest::TearDownTestSuite();
+    tempDir.reset();
+  }
+
+  /// \brief Directory of the shader cache
+  protected: static inline std::unique_ptr<common::TempDirectory> tempDir;
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2RenderEngineTest, StartupProfile)
+{
+  auto profile = engine->StartupProfile();
+  ASSERT_FALSE(profile.empty());
+
+  // the documented stages, in order
+  std::vector<std::string> stages;
+  double total = 0.0;
+  for (const auto &[name, duration] : profile)
+  {
+    stages.push_back(name);
+    EXPECT_GE(duration, 0.0) << name;
+    total += duration;
+  }
+  EXPECT_EQ(std::vector<std::string>({"CreateContext", "CreateRoot",
+      "LoadPlugins", "CreateRenderSystem", "CreateRenderWindow",
+      "CreateResources", "InitResourceGroups", "LoadShaderCache"}), stages);
+  EXPECT_GT(total, 0.0);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2RENDERINGTEST_HH_
+#define GZ_RENDERING_OGRE2_OGRE2RENDERINGTEST_HH_
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Image.hh>
+#include <gz/utils/Environment.hh>
+
+#include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreImage2.h>
+#include <OgreTextureBox.h>
+#include <OgreTextureGpu.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Fixture of the ogre2 unit tests that need a render engine. The
+/// engine is loaded once per test program, with the parameters given by
+/// the test suite, and tests are skipped unless the GZ_ENGINE_TO_TEST
+/// environment variable is ogre2, as for the common rendering tests.
+class Ogre2RenderingTest : public testing::Test
+{
+  /// \brief Load the render engine
+  /// \param[in] _params Parameters passed to Load in addition to the
+  /// backend and headless ones read from the environment
+  protected: static void LoadEngine(
+      std::map<std::string, std::string> _params = {})
+  {
+    std::string value;
+    if (!gz::utils::env("GZ_ENGINE_TO_TEST", value) || value != "ogre2")
+      return;
+    if (gz::utils::env("GZ_ENGINE_BACKEND", value) && value == "vulkan")
+      _params["vulkan"] = "1";
+    if (gz::utils::env("GZ_ENGINE_HEADLESS", value) && !value.empty())
+      _params["headless"] = "1";
+
+    auto *ogreEngine = gz::rendering::Ogre2RenderEngine::Instance();
+    if (ogreEngine->Load(_params) && ogreEngine->Init())
+      engine = ogreEngine;
+  }
+
+  /// \brief Load the render engine with default parameters. Test suites
+  /// needing other parameters hide this function.
+  public: static void SetUpTestSuite()
+  {
+    LoadEngine();
+  }
+
+  /// \brief Destroy the render engine
+  public: static void TearDownTestSuite()
+  {
+    if (engine)
+      engine->Destroy();
+    engine = nullptr;
+  }
+
+  /// \brief Skip the test if the render engine is not loaded
+  public: void SetUp() override
+  {
+    if (!engine)
+      GTEST_SKIP() << "ogre2 render engine not loaded";
+  }
+
+  /// \brief Value of a pixel of the images written by WriteGrayImage,
+  /// different for every pixel so flipped or transposed copies are detected
+  /// \param[in] _x Column of the pixel
+  /// \param[in] _y Row of the pixel, 0 being the top row
+  /// \return Value of the pixel
+  protected: static uint8_t GrayValue(unsigned int _x, unsigned int _y)
+  {
+    return static_cast<uint8_t>(10u + 20u * _y + 3u * _x);
+  }
+
+  /// \brief Write an 8 bit grayscale PNG image, see GrayValue
+  /// \param[in] _dir Directory of the image
+  /// \param[in] _name File name of the image
+  /// \param[in] _width Width of the image, at most 10
+  /// \param[in] _height Height of the image, at most 10
+  /// \return Path of the image
+  protected: static std::string WriteGrayImage(const std::string &_dir,
+      const std::string &_name, unsigned int _width, unsigned int _height)
+  {
+    std::vector<unsigned char> data;
+    for (unsigned int y = 0u; y < _height; ++y)
+    {
+      for (unsigned int x = 0u; x < _width; ++x)
+        data.push_back(GrayValue(x, y));
+    }
+    gz::common::Image image;
+    image.SetFromData(data.data(), _width, _height,
+        gz::common::Image::L_INT8);
+    std::string path = gz::common::joinPaths(_dir, _name);
+    image.SavePNG(path);
+    return path;
+  }
+
+  /// \brief Read back the first mipmap of an 8 bit RGBA texture
+  /// \param[in] _texture Texture to read
+  /// \return RGBA pixels, top row first
+  protected: static std::vector<uint8_t> TexturePixels(
+      Ogre::TextureGpu *_texture)
+  {
+    _texture->waitForData();
+    Ogre::Image2 image;
+    image.convertFromTexture(_texture, 0u, 0u);
+    Ogre::TextureBox box = image.getData(0u);
+    std::vector<uint8_t> pixels;
+    for (uint32_t y = 0u; y < box.height; ++y)
+    {
+      const auto *row = static_cast<const uint8_t *>(box.at(0u, y, 0u));
+      pixels.insert(pixels.end(), row, row + box.width * 4u);
+    }
+    return pixels;
+  }
+
+  /// \brief Render engine, null if it could not be loaded
+  protected: static inline gz::rendering::Ogre2RenderEngine *engine =
+      nullptr;
+};
+#endif
@@ -42,6 +42,7 @@
 #include "gz/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "gz/rendering/ogre2/Ogre2Node.hh"
 #include "gz/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "gz/rendering/ogre2/Ogre2PointCloudVisual.hh"
 #include "gz/rendering/ogre2/Ogre2Projector.hh"
 #include "gz/rendering/ogre2/Ogre2RayQuery.hh"
 #include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -103,6 +104,10 @@ class gz::rendering::Ogre2ScenePrivate
 
   /// \brief Name of shadow compositor node
   public: const std::string kShadowNodeName = "PbsMaterialsShadowNode";
+
+  /// \brief Scene extension API, one per scene so objects are created in
+  /// the scene they are requested from
+  public: std::unique_ptr<Ogre2SceneExt> ext;
 };
 
 using namespace gz;
@@ -112,9 +117,8 @@ using namespace rendering;
 Ogre2Scene::Ogre2Scene(unsigned int _id, const std::string &_name) :
   BaseScene(_id, _name), dataPtr(std::make_unique<Ogre2ScenePrivate>())
 {
-  // there should only be one scene / scene ext API
-  static Ogre2SceneExt ext(this);
-  this->SetExtension(&ext);
+  this->dataPtr->ext = std::make_unique<Ogre2SceneExt>(this);
+  this->SetExtension(this->dataPtr->ext.get());
 }
 
 //////////////////////////////////////////////////
@@ -188,6 +192,11 @@ void Ogre2Scene::PreRender()
              "See Scene::SetCameraPassCountPerGpuFlush for details");
   this->dataPtr->frameUpdateStarted = true;
 
+  // create the GPU buffers of meshes loaded in the background
+  this->meshFactory->ProcessAsyncLoads();
+
+  Ogre2RenderEngine::Instance()->UpdateTextureBudget();
+
   if (this->ShadowsDirty())
   {
     // notify all render targets
@@ -407,6 +416,10 @@ void Ogre2Scene::EndFrame()
 //////////////////////////////////////////////////
 void Ogre2Scene::SetCameraPassCountPerGpuFlush(uint8_t _numPass)
 {
+  // PreRender marks a frame as started in legacy mode too but nothing ends
+  // it, so don't carry it over when leaving legacy mode
+  if (this->LegacyAutoGpuFlush() && _numPass > 0u)
+    this->dataPtr->frameUpdateStarted = false;
   this->dataPtr->cameraPassCountPerGpuFlush = _numPass;
 }
 
@@ -433,6 +446,9 @@ void Ogre2Scene::Clear()
 //////////////////////////////////////////////////
 void Ogre2Scene::Destroy()
 {
+  // pending meshes would be created in a scene that no longer exists
+  this->meshFactory->CancelAsyncLoads();
+
   this->DestroyNodes();
 
   // cleanup any items that were not attached to nodes
@@ -1204,6 +1220,30 @@ MeshPtr Ogre2Scene::CreateMeshImpl(unsigned int _id,
   return (result) ? mesh : nullptr;
 }
 
+//////////////////////////////////////////////////
+std::future<MeshPtr> Ogre2Scene::CreateMeshAsync(const MeshDescriptor &_desc)
+{
+  std::string meshName = (_desc.mesh) ?
+      _desc.mesh->Name() : _desc.meshName;
+  unsigned int objId = this->CreateObjectId();
+  std::string objName = this->CreateObjectName(objId, "Mesh-" + meshName);
+
+  auto promise = std::make_shared<std::promise<MeshPtr>>();
+  std::future<MeshPtr> future = promise->get_future();
+  this->meshFactory->CreateAsync(_desc,
+      [this, promise, objId, objName, _desc](Ogre2MeshPtr _mesh)
+      {
+        if (_mesh)
+        {
+          _mesh->SetDescriptor(_desc);
+          if (!this->InitObject(_mesh, objId, objName))
+            _mesh = nullptr;
+        }
+        promise->set_value(_mesh);
+      });
+  return future;
+}
+
 //////////////////////////////////////////////////
 CapsulePtr Ogre2Scene::CreateCapsuleImpl(unsigned int _id,
     const std::string &_name)
@@ -1313,6 +1353,16 @@ ParticleEmitterPtr Ogre2Scene::CreateParticleEmitterImpl(unsigned int _id,
   return (result) ? visual : nullptr;
 }
 
+//////////////////////////////////////////////////
+PointCloudVisualPtr Ogre2Scene::CreatePointCloudImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2PointCloudVisualPtr visual(new Ogre2PointCloudVisual);
+  bool result = this->InitObject(visual, _id, _name);
+
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 ProjectorPtr Ogre2Scene::CreateProjectorImpl(unsigned int _id,
     const std::string &_name)
@@ -1502,6 +1552,17 @@ ObjectPtr Ogre2SceneExt::CreateExt(const std::string &_type,
     bool result = ogreScene->Visuals()->Add(projector);
     return (result) ? projector : nullptr;
   }
+  else if (_type == "point_cloud")
+  {
+    Ogre2Scene *ogreScene = dynamic_cast<Ogre2Scene *>(this->scene);
+    unsigned int objId = ogreScene->CreateObjectId();
+    std::string objName = _name.empty() ?
+        ogreScene->CreateObjectName(objId, "PointCloudVisual") : _name;
+    PointCloudVisualPtr visual = ogreScene->CreatePointCloudImpl(
+        objId, objName);
+    bool result = ogreScene->RegisterVisual(visual);
+    return (result) ? visual : nullptr;
+  }
 
   return ObjectPtr();
 }
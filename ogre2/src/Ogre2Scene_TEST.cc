@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/TempDirectory.hh>
+
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/Mesh.hh"
+#include "gz/rendering/MeshDescriptor.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+#include "Ogre2ShaderCache.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsCommon.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Tests of Ogre2Scene, with a shader cache, see
+/// Ogre2RenderEngine::ShaderCacheDir
+class Ogre2SceneTest : public Ogre2RenderingTest
+{
+  /// \brief Load the render engine with a shader cache
+  public: static void SetUpTestSuite()
+  {
+    tempDir = std::make_unique<common::TempDirectory>("ogre2_scene");
+    LoadEngine({{"shaderCacheDir", tempDir->Path()}});
+  }
+
+  /// \brief Destroy the render engine and the cache
+  public: static void TearDownTestSuite()
+  {
+    Ogre2RenderingTest::TearDownTestSuite();
+    tempDir.reset();
+  }
+
+  /// \brief Get the size of the Pbs Hlms cache saved by the engine
+  /// \return Size in bytes, 0 if the file does not exist
+  protected: static std::streamoff PbsCacheSize()
+  {
+    std::string path = common::joinPaths(
+        Ogre2ShaderCache::Directory(engine->ShaderCacheDir()),
+        "hlms" + std::to_string(Ogre::HLMS_PBS) + ".cache");
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    return stream ? static_cast<std::streamoff>(stream.tellg()) : 0;
+  }
+
+  /// \brief Directory of the shader cache
+  protected: static inline std::unique_ptr<common::TempDirectory> tempDir;
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, WarmUp)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // warming up an empty scene compiles no Pbs shader
+  scene->WarmUp();
+  engine->SaveShaderCache();
+  const std::streamoff emptySize = PbsCacheSize();
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(0.0, 0.0, 1.0);
+  box->SetMaterial(material);
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  root->AddChild(box);
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  root->AddChild(camera);
+
+  // warming up compiles the shaders of the box before any capture, so
+  // they are saved for the next run
+  scene->WarmUp();
+  engine->SaveShaderCache();
+  EXPECT_GT(PbsCacheSize(), emptySize);
+
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2SceneTest, MeshAsync)
+{
+  auto scene =
+      std::dynamic_pointer_cast<Ogre2Scene>(engine->CreateScene("scene"));
+  ASSERT_NE(nullptr, scene);
+
+  MeshDescriptor descriptor("unit_box");
+  std::future<MeshPtr> future = scene->CreateMeshAsync(descriptor);
+  ASSERT_TRUE(future.valid());
+
+  // the mesh is created on the render thread during PreRender
+  for (unsigned int i = 0; i < 100u &&
+      future.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+      ++i)
+  {
+    scene->PreRender();
+    scene->PostRender();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(std::future_status::ready,
+      future.wait_for(std::chrono::seconds(0)));
+
+  MeshPtr mesh = future.get();
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(1u, mesh->SubMeshCount());
+  EXPECT_EQ("unit_box", mesh->Descriptor().meshName);
+  EXPECT_NE(nullptr, mesh->SubMeshByIndex(0u));
+
+  // invalid descriptors result in a null mesh
+  std::future<MeshPtr> invalid = scene->CreateMeshAsync(MeshDescriptor());
+  scene->PreRender();
+  scene->PostRender();
+  ASSERT_EQ(std::future_status::ready,
+      invalid.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ(nullptr, invalid.get());
+
+  // meshes still pending when the scene is destroyed are cancelled
+  std::future<MeshPtr> pending =
+      scene->CreateMeshAsync(MeshDescriptor("unit_cylinder"));
+  ASSERT_TRUE(pending.valid());
+
+  engine->DestroyScene(scene);
+
+  ASSERT_EQ(std::future_status::ready,
+      pending.wait_for(std::chrono::seconds(0)));
+  EXPECT_EQ(nullptr, pending.get());
+}
@@ -376,7 +376,7 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
       VisualPtr visual = heightmap->Parent();
       const Ogre::Vector4 customParameter =
         ColorForVisual(visual, prevParentName);
-      heightmap->Terra()->SetSolidColor(1u, customParameter);
+      heightmap->SetSolidColor(1u, customParameter);
     }
   }
 
@@ -441,7 +441,7 @@ void Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene(
   {
     auto heightmap = h.lock();
     if (heightmap)
-      heightmap->Terra()->UnsetSolidColors();
+      heightmap->UnsetSolidColors();
   }
 
   engine->SetGzOgreRenderingMode(GORM_NORMAL);
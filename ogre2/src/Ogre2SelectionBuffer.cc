@@ -15,7 +15,11 @@
  *
 */
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <set>
+#include <vector>
 #include <gz/math/Color.hh>
 
 #include "gz/common/Console.hh"
@@ -36,6 +40,7 @@
 #include <Compositor/Pass/PassClear/OgreCompositorPassClearDef.h>
 #include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
 #include <Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h>
+#include <OgreAsyncTextureTicket.h>
 #include <OgreCamera.h>
 #include <OgreDepthBuffer.h>
 #include <OgreItem.h>
@@ -52,6 +57,10 @@
 using namespace gz;
 using namespace rendering;
 
+/// \brief Region textures are allocated in multiples of this size so that
+/// box selection with a changing rectangle does not reallocate every frame
+static const unsigned int kRegionTexGranularity = 64u;
+
 class gz::rendering::Ogre2SelectionBufferPrivate
 {
   /// \brief This is a material listener and a RenderTargetListener.
@@ -94,6 +103,35 @@ class gz::rendering::Ogre2SelectionBufferPrivate
 
   /// \brief The selection buffer material
   public: Ogre::MaterialPtr selectionMaterial;
+
+  /// \brief Render texture used by region queries
+  public: Ogre::TextureGpu *regionTexture = nullptr;
+
+  /// \brief Compositor workspace rendering into regionTexture
+  public: Ogre::CompositorWorkspace *regionWorkspace = nullptr;
+
+  /// \brief Ticket used to read back regionTexture asynchronously
+  public: Ogre::AsyncTextureTicket *regionTicket = nullptr;
+
+  /// \brief Top left pixel of the last requested region
+  public: math::Vector2i regionMin;
+
+  /// \brief Width of the last requested region
+  public: unsigned int regionWidth = 0u;
+
+  /// \brief Height of the last requested region
+  public: unsigned int regionHeight = 0u;
+
+  /// \brief World pose of the reference camera when the last region was
+  /// requested
+  public: math::Pose3d regionCameraPose;
+
+  /// \brief True if the readback of the last region has not been copied
+  /// into regionData yet
+  public: bool regionPending = false;
+
+  /// \brief RGBA float pixels of the last requested region
+  public: std::vector<float> regionData;
 };
 
 /////////////////////////////////////////////////
@@ -166,6 +204,12 @@ void Ogre2SelectionBuffer::Update()
   if (!this->dataPtr->renderTexture)
     return;
 
+  this->Render(this->dataPtr->ogreCompositorWorkspace);
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::Render(Ogre::CompositorWorkspace *_workspace)
+{
   this->dataPtr->materialSwitcher->Reset();
 
   this->dataPtr->scene->StartForcedRender();
@@ -175,14 +219,14 @@ void Ogre2SelectionBuffer::Update()
   // auto engine = Ogre2RenderEngine::Instance();
   // engine->OgreRoot()->renderOneFrame();
   // this->dataPtr->ogreCompositorWorkspace->setEnabled(false);
-  this->dataPtr->ogreCompositorWorkspace->_validateFinalTarget();
-  this->dataPtr->ogreCompositorWorkspace->_beginUpdate(false);
-  this->dataPtr->ogreCompositorWorkspace->_update();
-  this->dataPtr->ogreCompositorWorkspace->_endUpdate(false);
+  _workspace->_validateFinalTarget();
+  _workspace->_beginUpdate(false);
+  _workspace->_update();
+  _workspace->_endUpdate(false);
 
   Ogre::vector<Ogre::TextureGpu *>::type swappedTargets;
   swappedTargets.reserve(2u);
-  this->dataPtr->ogreCompositorWorkspace->_swapFinalTarget(swappedTargets);
+  _workspace->_swapFinalTarget(swappedTargets);
 
   this->dataPtr->scene->FlushGpuCommandsAndStartNewFrame(1u, false);
 
@@ -195,6 +239,10 @@ void Ogre2SelectionBuffer::Update()
 /////////////////////////////////////////////////
 void Ogre2SelectionBuffer::DeleteRTTBuffer()
 {
+  // the region workspace uses the same workspace definition so it needs to
+  // be removed first
+  this->DeleteRegionBuffer();
+
   if (this->dataPtr->ogreCompositorWorkspace)
   {
     // TODO(ahcorde): Remove the workspace. Potential leak here
@@ -404,15 +452,89 @@ Ogre::Item *Ogre2SelectionBuffer::OnSelectionClick(const int _x, const int _y)
 }
 
 /////////////////////////////////////////////////
-bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
-    Ogre::Item *&_item, math::Vector3d &_point)
+void Ogre2SelectionBuffer::DeleteRegionBuffer()
 {
-  if (!this->dataPtr->renderTexture)
-    return false;
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::TextureGpuManager *textureMgr =
+    engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
 
-  if (!this->dataPtr->camera)
-    return false;
+  if (this->dataPtr->regionTicket)
+  {
+    textureMgr->destroyAsyncTextureTicket(this->dataPtr->regionTicket);
+    this->dataPtr->regionTicket = nullptr;
+  }
+
+  if (this->dataPtr->regionWorkspace)
+  {
+    this->dataPtr->ogreCompMgr->removeWorkspace(
+        this->dataPtr->regionWorkspace);
+    this->dataPtr->regionWorkspace = nullptr;
+  }
+
+  if (this->dataPtr->regionTexture)
+  {
+    textureMgr->destroyTexture(this->dataPtr->regionTexture);
+    this->dataPtr->regionTexture = nullptr;
+  }
+
+  this->dataPtr->regionPending = false;
+  this->dataPtr->regionData.clear();
+  this->dataPtr->regionWidth = 0u;
+  this->dataPtr->regionHeight = 0u;
+}
 
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::CreateRegionBuffer(unsigned int _width,
+    unsigned int _height)
+{
+  if (this->dataPtr->regionTexture &&
+      this->dataPtr->regionTexture->getWidth() >= _width &&
+      this->dataPtr->regionTexture->getHeight() >= _height)
+  {
+    return;
+  }
+
+  this->DeleteRegionBuffer();
+
+  unsigned int texWidth = ((_width + kRegionTexGranularity - 1u) /
+      kRegionTexGranularity) * kRegionTexGranularity;
+  unsigned int texHeight = ((_height + kRegionTexGranularity - 1u) /
+      kRegionTexGranularity) * kRegionTexGranularity;
+
+  auto engine = Ogre2RenderEngine::Instance();
+  Ogre::TextureGpuManager *textureMgr =
+    engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+
+  this->dataPtr->regionTexture = textureMgr->createTexture(
+      this->dataPtr->camera->getName() + "_SelectionRegionTex",
+      Ogre::GpuPageOutStrategy::Discard,
+      Ogre::TextureFlags::RenderToTexture,
+      Ogre::TextureTypes::Type2D);
+  this->dataPtr->regionTexture->setResolution(texWidth, texHeight);
+  this->dataPtr->regionTexture->setNumMipmaps(1u);
+  this->dataPtr->regionTexture->setPixelFormat(Ogre::PFG_RGBA32_FLOAT);
+  this->dataPtr->regionTexture->scheduleTransitionTo(
+    Ogre::GpuResidency::Resident);
+
+  // reuse the workspace definition of the 1x1 buffer. Its textures are
+  // sized relative to the final target.
+  this->dataPtr->regionWorkspace =
+      this->dataPtr->ogreCompMgr->addWorkspace(
+        this->dataPtr->scene->OgreSceneManager(),
+        this->dataPtr->regionTexture,
+        this->dataPtr->selectionCamera,
+        this->dataPtr->ogreCompWorkspaceDefName,
+        false);
+
+  this->dataPtr->regionTicket = textureMgr->createAsyncTextureTicket(
+      texWidth, texHeight, 1u, Ogre::TextureTypes::Type2D,
+      Ogre::PFG_RGBA32_FLOAT);
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::SetupSelectionCamera(int _x, int _y,
+    unsigned int _width, unsigned int _height)
+{
   // check camera has valid projection matrix
   // There could be nan values if camera was resized
   Ogre::Matrix4 projectionMatrix =
@@ -421,24 +543,18 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
       projectionMatrix.extractQuaternion().isNaN())
     return false;
 
-   const unsigned int targetWidth = this->dataPtr->width;
-   const unsigned int targetHeight = this->dataPtr->height;
-
-   if (_x < 0 || _y < 0 || _x >= static_cast<int>(targetWidth)
-       || _y >= static_cast<int>(targetHeight))
-     return false;
+  const unsigned int targetWidth = this->dataPtr->width;
+  const unsigned int targetHeight = this->dataPtr->height;
 
-  // 1x1 selection buffer, adapted from rviz
+  // zoom the projection in on the region, adapted from rviz
   // http://docs.ros.org/indigo/api/rviz/html/c++/selection__manager_8cpp.html
-  unsigned int width = 1;
-  unsigned int height = 1;
   float x1 = static_cast<float>(_x) /
       static_cast<float>(targetWidth - 1) - 0.5f;
   float y1 = static_cast<float>(_y) /
       static_cast<float>(targetHeight - 1) - 0.5f;
-  float x2 = static_cast<float>(_x+width) /
+  float x2 = static_cast<float>(_x + static_cast<int>(_width)) /
       static_cast<float>(targetWidth - 1) - 0.5f;
-  float y2 = static_cast<float>(_y+height) /
+  float y2 = static_cast<float>(_y + static_cast<int>(_height)) /
       static_cast<float>(targetHeight - 1) - 0.5f;
 
   Ogre::Matrix4 scaleMatrix = Ogre::Matrix4::IDENTITY;
@@ -448,8 +564,7 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
   transMatrix[0][3] -= x1+x2;
   transMatrix[1][3] += y1+y2;
   Ogre::Matrix4 customProjectionMatrix =
-      scaleMatrix * transMatrix *
-      this->dataPtr->camera->getProjectionMatrix();
+      scaleMatrix * transMatrix * projectionMatrix;
   this->dataPtr->selectionCamera->setCustomProjectionMatrix(true,
       customProjectionMatrix);
 
@@ -457,15 +572,15 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
       this->dataPtr->camera->getDerivedPosition());
   this->dataPtr->selectionCamera->setOrientation(
       this->dataPtr->camera->getDerivedOrientation());
+  return true;
+}
 
-  // update render texture
-  this->Update();
-
-  Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->renderTexture, 0, 0);
-  Ogre::ColourValue pixel = image.getColourAt(0, 0, 0, 0);
-
-  float color = pixel[3];
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::DecodePixel(const Ogre::ColourValue &_pixel,
+    const math::Pose3d &_cameraPose, Ogre::Item *&_item,
+    math::Vector3d &_point) const
+{
+  float color = _pixel[3];
   uint32_t *rgba = reinterpret_cast<uint32_t *>(&color);
   unsigned int r = *rgba >> 24 & 0xFF;
   unsigned int g = *rgba >> 16 & 0xFF;
@@ -474,14 +589,8 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
   // todo(anyone) shaders may return nan values for semi-transparent objects
   // if there are no objects in the background (behind the semi-transparent
   // object)
-  math::Vector3d point(pixel[0], pixel[1], pixel[2]);
-
-  auto rot = Ogre2Conversions::Convert(
-      this->dataPtr->camera->getParentSceneNode()->_getDerivedOrientation());
-  auto pos = Ogre2Conversions::Convert(
-      this->dataPtr->camera->getParentSceneNode()->_getDerivedPosition());
-  math::Pose3d p(pos, rot);
-  point = rot * point + pos;
+  math::Vector3d point(_pixel[0], _pixel[1], _pixel[2]);
+  point = _cameraPose.Rot() * point + _cameraPose.Pos();
 
   gz::math::Color cv;
   cv.A(1.0);
@@ -531,3 +640,216 @@ bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
     }
   }
 }
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::ExecuteQuery(const int _x, const int _y,
+    Ogre::Item *&_item, math::Vector3d &_point)
+{
+  if (!this->dataPtr->renderTexture)
+    return false;
+
+  if (!this->dataPtr->camera)
+    return false;
+
+   const unsigned int targetWidth = this->dataPtr->width;
+   const unsigned int targetHeight = this->dataPtr->height;
+
+   if (_x < 0 || _y < 0 || _x >= static_cast<int>(targetWidth)
+       || _y >= static_cast<int>(targetHeight))
+     return false;
+
+  // 1x1 selection buffer
+  if (!this->SetupSelectionCamera(_x, _y, 1u, 1u))
+    return false;
+
+  // update render texture
+  this->Update();
+
+  Ogre::Image2 image;
+  image.convertFromTexture(this->dataPtr->renderTexture, 0, 0);
+  Ogre::ColourValue pixel = image.getColourAt(0, 0, 0, 0);
+
+  auto rot = Ogre2Conversions::Convert(
+      this->dataPtr->camera->getParentSceneNode()->_getDerivedOrientation());
+  auto pos = Ogre2Conversions::Convert(
+      this->dataPtr->camera->getParentSceneNode()->_getDerivedPosition());
+
+  return this->DecodePixel(pixel, math::Pose3d(pos, rot), _item, _point);
+}
+
+/////////////////////////////////////////////////
+unsigned int Ogre2SelectionBuffer::ExecuteQuery(
+    const std::vector<math::Vector2i> &_pixels,
+    std::vector<Ogre::Item *> &_items,
+    std::vector<math::Vector3d> &_points)
+{
+  _items.assign(_pixels.size(), nullptr);
+  _points.assign(_pixels.size(), math::Vector3d::Zero);
+
+  if (_pixels.empty())
+    return 0u;
+
+  // render the bounding rectangle of all pixels once
+  math::Vector2i minPixel(std::numeric_limits<int>::max(),
+      std::numeric_limits<int>::max());
+  math::Vector2i maxPixel(std::numeric_limits<int>::min(),
+      std::numeric_limits<int>::min());
+  for (const auto &pixel : _pixels)
+  {
+    minPixel.X(std::min(minPixel.X(), pixel.X()));
+    minPixel.Y(std::min(minPixel.Y(), pixel.Y()));
+    maxPixel.X(std::max(maxPixel.X(), pixel.X()));
+    maxPixel.Y(std::max(maxPixel.Y(), pixel.Y()));
+  }
+
+  if (!this->RequestRegion(minPixel, maxPixel))
+    return 0u;
+
+  unsigned int count = 0u;
+  for (unsigned int i = 0u; i < _pixels.size(); ++i)
+  {
+    if (this->RegionQuery(_pixels[i].X(), _pixels[i].Y(), _items[i],
+        _points[i]))
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::RequestRegion(const math::Vector2i &_min,
+    const math::Vector2i &_max)
+{
+  if (!this->dataPtr->renderTexture || !this->dataPtr->camera)
+    return false;
+
+  const int targetWidth = static_cast<int>(this->dataPtr->width);
+  const int targetHeight = static_cast<int>(this->dataPtr->height);
+
+  // clamp region to the camera image
+  int x0 = std::max(0, std::min(_min.X(), _max.X()));
+  int y0 = std::max(0, std::min(_min.Y(), _max.Y()));
+  int x1 = std::min(targetWidth - 1, std::max(_min.X(), _max.X()));
+  int y1 = std::min(targetHeight - 1, std::max(_min.Y(), _max.Y()));
+  if (x1 < x0 || y1 < y0)
+    return false;
+
+  unsigned int regionWidth = static_cast<unsigned int>(x1 - x0 + 1);
+  unsigned int regionHeight = static_cast<unsigned int>(y1 - y0 + 1);
+  this->CreateRegionBuffer(regionWidth, regionHeight);
+
+  // the whole region texture is rendered so the projection needs to cover
+  // its full size to keep a 1:1 mapping to camera pixels
+  if (!this->SetupSelectionCamera(x0, y0,
+      this->dataPtr->regionTexture->getWidth(),
+      this->dataPtr->regionTexture->getHeight()))
+  {
+    return false;
+  }
+
+  this->Render(this->dataPtr->regionWorkspace);
+
+  // start the readback but do not wait for it
+  this->dataPtr->regionTicket->download(this->dataPtr->regionTexture, 0u,
+      true);
+
+  auto rot = Ogre2Conversions::Convert(
+      this->dataPtr->camera->getParentSceneNode()->_getDerivedOrientation());
+  auto pos = Ogre2Conversions::Convert(
+      this->dataPtr->camera->getParentSceneNode()->_getDerivedPosition());
+  this->dataPtr->regionCameraPose = math::Pose3d(pos, rot);
+  this->dataPtr->regionMin = math::Vector2i(x0, y0);
+  this->dataPtr->regionWidth = regionWidth;
+  this->dataPtr->regionHeight = regionHeight;
+  this->dataPtr->regionData.clear();
+  this->dataPtr->regionPending = true;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::RegionReady()
+{
+  if (!this->dataPtr->regionPending)
+    return !this->dataPtr->regionData.empty();
+
+  if (!this->dataPtr->regionTicket->queryIsTransferDone())
+    return false;
+
+  this->FinishRegionReadback();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void Ogre2SelectionBuffer::FinishRegionReadback()
+{
+  if (!this->dataPtr->regionPending)
+    return;
+
+  // map blocks until the transfer is done
+  const unsigned int width = this->dataPtr->regionWidth;
+  const unsigned int height = this->dataPtr->regionHeight;
+  Ogre::TextureBox box = this->dataPtr->regionTicket->map(0u);
+  this->dataPtr->regionData.resize(width * height * 4u);
+  for (unsigned int y = 0u; y < height; ++y)
+  {
+    const float *row = reinterpret_cast<const float *>(box.at(0u, y, 0u));
+    std::copy(row, row + width * 4u,
+        this->dataPtr->regionData.begin() + y * width * 4u);
+  }
+  this->dataPtr->regionTicket->unmap();
+  this->dataPtr->regionPending = false;
+}
+
+/////////////////////////////////////////////////
+bool Ogre2SelectionBuffer::RegionQuery(const int _x, const int _y,
+    Ogre::Item *&_item, math::Vector3d &_point)
+{
+  this->FinishRegionReadback();
+
+  int x = _x - this->dataPtr->regionMin.X();
+  int y = _y - this->dataPtr->regionMin.Y();
+  if (this->dataPtr->regionData.empty() || x < 0 || y < 0 ||
+      x >= static_cast<int>(this->dataPtr->regionWidth) ||
+      y >= static_cast<int>(this->dataPtr->regionHeight))
+  {
+    return false;
+  }
+
+  const float *data = this->dataPtr->regionData.data() +
+      (y * this->dataPtr->regionWidth + x) * 4u;
+  Ogre::ColourValue pixel(data[0], data[1], data[2], data[3]);
+  return this->DecodePixel(pixel, this->dataPtr->regionCameraPose, _item,
+      _point);
+}
+
+/////////////////////////////////////////////////
+std::vector<Ogre::Item *> Ogre2SelectionBuffer::RegionItems()
+{
+  this->FinishRegionReadback();
+
+  // decode each unique color only once
+  std::set<uint32_t> colors;
+  const std::vector<float> &data = this->dataPtr->regionData;
+  for (size_t i = 3u; i < data.size(); i += 4u)
+  {
+    float color = data[i];
+    uint32_t rgba = *reinterpret_cast<uint32_t *>(&color);
+    colors.insert(rgba & 0xFFFFFF00);
+  }
+
+  std::vector<Ogre::Item *> items;
+  for (uint32_t rgba : colors)
+  {
+    float color = *reinterpret_cast<float *>(&rgba);
+    Ogre::ColourValue pixel(0, 0, 0, color);
+    Ogre::Item *item = nullptr;
+    math::Vector3d point;
+    if (this->DecodePixel(pixel, this->dataPtr->regionCameraPose, item,
+        point) && item)
+    {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
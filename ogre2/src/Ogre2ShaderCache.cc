@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <sstream>
+#include <string>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreArchive.h>
+#include <OgreArchiveManager.h>
+#include <OgreException.h>
+#include <OgreGpuProgramManager.h>
+#include <OgreHlms.h>
+#include <OgreHlmsDiskCache.h>
+#include <OgreHlmsManager.h>
+#include <OgreRenderSystem.h>
+#include <OgreRenderSystemCapabilities.h>
+#include <OgreRoot.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include <gz/common/Console.hh>
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Util.hh>
+#include <gz/common/Uuid.hh>
+
+#include "Ogre2ShaderCache.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Version of the cache layout. Bump it whenever the way cache
+  /// files are written changes.
+  const unsigned int kVersion = 1u;
+
+  /// \brief Name of the GPU program microcode cache file
+  const char kMicrocodeFile[] = "microcode.cache";
+
+  /// \brief Get the name of the disk cache file of an Hlms
+  /// \param[in] _type Hlms type
+  /// \return Name of the file
+  std::string hlmsFile(size_t _type)
+  {
+    return "hlms" + std::to_string(_type) + ".cache";
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Write a file of the cache through a temporary file, so that
+  /// concurrent writers and crashes never leave partial entries
+  /// \param[in] _archive Archive of the cache directory
+  /// \param[in] _dir Cache directory
+  /// \param[in] _name Name of the file
+  /// \param[in] _write Function writing the file content to a stream
+  template<typename T>
+  void writeFile(Ogre::Archive *_archive, const std::string &_dir,
+      const std::string &_name, T _write)
+  {
+    const std::string tmpName = _name + "." + common::Uuid().String() +
+        ".tmp";
+    try
+    {
+      Ogre::DataStreamPtr stream = _archive->create(tmpName);
+      _write(stream);
+      stream->close();
+    }
+    catch(Ogre::Exception &e)
+    {
+      gzwarn << "Unable to write shader cache file [" << _name << "]: "
+             << e.getDescription() << std::endl;
+      common::removeFile(common::joinPaths(_dir, tmpName));
+      return;
+    }
+    if (!common::moveFile(common::joinPaths(_dir, tmpName),
+        common::joinPaths(_dir, _name)))
+    {
+      common::removeFile(common::joinPaths(_dir, tmpName));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2ShaderCache::Directory(const std::string &_dir)
+{
+  Ogre::RenderSystem *renderSystem =
+      Ogre::Root::getSingleton().getRenderSystem();
+  const Ogre::RenderSystemCapabilities *caps =
+      renderSystem->getCapabilities();
+
+  std::ostringstream stream;
+  stream << kVersion << "\n"
+         << OGRE_VERSION_MAJOR << "." << OGRE_VERSION_MINOR << "."
+         << OGRE_VERSION_PATCH << "\n"
+         << GZ_RENDERING_VERSION_FULL << "\n"
+         << renderSystem->getName() << "\n";
+  if (caps)
+  {
+    stream << Ogre::RenderSystemCapabilities::vendorToString(
+                  caps->getVendor()) << "\n"
+           << caps->getDeviceName() << "\n"
+           << caps->getDriverVersion().toString() << "\n";
+  }
+  return common::joinPaths(_dir, common::sha1(stream.str()));
+}
+
+//////////////////////////////////////////////////
+void Ogre2ShaderCache::Load(const std::string &_dir)
+{
+  Ogre::GpuProgramManager &gpuProgramMgr =
+      Ogre::GpuProgramManager::getSingleton();
+  gpuProgramMgr.setSaveMicrocodesToCache(true);
+
+  if (!common::isDirectory(_dir))
+    return;
+
+  Ogre::ArchiveManager &archiveMgr = Ogre::ArchiveManager::getSingleton();
+  Ogre::Archive *archive = archiveMgr.load(_dir, "FileSystem", true);
+
+  // microcode first so the shaders listed by the Hlms caches are not
+  // compiled again
+  if (archive->exists(kMicrocodeFile))
+  {
+    try
+    {
+      Ogre::DataStreamPtr stream = archive->open(kMicrocodeFile);
+      gpuProgramMgr.loadMicrocodeCache(stream);
+    }
+    catch(Ogre::Exception &e)
+    {
+      gzwarn << "Ignoring invalid shader microcode cache in [" << _dir
+             << "]: " << e.getDescription() << std::endl;
+    }
+  }
+
+  Ogre::HlmsManager *hlmsMgr = Ogre::Root::getSingleton().getHlmsManager();
+  Ogre::HlmsDiskCache diskCache(hlmsMgr);
+  for (size_t i = Ogre::HLMS_LOW_LEVEL + 1u; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = hlmsMgr->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    const std::string name = hlmsFile(i);
+    if (!hlms || !archive->exists(name))
+      continue;
+
+    try
+    {
+      Ogre::DataStreamPtr stream = archive->open(name);
+      diskCache.loadFrom(stream);
+      diskCache.applyTo(hlms);
+    }
+    catch(Ogre::Exception &e)
+    {
+      gzwarn << "Ignoring invalid Hlms cache [" << name << "] in [" << _dir
+             << "]: " << e.getDescription() << std::endl;
+    }
+  }
+
+  archiveMgr.unload(archive);
+}
+
+//////////////////////////////////////////////////
+void Ogre2ShaderCache::Save(const std::string &_dir)
+{
+  if (!common::createDirectories(_dir))
+  {
+    gzerr << "Unable to create shader cache directory [" << _dir << "]"
+          << std::endl;
+    return;
+  }
+
+  Ogre::ArchiveManager &archiveMgr = Ogre::ArchiveManager::getSingleton();
+  Ogre::Archive *archive = archiveMgr.load(_dir, "FileSystem", false);
+
+  Ogre::HlmsManager *hlmsMgr = Ogre::Root::getSingleton().getHlmsManager();
+  Ogre::HlmsDiskCache diskCache(hlmsMgr);
+  for (size_t i = Ogre::HLMS_LOW_LEVEL + 1u; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = hlmsMgr->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    if (!hlms)
+      continue;
+
+    diskCache.copyFrom(hlms);
+    writeFile(archive, _dir, hlmsFile(i),
+        [&diskCache](Ogre::DataStreamPtr &_stream)
+        {
+          diskCache.saveTo(_stream);
+        });
+  }
+
+  Ogre::GpuProgramManager &gpuProgramMgr =
+      Ogre::GpuProgramManager::getSingleton();
+  if (gpuProgramMgr.isCacheDirty())
+  {
+    writeFile(archive, _dir, kMicrocodeFile,
+        [&gpuProgramMgr](Ogre::DataStreamPtr &_stream)
+        {
+          gpuProgramMgr.saveMicrocodeCache(_stream);
+        });
+  }
+
+  archiveMgr.unload(archive);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2SHADERCACHE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2SHADERCACHE_HH_
+
+#include <string>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief On-disk cache of shaders and pipeline states. Two caches are
+/// kept: the Hlms disk cache of each Hlms implementation, which records
+/// the shader variants and pipeline states that were generated so they
+/// can be recreated at startup instead of on first draw, and the GPU
+/// program microcode cache, which stores compiled shader binaries so they
+/// are not compiled again. Microcode is only valid for the GPU and driver
+/// that produced it, so entries are stored in a subdirectory named after
+/// a hash of the Ogre and gz-rendering versions, the render system, the
+/// device and the driver version. The Hlms disk cache additionally stores
+/// a hash of the shader templates and ignores entries made with other
+/// templates. Must be called from the render thread.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2ShaderCache
+{
+  /// \brief Get the directory where the cache of the current GPU and
+  /// driver is stored. The render system must be initialized.
+  /// \param[in] _dir Base cache directory
+  /// \return Cache directory of the current GPU and driver
+  public: static std::string Directory(const std::string &_dir);
+
+  /// \brief Load the cache, compiling the shaders it lists. Also enables
+  /// collection of microcode so it can be saved later. All Hlms
+  /// implementations must be registered.
+  /// \param[in] _dir Directory returned by Directory
+  public: static void Load(const std::string &_dir);
+
+  /// \brief Save the shaders and pipeline states created so far
+  /// \param[in] _dir Directory returned by Directory, created if missing
+  public: static void Save(const std::string &_dir);
+};
+}
+}
+}
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/TempDirectory.hh>
+
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/Image.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+
+#include "Ogre2RenderingTest.hh"
+#include "Ogre2ShaderCache.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreHlmsCommon.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+class Ogre2ShaderCacheTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2ShaderCacheTest, SaveAndLoad)
+{
+  common::TempDirectory tempDir("ogre2_shader_cache");
+
+  // the cache of the current GPU and driver is a stable subdirectory
+  std::string dir = Ogre2ShaderCache::Directory(tempDir.Path());
+  EXPECT_EQ(dir, Ogre2ShaderCache::Directory(tempDir.Path()));
+  EXPECT_EQ(tempDir.Path(), common::parentPath(dir));
+
+  // loading a missing cache only enables collection of microcode
+  Ogre2ShaderCache::Load(dir);
+  EXPECT_FALSE(common::exists(dir));
+
+  // render a scene so shaders are generated and compiled
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(0.0, 0.0, 1.0);
+  box->SetMaterial(material);
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  root->AddChild(box);
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  root->AddChild(camera);
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+
+  Ogre2ShaderCache::Save(dir);
+
+  // the Pbs shaders used by the box and their microcode are saved, with
+  // no temporary file left behind
+  std::vector<std::string> files;
+  for (common::DirIter it(dir); it != common::DirIter(); ++it)
+    files.push_back(common::basename(*it));
+  const std::string pbsFile =
+      "hlms" + std::to_string(Ogre::HLMS_PBS) + ".cache";
+  EXPECT_NE(files.end(), std::find(files.begin(), files.end(), pbsFile));
+  EXPECT_NE(files.end(),
+      std::find(files.begin(), files.end(), "microcode.cache"));
+  for (const auto &file : files)
+    EXPECT_EQ(std::string::npos, file.find(".tmp")) << file;
+  {
+    std::ifstream stream(common::joinPaths(dir, pbsFile),
+        std::ios::binary | std::ios::ate);
+    EXPECT_GT(stream.tellg(), 0);
+  }
+
+  // the saved cache loads back
+  EXPECT_NO_THROW(Ogre2ShaderCache::Load(dir));
+
+  // invalid cache files are ignored
+  std::string invalidDir = common::joinPaths(tempDir.Path(), "invalid");
+  ASSERT_TRUE(common::createDirectories(invalidDir));
+  {
+    std::ofstream stream(common::joinPaths(invalidDir, pbsFile),
+        std::ios::binary);
+    stream << "not a cache";
+  }
+  EXPECT_NO_THROW(Ogre2ShaderCache::Load(invalidDir));
+
+  // the scene still renders afterwards
+  camera->Capture(image);
+
+  engine->DestroyScene(scene);
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+#include <vector>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
+#include <OgreHlms.h>
+#include <OgreHlmsManager.h>
+#include <OgreTextureGpu.h>
+#include <OgreTextureGpuManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include <gz/common/Console.hh>
+
+#include "Ogre2TextureBudget.hh"
+
+#include "Terra/Hlms/OgreHlmsTerraDatablock.h"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Time a texture must go undrawn before it can be evicted
+  const std::chrono::steady_clock::duration kMinIdleTime =
+      std::chrono::seconds(3);
+
+  //////////////////////////////////////////////////
+  /// \brief Add the textures of a datablock to a set
+  /// \param[in] _datablock Datablock of any Hlms
+  /// \param[in,out] _textures Set to add to
+  void addTextures(const Ogre::HlmsDatablock *_datablock,
+      std::unordered_set<const Ogre::TextureGpu *> &_textures)
+  {
+    auto add = [&_textures](const auto *_d, Ogre::uint8 _count)
+    {
+      for (Ogre::uint8 i = 0u; i < _count; ++i)
+      {
+        if (const Ogre::TextureGpu *texture = _d->getTexture(i))
+          _textures.insert(texture);
+      }
+    };
+    if (auto pbs = dynamic_cast<const Ogre::HlmsPbsDatablock *>(_datablock))
+      add(pbs, Ogre::NUM_PBSM_TEXTURE_TYPES);
+    else if (auto unlit =
+        dynamic_cast<const Ogre::HlmsUnlitDatablock *>(_datablock))
+      add(unlit, Ogre::NUM_UNLIT_TEXTURE_TYPES);
+    else if (auto terra =
+        dynamic_cast<const Ogre::HlmsTerraDatablock *>(_datablock))
+      add(terra, Ogre::NUM_TERRA_TEXTURE_TYPES);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureBudget::SetBudget(uint64_t _bytes)
+{
+  this->budget = _bytes;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2TextureBudget::Budget() const
+{
+  return this->budget;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureBudget::Managed(const Ogre::TextureGpu *_texture)
+{
+  return !_texture->isManualTexture() && !_texture->isRenderToTexture() &&
+      !_texture->isUav();
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureBudget::Update(Ogre::HlmsManager *_hlmsManager,
+    Ogre::TextureGpuManager *_textureMgr,
+    const std::unordered_set<const Ogre::HlmsDatablock *> &_drawnDatablocks,
+    std::chrono::steady_clock::time_point _now)
+{
+  // find the textures of Pbs datablocks, those drawn and those referenced
+  // by datablocks in use. Draws are only recorded for Pbs datablocks, so
+  // textures of any other datablock are pinned.
+  std::unordered_set<const Ogre::TextureGpu *> pbs;
+  std::unordered_set<const Ogre::TextureGpu *> drawn;
+  std::unordered_set<const Ogre::TextureGpu *> referenced;
+  std::unordered_set<const Ogre::TextureGpu *> pinned;
+  for (int i = 0; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = _hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    if (!hlms)
+      continue;
+    for (const auto &entry : hlms->getDatablockMap())
+    {
+      const Ogre::HlmsDatablock *datablock = entry.second.datablock;
+      if (i != Ogre::HLMS_PBS)
+      {
+        addTextures(datablock, pinned);
+        continue;
+      }
+      addTextures(datablock, pbs);
+      if (_drawnDatablocks.count(datablock) > 0u)
+        addTextures(datablock, drawn);
+      if (_drawnDatablocks.count(datablock) > 0u ||
+          !datablock->getLinkedRenderables().empty())
+      {
+        addTextures(datablock, referenced);
+      }
+    }
+  }
+
+  // stream in evicted textures that are drawn or pinned and list eviction
+  // candidates. Entries of destroyed textures are dropped along the way.
+  std::unordered_map<const Ogre::TextureGpu *,
+      std::chrono::steady_clock::time_point> lastDrawnNow;
+  std::unordered_set<const Ogre::TextureGpu *> evictedNow;
+  std::vector<std::tuple<bool, std::chrono::steady_clock::time_point,
+      Ogre::TextureGpu *>> candidates;
+  uint64_t residentBytes = 0u;
+  for (const auto &entry : _textureMgr->getEntries())
+  {
+    Ogre::TextureGpu *texture = entry.second.texture;
+    if (!texture || entry.second.destroyRequested || !Managed(texture))
+      continue;
+
+    bool isPinned = pinned.count(texture) > 0u;
+    bool wasEvicted = this->evicted.count(texture) > 0u;
+    if (wasEvicted && (isPinned || drawn.count(texture) > 0u))
+    {
+      texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+      ++this->streamIns;
+      wasEvicted = false;
+    }
+
+    // textures keep being managed after their datablocks are destroyed,
+    // they are then the first ones evicted
+    auto it = this->lastDrawn.find(texture);
+    if (isPinned || (it == this->lastDrawn.end() && pbs.count(texture) == 0u))
+      continue;
+
+    // textures start out as just drawn so they are not evicted before
+    // their first draw
+    auto last = it != this->lastDrawn.end() ? it->second : _now;
+    if (drawn.count(texture) > 0u)
+      last = _now;
+    lastDrawnNow[texture] = last;
+    if (wasEvicted)
+      evictedNow.insert(texture);
+
+    if (texture->getNextResidencyStatus() != Ogre::GpuResidency::Resident)
+      continue;
+    residentBytes += texture->getSizeBytes();
+    if (_now - last >= kMinIdleTime)
+    {
+      candidates.emplace_back(referenced.count(texture) > 0u, last,
+          texture);
+    }
+  }
+  this->lastDrawn.swap(lastDrawnNow);
+  this->evicted.swap(evictedNow);
+
+  if (this->budget == 0u || residentBytes <= this->budget)
+    return;
+
+  // unreferenced textures first, then least recently drawn
+  std::sort(candidates.begin(), candidates.end(),
+      [](const auto &_a, const auto &_b)
+      {
+        return std::make_pair(std::get<0>(_a), std::get<1>(_a)) <
+            std::make_pair(std::get<0>(_b), std::get<1>(_b));
+      });
+  for (const auto &candidate : candidates)
+  {
+    if (residentBytes <= this->budget)
+      break;
+    Ogre::TextureGpu *texture = std::get<2>(candidate);
+    residentBytes -= texture->getSizeBytes();
+    texture->scheduleTransitionTo(Ogre::GpuResidency::OnStorage);
+    this->evicted.insert(texture);
+    ++this->evictions;
+  }
+
+  if (residentBytes > this->budget && !this->warned)
+  {
+    gzwarn << "Recently drawn textures use " << residentBytes
+           << " bytes, which exceeds the texture budget of " << this->budget
+           << " bytes" << std::endl;
+    this->warned = true;
+  }
+}
+
+//////////////////////////////////////////////////
+Ogre2TextureStats Ogre2TextureBudget::Stats(
+    Ogre::TextureGpuManager *_textureMgr) const
+{
+  Ogre2TextureStats stats;
+  stats.budgetBytes = this->budget;
+  stats.evictions = this->evictions;
+  stats.streamIns = this->streamIns;
+  for (const auto &entry : _textureMgr->getEntries())
+  {
+    Ogre::TextureGpu *texture = entry.second.texture;
+    if (!texture || entry.second.destroyRequested || !Managed(texture) ||
+        texture->getNextResidencyStatus() != Ogre::GpuResidency::Resident)
+    {
+      continue;
+    }
+    stats.residentBytes += texture->getSizeBytes();
+    ++stats.residentTextures;
+  }
+  return stats;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2TEXTUREBUDGET_HH_
+#define GZ_RENDERING_OGRE2_OGRE2TEXTUREBUDGET_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+#include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
+
+namespace Ogre
+{
+  class HlmsDatablock;
+  class HlmsManager;
+  class TextureGpu;
+  class TextureGpuManager;
+}
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Keeps the textures loaded from files within a memory budget.
+/// Only textures of Pbs datablocks are managed, since those are the only
+/// datablocks whose draws are recorded; textures also referenced by a
+/// datablock of another Hlms are never evicted. Every update, textures of
+/// the datablocks that were drawn are marked as used. When resident
+/// textures exceed the budget, the textures not referenced by any
+/// datablock in use are evicted first, then the least recently drawn
+/// ones. Textures drawn within the last few seconds are kept, so cameras
+/// rendering at a low rate and objects culled for a while do not make
+/// their textures bounce in and out. Evicted textures are made
+/// non-resident and are streamed in again from their file the next time
+/// they are drawn. Manual textures and render targets are never evicted.
+/// Must be called from the render thread.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2TextureBudget
+{
+  /// \brief Set the budget
+  /// \param[in] _bytes Max bytes of resident textures, 0 for no limit
+  public: void SetBudget(uint64_t _bytes);
+
+  /// \brief Get the budget
+  /// \return Max bytes of resident textures, 0 for no limit
+  public: uint64_t Budget() const;
+
+  /// \brief Update texture usage and evict textures to fit in the budget
+  /// \param[in] _hlmsManager Ogre Hlms manager
+  /// \param[in] _textureMgr Ogre texture manager
+  /// \param[in] _drawnDatablocks Datablocks drawn since the last update.
+  /// Only used to look up live datablocks, never dereferenced.
+  /// \param[in] _now Time of the update
+  public: void Update(Ogre::HlmsManager *_hlmsManager,
+      Ogre::TextureGpuManager *_textureMgr,
+      const std::unordered_set<const Ogre::HlmsDatablock *> &_drawnDatablocks,
+      std::chrono::steady_clock::time_point _now);
+
+  /// \brief Get residency statistics
+  /// \param[in] _textureMgr Ogre texture manager
+  /// \return Statistics
+  public: Ogre2TextureStats Stats(Ogre::TextureGpuManager *_textureMgr) const;
+
+  /// \brief Check if a texture can be evicted and streamed in again
+  /// \param[in] _texture Texture
+  /// \return True if the texture is loaded from a file
+  private: static bool Managed(const Ogre::TextureGpu *_texture);
+
+  /// \brief Budget in bytes, 0 for no limit
+  private: uint64_t budget = 0u;
+
+  /// \brief Time each managed texture was last drawn
+  private: std::unordered_map<const Ogre::TextureGpu *,
+      std::chrono::steady_clock::time_point> lastDrawn;
+
+  /// \brief Textures evicted and not streamed in since
+  private: std::unordered_set<const Ogre::TextureGpu *> evicted;
+
+  /// \brief Number of evictions since startup
+  private: uint64_t evictions = 0u;
+
+  /// \brief Number of evicted textures streamed in again since startup
+  private: uint64_t streamIns = 0u;
+
+  /// \brief True once a warning was printed because recently drawn
+  /// textures exceed the budget
+  private: bool warned = false;
+};
+}
+}
+}
+#endif
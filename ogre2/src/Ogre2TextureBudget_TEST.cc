@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include <gz/common/TempDirectory.hh>
+
+#include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#include "Ogre2RenderingTest.hh"
+#include "Ogre2TextureBudget.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <OgreRenderSystem.h>
+#include <OgreRoot.h>
+#include <OgreTextureGpuManager.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+using namespace std::chrono_literals;
+
+class Ogre2TextureBudgetTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2TextureBudgetTest, EvictAndRestore)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  common::TempDirectory tempDir("ogre2_texture_budget");
+  std::string pathA =
+      WriteGrayImage(tempDir.Path(), "budget_a.png", 4u, 4u);
+  std::string pathB =
+      WriteGrayImage(tempDir.Path(), "budget_b.png", 4u, 4u);
+
+  auto materialA =
+      std::dynamic_pointer_cast<Ogre2Material>(scene->CreateMaterial());
+  auto materialB =
+      std::dynamic_pointer_cast<Ogre2Material>(scene->CreateMaterial());
+  ASSERT_NE(nullptr, materialA);
+  ASSERT_NE(nullptr, materialB);
+  materialA->SetTexture(pathA);
+  materialB->SetTexture(pathB);
+
+  // the texture of B is also used by an Unlit datablock, whose draws are
+  // not recorded
+  ASSERT_NE(nullptr, materialB->UnlitDatablock());
+
+  Ogre::TextureGpu *textureA =
+      materialA->Datablock()->getTexture(Ogre::PBSM_DIFFUSE);
+  Ogre::TextureGpu *textureB =
+      materialB->Datablock()->getTexture(Ogre::PBSM_DIFFUSE);
+  ASSERT_NE(nullptr, textureA);
+  ASSERT_NE(nullptr, textureB);
+  ASSERT_NE(textureA, textureB);
+
+  Ogre::HlmsManager *hlmsManager = engine->OgreRoot()->getHlmsManager();
+  Ogre::TextureGpuManager *textureMgr =
+      engine->OgreRoot()->getRenderSystem()->getTextureGpuManager();
+  textureMgr->waitForStreamingCompletion();
+
+  Ogre2TextureBudget budget;
+  budget.SetBudget(1u);
+  const std::unordered_set<const Ogre::HlmsDatablock *> drawnA =
+      {materialA->Datablock()};
+  const auto start = std::chrono::steady_clock::now();
+
+  // recently drawn textures are kept even over budget
+  budget.Update(hlmsManager, textureMgr, drawnA, start);
+  EXPECT_EQ(Ogre::GpuResidency::Resident, textureA->getNextResidencyStatus());
+  budget.Update(hlmsManager, textureMgr, {}, start + 1s);
+  EXPECT_EQ(Ogre::GpuResidency::Resident, textureA->getNextResidencyStatus());
+  EXPECT_EQ(0u, budget.Stats(textureMgr).evictions);
+
+  // textures idle for a while are evicted, pinned ones are kept
+  budget.Update(hlmsManager, textureMgr, {}, start + 10s);
+  EXPECT_EQ(Ogre::GpuResidency::OnStorage,
+      textureA->getNextResidencyStatus());
+  EXPECT_EQ(Ogre::GpuResidency::Resident, textureB->getNextResidencyStatus());
+  EXPECT_GE(budget.Stats(textureMgr).evictions, 1u);
+  EXPECT_EQ(0u, budget.Stats(textureMgr).streamIns);
+
+  // drawing an evicted texture streams it in again from its file
+  budget.Update(hlmsManager, textureMgr, drawnA, start + 11s);
+  EXPECT_EQ(Ogre::GpuResidency::Resident, textureA->getNextResidencyStatus());
+  EXPECT_EQ(1u, budget.Stats(textureMgr).streamIns);
+  textureMgr->waitForStreamingCompletion();
+  EXPECT_EQ(Ogre::GpuResidency::Resident, textureA->getResidencyStatus());
+  EXPECT_EQ(4u, textureA->getWidth());
+  EXPECT_EQ(4u, textureA->getHeight());
+
+  // and it is not evicted again right away
+  budget.Update(hlmsManager, textureMgr, {}, start + 12s);
+  EXPECT_EQ(Ogre::GpuResidency::Resident, textureA->getNextResidencyStatus());
+
+  engine->DestroyScene(scene);
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreDataStream.h>
+#include <OgreException.h>
+#include <OgreImage2.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+#include <gz/common/Console.hh>
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Util.hh>
+#include <gz/common/Uuid.hh>
+#include <gz/common/WorkerPool.hh>
+
+#include "Ogre2TextureCache.hh"
+
+using namespace gz;
+using namespace rendering;
+
+namespace
+{
+  /// \brief Version of the cached textures. Bump it whenever the
+  /// conversion changes.
+  const uint32_t kVersion = 2u;
+
+  /// \brief Extension of cache files, which selects Ogre's OITD codec
+  const char kExtension[] = ".oitd";
+
+  /// \brief Extension of files being written, which Ogre never loads
+  const char kTmpExtension[] = ".tmp";
+
+  /// \brief Extensions of files that are already in a GPU format
+  const char *kGpuExtensions[] = {"dds", "ktx", "oitd", "astc", "pvr"};
+
+  /// \brief Mutex protecting g_pending and g_pool
+  std::mutex g_mutex;
+
+  /// \brief Entries being created by worker threads, as cache directory
+  /// joined with entry name
+  std::unordered_set<std::string> g_pending;
+
+  /// \brief Worker threads creating entries, created on first use
+  std::unique_ptr<common::WorkerPool> g_pool;
+
+  //////////////////////////////////////////////////
+  /// \brief Get the lower case extension of a file
+  /// \param[in] _path Path of the file
+  /// \return Extension without the dot, empty if none
+  std::string extension(const std::string &_path)
+  {
+    std::string result;
+    std::size_t dot = _path.rfind('.');
+    if (dot != std::string::npos)
+      result = _path.substr(dot + 1u);
+    std::transform(result.begin(), result.end(), result.begin(),
+        [](unsigned char _c) { return std::tolower(_c); });
+    return result;
+  }
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2TextureCache::Name(const std::string &_path, bool _srgb)
+{
+  std::string ext = extension(_path);
+  if (ext.empty() ||
+      std::find(std::begin(kGpuExtensions), std::end(kGpuExtensions),
+      ext) != std::end(kGpuExtensions))
+  {
+    return std::string();
+  }
+
+  std::error_code ec;
+  std::filesystem::path file = std::filesystem::absolute(_path, ec);
+  if (ec)
+    return std::string();
+  auto size = std::filesystem::file_size(file, ec);
+  if (ec)
+    return std::string();
+  auto time = std::filesystem::last_write_time(file, ec);
+  if (ec)
+    return std::string();
+
+  // key on the file identity and on the conversion settings
+  std::ostringstream key;
+  key << file.lexically_normal().string() << '\n' << size << '\n'
+      << time.time_since_epoch().count() << '\n' << kVersion << '\n'
+      << _srgb;
+  std::string keyStr = key.str();
+  return common::sha1(keyStr.data(), keyStr.size()) + kExtension;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2TextureCache::Find(const std::string &_dir,
+    const std::string &_path, bool _srgb)
+{
+  std::string name = Name(_path, _srgb);
+  if (name.empty() || !common::isFile(common::joinPaths(_dir, name)))
+    return std::string();
+  return name;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2TextureCache::Create(const std::string &_dir,
+    const std::string &_path, bool _srgb)
+{
+  std::string name = Name(_path, _srgb);
+  if (name.empty())
+    return false;
+  std::string path = common::joinPaths(_dir, name);
+  if (common::isFile(path))
+    return true;
+
+  if (!common::isDirectory(_dir) && !common::createDirectories(_dir))
+  {
+    gzerr << "Unable to create texture cache directory [" << _dir << "]"
+           << std::endl;
+    return false;
+  }
+
+  std::vector<char> bytes;
+  {
+    std::ifstream file(_path, std::ios::binary);
+    if (!file)
+      return false;
+    bytes.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+  }
+
+  // write to a unique temporary file first so a concurrent reader never
+  // sees a partially written entry. The temporary file does not have the
+  // extension of cache files so Ogre never tries to load it.
+  std::string tmpPath = common::joinPaths(_dir,
+      name + "." + common::Uuid().String() + kTmpExtension);
+  try
+  {
+    Ogre::DataStreamPtr stream(OGRE_NEW Ogre::MemoryDataStream(
+        bytes.data(), bytes.size(), false, true));
+    Ogre::Image2 image;
+    image.load(stream, extension(_path));
+    if (image.getNumMipmaps() <= 1u &&
+        !image.generateMipmaps(_srgb, Ogre::Image2::FILTER_BILINEAR))
+    {
+      return false;
+    }
+    Ogre::DataStreamPtr encoded = image.encode(
+        std::string(kExtension + 1), 0u, image.getNumMipmaps());
+    std::vector<char> data(encoded->size());
+    encoded->read(data.data(), data.size());
+
+    std::ofstream out(tmpPath, std::ios::binary);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    if (!out)
+    {
+      gzwarn << "Unable to write texture cache file [" << tmpPath << "]"
+             << std::endl;
+      out.close();
+      common::removeFile(tmpPath);
+      return false;
+    }
+  }
+  catch (Ogre::Exception &e)
+  {
+    gzwarn << "Unable to cache texture [" << _path << "]: "
+           << e.getDescription() << std::endl;
+    common::removeFile(tmpPath);
+    return false;
+  }
+
+  if (!common::moveFile(tmpPath, path))
+  {
+    common::removeFile(tmpPath);
+    return common::isFile(path);
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureCache::CreateAsync(const std::string &_dir,
+    const std::string &_path, bool _srgb)
+{
+  std::string name = Name(_path, _srgb);
+  if (name.empty())
+    return;
+  std::string entry = common::joinPaths(_dir, name);
+
+  std::lock_guard<std::mutex> lock(g_mutex);
+  if (!g_pending.insert(entry).second)
+    return;
+  if (!g_pool)
+    g_pool = std::make_unique<common::WorkerPool>();
+  g_pool->AddWork([_dir, _path, _srgb, entry]()
+      {
+        Create(_dir, _path, _srgb);
+        std::lock_guard<std::mutex> workLock(g_mutex);
+        g_pending.erase(entry);
+      });
+}
+
+//////////////////////////////////////////////////
+void Ogre2TextureCache::Wait()
+{
+  common::WorkerPool *pool = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    pool = g_pool.get();
+  }
+  if (pool)
+    pool->WaitForResults();
+}
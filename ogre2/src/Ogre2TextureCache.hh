@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2TEXTURECACHE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2TEXTURECACHE_HH_
+
+#include <string>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief On-disk cache of GPU-ready textures. Entries are created on a
+/// worker thread the first time a texture file is used: the file is
+/// decoded, its full mipmap chain is generated and the result is saved in
+/// Ogre's internal texture dump format (OITD), which Ogre loads with a
+/// plain copy. Entries are named after a SHA1 hash of the file path, size
+/// and modification time and of the conversion settings, so looking an
+/// entry up never reads the image and a modified image gets a new entry.
+/// Files are written to a temporary name and renamed so concurrent writers
+/// never produce partial entries.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2TextureCache
+{
+  /// \brief Get the name of the cached copy of a texture, whether it
+  /// exists or not
+  /// \param[in] _path Path of the source image
+  /// \param[in] _srgb True if the texture is sampled as sRGB, in which
+  /// case mipmaps are filtered in linear space
+  /// \return Name of the cached file, or an empty string if the image can
+  /// not be cached, e.g. because it is already in a GPU format
+  public: static std::string Name(const std::string &_path, bool _srgb);
+
+  /// \brief Get the cached copy of a texture if it exists. Only checks
+  /// file metadata so it is cheap enough for the render thread.
+  /// \param[in] _dir Cache directory
+  /// \param[in] _path Path of the source image
+  /// \param[in] _srgb True if the texture is sampled as sRGB
+  /// \return Name of the cached file in _dir, or an empty string if there
+  /// is none
+  public: static std::string Find(const std::string &_dir,
+      const std::string &_path, bool _srgb);
+
+  /// \brief Create the cached copy of a texture if it does not exist.
+  /// Decodes the image so it should not be called from the render thread.
+  /// \param[in] _dir Cache directory, created if missing
+  /// \param[in] _path Path of the source image
+  /// \param[in] _srgb True if the texture is sampled as sRGB
+  /// \return True if the cached copy exists
+  public: static bool Create(const std::string &_dir,
+      const std::string &_path, bool _srgb);
+
+  /// \brief Create the cached copy of a texture on a worker thread,
+  /// unless it is already being created
+  /// \param[in] _dir Cache directory, created if missing
+  /// \param[in] _path Path of the source image
+  /// \param[in] _srgb True if the texture is sampled as sRGB
+  public: static void CreateAsync(const std::string &_dir,
+      const std::string &_path, bool _srgb);
+
+  /// \brief Wait for the cached copies being created by worker threads.
+  /// Must be called before Ogre's image codecs are destroyed.
+  public: static void Wait();
+};
+}
+}
+}
+#endif
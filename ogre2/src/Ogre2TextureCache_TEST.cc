@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/TempDirectory.hh>
+
+#include "Ogre2RenderingTest.hh"
+#include "Ogre2TextureCache.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreDataStream.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+class Ogre2TextureCacheTest : public Ogre2RenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(Ogre2TextureCacheTest, CreateAndFind)
+{
+  common::TempDirectory tempDir("ogre2_texture_cache");
+  std::string cacheDir = common::joinPaths(tempDir.Path(), "cache");
+  std::string path = WriteGrayImage(tempDir.Path(), "gray.png", 8u, 8u);
+
+  // images in a GPU format and missing images are not cached
+  EXPECT_TRUE(Ogre2TextureCache::Name(
+      common::joinPaths(tempDir.Path(), "gray.dds"), false).empty());
+  EXPECT_TRUE(Ogre2TextureCache::Name(
+      common::joinPaths(tempDir.Path(), "missing.png"), false).empty());
+
+  std::string name = Ogre2TextureCache::Name(path, true);
+  ASSERT_FALSE(name.empty());
+  EXPECT_NE(name, Ogre2TextureCache::Name(path, false));
+  EXPECT_TRUE(Ogre2TextureCache::Find(cacheDir, path, true).empty());
+
+  ASSERT_TRUE(Ogre2TextureCache::Create(cacheDir, path, true));
+  EXPECT_EQ(name, Ogre2TextureCache::Find(cacheDir, path, true));
+  EXPECT_TRUE(Ogre2TextureCache::Find(cacheDir, path, false).empty());
+
+  // no temporary file is left behind
+  std::vector<std::string> files;
+  for (common::DirIter it(cacheDir); it != common::DirIter(); ++it)
+    files.push_back(common::basename(*it));
+  ASSERT_EQ(1u, files.size());
+  EXPECT_EQ(name, files[0]);
+
+  // the entry has the full mipmap chain
+  std::string entry = common::joinPaths(cacheDir, name);
+  std::vector<char> bytes;
+  {
+    std::ifstream file(entry, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+  }
+  ASSERT_FALSE(bytes.empty());
+  Ogre::DataStreamPtr stream(OGRE_NEW Ogre::MemoryDataStream(
+      bytes.data(), bytes.size(), false, true));
+  Ogre::Image2 image;
+  image.load(stream, "oitd");
+  EXPECT_EQ(8u, image.getWidth());
+  EXPECT_EQ(8u, image.getHeight());
+  EXPECT_EQ(4u, image.getNumMipmaps());
+
+  // a modified image gets a new entry
+  WriteGrayImage(tempDir.Path(), "gray.png", 4u, 4u);
+  EXPECT_NE(name, Ogre2TextureCache::Name(path, true));
+  EXPECT_TRUE(Ogre2TextureCache::Find(cacheDir, path, true).empty());
+
+  // entries created on a worker thread
+  Ogre2TextureCache::CreateAsync(cacheDir, path, true);
+  Ogre2TextureCache::Wait();
+  EXPECT_EQ(Ogre2TextureCache::Name(path, true),
+      Ogre2TextureCache::Find(cacheDir, path, true));
+}
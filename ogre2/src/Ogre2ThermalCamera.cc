@@ -598,7 +598,7 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
         const float color = static_cast<float>((temp / this->resolution) /
                                                ((1 << bitDepth) - 1.0));
 
-        heightmap->Terra()->SetSolidColor(1u, Ogre::Vector4(color, 0, 0, 0.0));
+        heightmap->SetSolidColor(1u, Ogre::Vector4(color, 0, 0, 0.0));
         // TODO(anyone): Retrieve datablock and make sure it's not blending
         // like we do with Items (it should be impossible?)
       }
@@ -615,8 +615,7 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
 
         // TODO(anyone): Retrieve datablock and get diffuse color
         // (it's likely gonna be 1 1 1 1 anyway... Does it matter?).
-        heightmap->Terra()->SetSolidColor(1u,
-                                          Ogre::Vector4(1.0, 1.0, 1.0, 1.0));
+        heightmap->SetSolidColor(1u, Ogre::Vector4(1.0, 1.0, 1.0, 1.0));
         // TODO(anyone): Retrieve datablock and make sure it's not blending
         // like we do with Items (it should be impossible?)
       }
@@ -680,7 +679,7 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPostRenderScene(
   {
     auto heightmap = h.lock();
     if (heightmap)
-      heightmap->Terra()->UnsetSolidColors();
+      heightmap->UnsetSolidColors();
   }
 
   // restore item to use pbs hlms material
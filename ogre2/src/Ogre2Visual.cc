@@ -19,6 +19,7 @@
 
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2Geometry.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
 #include "gz/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "gz/rendering/ogre2/Ogre2RenderTypes.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
@@ -65,6 +66,23 @@ void Ogre2Visual::SetWireframe(bool _show)
     return;
 
   this->dataPtr->wireframe = _show;
+
+  // the macroblock is changed in place so shared datablocks must not be
+  // used
+  for (unsigned int i = 0; i < this->GeometryCount(); ++i)
+  {
+    auto mesh = std::dynamic_pointer_cast<Ogre2Mesh>(this->GeometryByIndex(i));
+    if (!mesh)
+      continue;
+    for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+    {
+      auto subMesh =
+          std::dynamic_pointer_cast<Ogre2SubMesh>(mesh->SubMeshByIndex(j));
+      if (subMesh)
+        subMesh->Unshare();
+    }
+  }
+
   for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects();
       i++)
   {
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "Ogre2WorkQueue.hh"
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2WorkQueue::Ogre2WorkQueue(unsigned int _threadCount)
+    : maxThreads(std::max(1u, _threadCount))
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2WorkQueue::~Ogre2WorkQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->done = true;
+    this->activeJobs -= this->jobs.size();
+    this->jobs.clear();
+  }
+  this->jobAdded.notify_all();
+  this->jobsDone.notify_all();
+  for (auto &thread : this->threads)
+    thread.join();
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkQueue::Add(std::function<void()> _job)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->jobs.push_back(std::move(_job));
+    ++this->activeJobs;
+    // start a thread per job until the max is reached
+    if (this->threads.size() < this->maxThreads &&
+        this->threads.size() < this->activeJobs)
+    {
+      this->threads.emplace_back(&Ogre2WorkQueue::Run, this);
+    }
+  }
+  this->jobAdded.notify_one();
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkQueue::Wait()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  this->jobsDone.wait(lock, [this]() { return this->activeJobs == 0u; });
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2WorkQueue::ThreadCount() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return static_cast<unsigned int>(this->threads.size());
+}
+
+//////////////////////////////////////////////////
+void Ogre2WorkQueue::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->jobAdded.wait(lock,
+        [this]() { return this->done || !this->jobs.empty(); });
+    if (this->done)
+      return;
+
+    std::function<void()> job = std::move(this->jobs.front());
+    this->jobs.pop_front();
+    lock.unlock();
+    job();
+    lock.lock();
+
+    if (--this->activeJobs == 0u)
+      this->jobsDone.notify_all();
+  }
+}
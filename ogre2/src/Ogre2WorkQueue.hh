@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2WORKQUEUE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2WORKQUEUE_HH_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/ogre2/Export.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+
+/// \brief Runs jobs in the order they are added on a fixed number of
+/// threads. Unlike common::WorkerPool, which starts at least one thread
+/// per core, it starts exactly the number of threads requested, so
+/// several instances can coexist without oversubscribing the CPU.
+class GZ_RENDERING_OGRE2_VISIBLE Ogre2WorkQueue
+{
+  /// \brief Constructor. Threads are started on the first job.
+  /// \param[in] _threadCount Number of threads, at least 1
+  public: explicit Ogre2WorkQueue(unsigned int _threadCount);
+
+  /// \brief Destructor. Jobs not started yet are dropped, running jobs
+  /// are finished.
+  public: ~Ogre2WorkQueue();
+
+  /// \brief Queue a job
+  /// \param[in] _job Job to run on one of the threads
+  public: void Add(std::function<void()> _job);
+
+  /// \brief Wait until all queued jobs are done
+  public: void Wait();
+
+  /// \brief Get the number of threads started so far
+  /// \return Thread count, at most the count passed to the constructor
+  public: unsigned int ThreadCount() const;
+
+  /// \brief Run jobs until the queue is destroyed
+  private: void Run();
+
+  /// \brief Max number of threads
+  private: unsigned int maxThreads;
+
+  /// \brief Threads running jobs
+  private: std::vector<std::thread> threads;
+
+  /// \brief Jobs not started yet
+  private: std::deque<std::function<void()>> jobs;
+
+  /// \brief Number of jobs queued or running
+  private: std::size_t activeJobs = 0u;
+
+  /// \brief True once the queue is being destroyed
+  private: bool done = false;
+
+  /// \brief Protects all members
+  private: mutable std::mutex mutex;
+
+  /// \brief Notified when a job is added or the queue is destroyed
+  private: std::condition_variable jobAdded;
+
+  /// \brief Notified when all jobs are done
+  private: std::condition_variable jobsDone;
+};
+}
+}
+}
+
+#endif
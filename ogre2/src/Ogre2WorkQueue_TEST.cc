@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "Ogre2WorkQueue.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkQueueTest, ThreadCount)
+{
+  // never more threads than requested, whatever the number of cores
+  Ogre2WorkQueue queue(2u);
+  EXPECT_EQ(0u, queue.ThreadCount());
+
+  std::mutex mutex;
+  std::set<std::thread::id> threadIds;
+  std::atomic<unsigned int> running{0u};
+  std::atomic<unsigned int> maxRunning{0u};
+  for (unsigned int i = 0u; i < 50u; ++i)
+  {
+    queue.Add([&]()
+    {
+      unsigned int now = ++running;
+      unsigned int prev = maxRunning;
+      while (now > prev && !maxRunning.compare_exchange_weak(prev, now))
+      {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        threadIds.insert(std::this_thread::get_id());
+      }
+      --running;
+    });
+  }
+  queue.Wait();
+
+  EXPECT_LE(queue.ThreadCount(), 2u);
+  EXPECT_LE(threadIds.size(), 2u);
+  EXPECT_LE(maxRunning.load(), 2u);
+  EXPECT_EQ(0u, threadIds.count(std::this_thread::get_id()));
+
+  // a single job starts a single thread
+  Ogre2WorkQueue single(4u);
+  std::atomic<bool> ran{false};
+  single.Add([&]() { ran = true; });
+  single.Wait();
+  EXPECT_TRUE(ran);
+  EXPECT_EQ(1u, single.ThreadCount());
+}
+
+/////////////////////////////////////////////////
+TEST(Ogre2WorkQueueTest, Destroy)
+{
+  std::atomic<unsigned int> done{0u};
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  {
+    auto queue = std::make_unique<Ogre2WorkQueue>(1u);
+    queue->Add([&]()
+    {
+      started = true;
+      while (!release)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      ++done;
+    });
+    for (unsigned int i = 0u; i < 10u; ++i)
+      queue->Add([&]() { ++done; });
+    while (!started)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    // the running job is finished, the queued ones are dropped
+    std::thread releaser([&]()
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      release = true;
+    });
+    queue.reset();
+    releaser.join();
+  }
+  EXPECT_EQ(1u, done.load());
+
+  // waiting on an empty queue returns immediately
+  Ogre2WorkQueue queue(1u);
+  queue.Wait();
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version ogre_glsl_ver_330
+
+// Reads the points of a DepthCamera from its output texture, see
+// depth_camera_final_fs.glsl. Each vertex holds the pixel coordinates of
+// its point in the texture.
+
+vulkan_layout( OGRE_POSITION ) in vec4 vertex;
+
+vulkan_layout( ogre_t0 ) uniform utexture2D pointTexture;
+
+vulkan( layout( ogre_P0 ) uniform Params { )
+  uniform mat4 worldViewProj;
+  // x: point size in pixels
+  uniform vec4 pointParams;
+  // x: min range, y: max range
+  uniform vec4 ranges;
+vulkan( }; )
+
+vulkan_layout( location = 0 )
+out block
+{
+  vec3 ptColor;
+} outVs;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+  float gl_PointSize;
+};
+
+void main()
+{
+  uvec4 p = texelFetch(pointTexture, ivec2(vertex.xy), 0);
+  vec3 point = uintBitsToFloat(p.xyz);
+
+  gl_Position = worldViewProj * vec4(point, 1.0);
+  gl_PointSize = pointParams.x;
+
+  // color is packed as rgba8 with red in the most significant byte
+  outVs.ptColor = vec3(float((p.a >> 24u) & 0xFFu),
+      float((p.a >> 16u) & 0xFFu), float((p.a >> 8u) & 0xFFu)) / 255.0;
+
+  // points clamped to the min or max range
+  float dist = length(point);
+  if (any(isinf(point)) || any(isnan(point)) || point.x < ranges.x ||
+      dist >= ranges.y)
+  {
+    // move the point outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version ogre_glsl_ver_330
+
+// Reconstructs lidar points from the range texture of a GpuRays sensor.
+// Each vertex holds the pixel coordinates of its ray in the texture.
+
+vulkan_layout( OGRE_POSITION ) in vec4 vertex;
+
+vulkan_layout( ogre_t0 ) uniform texture2D rangeTexture;
+
+vulkan( layout( ogre_P0 ) uniform Params { )
+  uniform mat4 worldViewProj;
+  // x: point size in pixels
+  uniform vec4 pointParams;
+  // horizontal min, horizontal max, vertical min, vertical max angles
+  uniform vec4 angles;
+  // x: min range, y: max range
+  uniform vec4 ranges;
+vulkan( }; )
+
+vulkan_layout( location = 0 )
+out block
+{
+  vec3 ptColor;
+} outVs;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+  float gl_PointSize;
+};
+
+void main()
+{
+  ivec2 size = textureSize(rangeTexture, 0);
+  ivec2 pixel = ivec2(vertex.xy);
+  float range = texelFetch(rangeTexture, pixel, 0).x;
+
+  // rays are evenly spaced between the min and max angles, the first row
+  // and column hold the min angles, see Ogre2GpuRays::CreateSampleTexture
+  vec2 steps = vec2(
+      (angles.y - angles.x) / max(float(size.x - 1), 1.0),
+      (angles.w - angles.z) / max(float(size.y - 1), 1.0));
+  float h = angles.x + float(pixel.x) * steps.x;
+  float v = angles.z + float(pixel.y) * steps.y;
+  vec3 dir = vec3(cos(v) * cos(h), cos(v) * sin(h), sin(v));
+
+  gl_Position = worldViewProj * vec4(dir * range, 1.0);
+  gl_PointSize = pointParams.x;
+  outVs.ptColor = vec3(1.0, 1.0, 1.0);
+
+  // rays that did not hit anything
+  if (isinf(range) || isnan(range) || range < ranges.x || range >= ranges.y)
+  {
+    // move the point outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+  }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version ogre_glsl_ver_330
+
+vulkan_layout( OGRE_POSITION ) in vec4 vertex;
+vulkan_layout( OGRE_DIFFUSE ) in vec4 colour;
+
+vulkan( layout( ogre_P0 ) uniform Params { )
+  uniform mat4 worldViewProj;
+  uniform mat4 worldView;
+  // x: point size in pixels, y: decimation distance (0 to disable)
+  uniform vec4 pointParams;
+vulkan( }; )
+
+vulkan_layout( location = 0 )
+out block
+{
+  vec3 ptColor;
+} outVs;
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+  float gl_PointSize;
+};
+
+void main()
+{
+  // Calculate output position
+  gl_Position = worldViewProj * vertex;
+  gl_PointSize = pointParams.x;
+  outVs.ptColor = colour.xyz;
+
+  // Past the decimation distance, keep a fraction of the points that
+  // decreases with the squared distance so the density of points on screen
+  // stays constant. Points are ranked by hashing their index so the kept
+  // subset is spread evenly over the chunk.
+  if (pointParams.y > 0.0)
+  {
+    float dist = length((worldView * vertex).xyz);
+    float keep = pointParams.y / max(dist, pointParams.y);
+    uint hash = uint(gl_VertexID) * 2654435761u;
+    float rank = float(hash >> 8u) / 16777216.0;
+    if (rank >= keep * keep)
+    {
+      // move the point outside of the clip volume
+      gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    }
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: point_cloud_visual_depth_vs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct VS_INPUT
+{
+  float4 position [[attribute(VES_POSITION)]];
+};
+
+struct PS_INPUT
+{
+  float4 gl_Position  [[position]];
+  float  gl_PointSize [[point_size]];
+  float3 ptColor;
+};
+
+struct Params
+{
+  float4x4 worldViewProj;
+  float4 pointParams;
+  float4 ranges;
+};
+
+vertex PS_INPUT main_metal
+(
+  VS_INPUT input [[stage_in]],
+  texture2d<uint> pointTexture [[texture(0)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_INPUT outVs;
+
+  uint4 data = pointTexture.read(uint2(input.position.xy), 0);
+  float3 point = as_type<float3>(data.xyz);
+
+  outVs.gl_Position  = p.worldViewProj * float4(point, 1.0);
+  outVs.gl_PointSize = p.pointParams.x;
+  outVs.ptColor      = float3(float((data.w >> 24u) & 0xFFu),
+      float((data.w >> 16u) & 0xFFu), float((data.w >> 8u) & 0xFFu)) / 255.0;
+
+  if (any(isinf(point)) || any(isnan(point)) || point.x < p.ranges.x ||
+      length(point) >= p.ranges.y)
+  {
+    outVs.gl_Position = float4(2.0, 2.0, 2.0, 1.0);
+  }
+
+  return outVs;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// For details and documentation see: point_cloud_visual_rays_vs.glsl
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct VS_INPUT
+{
+  float4 position [[attribute(VES_POSITION)]];
+};
+
+struct PS_INPUT
+{
+  float4 gl_Position  [[position]];
+  float  gl_PointSize [[point_size]];
+  float3 ptColor;
+};
+
+struct Params
+{
+  float4x4 worldViewProj;
+  float4 pointParams;
+  float4 angles;
+  float4 ranges;
+};
+
+vertex PS_INPUT main_metal
+(
+  VS_INPUT input [[stage_in]],
+  texture2d<float> rangeTexture [[texture(0)]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_INPUT outVs;
+
+  float2 size = float2(rangeTexture.get_width(), rangeTexture.get_height());
+  uint2 pixel = uint2(input.position.xy);
+  float range = rangeTexture.read(pixel, 0).x;
+
+  float2 steps = float2(
+      (p.angles.y - p.angles.x) / max(size.x - 1.0, 1.0),
+      (p.angles.w - p.angles.z) / max(size.y - 1.0, 1.0));
+  float h = p.angles.x + float(pixel.x) * steps.x;
+  float v = p.angles.z + float(pixel.y) * steps.y;
+  float3 dir = float3(cos(v) * cos(h), cos(v) * sin(h), sin(v));
+
+  outVs.gl_Position  = p.worldViewProj * float4(dir * range, 1.0);
+  outVs.gl_PointSize = p.pointParams.x;
+  outVs.ptColor      = float3(1.0, 1.0, 1.0);
+
+  if (isinf(range) || isnan(range) || range < p.ranges.x ||
+      range >= p.ranges.y)
+  {
+    outVs.gl_Position = float4(2.0, 2.0, 2.0, 1.0);
+  }
+
+  return outVs;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct VS_INPUT
+{
+  float4 position [[attribute(VES_POSITION)]];
+  float4 colour   [[attribute(VES_DIFFUSE)]];
+};
+
+struct PS_INPUT
+{
+  float4 gl_Position  [[position]];
+  float  gl_PointSize [[point_size]];
+  float3 ptColor;
+};
+
+struct Params
+{
+  float4x4 worldViewProj;
+  float4x4 worldView;
+  // x: point size in pixels, y: decimation distance (0 to disable)
+  float4 pointParams;
+};
+
+vertex PS_INPUT main_metal
+(
+  VS_INPUT input [[stage_in]],
+  uint vertexId [[vertex_id]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_INPUT outVs;
+
+  outVs.gl_Position    = ( p.worldViewProj * input.position ).xyzw;
+  outVs.gl_PointSize   = p.pointParams.x;
+  outVs.ptColor        = input.colour.xyz;
+
+  // Past the decimation distance, keep a fraction of the points that
+  // decreases with the squared distance so the density of points on screen
+  // stays constant. Points are ranked by hashing their index so the kept
+  // subset is spread evenly over the chunk.
+  if (p.pointParams.y > 0.0)
+  {
+    float dist = length(( p.worldView * input.position ).xyz);
+    float keep = p.pointParams.y / max(dist, p.pointParams.y);
+    uint hash = vertexId * 2654435761u;
+    float rank = float(hash >> 8u) / 16777216.0;
+    if (rank >= keep * keep)
+    {
+      // move the point outside of the clip volume
+      outVs.gl_Position = float4(2.0, 2.0, 2.0, 1.0);
+    }
+  }
+
+  return outVs;
+}
@@ -71,6 +71,18 @@ class gz::rendering::HeightmapDescriptorPrivate
   /// \brief Blends in this heightmap, in height order. There should be one
   /// less than textures.
   public: std::vector<HeightmapBlend> blends;
+
+  /// \brief Number of tiles along X, 0 if not tiled.
+  public: unsigned int tileColumns{0u};
+
+  /// \brief Number of tiles along Y, 0 if not tiled.
+  public: unsigned int tileRows{0u};
+
+  /// \brief Function loading the data of a tile.
+  public: HeightmapDescriptor::TileLoader tileLoader;
+
+  /// \brief Distance from the camera within which tiles are loaded.
+  public: double tileLoadDistance{0.0};
 };
 
 //////////////////////////////////////////////////
@@ -353,3 +365,56 @@ void HeightmapDescriptor::AddBlend(const HeightmapBlend &_blend)
 {
   this->dataPtr->blends.push_back(_blend);
 }
+
+/////////////////////////////////////////////////
+void HeightmapDescriptor::SetTiles(unsigned int _columns, unsigned int _rows,
+    const TileLoader &_loader)
+{
+  if (_columns == 0u || _rows == 0u || !_loader)
+  {
+    this->dataPtr->tileColumns = 0u;
+    this->dataPtr->tileRows = 0u;
+    this->dataPtr->tileLoader = nullptr;
+    return;
+  }
+
+  this->dataPtr->tileColumns = _columns;
+  this->dataPtr->tileRows = _rows;
+  this->dataPtr->tileLoader = _loader;
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapDescriptor::TileColumns() const
+{
+  return this->dataPtr->tileColumns;
+}
+
+/////////////////////////////////////////////////
+unsigned int HeightmapDescriptor::TileRows() const
+{
+  return this->dataPtr->tileRows;
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<common::HeightmapData> HeightmapDescriptor::LoadTile(
+    unsigned int _column, unsigned int _row) const
+{
+  if (_column >= this->dataPtr->tileColumns ||
+      _row >= this->dataPtr->tileRows)
+  {
+    return nullptr;
+  }
+  return this->dataPtr->tileLoader(_column, _row);
+}
+
+/////////////////////////////////////////////////
+double HeightmapDescriptor::TileLoadDistance() const
+{
+  return this->dataPtr->tileLoadDistance;
+}
+
+/////////////////////////////////////////////////
+void HeightmapDescriptor::SetTileLoadDistance(double _distance)
+{
+  this->dataPtr->tileLoadDistance = _distance;
+}
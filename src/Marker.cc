@@ -16,13 +16,79 @@
  */
 
 
+#include <unordered_map>
+#include <utility>
+
 #include "gz/rendering/Marker.hh"
+#include "gz/rendering/base/MarkerExt.hh"
 
 using namespace gz;
 using namespace rendering;
 
+/// \brief Marker extensions, kept outside of Marker for ABI compatibility
+static std::unordered_map<const Marker *, MarkerExt *> g_markerExtMap;
+
 //////////////////////////////////////////////////
 Marker::Marker() = default;
 
 //////////////////////////////////////////////////
-Marker::~Marker() = default;
+Marker::~Marker()
+{
+  g_markerExtMap.erase(this);
+}
+
+//////////////////////////////////////////////////
+void Marker::SetPoints(const float *_xyz, const float *_rgba,
+    std::size_t _count)
+{
+  MarkerExt *ext = this->Extension();
+  if (ext)
+    ext->SetPoints(_xyz, _rgba, _count);
+  else
+    MarkerExt(this).SetPoints(_xyz, _rgba, _count);
+}
+
+//////////////////////////////////////////////////
+void Marker::SetPoints(std::vector<float> &&_xyz, std::vector<float> &&_rgba)
+{
+  MarkerExt *ext = this->Extension();
+  if (ext)
+    ext->SetPoints(std::move(_xyz), std::move(_rgba));
+  else
+    MarkerExt(this).SetPoints(std::move(_xyz), std::move(_rgba));
+}
+
+//////////////////////////////////////////////////
+void Marker::SetMaxPointCount(unsigned int _count)
+{
+  MarkerExt *ext = this->Extension();
+  if (ext)
+    ext->SetMaxPointCount(_count);
+  else
+    MarkerExt(this).SetMaxPointCount(_count);
+}
+
+//////////////////////////////////////////////////
+unsigned int Marker::MaxPointCount() const
+{
+  MarkerExt *ext = this->Extension();
+  return ext ? ext->MaxPointCount() : 0u;
+}
+
+//////////////////////////////////////////////////
+MarkerExt *Marker::Extension() const
+{
+  auto it = g_markerExtMap.find(this);
+  if (it != g_markerExtMap.end())
+    return it->second;
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+void Marker::SetExtension(MarkerExt *_ext)
+{
+  if (_ext)
+    g_markerExtMap[this] = _ext;
+  else
+    g_markerExtMap.erase(this);
+}
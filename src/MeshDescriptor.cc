@@ -15,6 +15,9 @@
  *
  */
 
+#include <map>
+#include <mutex>
+
 #include <gz/common/Console.hh>
 #include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
@@ -24,6 +27,15 @@
 using namespace gz;
 using namespace rendering;
 
+/// \brief Levels of detail of each mesh, by mesh name
+// kept outside MeshDescriptor for ABI compatibility
+static std::map<std::string, std::vector<MeshDescriptor::LodLevel>>
+    g_lodLevels;
+
+/// \brief Mutex protecting g_lodLevels, since meshes may be loaded on
+/// worker threads
+static std::mutex g_lodLevelsMutex;
+
 //////////////////////////////////////////////////
 MeshDescriptor::MeshDescriptor() = default;
 
@@ -60,3 +72,32 @@ void MeshDescriptor::Load()
     gzerr << "Missing mesh or mesh name" << std::endl;
   }
 }
+
+//////////////////////////////////////////////////
+void MeshDescriptor::SetLodLevels(const std::string &_meshName,
+    const std::vector<LodLevel> &_levels)
+{
+  std::lock_guard<std::mutex> lock(g_lodLevelsMutex);
+  if (_levels.empty())
+    g_lodLevels.erase(_meshName);
+  else
+    g_lodLevels[_meshName] = _levels;
+}
+
+//////////////////////////////////////////////////
+void MeshDescriptor::ClearLodLevels()
+{
+  std::lock_guard<std::mutex> lock(g_lodLevelsMutex);
+  g_lodLevels.clear();
+}
+
+//////////////////////////////////////////////////
+std::vector<MeshDescriptor::LodLevel> MeshDescriptor::LodLevels() const
+{
+  const std::string &name = this->mesh ? this->mesh->Name() : this->meshName;
+  std::lock_guard<std::mutex> lock(g_lodLevelsMutex);
+  auto it = g_lodLevels.find(name);
+  if (it == g_lodLevels.end())
+    return std::vector<LodLevel>();
+  return it->second;
+}
@@ -15,6 +15,7 @@
  *
  */
 
+#include "gz/rendering/Camera.hh"
 #include "gz/rendering/Scene.hh"
 
 using namespace gz;
@@ -25,7 +26,10 @@ using namespace rendering;
 static std::unordered_map<const Scene *, SceneExt *> g_sceneExtMap;
 
 //////////////////////////////////////////////////
-Scene::~Scene() = default;
+Scene::~Scene()
+{
+  g_sceneExtMap.erase(this);
+}
 
 //////////////////////////////////////////////////
 SceneExt *Scene::Extension() const
@@ -41,3 +45,32 @@ void Scene::SetExtension(SceneExt *_ext)
 {
   g_sceneExtMap[this] = _ext;
 }
+
+//////////////////////////////////////////////////
+void Scene::WarmUp()
+{
+  // end the warm-up frame explicitly even in legacy mode, where PostRender
+  // is never called, otherwise its commands are only flushed by the first
+  // real frame
+  const bool legacy = this->LegacyAutoGpuFlush();
+  const uint8_t passCount = this->CameraPassCountPerGpuFlush();
+  if (legacy)
+    this->SetCameraPassCountPerGpuFlush(1u);
+
+  this->PreRender();
+  for (unsigned int i = 0u; i < this->SensorCount(); ++i)
+  {
+    CameraPtr camera =
+        std::dynamic_pointer_cast<Camera>(this->SensorByIndex(i));
+    if (!camera)
+      continue;
+
+    // skip PostRender so no new frame is sent to listeners
+    camera->PreRender();
+    camera->Render();
+  }
+  this->PostRender();
+
+  if (legacy)
+    this->SetCameraPassCountPerGpuFlush(passCount);
+}
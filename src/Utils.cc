@@ -101,6 +101,56 @@ math::Vector3d screenToPlane(
   return origin + direction * distance;
 }
 
+/////////////////////////////////////////////////
+void closestPoints(
+    const RayQueryPtr &_rayQuery,
+    const RayQueryRay *_rays,
+    RayQueryResult *_results,
+    std::size_t _count,
+    double _maxDistance,
+    uint32_t _visibilityMask,
+    bool _forceSceneUpdate)
+{
+  // Objects excluded by the visibility mask must not hide farther objects,
+  // so the ray is cast again from just past each excluded hit.
+  const int maxMaskedHits = 64;
+  const double skipDistance = 1e-4;
+  math::Vector3d prevOrigin = _rayQuery->Origin();
+  math::Vector3d prevDirection = _rayQuery->Direction();
+  ScenePtr scene = _rayQuery->Scene();
+  bool filter = _visibilityMask != GZ_VISIBILITY_ALL && scene;
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    math::Vector3d direction = _rays[i].direction;
+    direction.Normalize();
+    _rayQuery->SetOrigin(_rays[i].origin);
+    _rayQuery->SetDirection(direction);
+    double travelled = 0.0;
+    RayQueryResult result;
+    for (int hit = 0; hit <= maxMaskedHits; ++hit)
+    {
+      // only the first query needs to update the scene graph
+      result = _rayQuery->ClosestPoint(
+          _forceSceneUpdate && i == 0u && hit == 0);
+      if (!result || !filter)
+        break;
+      VisualPtr visual = scene->VisualById(result.objectId);
+      if (!visual || (visual->VisibilityFlags() & _visibilityMask))
+        break;
+      travelled += result.distance + skipDistance;
+      _rayQuery->SetOrigin(result.point + direction * skipDistance);
+      result = RayQueryResult();
+    }
+    if (result)
+      result.distance += travelled;
+    if (result && _maxDistance > 0.0 && result.distance > _maxDistance)
+      result = RayQueryResult();
+    _results[i] = result;
+  }
+  _rayQuery->SetOrigin(prevOrigin);
+  _rayQuery->SetDirection(prevDirection);
+}
+
 /////////////////////////////////////////////////
 float screenScalingFactor()
 {
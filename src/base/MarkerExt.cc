@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gz/common/Console.hh>
+
+#include "gz/rendering/base/MarkerExt.hh"
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+MarkerExt::MarkerExt(Marker *_marker)
+  : marker(_marker)
+{
+}
+
+//////////////////////////////////////////////////
+MarkerExt::~MarkerExt() = default;
+
+//////////////////////////////////////////////////
+void MarkerExt::SetPoints(const float *_xyz, const float *_rgba,
+    std::size_t _count)
+{
+  this->marker->ClearPoints();
+  for (std::size_t i = 0; i < _count; ++i)
+  {
+    math::Color color = math::Color::White;
+    if (_rgba)
+    {
+      color.Set(_rgba[i * 4], _rgba[i * 4 + 1], _rgba[i * 4 + 2],
+          _rgba[i * 4 + 3]);
+    }
+    this->marker->AddPoint(math::Vector3d(_xyz[i * 3], _xyz[i * 3 + 1],
+        _xyz[i * 3 + 2]), color);
+  }
+}
+
+//////////////////////////////////////////////////
+void MarkerExt::SetPoints(std::vector<float> &&_xyz,
+    std::vector<float> &&_rgba)
+{
+  std::size_t count = _xyz.size() / 3u;
+  if (!_rgba.empty() && _rgba.size() != count * 4u)
+  {
+    gzerr << "Marker point color count [" << _rgba.size() / 4u
+           << "] does not match point count [" << count << "]"
+           << std::endl;
+    return;
+  }
+  this->SetPoints(_xyz.data(), _rgba.empty() ? nullptr : _rgba.data(),
+      count);
+}
+
+//////////////////////////////////////////////////
+void MarkerExt::SetMaxPointCount(unsigned int _count)
+{
+  if (_count > 0u)
+    gzwarn << "Max point count not supported by the render engine\n";
+}
+
+//////////////////////////////////////////////////
+unsigned int MarkerExt::MaxPointCount() const
+{
+  return 0u;
+}
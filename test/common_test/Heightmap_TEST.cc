@@ -327,3 +327,87 @@ TEST_F(HeightmapTest, CopyAssignmentAfterMove)
   EXPECT_DOUBLE_EQ(456.123, blend1.MinHeight());
   EXPECT_DOUBLE_EQ(123.456, blend2.MinHeight());
 }
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTest, Tiles)
+{
+  HeightmapDescriptor descriptor;
+  EXPECT_EQ(0u, descriptor.TileColumns());
+  EXPECT_EQ(0u, descriptor.TileRows());
+  EXPECT_EQ(nullptr, descriptor.LoadTile(0u, 0u));
+  EXPECT_DOUBLE_EQ(0.0, descriptor.TileLoadDistance());
+
+  auto data = std::make_shared<common::ImageHeightmap>();
+  std::vector<std::pair<unsigned int, unsigned int>> loaded;
+  descriptor.SetTiles(3u, 2u,
+      [&](unsigned int _column, unsigned int _row)
+      {
+        loaded.emplace_back(_column, _row);
+        return data;
+      });
+  descriptor.SetTileLoadDistance(12.5);
+  EXPECT_EQ(3u, descriptor.TileColumns());
+  EXPECT_EQ(2u, descriptor.TileRows());
+  EXPECT_DOUBLE_EQ(12.5, descriptor.TileLoadDistance());
+
+  EXPECT_EQ(data, descriptor.LoadTile(2u, 1u));
+  EXPECT_EQ(nullptr, descriptor.LoadTile(3u, 0u));
+  EXPECT_EQ(nullptr, descriptor.LoadTile(0u, 2u));
+  ASSERT_EQ(1u, loaded.size());
+  EXPECT_EQ(2u, loaded[0].first);
+  EXPECT_EQ(1u, loaded[0].second);
+
+  // copies share the loader
+  HeightmapDescriptor descriptor2(descriptor);
+  EXPECT_EQ(3u, descriptor2.TileColumns());
+  EXPECT_EQ(2u, descriptor2.TileRows());
+  EXPECT_DOUBLE_EQ(12.5, descriptor2.TileLoadDistance());
+  EXPECT_EQ(data, descriptor2.LoadTile(0u, 0u));
+  EXPECT_EQ(2u, loaded.size());
+
+  // disable tiling
+  descriptor.SetTiles(0u, 2u, nullptr);
+  EXPECT_EQ(0u, descriptor.TileColumns());
+  EXPECT_EQ(0u, descriptor.TileRows());
+  EXPECT_EQ(nullptr, descriptor.LoadTile(0u, 0u));
+}
+
+/////////////////////////////////////////////////
+TEST_F(HeightmapTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(TiledHeightmap))
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  auto heightImage = common::joinPaths(TEST_MEDIA_PATH, "heightmap_bowl.png");
+  auto data = std::make_shared<common::ImageHeightmap>();
+  data->Load(heightImage);
+
+  // only the tile at the center is loaded when the heightmap is created
+  std::vector<std::pair<unsigned int, unsigned int>> loaded;
+  HeightmapDescriptor desc;
+  desc.SetSize({51, 51, 10});
+  desc.SetTiles(3u, 3u,
+      [&](unsigned int _column, unsigned int _row)
+      {
+        loaded.emplace_back(_column, _row);
+        return data;
+      });
+
+  auto heightmap = scene->CreateHeightmap(desc);
+  ASSERT_NE(nullptr, heightmap);
+  ASSERT_EQ(1u, loaded.size());
+  EXPECT_EQ(1u, loaded[0].first);
+  EXPECT_EQ(1u, loaded[0].second);
+  EXPECT_EQ(3u, heightmap->Descriptor().TileColumns());
+  EXPECT_EQ(3u, heightmap->Descriptor().TileRows());
+
+  auto vis = scene->CreateVisual();
+  vis->AddGeometry(heightmap);
+  EXPECT_TRUE(vis->HasGeometry(heightmap));
+  scene->RootVisual()->AddChild(vis);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
@@ -16,10 +16,13 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include "gz/rendering/Marker.hh"
 #include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
 
 using namespace gz;
 using namespace rendering;
@@ -90,6 +93,45 @@ TEST_F(MarkerTest, Marker)
   EXPECT_NO_THROW(marker->SetPoint(0, math::Vector3d(3, 1, 2)));
   EXPECT_NO_THROW(marker->ClearPoints());
 
+  // bulk point upload
+  const float xyz[] = {0, 1, 2, 3, 4, 5};
+  const float rgba[] = {1, 0, 0, 1, 0, 1, 0, 1};
+  EXPECT_NO_THROW(marker->SetPoints(xyz, rgba, 2u));
+  EXPECT_NO_THROW(marker->SetPoints(xyz, nullptr, 2u));
+  EXPECT_NO_THROW(marker->SetPoints(std::vector<float>(xyz, xyz + 6),
+      std::vector<float>(rgba, rgba + 8)));
+  // mismatched buffer sizes are rejected
+  EXPECT_NO_THROW(marker->SetPoints(std::vector<float>(xyz, xyz + 6),
+      std::vector<float>(rgba, rgba + 4)));
+  EXPECT_NO_THROW(marker->ClearPoints());
+
+  // bounded point list
+  EXPECT_EQ(0u, marker->MaxPointCount());
+  marker->SetType(MarkerType::MT_LINE_STRIP);
+  marker->SetMaxPointCount(2u);
+  VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(marker);
+  scene->RootVisual()->AddChild(visual);
+  for (unsigned int i = 0; i < 5u; ++i)
+  {
+    EXPECT_NO_THROW(marker->AddPoint(math::Vector3d(i, 0, 0),
+        math::Color::White));
+  }
+  marker->PreRender();
+  // render engines without a bounded point list report no limit and keep
+  // every point
+  if (marker->MaxPointCount() > 0u)
+  {
+    EXPECT_EQ(2u, marker->MaxPointCount());
+    // only the 2 newest points are left
+    math::AxisAlignedBox box = visual->LocalBoundingBox();
+    EXPECT_EQ(math::Vector3d(3, 0, 0), box.Min());
+    EXPECT_EQ(math::Vector3d(4, 0, 0), box.Max());
+  }
+  marker->SetMaxPointCount(0u);
+  EXPECT_EQ(0u, marker->MaxPointCount());
+  EXPECT_NO_THROW(marker->ClearPoints());
+
   EXPECT_DOUBLE_EQ(1.0, marker->Size());
   marker->SetSize(3.0);
   EXPECT_DOUBLE_EQ(3.0, marker->Size());
@@ -97,3 +139,53 @@ TEST_F(MarkerTest, Marker)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(MarkerTest, Points)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  MarkerPtr marker = scene->CreateMarker();
+  ASSERT_NE(nullptr, marker);
+  // ogre2 uploads bulk points through its marker extension
+  EXPECT_NE(nullptr, marker->Extension());
+  marker->SetType(MarkerType::MT_LINE_STRIP);
+  VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(marker);
+  scene->RootVisual()->AddChild(visual);
+
+  // the bounds of the uploaded points match the points set
+  const float xyz[] = {-1, 2, 3, 4, -5, 6, 0, 0, -7};
+  marker->SetPoints(xyz, nullptr, 3u);
+  marker->PreRender();
+  math::AxisAlignedBox box = visual->LocalBoundingBox();
+  EXPECT_EQ(math::Vector3d(-1, -5, -7), box.Min());
+  EXPECT_EQ(math::Vector3d(4, 2, 6), box.Max());
+
+  // a bounded marker only keeps the newest points of a bulk update
+  marker->SetMaxPointCount(2u);
+  EXPECT_EQ(2u, marker->MaxPointCount());
+  const float line[] = {0, 0, 0, 1, 0, 0, 2, 0, 0, 3, 0, 0, 4, 0, 0};
+  marker->SetPoints(std::vector<float>(line, line + 15),
+      std::vector<float>());
+  marker->PreRender();
+  box = visual->LocalBoundingBox();
+  EXPECT_EQ(math::Vector3d(3, 0, 0), box.Min());
+  EXPECT_EQ(math::Vector3d(4, 0, 0), box.Max());
+
+  // points added after the ring buffer wrapped around are uploaded
+  for (unsigned int i = 5; i < 9u; ++i)
+  {
+    marker->AddPoint(math::Vector3d(i, 1, 0), math::Color::White);
+    marker->PreRender();
+    box = visual->LocalBoundingBox();
+    EXPECT_DOUBLE_EQ(i, box.Max().X());
+    EXPECT_DOUBLE_EQ(1.0, box.Max().Y());
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
@@ -16,14 +16,19 @@
 */
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "CommonRenderingTest.hh"
 
+#include <gz/common/Material.hh>
+#include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
 #include <gz/common/Skeleton.hh>
 #include <gz/common/SkeletonAnimation.hh>
+#include <gz/common/SubMesh.hh>
 
 #include "gz/rendering/Camera.hh"
 #include "gz/rendering/Mesh.hh"
@@ -85,6 +90,87 @@ TEST_F(MeshTest, MeshSubMesh)
   engine->DestroyScene(scene);
 }
 
+/////////////////////////////////////////////////
+TEST_F(MeshTest, MeshLod)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  MeshDescriptor descriptor("unit_sphere");
+  std::vector<MeshDescriptor::LodLevel> levels(2u);
+  levels[0].triangleRatio = 0.5;
+  levels[0].screenRatio = 0.2;
+  levels[1].triangleRatio = 0.1;
+  levels[1].screenRatio = 0.05;
+  MeshDescriptor::SetLodLevels("unit_sphere", levels);
+
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(1u, mesh->SubMeshCount());
+  EXPECT_EQ(2u, mesh->Descriptor().LodLevels().size());
+
+  // levels must get less detailed
+  MeshDescriptor invalid("unit_sphere");
+  levels[1].triangleRatio = 0.8;
+  MeshDescriptor::SetLodLevels("unit_sphere", levels);
+  EXPECT_EQ(nullptr, scene->CreateMesh(invalid));
+  MeshDescriptor::SetLodLevels("unit_sphere", {});
+  EXPECT_TRUE(invalid.LodLevels().empty());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshTest, MeshEmptySubMesh)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // an empty submesh between two triangles must not shift the submesh
+  // indices
+  common::Mesh commonMesh;
+  commonMesh.SetName("mesh_empty_submesh");
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    common::SubMesh subMesh;
+    subMesh.SetName("submesh" + std::to_string(i));
+    subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+    subMesh.SetMaterialIndex(i);
+    if (i != 1u)
+    {
+      subMesh.AddVertex(math::Vector3d(0, 0, 0));
+      subMesh.AddVertex(math::Vector3d(1, 0, 0));
+      subMesh.AddVertex(math::Vector3d(0, 1, 0));
+      subMesh.AddIndex(0u);
+      subMesh.AddIndex(1u);
+      subMesh.AddIndex(2u);
+    }
+    commonMesh.AddSubMesh(subMesh);
+
+    auto material = std::make_shared<common::Material>();
+    material->SetDiffuse(math::Color(0.1f * (i + 1), 0.0f, 0.0f));
+    commonMesh.AddMaterial(material);
+  }
+
+  MeshDescriptor descriptor(&commonMesh);
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, mesh);
+  ASSERT_EQ(3u, mesh->SubMeshCount());
+  for (unsigned int i = 0; i < 3u; ++i)
+  {
+    SubMeshPtr subMesh = mesh->SubMeshByIndex(i);
+    ASSERT_NE(nullptr, subMesh);
+    ASSERT_NE(nullptr, subMesh->Material());
+    EXPECT_FLOAT_EQ(0.1f * (i + 1), subMesh->Material()->Diffuse().R());
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
 /////////////////////////////////////////////////
 TEST_F(MeshTest, MeshSkeleton)
 {
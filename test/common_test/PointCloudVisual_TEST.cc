@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2024 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CommonRenderingTest.hh"
+
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/DepthCamera.hh"
+#include "gz/rendering/GpuRays.hh"
+#include "gz/rendering/PointCloudVisual.hh"
+#include "gz/rendering/Scene.hh"
+
+using namespace gz;
+using namespace rendering;
+
+class PointCloudVisualTest : public CommonRenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(PointCloudVisualTest, PointCloudVisual)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  ASSERT_NE(nullptr, scene->Extension());
+  PointCloudVisualPtr pointCloud = std::dynamic_pointer_cast<PointCloudVisual>(
+      scene->Extension()->CreateExt("point_cloud"));
+  ASSERT_NE(nullptr, pointCloud);
+
+  // check default values
+  EXPECT_EQ(0u, pointCloud->PointCount());
+  EXPECT_DOUBLE_EQ(1.0, pointCloud->PointSize());
+  EXPECT_DOUBLE_EQ(0.0, pointCloud->DecimationDistance());
+  EXPECT_EQ(65536u, pointCloud->ChunkSize());
+
+  // set and verify parameters
+  pointCloud->SetPointSize(3.0);
+  EXPECT_DOUBLE_EQ(3.0, pointCloud->PointSize());
+  pointCloud->SetDecimationDistance(20.0);
+  EXPECT_DOUBLE_EQ(20.0, pointCloud->DecimationDistance());
+  pointCloud->SetChunkSize(8u);
+  EXPECT_EQ(8u, pointCloud->ChunkSize());
+
+  // invalid values are ignored
+  pointCloud->SetDecimationDistance(-1.0);
+  EXPECT_DOUBLE_EQ(20.0, pointCloud->DecimationDistance());
+  pointCloud->SetChunkSize(0u);
+  EXPECT_EQ(8u, pointCloud->ChunkSize());
+
+  // set more points than fit in a single chunk
+  const std::size_t count = 100u;
+  std::vector<float> xyz;
+  std::vector<uint8_t> rgba;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    xyz.push_back(static_cast<float>(i % 10u));
+    xyz.push_back(static_cast<float>(i / 10u));
+    xyz.push_back(0.0f);
+    rgba.push_back(static_cast<uint8_t>(i));
+    rgba.push_back(0u);
+    rgba.push_back(255u);
+    rgba.push_back(255u);
+  }
+  pointCloud->SetPoints(xyz.data(), rgba.data(), count);
+  EXPECT_EQ(count, pointCloud->PointCount());
+
+  // points without colors
+  pointCloud->SetPoints(xyz.data(), nullptr, 10u);
+  EXPECT_EQ(10u, pointCloud->PointCount());
+
+  // null positions clear the point cloud
+  pointCloud->SetPoints(nullptr, nullptr, 10u);
+  EXPECT_EQ(0u, pointCloud->PointCount());
+
+  pointCloud->SetPoints(xyz.data(), rgba.data(), count);
+  pointCloud->ClearPoints();
+  EXPECT_EQ(0u, pointCloud->PointCount());
+
+  // draw the output of sensors
+  EXPECT_EQ(nullptr, pointCloud->Source());
+  GpuRaysPtr gpuRays = scene->CreateGpuRays();
+  ASSERT_NE(nullptr, gpuRays);
+  pointCloud->SetSource(gpuRays);
+  EXPECT_EQ(gpuRays, pointCloud->Source());
+  EXPECT_EQ(0u, pointCloud->PointCount());
+
+  DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+  ASSERT_NE(nullptr, depthCamera);
+  pointCloud->SetSource(depthCamera);
+  EXPECT_EQ(depthCamera, pointCloud->Source());
+
+  // other sensors are not supported
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  pointCloud->SetSource(camera);
+  EXPECT_EQ(depthCamera, pointCloud->Source());
+
+  pointCloud->SetSource(nullptr);
+  EXPECT_EQ(nullptr, pointCloud->Source());
+
+  pointCloud->SetPoints(xyz.data(), rgba.data(), count);
+  scene->DestroyVisual(pointCloud);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
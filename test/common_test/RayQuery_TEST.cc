@@ -17,11 +17,14 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include "gz/rendering/Camera.hh"
 #include "gz/rendering/RayQuery.hh"
 #include "gz/rendering/Scene.hh"
+#include "gz/rendering/Utils.hh"
 
 using namespace gz;
 using namespace rendering;
@@ -111,3 +114,87 @@ TEST_F(RayQueryTest, RayQuery)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(RayQueryTest, ClosestPoints)
+{
+  CHECK_UNSUPPORTED_ENGINE("optix");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(0.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  RayQueryPtr rayQuery = scene->CreateRayQuery();
+  ASSERT_NE(nullptr, rayQuery);
+
+  std::vector<RayQueryRay> rays(3u);
+  // hits the -x face of the box
+  rays[0].origin = math::Vector3d(-5.0, 0.0, 0.0);
+  rays[0].direction = math::Vector3d::UnitX;
+  // non unit direction hitting the +z face of the box
+  rays[1].origin = math::Vector3d(0.0, 0.0, 3.0);
+  rays[1].direction = math::Vector3d(0.0, 0.0, -4.0);
+  // misses the box
+  rays[2].origin = math::Vector3d(-5.0, 3.0, 0.0);
+  rays[2].direction = math::Vector3d::UnitX;
+
+  rayQuery->SetOrigin(math::Vector3d(1.0, 2.0, 3.0));
+  rayQuery->SetDirection(math::Vector3d::UnitY);
+  std::vector<RayQueryResult> results(rays.size());
+  closestPoints(rayQuery, rays.data(), results.data(), rays.size());
+  EXPECT_EQ(math::Vector3d(1.0, 2.0, 3.0), rayQuery->Origin());
+  EXPECT_EQ(math::Vector3d::UnitY, rayQuery->Direction());
+
+  EXPECT_TRUE(results[0]);
+  EXPECT_NEAR(4.5, results[0].distance, 1e-4);
+  EXPECT_EQ(math::Vector3d(-0.5, 0.0, 0.0), results[0].point);
+  EXPECT_EQ(box->Id(), results[0].objectId);
+
+  EXPECT_TRUE(results[1]);
+  EXPECT_NEAR(2.5, results[1].distance, 1e-4);
+  EXPECT_EQ(box->Id(), results[1].objectId);
+
+  EXPECT_FALSE(results[2]);
+
+  // max distance cutoff
+  closestPoints(rayQuery, rays.data(), results.data(), rays.size(), 3.0);
+  EXPECT_FALSE(results[0]);
+  EXPECT_TRUE(results[1]);
+  EXPECT_FALSE(results[2]);
+
+  // visibility mask filtering
+  box->SetVisibilityFlags(0x01);
+  closestPoints(rayQuery, rays.data(), results.data(), rays.size(), -1.0,
+      0x02);
+  EXPECT_FALSE(results[0]);
+  EXPECT_FALSE(results[1]);
+  closestPoints(rayQuery, rays.data(), results.data(), rays.size(), -1.0,
+      0x01);
+  EXPECT_TRUE(results[0]);
+  EXPECT_TRUE(results[1]);
+
+  // a nearer object excluded by the mask must not hide a farther one
+  VisualPtr nearBox = scene->CreateVisual();
+  nearBox->AddGeometry(scene->CreateBox());
+  nearBox->SetLocalPosition(-2.0, 0.0, 0.0);
+  nearBox->SetVisibilityFlags(0x02);
+  root->AddChild(nearBox);
+  closestPoints(rayQuery, rays.data(), results.data(), 1u);
+  EXPECT_TRUE(results[0]);
+  EXPECT_NEAR(2.5, results[0].distance, 1e-4);
+  EXPECT_EQ(nearBox->Id(), results[0].objectId);
+  closestPoints(rayQuery, rays.data(), results.data(), 1u, -1.0, 0x01);
+  EXPECT_TRUE(results[0]);
+  EXPECT_NEAR(4.5, results[0].distance, 1e-3);
+  EXPECT_EQ(box->Id(), results[0].objectId);
+  root->RemoveChild(nearBox);
+  scene->DestroyVisual(nearBox);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
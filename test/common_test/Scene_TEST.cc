@@ -19,6 +19,9 @@
 
 #include "CommonRenderingTest.hh"
 
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/DepthCamera.hh"
+#include "gz/rendering/Image.hh"
 #include "gz/rendering/RenderTarget.hh"
 #include "gz/rendering/Scene.hh"
 
@@ -751,3 +754,88 @@ TEST_F(SceneTest, Sky)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(SceneTest, WarmUp)
+{
+  auto scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // warming up an empty scene does nothing
+  scene->WarmUp();
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  MaterialPtr mat = scene->CreateMaterial();
+  mat->SetDiffuse(0.0, 0.0, 1.0);
+  mat->SetEmissive(0.0, 0.0, 1.0);
+  box->SetMaterial(mat);
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64u);
+  camera->SetImageHeight(64u);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  DepthCameraPtr depthCamera = scene->CreateDepthCamera();
+  ASSERT_NE(nullptr, depthCamera);
+  depthCamera->SetImageWidth(64u);
+  depthCamera->SetImageHeight(64u);
+  depthCamera->CreateDepthTexture();
+  root->AddChild(depthCamera);
+
+  unsigned int frames = 0u;
+  common::ConnectionPtr connection = depthCamera->ConnectNewDepthFrame(
+      [&frames](const float *, unsigned int, unsigned int, unsigned int,
+          const std::string &)
+      {
+        ++frames;
+      });
+
+  // warming up renders every camera without sending frames to listeners
+  scene->WarmUp();
+  EXPECT_EQ(0u, frames);
+  depthCamera->Update();
+  EXPECT_EQ(1u, frames);
+
+  // the first capture after warming up already shows the box, which is
+  // emissive so it does not depend on lighting
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  const unsigned char *data = image.Data<unsigned char>();
+  ASSERT_NE(nullptr, data);
+  const unsigned int center = (32u * 64u + 32u) * 3u;
+  EXPECT_LT(data[center], 50u);
+  EXPECT_LT(data[center + 1u], 50u);
+  EXPECT_GT(data[center + 2u], 200u);
+
+  // and again once the scene changes
+  VisualPtr sphere = scene->CreateVisual();
+  sphere->AddGeometry(scene->CreateSphere());
+  sphere->SetMaterial(mat);
+  sphere->SetLocalPosition(2.0, 1.0, 0.0);
+  root->AddChild(sphere);
+  scene->WarmUp();
+  EXPECT_EQ(1u, frames);
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_GT(data[center + 2u], 200u);
+
+  // in legacy mode the warm-up frame is ended before returning, and the
+  // mode is kept
+  scene->SetCameraPassCountPerGpuFlush(0u);
+  scene->WarmUp();
+  EXPECT_EQ(0u, scene->CameraPassCountPerGpuFlush());
+  EXPECT_TRUE(scene->LegacyAutoGpuFlush());
+  EXPECT_EQ(1u, frames);
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_GT(data[center + 2u], 200u);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}